@@ -120,16 +120,13 @@ int main(int argc, char* argv[])
   xbt_replay_action_register("read", Replayer::read);
   xbt_replay_action_register("close", Replayer::close);
 
-  if (argv[3]) {
-    simgrid::xbt::action_fs = new std::ifstream(argv[3], std::ifstream::in);
-  }
+  if (argv[3])
+    simgrid::xbt::replay_trace_open(argv[3]);
 
   e->run();
 
-  if (argv[3]) {
-    delete simgrid::xbt::action_fs;
-    simgrid::xbt::action_fs = nullptr;
-  }
+  if (argv[3])
+    simgrid::xbt::replay_trace_close();
 
   XBT_INFO("Simulation time %g", e->getClock());
 
@@ -80,6 +80,11 @@ public:
   void netpointRegister(simgrid::kernel::routing::NetPoint * card);
   void netpointUnregister(simgrid::kernel::routing::NetPoint * card);
 
+  /** @brief Amount of routes retrieved from the route cache (see the network/route-cache configuration item) */
+  unsigned long long getRouteCacheHits();
+  /** @brief Amount of routes that had to be computed because they were not in the route cache */
+  unsigned long long getRouteCacheMisses();
+
   template <class F> void registerFunction(const char* name)
   {
     simgrid::simix::registerFunction(name, [](std::vector<std::string> args) {
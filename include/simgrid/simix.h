@@ -84,6 +84,7 @@ XBT_PUBLIC(int) SIMIX_context_get_parallel_threshold();
 XBT_PUBLIC(void) SIMIX_context_set_parallel_threshold(int threshold);
 XBT_PUBLIC(e_xbt_parmap_mode_t) SIMIX_context_get_parallel_mode();
 XBT_PUBLIC(void) SIMIX_context_set_parallel_mode(e_xbt_parmap_mode_t mode);
+XBT_PUBLIC(void) SIMIX_context_stack_stats(size_t* allocated, size_t* reused, size_t* peak_size);
 XBT_PUBLIC(int) SIMIX_is_maestro();
 
 
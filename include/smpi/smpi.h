@@ -896,9 +896,9 @@ XBT_PUBLIC(unsigned int) smpi_sleep(unsigned int secs);
 XBT_PUBLIC(int) smpi_gettimeofday(struct timeval *tv, void* tz);
 XBT_PUBLIC(unsigned long long) smpi_rastro_resolution ();
 XBT_PUBLIC(unsigned long long) smpi_rastro_timestamp ();
-XBT_PUBLIC(void) smpi_sample_1(int global, const char *file, int line, int iters, double threshold);
-XBT_PUBLIC(int) smpi_sample_2(int global, const char *file, int line);
-XBT_PUBLIC(void) smpi_sample_3(int global, const char *file, int line);
+XBT_PUBLIC(int) smpi_sample_1(int global, const char *file, int line, int iters, double threshold);
+XBT_PUBLIC(int) smpi_sample_2(int global, int site);
+XBT_PUBLIC(void) smpi_sample_3(int global, int site);
 
 /**
  * Need a public setter for SMPI copy_callback function, so users can define
@@ -918,13 +918,15 @@ XBT_PUBLIC(void) smpi_trace_set_call_location_(const char *file, int* line);
 /** Fortran binding + -fsecond-underscore **/
 XBT_PUBLIC(void) smpi_trace_set_call_location__(const char *file, int* line);
 
-#define SMPI_SAMPLE_LOCAL(iters,thres) for(smpi_sample_1(0, __FILE__, __LINE__, iters, thres); \
-                                           smpi_sample_2(0, __FILE__, __LINE__);      \
-                                           smpi_sample_3(0, __FILE__, __LINE__))
+/* smpi_sample_1() finds the sampled block from the address of its __FILE__ literal and its line, and returns its site
+ * index, that identifies it in the sampling statistics for the rest of the loop. */
+#define SMPI_SAMPLE_LOCAL(iters,thres) for(int smpi_sample_ = smpi_sample_1(0, __FILE__, __LINE__, iters, thres); \
+                                           smpi_sample_2(0, smpi_sample_);                                       \
+                                           smpi_sample_3(0, smpi_sample_))
 
-#define SMPI_SAMPLE_GLOBAL(iters,thres) for(smpi_sample_1(1, __FILE__, __LINE__, iters, thres); \
-                                            smpi_sample_2(1, __FILE__, __LINE__);      \
-                                            smpi_sample_3(1, __FILE__, __LINE__))
+#define SMPI_SAMPLE_GLOBAL(iters,thres) for(int smpi_sample_ = smpi_sample_1(1, __FILE__, __LINE__, iters, thres); \
+                                            smpi_sample_2(1, smpi_sample_);                                       \
+                                            smpi_sample_3(1, smpi_sample_))
 
 #define SMPI_SAMPLE_DELAY(duration) for(smpi_execute(duration); 0; )
 #define SMPI_SAMPLE_FLOPS(flops) for(smpi_execute_flops(flops); 0; )
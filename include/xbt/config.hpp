@@ -10,6 +10,7 @@
 
 #include <cstdlib>
 
+#include <atomic>
 #include <functional>
 #include <initializer_list>
 #include <stdexcept>
@@ -236,6 +237,58 @@ public:
   bool operator>=(U const& that) const { return value_ >= that; }
 };
 
+template<class T> class Handle;
+
+/** Bind a handle to its option (used internally by Handle<T>::get()) */
+template<class T>
+XBT_PUBLIC(void) bindHandle(Handle<T>& handle);
+
+extern template XBT_PUBLIC(void) bindHandle(Handle<int>& handle);
+extern template XBT_PUBLIC(void) bindHandle(Handle<double>& handle);
+extern template XBT_PUBLIC(void) bindHandle(Handle<bool>& handle);
+extern template XBT_PUBLIC(void) bindHandle(Handle<std::string>& handle);
+
+/** Typed handle on an option declared elsewhere
+ *
+ *  Unlike getConfig() or xbt_cfg_get_*(), which look the option up by name
+ *  each time, the handle resolves the option the first time it is read and
+ *  keeps a copy of its value, refreshed by the option whenever it changes.
+ *  Reading it is thus as cheap as reading a variable, which makes it
+ *  suitable for the hot paths.
+ *
+ *  <pre><code>
+ *  static simgrid::config::Handle<int> thresh("smpi/async-small-thresh");
+ *  if (size < thresh.get())
+ *    ...
+ *  </code></pre>
+ *
+ *  The handle is unbound when the configuration is freed, and binds again
+ *  on next read.
+ */
+template<class T>
+class Handle {
+  const char* name_;
+  T value_ = T();
+  std::atomic<bool> bound_{false};
+  template<class U> friend XBT_PUBLIC(void) bindHandle(Handle<U>& handle);
+public:
+  explicit Handle(const char* name) : name_(name) {}
+
+  // No copy:
+  Handle(Handle const&) = delete;
+  Handle& operator=(Handle const&) = delete;
+
+  const char* getName() const { return name_; }
+
+  T const& get()
+  {
+    if (not bound_.load(std::memory_order_acquire))
+      bindHandle(*this);
+    return value_;
+  }
+  operator T const&() { return get(); }
+};
+
 }
 }
 
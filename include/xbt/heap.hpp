@@ -0,0 +1,173 @@
+/* Copyright (c) 2017. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#ifndef SIMGRID_XBT_HEAP_HPP
+#define SIMGRID_XBT_HEAP_HPP
+
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <xbt/asserts.h>
+
+namespace simgrid {
+namespace xbt {
+
+/** Position tracker of the heaps whose elements do not need to know where they are */
+struct HeapNoIndex {
+  template <class T> void operator()(const T&, int) const {}
+};
+
+/** @brief A typed binary heap of (key, value) pairs, smallest key first
+ *
+ *  This is the C++ counterpart of xbt_heap_t. The items are stored by value in a single array, with no void* nor
+ *  callback through a function pointer. The layout of the array and the moves of the items are exactly the ones of
+ *  xbt_heap: the items of same key come out in the same order, so that the simulations do not depend on which of the
+ *  two heaps is used.
+ *
+ *  Each time a value moves in the array, `IndexUpdate` is called with the value and its new position (-1 when it
+ *  leaves the heap). Intrusive users store this position in their value, and give it back to update() or remove().
+ *
+ *  @code{.cpp}
+ *  struct TimerIndex {
+ *    void operator()(Timer* timer, int i) const { timer->index = i; }
+ *  };
+ *  simgrid::xbt::Heap<Timer*, TimerIndex> timers;
+ *  timers.push(timer, date);
+ *  timers.update(timer->index, new_date);
+ *  @endcode
+ */
+template <class T, class IndexUpdate = HeapNoIndex> class Heap {
+  struct Item {
+    double key;
+    T value;
+  };
+
+public:
+  explicit Heap(IndexUpdate index_update = IndexUpdate()) : index_update_(std::move(index_update)) {}
+
+  bool empty() const { return items_.empty(); }
+  std::size_t size() const { return items_.size(); }
+  void reserve(std::size_t size) { items_.reserve(size); }
+
+  /** The smallest key of the heap */
+  double top_key() const
+  {
+    xbt_assert(not items_.empty(), "Empty heap");
+    return items_.front().key;
+  }
+  /** The value of smallest key */
+  const T& top() const
+  {
+    xbt_assert(not items_.empty(), "Empty heap");
+    return items_.front().value;
+  }
+  /** The key of the value at the given position */
+  double key(int i) const { return items_[i].key; }
+
+  void push(T value, double key)
+  {
+    items_.push_back(Item{key, std::move(value)});
+    sift_up(items_.size() - 1);
+  }
+
+  /** Extract the value of smallest key */
+  T pop()
+  {
+    xbt_assert(not items_.empty(), "Empty heap");
+    T value = std::move(items_.front().value);
+    if (items_.size() > 1) {
+      items_.front() = std::move(items_.back());
+      items_.pop_back();
+      sift_down(0);
+    } else {
+      items_.pop_back();
+    }
+    index_update_(value, -1);
+    return value;
+  }
+
+  /** Extract the value at the given position */
+  T remove(int i)
+  {
+    xbt_assert(i >= 0 && static_cast<std::size_t>(i) < items_.size(), "Invalid heap position %d (size: %zu)", i,
+               items_.size());
+    // Bring it to the top, as xbt_heap_remove() does:
+    if (i > 0) {
+      items_[i].key = std::numeric_limits<double>::lowest();
+      sift_up(i);
+    }
+    return pop();
+  }
+
+  /** Change the key of the value at the given position */
+  void update(int i, double key)
+  {
+    xbt_assert(i >= 0 && static_cast<std::size_t>(i) < items_.size(), "Invalid heap position %d (size: %zu)", i,
+               items_.size());
+    double old_key = items_[i].key;
+    items_[i].key  = key;
+    if (key < old_key)
+      sift_up(i);
+    else if (key > old_key)
+      sift_down(i);
+  }
+
+  void clear()
+  {
+    for (Item& item : items_)
+      index_update_(item.value, -1);
+    items_.clear();
+  }
+
+private:
+  /* The children of i are 2i and 2i+1 (only 1 for the root), as in xbt_heap */
+  static std::size_t parent(std::size_t i) { return i >> 1; }
+
+  void sift_up(std::size_t i)
+  {
+    Item item = std::move(items_[i]);
+    while (i > 0 && items_[parent(i)].key > item.key) {
+      items_[i] = std::move(items_[parent(i)]);
+      index_update_(items_[i].value, i);
+      i = parent(i);
+    }
+    items_[i] = std::move(item);
+    index_update_(items_[i].value, i);
+  }
+
+  void sift_down(std::size_t i)
+  {
+    Item item         = std::move(items_[i]);
+    std::size_t count = items_.size();
+    while (true) {
+      // The smallest of the item and its children, the left one winning the ties:
+      std::size_t left = i << 1;
+      std::size_t best = i;
+      double best_key  = item.key;
+      if (left != i && left < count && items_[left].key < best_key) {
+        best     = left;
+        best_key = items_[left].key;
+      }
+      if (left + 1 < count && items_[left + 1].key < best_key)
+        best = left + 1;
+      if (best == i)
+        break;
+      items_[i] = std::move(items_[best]);
+      index_update_(items_[i].value, i);
+      i = best;
+    }
+    items_[i] = std::move(item);
+    index_update_(items_[i].value, i);
+  }
+
+  std::vector<Item> items_;
+  IndexUpdate index_update_;
+};
+}
+}
+
+#endif
@@ -36,7 +36,8 @@ typedef enum {
   XBT_PARMAP_POSIX,          /**< use POSIX synchronization primitives */
   XBT_PARMAP_FUTEX,          /**< use Linux futex system call */
   XBT_PARMAP_BUSY_WAIT,      /**< busy waits (no system calls, maximum CPU usage) */
-  XBT_PARMAP_DEFAULT         /**< futex if available, posix otherwise */
+  XBT_PARMAP_DEFAULT,        /**< futex if available, posix otherwise */
+  XBT_PARMAP_WORK_STEALING   /**< per-worker ranges of data that idle workers steal, spinning before sleeping */
 } e_xbt_parmap_mode_t;
 
 XBT_PUBLIC(xbt_parmap_t) xbt_parmap_new(unsigned int num_workers, e_xbt_parmap_mode_t mode);
@@ -11,18 +11,72 @@
 
 #include "xbt/dict.h"
 #ifdef __cplusplus
+#include <cstdint>
+#include <cstdio>
 #include <fstream>
-#include <queue>
+#include <functional>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace simgrid {
 namespace xbt {
-/* To split the file if a unique one is given (specific variable for the other case live in runner()) */
-typedef std::vector<std::string> ReplayAction;
-static std::unordered_map<std::string, std::queue<ReplayAction*>*> action_queues;
-
+/* A unique trace file for all actors is either opened by name (and mapped in memory), or read from action_fs.
+ * Otherwise, each actor reads the trace file given as its second argument. */
 XBT_PUBLIC_DATA(std::ifstream*) action_fs;
+XBT_PUBLIC(void) replay_trace_open(const char* filename);
+XBT_PUBLIC(void) replay_trace_close();
 XBT_PUBLIC(int) replay_runner(int argc, char* argv[]);
+
+/** @brief Calls @a f on each action of a trace file, textual or binary
+ *
+ * The tokens given to @a f (terminated by a nullptr) are only valid during the call. */
+XBT_PUBLIC(void) replay_trace_foreach(const char* filename, std::function<void(const char* const*)> const& f);
+
+/** @brief Gets the value of the token @a i of an action, if it was read as a number from a binary trace
+ *
+ * To be called by the action handlers on the tokens they are given. Returns false if the value is not known, e.g. for
+ * textual traces, in which case the token must be parsed as usual.
+ */
+XBT_PUBLIC(bool) replay_action_number(const char* const* action, int i, double* value);
+
+/** @brief Writer of binary traces
+ *
+ * The binary traces hold the same actions as the textual ones, but are decoded without any text parsing. The action
+ * names are replaced by their index in an opcode table, the numbers are stored as varints (or as raw doubles when they
+ * are not integers), and the actions of each actor are grouped in chunks. An index at the end of the file lists the
+ * chunks of each actor, so that every actor only reads its own actions, even when they all share the file.
+ * replay_runner() and replay_trace_open() recognize the binary traces by their header.
+ */
+XBT_PUBLIC_CLASS ReplayBinaryWriter {
+  struct Chunk {
+    unsigned actor;
+    uint64_t offset;
+    uint64_t length;
+  };
+
+  FILE* file_;
+  uint64_t offset_;
+  std::unordered_map<std::string, unsigned> opcodes_;
+  std::vector<std::string> opcode_names_;
+  std::unordered_map<std::string, unsigned> actors_;
+  std::vector<std::string> actor_names_;
+  std::vector<std::string> pending_; // actions of each actor that are not written yet
+  std::vector<Chunk> chunks_;
+
+  void flush(unsigned actor);
+
+public:
+  explicit ReplayBinaryWriter(const char* filename);
+  ReplayBinaryWriter(ReplayBinaryWriter const&) = delete;
+  ReplayBinaryWriter& operator=(ReplayBinaryWriter const&) = delete;
+  ~ReplayBinaryWriter();
+
+  /** Adds an action, given as its tokens terminated by a nullptr: the actor name, the action name and the arguments */
+  void write(const char* const* action);
+  /** Adds an action, given as a line of a textual trace */
+  void write_line(const char* line);
+};
 }
 }
 #endif
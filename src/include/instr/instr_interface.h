@@ -16,6 +16,7 @@ XBT_PUBLIC(void) TRACE_global_init(int *argc, char **argv);
 XBT_PUBLIC(void) TRACE_help(int detailed);
 XBT_PUBLIC(void) TRACE_surf_resource_utilization_alloc();
 XBT_PUBLIC(void) TRACE_surf_resource_utilization_release();
+XBT_PUBLIC(void) TRACE_binary_to_paje(const char* input, const char* output);
 
 SG_END_DECL()
 
@@ -30,6 +30,7 @@ extern XBT_PRIVATE int _sg_do_model_check_record;
 extern XBT_PRIVATE int _sg_mc_checkpoint;
 extern XBT_PUBLIC(int) _sg_mc_sparse_checkpoint;
 extern XBT_PUBLIC(int) _sg_mc_ksm;
+extern XBT_PRIVATE int _sg_mc_soft_dirty;
 extern XBT_PUBLIC(char*) _sg_mc_property_file;
 extern XBT_PRIVATE int _sg_mc_timeout;
 extern XBT_PRIVATE int _sg_mc_hash;
@@ -40,18 +41,23 @@ extern XBT_PUBLIC(int) _sg_mc_comms_determinism;
 extern XBT_PUBLIC(int) _sg_mc_send_determinism;
 extern XBT_PRIVATE int _sg_mc_snapshot_fds;
 extern XBT_PRIVATE int _sg_mc_termination;
+extern XBT_PUBLIC(int) _sg_mc_workers;
+extern XBT_PRIVATE int _sg_mc_compare_threads;
 
 /********************************* Global *************************************/
 XBT_PRIVATE void _mc_cfg_cb_reduce(const char *name);
 XBT_PRIVATE void _mc_cfg_cb_checkpoint(const char *name);
 XBT_PRIVATE void _mc_cfg_cb_sparse_checkpoint(const char *name);
 XBT_PRIVATE void _mc_cfg_cb_ksm(const char *name);
+XBT_PRIVATE void _mc_cfg_cb_soft_dirty(const char *name);
 XBT_PRIVATE void _mc_cfg_cb_property(const char *name);
 XBT_PRIVATE void _mc_cfg_cb_timeout(const char *name);
 XBT_PRIVATE void _mc_cfg_cb_snapshot_fds(const char *name);
 XBT_PRIVATE void _mc_cfg_cb_hash(const char *name);
 XBT_PRIVATE void _mc_cfg_cb_max_depth(const char *name);
 XBT_PRIVATE void _mc_cfg_cb_visited(const char *name);
+XBT_PRIVATE void _mc_cfg_cb_workers(const char *name);
+XBT_PRIVATE void _mc_cfg_cb_compare_threads(const char *name);
 XBT_PRIVATE void _mc_cfg_cb_dot_output(const char *name);
 XBT_PRIVATE void _mc_cfg_cb_comms_determinism(const char *name);
 XBT_PRIVATE void _mc_cfg_cb_send_determinism(const char *name);
@@ -130,6 +130,7 @@ class Action;
 XBT_PUBLIC_DATA(double) sg_maxmin_precision;
 XBT_PUBLIC_DATA(double) sg_surf_precision;
 XBT_PUBLIC_DATA(int) sg_concurrency_limit;
+XBT_PUBLIC_DATA(bool) sg_maxmin_soa;
 
 static inline void double_update(double *variable, double value, double precision)
 {
@@ -433,10 +434,20 @@ XBT_PUBLIC(void) lmm_print(lmm_system_t sys);
 
 /**
  * @brief Solve the lmm system
+ * @details Delegates to lmm_solve_soa() when the maxmin/soa configuration option is set.
  * @param sys The lmm system to solve
  */
 XBT_PUBLIC(void) lmm_solve(lmm_system_t sys);
 
+/**
+ * @brief Solve the lmm system on contiguous storage
+ * @details Same algorithm and results as lmm_solve(), but on the index-addressed arrays (structure of arrays) that
+ * the system keeps up to date when it is created with the maxmin/soa configuration option set, so that the saturation
+ * loop does not chase the swag pointers.
+ * @param sys The lmm system to solve
+ */
+XBT_PUBLIC(void) lmm_solve_soa(lmm_system_t sys);
+
 XBT_PUBLIC(void) lagrange_solve(lmm_system_t sys);
 XBT_PUBLIC(void) bottleneck_solve(lmm_system_t sys);
 
@@ -27,8 +27,12 @@ extern XBT_PRIVATE double sg_latency_factor;
 extern XBT_PRIVATE double sg_bandwidth_factor;
 extern XBT_PRIVATE double sg_weight_S_parameter;
 extern XBT_PRIVATE int sg_network_crosstraffic;
+extern XBT_PRIVATE int sg_route_cache_size;
+extern XBT_PRIVATE int sg_route_cache_shards;
+extern XBT_PRIVATE int sg_dijkstra_threads;
 
 #ifdef __cplusplus
+extern XBT_PRIVATE bool sg_surf_calendar_queue;
 
 namespace simgrid {
 namespace surf {
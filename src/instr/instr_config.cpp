@@ -12,6 +12,8 @@ XBT_LOG_NEW_CATEGORY(instr, "Logging the behavior of the tracing system (used fo
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY (instr_config, instr, "Configuration");
 
 #define OPT_TRACING_BASIC                "tracing/basic"
+#define OPT_TRACING_BINARY               "tracing/binary"
+#define OPT_TRACING_BINARY_COMPRESS      "tracing/binary/compress"
 #define OPT_TRACING_BUFFER               "tracing/buffer"
 #define OPT_TRACING_CATEGORIZED          "tracing/categorized"
 #define OPT_TRACING_COMMENT_FILE         "tracing/comment-file"
@@ -22,6 +24,7 @@ XBT_LOG_NEW_DEFAULT_SUBCATEGORY (instr_config, instr, "Configuration");
 #define OPT_TRACING_DISPLAY_SIZES        "tracing/smpi/display-sizes"
 #define OPT_TRACING_FILENAME             "tracing/filename"
 #define OPT_TRACING_FORMAT_TI_ONEFILE    "tracing/smpi/format/ti-one-file"
+#define OPT_TRACING_FORMAT_TI_BINARY     "tracing/smpi/format/ti-binary"
 #define OPT_TRACING_FORMAT               "tracing/smpi/format"
 #define OPT_TRACING_MSG_PROCESS          "tracing/msg/process"
 #define OPT_TRACING_MSG_VM               "tracing/msg/vm"
@@ -298,6 +301,16 @@ int TRACE_precision ()
   return xbt_cfg_get_int(OPT_TRACING_PRECISION);
 }
 
+bool TRACE_binary()
+{
+  return xbt_cfg_get_boolean(OPT_TRACING_BINARY);
+}
+
+bool TRACE_binary_compress()
+{
+  return xbt_cfg_get_boolean(OPT_TRACING_BINARY_COMPRESS);
+}
+
 char *TRACE_get_filename()
 {
   return xbt_cfg_get_string(OPT_TRACING_FILENAME);
@@ -345,11 +358,14 @@ void TRACE_global_init(int *argc, char **argv)
   xbt_cfg_register_boolean(OPT_TRACING_DISPLAY_SIZES, "no", nullptr, "(smpi only) Extended events with message size information");
   xbt_cfg_register_string(OPT_TRACING_FORMAT, "Paje", nullptr, "(smpi only) Switch the output format of Tracing");
   xbt_cfg_register_boolean(OPT_TRACING_FORMAT_TI_ONEFILE, "no", nullptr, "(smpi only) For replay format only : output to one file only");
+  xbt_cfg_register_boolean(OPT_TRACING_FORMAT_TI_BINARY, "no", nullptr, "(smpi only) For replay format only : output binary traces");
   xbt_cfg_register_string(OPT_TRACING_COMMENT, "", nullptr, "Comment to be added on the top of the trace file.");
   xbt_cfg_register_string(OPT_TRACING_COMMENT_FILE, "", nullptr,
       "The contents of the file are added to the top of the trace file as comment.");
   xbt_cfg_register_int(OPT_TRACING_PRECISION, 6, nullptr, "Numerical precision used when timestamping events "
       "(expressed in number of digits after decimal point)");
+  xbt_cfg_register_boolean(OPT_TRACING_BINARY, "no", nullptr, "Write the Paje trace in a binary format.");
+  xbt_cfg_register_boolean(OPT_TRACING_BINARY_COMPRESS, "yes", nullptr, "Compress the binary trace with zlib.");
   /* Viva graph configuration for uncategorized tracing */
   xbt_cfg_register_string(OPT_VIVA_UNCAT_CONF, "", nullptr, "Viva Graph configuration file for uncategorized resource utilization traces.");
   xbt_cfg_register_string(OPT_VIVA_CAT_CONF, "", nullptr, "Viva Graph configuration file for categorized resource utilization traces.");
@@ -450,6 +466,15 @@ void TRACE_help (int detailed)
       "  By default, each process outputs to a separate file, inside a filename_files folder\n"
       "  By setting this option to yes, all processes will output to only one file\n"
       "  This is meant to avoid opening thousands of files with large simulations", detailed);
+  print_line (OPT_TRACING_FORMAT_TI_BINARY, "Only works for SMPI now, and TI output format",
+      "  By setting this option to yes, the traces are written in a binary format (.bin files)\n"
+      "  that is smaller and much faster to replay. Use the ti2bin tool to convert them from or to text", detailed);
+  print_line (OPT_TRACING_BINARY, "Write the trace in a binary format",
+      "  The Paje events are written in a binary format instead of text, which is much\n"
+      "  smaller and faster to generate. Use the bin2paje tool to convert it to the\n"
+      "  regular Paje format, read by the visualization tools.", detailed);
+  print_line (OPT_TRACING_BINARY_COMPRESS, "Compress the binary trace",
+      "  The binary trace is compressed with zlib (if SimGrid was compiled with it).", detailed);
   print_line (OPT_TRACING_COMMENT, "Comment to be added on the top of the trace file.",
       "  Use this to add a comment line to the top of the trace file.", detailed);
   print_line (OPT_TRACING_COMMENT_FILE, "File contents added to trace file as comment.",
@@ -0,0 +1,553 @@
+/* Copyright (c) 2017. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#include "src/instr/instr_paje_writer.hpp"
+#include "xbt/ex.hpp"
+
+#include <cstring>
+#if HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+XBT_LOG_NEW_DEFAULT_SUBCATEGORY(instr_paje_binary, instr, "Binary Paje traces");
+
+/* Layout of the binary traces:
+ *  - the magic string, the version of the format, a byte of flags (display sizes, call location) and the precision
+ *  - the textual preamble of the Paje trace, terminated by a null byte
+ *  - chunks of events (see PajeOutput::write_chunk()), an event never spanning two chunks.
+ * Each event is a byte (its Paje type, or 31 for the definition of a string, plus 128 when it happens at the same date
+ * as the previous event), the date as a raw double, and its fields in the order of the Paje trace. The doubles are in
+ * the byte order of the machine, the integers are (zigzag) varints, and the other strings are atoms: 0 for none, 2n+2
+ * for the decimal number n, or 2n+1 for the string defined in n-th position.
+ */
+static const char binary_magic[] = "SGPAJEB";
+static const int binary_version  = 1;
+static const int string_definition = 31;
+static const int same_timestamp    = 128;
+static const size_t max_string_length = PajeOutput::buffer_size / 2;
+
+static inline char* put_varint(char* pos, uint64_t value)
+{
+  while (value >= 0x80) {
+    *pos++ = static_cast<char>(value | 0x80);
+    value >>= 7;
+  }
+  *pos++ = static_cast<char>(value);
+  return pos;
+}
+
+static inline char* put_int(char* pos, int value)
+{
+  return put_varint(pos, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(static_cast<int64_t>(value) >> 63));
+}
+
+static inline char* put_double(char* pos, double value)
+{
+  memcpy(pos, &value, sizeof value);
+  return pos + sizeof value;
+}
+
+static inline char* put_string(char* pos, const char* str, size_t len)
+{
+  pos = put_varint(pos, len);
+  memcpy(pos, str, len);
+  return pos + len;
+}
+
+/* Whether str is the decimal representation of a number that fits in 60 bits */
+static inline bool is_decimal(const char* str, uint64_t& value)
+{
+  if (str[0] == '0') {
+    value = 0;
+    return str[1] == '\0';
+  }
+  value = 0;
+  int digits = 0;
+  for (; *str != '\0'; str++, digits++) {
+    if (*str < '0' || *str > '9' || digits == 18)
+      return false;
+    value = value * 10 + (*str - '0');
+  }
+  return digits > 0;
+}
+
+PajeBinaryWriter::PajeBinaryWriter(FILE* file, int precision, bool display_sizes, bool call_location, bool compress)
+    : file_(file), display_sizes_(display_sizes), call_location_(call_location), compress_(compress)
+{
+#if !HAVE_ZLIB
+  if (compress_)
+    XBT_INFO("SimGrid was compiled without zlib: the binary trace is not compressed");
+#endif
+  unsigned char header[] = {binary_version, static_cast<unsigned char>((display_sizes ? 1 : 0) | (call_location ? 2 : 0)),
+                            static_cast<unsigned char>(precision)};
+  fwrite(binary_magic, 1, sizeof binary_magic - 1, file_);
+  fwrite(header, 1, sizeof header, file_);
+}
+
+void PajeBinaryWriter::start()
+{
+  fputc('\0', file_); // end of the preamble
+  stream_.open(file_, 0, true, compress_);
+}
+
+/* The atom of a string, that is defined in the trace on first use if it is not a number */
+uint64_t PajeBinaryWriter::atom(const char* str)
+{
+  if (str == nullptr)
+    return 0;
+  uint64_t value;
+  if (is_decimal(str, value))
+    return 2 * value + 2;
+  auto result = strings_.insert({str, strings_.size()});
+  if (result.second) {
+    size_t len = strlen(str);
+    if (len >= max_string_length)
+      xbt_die("String too long for the binary trace: %.100s...", str);
+    char* pos = stream_.reserve(len + 16);
+    *pos++    = string_definition;
+    stream_.advance(put_string(pos, str, len));
+  }
+  return 2 * result.first->second + 1;
+}
+
+char* PajeBinaryWriter::begin(char* pos, e_event_type event, double timestamp)
+{
+  if (timestamp == last_timestamp_) {
+    *pos++ = static_cast<char>(event | same_timestamp);
+    return pos;
+  }
+  *pos++          = event;
+  last_timestamp_ = timestamp;
+  return put_double(pos, timestamp);
+}
+
+void PajeBinaryWriter::defineContainerType(const char* id, const char* father, const char* name)
+{
+  uint64_t atoms[] = {atom(id), atom(father), atom(name)};
+  char* pos        = stream_.reserve(64);
+  *pos++           = PAJE_DefineContainerType;
+  for (uint64_t a : atoms)
+    pos = put_varint(pos, a);
+  stream_.advance(pos);
+}
+
+void PajeBinaryWriter::defineVariableType(const char* id, const char* father, const char* name, const char* color)
+{
+  uint64_t atoms[] = {atom(id), atom(father), atom(name), atom(color)};
+  char* pos        = stream_.reserve(64);
+  *pos++           = PAJE_DefineVariableType;
+  for (uint64_t a : atoms)
+    pos = put_varint(pos, a);
+  stream_.advance(pos);
+}
+
+void PajeBinaryWriter::defineStateType(const char* id, const char* father, const char* name)
+{
+  uint64_t atoms[] = {atom(id), atom(father), atom(name)};
+  char* pos        = stream_.reserve(64);
+  *pos++           = PAJE_DefineStateType;
+  for (uint64_t a : atoms)
+    pos = put_varint(pos, a);
+  stream_.advance(pos);
+}
+
+void PajeBinaryWriter::defineEventType(const char* id, const char* father, const char* name)
+{
+  uint64_t atoms[] = {atom(id), atom(father), atom(name)};
+  char* pos        = stream_.reserve(64);
+  *pos++           = PAJE_DefineEventType;
+  for (uint64_t a : atoms)
+    pos = put_varint(pos, a);
+  stream_.advance(pos);
+}
+
+void PajeBinaryWriter::defineLinkType(const char* id, const char* father, const char* source, const char* dest,
+                                      const char* name)
+{
+  uint64_t atoms[] = {atom(id), atom(father), atom(source), atom(dest), atom(name)};
+  char* pos        = stream_.reserve(64);
+  *pos++           = PAJE_DefineLinkType;
+  for (uint64_t a : atoms)
+    pos = put_varint(pos, a);
+  stream_.advance(pos);
+}
+
+void PajeBinaryWriter::defineEntityValue(const char* id, const char* father, const char* name, const char* color)
+{
+  uint64_t atoms[] = {atom(id), atom(father), atom(name), atom(color)};
+  char* pos        = stream_.reserve(64);
+  *pos++           = PAJE_DefineEntityValue;
+  for (uint64_t a : atoms)
+    pos = put_varint(pos, a);
+  stream_.advance(pos);
+}
+
+void PajeBinaryWriter::createContainer(double timestamp, const char* id, const char* type, const char* father,
+                                       const char* name)
+{
+  uint64_t atoms[] = {atom(id), atom(type), atom(father), atom(name)};
+  char* pos        = begin(stream_.reserve(64), PAJE_CreateContainer, timestamp);
+  for (uint64_t a : atoms)
+    pos = put_varint(pos, a);
+  stream_.advance(pos);
+}
+
+void PajeBinaryWriter::destroyContainer(double timestamp, const char* type, const char* id)
+{
+  uint64_t atoms[] = {atom(type), atom(id)};
+  char* pos        = begin(stream_.reserve(64), PAJE_DestroyContainer, timestamp);
+  for (uint64_t a : atoms)
+    pos = put_varint(pos, a);
+  stream_.advance(pos);
+}
+
+void PajeBinaryWriter::variable(e_event_type event, double timestamp, const char* type, const char* container,
+                                double value)
+{
+  uint64_t atoms[] = {atom(type), atom(container)};
+  char* pos        = begin(stream_.reserve(64), event, timestamp);
+  for (uint64_t a : atoms)
+    pos = put_varint(pos, a);
+  stream_.advance(put_double(pos, value));
+}
+
+void PajeBinaryWriter::setState(double timestamp, const char* type, const char* container, const char* value,
+                                const char* filename, int linenumber)
+{
+  uint64_t atoms[] = {atom(type), atom(container), atom(value), call_location_ ? atom(filename) : 0};
+  char* pos        = begin(stream_.reserve(64), PAJE_SetState, timestamp);
+  for (uint64_t a : atoms)
+    pos = put_varint(pos, a);
+  if (call_location_)
+    pos = put_int(pos, linenumber);
+  stream_.advance(pos);
+}
+
+void PajeBinaryWriter::pushState(double timestamp, const char* type, const char* container, const char* value,
+                                 int size, const char* filename, int linenumber)
+{
+  uint64_t atoms[] = {atom(type), atom(container), atom(value), call_location_ ? atom(filename) : 0};
+  char* pos        = begin(stream_.reserve(64), PAJE_PushState, timestamp);
+  for (uint64_t a : atoms)
+    pos = put_varint(pos, a);
+  if (display_sizes_)
+    pos = put_int(pos, size);
+  if (call_location_)
+    pos = put_int(pos, linenumber);
+  stream_.advance(pos);
+}
+
+void PajeBinaryWriter::popState(e_event_type event, double timestamp, const char* type, const char* container)
+{
+  uint64_t atoms[] = {atom(type), atom(container)};
+  char* pos        = begin(stream_.reserve(64), event, timestamp);
+  for (uint64_t a : atoms)
+    pos = put_varint(pos, a);
+  stream_.advance(pos);
+}
+
+/* The keys of the links are different for each communication: they are written in place */
+void PajeBinaryWriter::startLink(double timestamp, const char* type, const char* container, const char* value,
+                                 const char* source, const char* key, int size)
+{
+  uint64_t atoms[] = {atom(type), atom(container), atom(value), atom(source)};
+  size_t len       = strlen(key);
+  if (len >= max_string_length)
+    xbt_die("Link key too long for the binary trace: %.100s...", key);
+  char* pos = begin(stream_.reserve(len + 64), PAJE_StartLink, timestamp);
+  for (uint64_t a : atoms)
+    pos = put_varint(pos, a);
+  pos = put_string(pos, key, len);
+  if (display_sizes_)
+    pos = put_int(pos, size);
+  stream_.advance(pos);
+}
+
+void PajeBinaryWriter::endLink(double timestamp, const char* type, const char* container, const char* value,
+                               const char* dest, const char* key)
+{
+  uint64_t atoms[] = {atom(type), atom(container), atom(value), atom(dest)};
+  size_t len       = strlen(key);
+  if (len >= max_string_length)
+    xbt_die("Link key too long for the binary trace: %.100s...", key);
+  char* pos = begin(stream_.reserve(len + 64), PAJE_EndLink, timestamp);
+  for (uint64_t a : atoms)
+    pos = put_varint(pos, a);
+  stream_.advance(put_string(pos, key, len));
+}
+
+void PajeBinaryWriter::newEvent(double timestamp, const char* type, const char* container, const char* value)
+{
+  uint64_t atoms[] = {atom(type), atom(container), atom(value)};
+  char* pos        = begin(stream_.reserve(64), PAJE_NewEvent, timestamp);
+  for (uint64_t a : atoms)
+    pos = put_varint(pos, a);
+  stream_.advance(pos);
+}
+
+namespace {
+/* Decoding of the events of a chunk, for TRACE_binary_to_paje() */
+class ChunkDecoder {
+  const char* pos_;
+  const char* end_;
+  const std::vector<std::string>& strings_;
+  char numbers_[6][24]; // the decimal atoms of the current event
+  int next_number_ = 0;
+
+  void check(size_t size)
+  {
+    if (static_cast<size_t>(end_ - pos_) < size)
+      xbt_die("Truncated event in the binary trace");
+  }
+
+public:
+  ChunkDecoder(const char* data, size_t size, const std::vector<std::string>& strings)
+      : pos_(data), end_(data + size), strings_(strings)
+  {
+  }
+  bool empty() const { return pos_ == end_; }
+  void new_event() { next_number_ = 0; }
+
+  uint64_t varint()
+  {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      check(1);
+      unsigned char byte = *pos_++;
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if (byte < 0x80)
+        return value;
+    }
+    xbt_die("Invalid varint in the binary trace");
+  }
+  int integer()
+  {
+    uint64_t value = varint();
+    return static_cast<int>((value >> 1) ^ -(value & 1));
+  }
+  unsigned char byte()
+  {
+    check(1);
+    return *pos_++;
+  }
+  double real()
+  {
+    double value;
+    check(sizeof value);
+    memcpy(&value, pos_, sizeof value);
+    pos_ += sizeof value;
+    return value;
+  }
+  std::string string()
+  {
+    size_t len = varint();
+    check(len);
+    std::string str(pos_, len);
+    pos_ += len;
+    return str;
+  }
+  const char* atom()
+  {
+    uint64_t value = varint();
+    if (value == 0)
+      return nullptr;
+    if (value & 1) {
+      if ((value >> 1) >= strings_.size())
+        xbt_die("Undefined string in the binary trace");
+      return strings_[value >> 1].c_str();
+    }
+    char* str = numbers_[next_number_++];
+    snprintf(str, sizeof numbers_[0], "%llu", static_cast<unsigned long long>((value >> 1) - 1));
+    return str;
+  }
+};
+}
+
+/* Converts a binary trace written with tracing/binary into the regular Paje format */
+void TRACE_binary_to_paje(const char* input, const char* output)
+{
+  FILE* in = fopen(input, "rb");
+  if (in == nullptr)
+    THROWF(system_error, 1, "Binary trace %s could not be opened for reading.", input);
+  char magic[sizeof binary_magic - 1];
+  unsigned char header[3];
+  bool is_binary = fread(magic, 1, sizeof magic, in) == sizeof magic &&
+                   memcmp(magic, binary_magic, sizeof magic) == 0 && fread(header, 1, sizeof header, in) == sizeof header;
+  if (not is_binary)
+    xbt_die("%s is not a binary trace", input);
+  if (header[0] != binary_version)
+    xbt_die("Unsupported version %d of the binary traces in %s", header[0], input);
+  bool display_sizes = header[1] & 1;
+  bool call_location = header[1] & 2;
+
+  FILE* out = fopen(output, "w");
+  if (out == nullptr)
+    THROWF(system_error, 1, "Tracefile %s could not be opened for writing.", output);
+  int c;
+  while ((c = fgetc(in)) != EOF && c != '\0')
+    fputc(c, out);
+  if (c != '\0')
+    xbt_die("Truncated binary trace %s", input);
+
+  std::unique_ptr<PajeTextWriter> writer(new PajeTextWriter(out, header[2], display_sizes, call_location));
+  writer->start();
+  std::vector<std::string> strings;
+  std::vector<char> stored;
+  std::vector<char> raw;
+  double timestamp = 0;
+  unsigned char chunk[9];
+  size_t read;
+  while ((read = fread(chunk, 1, sizeof chunk, in)) == sizeof chunk) {
+    size_t raw_size    = 0;
+    size_t stored_size = 0;
+    for (int i = 3; i >= 0; i--) {
+      raw_size    = (raw_size << 8) | chunk[1 + i];
+      stored_size = (stored_size << 8) | chunk[5 + i];
+    }
+    stored.resize(stored_size);
+    if (fread(stored.data(), 1, stored_size, in) != stored_size)
+      xbt_die("Truncated binary trace %s", input);
+    const std::vector<char>* data = &stored;
+    if (chunk[0] == 1) {
+#if HAVE_ZLIB
+      raw.resize(raw_size);
+      uLongf length = raw_size;
+      int status = uncompress(reinterpret_cast<Bytef*>(raw.data()), &length,
+                              reinterpret_cast<const Bytef*>(stored.data()), stored_size);
+      if (status != Z_OK || length != raw_size)
+        xbt_die("Corrupted chunk in the binary trace %s", input);
+      data = &raw;
+#else
+      xbt_die("The binary trace %s is compressed, but SimGrid was compiled without zlib", input);
+#endif
+    } else {
+      if (chunk[0] != 0 || raw_size != stored_size)
+        xbt_die("Corrupted chunk in the binary trace %s", input);
+    }
+
+    ChunkDecoder event(data->data(), raw_size, strings);
+    while (not event.empty()) {
+      event.new_event();
+      int tag = event.byte();
+      int type = tag & ~same_timestamp;
+      if (type == string_definition) {
+        strings.push_back(event.string());
+        continue;
+      }
+      if (type >= PAJE_CreateContainer && type <= PAJE_NewEvent && not(tag & same_timestamp))
+        timestamp = event.real();
+      switch (type) {
+        case PAJE_DefineContainerType: {
+          const char* id     = event.atom();
+          const char* father = event.atom();
+          writer->defineContainerType(id, father, event.atom());
+          break;
+        }
+        case PAJE_DefineVariableType: {
+          const char* id     = event.atom();
+          const char* father = event.atom();
+          const char* name   = event.atom();
+          writer->defineVariableType(id, father, name, event.atom());
+          break;
+        }
+        case PAJE_DefineStateType: {
+          const char* id     = event.atom();
+          const char* father = event.atom();
+          writer->defineStateType(id, father, event.atom());
+          break;
+        }
+        case PAJE_DefineEventType: {
+          const char* id     = event.atom();
+          const char* father = event.atom();
+          writer->defineEventType(id, father, event.atom());
+          break;
+        }
+        case PAJE_DefineLinkType: {
+          const char* id     = event.atom();
+          const char* father = event.atom();
+          const char* source = event.atom();
+          const char* dest   = event.atom();
+          writer->defineLinkType(id, father, source, dest, event.atom());
+          break;
+        }
+        case PAJE_DefineEntityValue: {
+          const char* id     = event.atom();
+          const char* father = event.atom();
+          const char* name   = event.atom();
+          writer->defineEntityValue(id, father, name, event.atom());
+          break;
+        }
+        case PAJE_CreateContainer: {
+          const char* id      = event.atom();
+          const char* type_id = event.atom();
+          const char* father  = event.atom();
+          writer->createContainer(timestamp, id, type_id, father, event.atom());
+          break;
+        }
+        case PAJE_DestroyContainer: {
+          const char* type_id = event.atom();
+          writer->destroyContainer(timestamp, type_id, event.atom());
+          break;
+        }
+        case PAJE_SetVariable:
+        case PAJE_AddVariable:
+        case PAJE_SubVariable: {
+          const char* type_id   = event.atom();
+          const char* container = event.atom();
+          writer->variable(static_cast<e_event_type>(type), timestamp, type_id, container, event.real());
+          break;
+        }
+        case PAJE_SetState:
+        case PAJE_PushState: {
+          const char* type_id   = event.atom();
+          const char* container = event.atom();
+          const char* value     = event.atom();
+          const char* filename  = event.atom();
+          int size              = (type == PAJE_PushState && display_sizes) ? event.integer() : 0;
+          int linenumber        = call_location ? event.integer() : 0;
+          if (type == PAJE_SetState)
+            writer->setState(timestamp, type_id, container, value, filename, linenumber);
+          else
+            writer->pushState(timestamp, type_id, container, value, size, filename, linenumber);
+          break;
+        }
+        case PAJE_PopState:
+        case PAJE_ResetState: {
+          const char* type_id = event.atom();
+          writer->popState(static_cast<e_event_type>(type), timestamp, type_id, event.atom());
+          break;
+        }
+        case PAJE_StartLink:
+        case PAJE_EndLink: {
+          const char* type_id   = event.atom();
+          const char* container = event.atom();
+          const char* value     = event.atom();
+          const char* other     = event.atom();
+          std::string key       = event.string();
+          if (type == PAJE_StartLink) {
+            int size = display_sizes ? event.integer() : 0;
+            writer->startLink(timestamp, type_id, container, value, other, key.c_str(), size);
+          } else {
+            writer->endLink(timestamp, type_id, container, value, other, key.c_str());
+          }
+          break;
+        }
+        case PAJE_NewEvent: {
+          const char* type_id   = event.atom();
+          const char* container = event.atom();
+          writer->newEvent(timestamp, type_id, container, event.atom());
+          break;
+        }
+        default:
+          xbt_die("Unknown event %d in the binary trace %s", type, input);
+      }
+    }
+  }
+  if (read != 0)
+    xbt_die("Truncated binary trace %s", input);
+  fclose(in);
+  writer.reset(); // flushes the events
+  fclose(out);
+}
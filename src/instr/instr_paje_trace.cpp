@@ -4,16 +4,18 @@
 /* This program is free software; you can redistribute it and/or modify it
  * under the terms of the license (GNU LGPL) which comes with this package. */
 
+#include "src/instr/instr_paje_writer.hpp"
 #include "src/instr/instr_private.h"
 #include "src/instr/instr_smpi.h"
 #include "src/smpi/private.hpp"
 #include "typeinfo"
+#include "xbt/replay.hpp"
 #include "xbt/virtu.h" /* sg_cmdline */
 #include "simgrid/sg_config.h"
 
-#include <sstream>
+#include <cstdarg>
+#include <deque>
 #include <vector>
-#include <iomanip> /** std::setprecision **/
 #include <sys/stat.h>
 #ifdef WIN32
 #include <direct.h> // _mkdir
@@ -21,20 +23,81 @@
 
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY(instr_paje_trace, instr, "tracing event system");
 
-static std::stringstream stream;
 FILE *tracing_file = nullptr;
 
+/* The backend of the Paje events, that writes them as text or in the binary format */
+static PajeWriter* paje_writer = nullptr;
+
 static xbt_dict_t tracing_files = nullptr; // TI specific
+static simgrid::config::Handle<bool> trace_ti_one_file("tracing/smpi/format/ti-one-file"); // TI specific
+static simgrid::config::Handle<bool> trace_ti_binary("tracing/smpi/format/ti-binary");     // TI specific
+static simgrid::config::Handle<bool> trace_call_location("smpi/trace-call-location");
 static double prefix=0.0; // TI specific
 
+/* Append to a line of TI trace, which is then written as text or encoded in binary */
+static void ti_print(std::string& line, const char* format, ...)
+{
+  char buff[256];
+  va_list ap;
+  va_start(ap, format);
+  int len = vsnprintf(buff, sizeof buff, format, ap);
+  va_end(ap);
+  if (len < static_cast<int>(sizeof buff)) {
+    line.append(buff, len);
+  } else {
+    size_t start = line.size();
+    line.resize(start + len + 1);
+    va_start(ap, format);
+    vsnprintf(&line[start], len + 1, format, ap);
+    va_end(ap);
+    line.resize(start + len);
+  }
+}
+
 
 void print_NULL(PajeEvent* event){}
 
 /* The active set of functions for the selected trace format
  * By default, they all do nothing, hence the print_NULL to avoid segfaults */
 
-std::vector<PajeEvent*> buffer;
-void buffer_debug(std::vector<PajeEvent*> *buf);
+/* The events that are not written yet, sorted by date (tracing/buffer) */
+static std::deque<PajeEvent*> buffer;
+
+/* The events are allocated and freed at a high rate. Their memory is kept in one free list per size (they are all
+ * small), and reused for the next events of the same size. */
+static const size_t event_pool_granularity = 16;
+static std::vector<void*> event_pool[16];
+
+void* PajeEvent::operator new(size_t size)
+{
+  size_t slot = (size + event_pool_granularity - 1) / event_pool_granularity;
+  if (slot >= sizeof event_pool / sizeof event_pool[0])
+    return ::operator new(size);
+  if (event_pool[slot].empty())
+    return ::operator new(slot * event_pool_granularity);
+  void* ptr = event_pool[slot].back();
+  event_pool[slot].pop_back();
+  return ptr;
+}
+
+void PajeEvent::operator delete(void* ptr, size_t size)
+{
+  size_t slot = (size + event_pool_granularity - 1) / event_pool_granularity;
+  if (slot >= sizeof event_pool / sizeof event_pool[0])
+    ::operator delete(ptr);
+  else
+    event_pool[slot].push_back(ptr);
+}
+
+static void free_event_pool()
+{
+  for (auto& list : event_pool) {
+    for (void* ptr : list)
+      ::operator delete(ptr);
+    list.clear();
+    list.shrink_to_fit();
+  }
+}
 
 void dump_comment (const char *comment)
 {
@@ -80,50 +143,15 @@ void TRACE_paje_dump_buffer (int force)
     }
     buffer.clear();
   }else{
-    std::vector<PajeEvent*>::iterator i = buffer.begin();
-    for (auto event :buffer){
-      double head_timestamp = event->timestamp;
-      if (head_timestamp > TRACE_last_timestamp_to_dump)
-        break;
-      event->print();
-      delete event;
-      ++i;
+    while (not buffer.empty() && buffer.front()->timestamp <= TRACE_last_timestamp_to_dump) {
+      buffer.front()->print();
+      delete buffer.front();
+      buffer.pop_front();
     }
-    buffer.erase(buffer.begin(), i);
   }
   XBT_DEBUG("%s: ends", __FUNCTION__);
 }
 
-void buffer_debug(std::vector<PajeEvent*> *buf);
-void buffer_debug(std::vector<PajeEvent*> *buf) {
-  return;
-  XBT_DEBUG(">>>>>> Dump the state of the buffer. %zu events", buf->size());
-  for (auto event :*buf){
-    event->print();
-    XBT_DEBUG("%p %s", event, stream.str().c_str());
-    stream.str("");
-    stream.clear();
-  }
-  XBT_DEBUG("<<<<<<");
-}
-
-static void print_row() {
-  stream << std::endl;
-  fprintf(tracing_file, "%s", stream.str().c_str());
-  XBT_DEBUG("Dump %s", stream.str().c_str());
-  stream.str("");
-  stream.clear();
-}
-
-static void print_timestamp(PajeEvent* event) {
-  stream << " ";
-  /* prevent 0.0000 in the trace - this was the behavior before the transition to c++ */
-  if (event->timestamp < 1e-12)
-    stream << 0;
-  else
-    stream << event->timestamp;
-}
-
 /* internal do the instrumentation module */
 static void insert_into_buffer (PajeEvent* tbi)
 {
@@ -132,11 +160,9 @@ static void insert_into_buffer (PajeEvent* tbi)
     delete tbi;
     return;
   }
-  buffer_debug(&buffer);
-
   XBT_DEBUG("%s: insert event_type=%d, timestamp=%f, buffersize=%zu)",
       __FUNCTION__, (int)tbi->event_type, tbi->timestamp, buffer.size());
-  std::vector<PajeEvent*>::reverse_iterator i;
+  std::deque<PajeEvent*>::reverse_iterator i;
   for (i = buffer.rbegin(); i != buffer.rend(); ++i) {
     PajeEvent* e1 = *i;
     XBT_DEBUG("compare to %p is of type %d; timestamp:%f", e1,
@@ -152,8 +178,6 @@ static void insert_into_buffer (PajeEvent* tbi)
     XBT_DEBUG("%s: inserted at pos= %zd from its end", __FUNCTION__,
         std::distance(buffer.rbegin(),i));
   buffer.insert(i.base(), tbi);
-
-  buffer_debug(&buffer);
 }
 
 PajeEvent:: ~PajeEvent()
@@ -178,13 +202,23 @@ PajeEvent:: ~PajeEvent()
 
 void TRACE_paje_start() {
   char *filename = TRACE_get_filename();
-  tracing_file = fopen(filename, "w");
+  tracing_file = fopen(filename, TRACE_binary() ? "wb" : "w");
   if (tracing_file == nullptr){
     THROWF (system_error, 1, "Tracefile %s could not be opened for writing.", filename);
   }
 
   XBT_DEBUG("Filename %s is open for writing", filename);
 
+  bool call_location = false;
+#if HAVE_SMPI
+  call_location = trace_call_location.get();
+#endif
+  if (TRACE_binary())
+    paje_writer = new PajeBinaryWriter(tracing_file, TRACE_precision(), TRACE_display_sizes(), call_location,
+                                       TRACE_binary_compress());
+  else
+    paje_writer = new PajeTextWriter(tracing_file, TRACE_precision(), TRACE_display_sizes(), call_location);
+
   /* output generator version */
   fprintf (tracing_file, "#This file was generated using SimGrid-%d.%d.%d\n",
            SIMGRID_VERSION_MAJOR, SIMGRID_VERSION_MINOR, SIMGRID_VERSION_PATCH);
@@ -204,9 +238,15 @@ void TRACE_paje_start() {
 
   /* output header */
   TRACE_header(TRACE_basic(),TRACE_display_sizes());
+
+  /* the events are written by the output thread from now on */
+  paje_writer->start();
 }
 
 void TRACE_paje_end() {
+  delete paje_writer;
+  paje_writer = nullptr;
+  free_event_pool();
   fclose(tracing_file);
   char *filename = TRACE_get_filename();
   XBT_DEBUG("Filename %s is closed", filename);
@@ -218,10 +258,7 @@ void DefineContainerEvent(type_t type)
   //print it
   if (instr_fmt_type == instr_fmt_paje) {
     XBT_DEBUG("%s: event_type=%d, timestamp=%.*f", __FUNCTION__, PAJE_DefineContainerType, TRACE_precision(), 0.);
-    stream << std::fixed << std::setprecision(TRACE_precision());
-    stream << PAJE_DefineContainerType;
-    stream << " " << type->id << " " << type->father->id << " " << type->name;
-    print_row();
+    paje_writer->defineContainerType(type->id, type->father->id, type->name);
   } else if (instr_fmt_type == instr_fmt_TI) {
     /* Nothing to do */
   } else {
@@ -240,12 +277,7 @@ void LogVariableTypeDefinition(type_t type)
   //print it
 if (instr_fmt_type == instr_fmt_paje) {
     XBT_DEBUG("%s: event_type=%d, timestamp=%.*f", __FUNCTION__, PAJE_DefineVariableType, TRACE_precision(), 0.);
-    stream << std::fixed << std::setprecision(TRACE_precision());
-    stream << PAJE_DefineVariableType;
-    stream << " " << type->id << " " << type->father->id << " " << type->name;
-    if (type->color)
-      stream << " \"" << type->color << "\"";
-    print_row();
+    paje_writer->defineVariableType(type->id, type->father->id, type->name, type->color);
   } else if (instr_fmt_type == instr_fmt_TI) {
     /* Nothing to do */
   } else {
@@ -259,10 +291,7 @@ void LogStateTypeDefinition(type_t type)
   //print it
 if (instr_fmt_type == instr_fmt_paje) {
     XBT_DEBUG("%s: event_type=%d, timestamp=%.*f", __FUNCTION__, PAJE_DefineStateType, TRACE_precision(), 0.);
-    stream << std::fixed << std::setprecision(TRACE_precision());
-    stream << PAJE_DefineStateType;
-    stream << " " << type->id << " " << type->father->id << " " << type->name;
-    print_row();
+    paje_writer->defineStateType(type->id, type->father->id, type->name);
   } else if (instr_fmt_type == instr_fmt_TI) {
     /* Nothing to do */
   } else {
@@ -276,10 +305,7 @@ void LogDefineEventType(type_t type)
   //print it
   if (instr_fmt_type == instr_fmt_paje) {
     XBT_DEBUG("%s: event_type=%d, timestamp=%.*f", __FUNCTION__, PAJE_DefineEventType, TRACE_precision(), 0.);
-    stream << std::fixed << std::setprecision(TRACE_precision());
-    stream << PAJE_DefineEventType;
-    stream << " " << type->id << " " << type->father->id << " " << type->name;
-    print_row();
+    paje_writer->defineEventType(type->id, type->father->id, type->name);
   } else if (instr_fmt_type == instr_fmt_TI) {
     /* Nothing to do */
   } else {
@@ -293,10 +319,7 @@ void LogLinkTypeDefinition(type_t type, type_t source, type_t dest)
   //print it
 if (instr_fmt_type == instr_fmt_paje) {
     XBT_DEBUG("%s: event_type=%d, timestamp=%.*f", __FUNCTION__, PAJE_DefineLinkType, TRACE_precision(), 0.);
-    stream << std::fixed << std::setprecision(TRACE_precision());
-    stream << PAJE_DefineLinkType;
-    stream << " " << type->id << " " << type->father->id << " " << source->id << " " << dest->id << " " << type->name;
-    print_row();
+    paje_writer->defineLinkType(type->id, type->father->id, source->id, dest->id, type->name);
   } else if (instr_fmt_type == instr_fmt_TI) {
     /* Nothing to do */
   } else {
@@ -309,12 +332,7 @@ void LogEntityValue (val_t value)
   XBT_DEBUG("%s: event_type=%d", __FUNCTION__, PAJE_DefineEntityValue);
   //print it
 if (instr_fmt_type == instr_fmt_paje) {
-    stream << std::fixed << std::setprecision(TRACE_precision());
-    stream << PAJE_DefineEntityValue;
-    stream << " " << value->id << " " << value->father->id << " " << value->name;
-    if (value->color)
-      stream << " \"" << value->color << "\"";
-    print_row();
+    paje_writer->defineEntityValue(value->id, value->father->id, value->name, value->color);
   } else if (instr_fmt_type == instr_fmt_TI) {
     /* Nothing to do */
   } else {
@@ -330,21 +348,11 @@ void LogContainerCreation (container_t container)
   XBT_DEBUG("%s: event_type=%d, timestamp=%f", __FUNCTION__, PAJE_CreateContainer,timestamp);
 
 if (instr_fmt_type == instr_fmt_paje) {
-    stream << std::fixed << std::setprecision(TRACE_precision());
-    stream << PAJE_CreateContainer;
-    stream << " ";
-  /* prevent 0.0000 in the trace - this was the behavior before the transition to c++ */
-    if (timestamp < 1e-12)
-      stream << 0;
-    else
-      stream << timestamp;
-    stream << " " << container->id << " " << container->type->id << " " << container->father->id << " \""
-           << container->name << "\"";
-
-    print_row();
+    paje_writer->createContainer(timestamp, container->id, container->type->id, container->father->id,
+                                 container->name);
   } else if (instr_fmt_type == instr_fmt_TI) {
     // if we are in the mode with only one file
-    static FILE* ti_unique_file = nullptr;
+    static void* ti_unique_file = nullptr; // a FILE*, or a ReplayBinaryWriter* in binary mode
 
     if (tracing_files == nullptr) {
       tracing_files = xbt_dict_new_homogeneous(nullptr);
@@ -352,23 +360,28 @@ if (instr_fmt_type == instr_fmt_paje) {
       prefix = xbt_os_time();
     }
 
-    if (not xbt_cfg_get_boolean("tracing/smpi/format/ti-one-file") || ti_unique_file == nullptr) {
+    if (not trace_ti_one_file.get() || ti_unique_file == nullptr) {
       char* folder_name = bprintf("%s_files", TRACE_get_filename());
-      char* filename    = bprintf("%s/%f_%s.txt", folder_name, prefix, container->name);
+      char* filename    = bprintf("%s/%f_%s.%s", folder_name, prefix, container->name,
+                               trace_ti_binary.get() ? "bin" : "txt");
 #ifdef WIN32
       _mkdir(folder_name);
 #else
       mkdir(folder_name, S_IRWXU | S_IRWXG | S_IRWXO);
 #endif
-      ti_unique_file = fopen(filename, "w");
-      xbt_assert(ti_unique_file, "Tracefile %s could not be opened for writing: %s", filename, strerror(errno));
+      if (trace_ti_binary.get()) {
+        ti_unique_file = new simgrid::xbt::ReplayBinaryWriter(filename);
+      } else {
+        ti_unique_file = fopen(filename, "w");
+        xbt_assert(ti_unique_file, "Tracefile %s could not be opened for writing: %s", filename, strerror(errno));
+      }
       fprintf(tracing_file, "%s\n", filename);
 
       xbt_free(folder_name);
       xbt_free(filename);
     }
 
-    xbt_dict_set(tracing_files, container->name, (void*)ti_unique_file, nullptr);
+    xbt_dict_set(tracing_files, container->name, ti_unique_file, nullptr);
   } else {
     THROW_IMPOSSIBLE;
   }
@@ -381,20 +394,14 @@ void LogContainerDestruction(container_t container)
   XBT_DEBUG("%s: event_type=%d, timestamp=%f", __FUNCTION__, PAJE_DestroyContainer, timestamp);
 
 if (instr_fmt_type == instr_fmt_paje) {
-    stream << std::fixed << std::setprecision(TRACE_precision());
-    stream << PAJE_DestroyContainer;
-    stream << " ";
-  /* prevent 0.0000 in the trace - this was the behavior before the transition to c++ */
-    if (timestamp < 1e-12)
-        stream << 0;
-    else
-      stream << timestamp;
-    stream << " " << container->type->id << " " << container->id;
-    print_row();
+    paje_writer->destroyContainer(timestamp, container->type->id, container->id);
   } else if (instr_fmt_type == instr_fmt_TI) {
-    if (not xbt_cfg_get_boolean("tracing/smpi/format/ti-one-file") || xbt_dict_length(tracing_files) == 1) {
-      FILE* f = (FILE*)xbt_dict_get_or_null(tracing_files, container->name);
-      fclose(f);
+    if (not trace_ti_one_file.get() || xbt_dict_length(tracing_files) == 1) {
+      void* f = xbt_dict_get_or_null(tracing_files, container->name);
+      if (trace_ti_binary.get())
+        delete static_cast<simgrid::xbt::ReplayBinaryWriter*>(f);
+      else
+        fclose(static_cast<FILE*>(f));
     }
     xbt_dict_remove(tracing_files, container->name);
         } else {
@@ -419,11 +426,7 @@ SetVariableEvent::SetVariableEvent (double timestamp, container_t container, typ
 void SetVariableEvent::print() {
   if (instr_fmt_type == instr_fmt_paje) {
     XBT_DEBUG("%s: event_type=%d, timestamp=%.*f", __FUNCTION__, (int)event_type, TRACE_precision(), timestamp);
-    stream << std::fixed << std::setprecision(TRACE_precision());
-    stream << (int)this->event_type;
-    print_timestamp(this);
-    stream << " " << type->id << " " << container->id << " " << value;
-    print_row();
+    paje_writer->variable(event_type, timestamp, type->id, container->id, value);
   } else if (instr_fmt_type == instr_fmt_TI) {
     /* Nothing to do */
   } else {
@@ -447,11 +450,7 @@ AddVariableEvent::AddVariableEvent (double timestamp, container_t container, typ
 void AddVariableEvent::print() {
   if (instr_fmt_type == instr_fmt_paje) {
     XBT_DEBUG("%s: event_type=%d, timestamp=%.*f", __FUNCTION__, (int)event_type, TRACE_precision(), timestamp);
-    stream << std::fixed << std::setprecision(TRACE_precision());
-    stream << (int)this->event_type;
-    print_timestamp(this);
-    stream << " " << type->id << " " << container->id << " " << value;
-    print_row();
+    paje_writer->variable(event_type, timestamp, type->id, container->id, value);
   } else if (instr_fmt_type == instr_fmt_TI) {
     /* Nothing to do */
   } else {
@@ -475,11 +474,7 @@ SubVariableEvent::SubVariableEvent (double timestamp, container_t container, typ
 void SubVariableEvent::print() {
   if (instr_fmt_type == instr_fmt_paje) {
     XBT_DEBUG("%s: event_type=%d, timestamp=%.*f", __FUNCTION__, (int)event_type, TRACE_precision(), timestamp);
-    stream << std::fixed << std::setprecision(TRACE_precision());
-    stream << (int)this->event_type;
-    print_timestamp(this);
-    stream << " " << type->id << " " << container->id << " " << value;
-    print_row();
+    paje_writer->variable(event_type, timestamp, type->id, container->id, value);
   } else if (instr_fmt_type == instr_fmt_TI) {
     /* Nothing to do */
   } else {
@@ -494,9 +489,11 @@ SetStateEvent::SetStateEvent (double timestamp, container_t container, type_t ty
   this->type      = type;
   this->container = container;
   this->value     = value;
+  filename        = nullptr;
+  linenumber      = 0;
 
 #if HAVE_SMPI
-  if (xbt_cfg_get_boolean("smpi/trace-call-location")) {
+  if (trace_call_location.get()) {
     smpi_trace_call_location_t* loc = smpi_trace_get_call_location();
     filename   = loc->filename;
     linenumber = loc->linenumber;
@@ -511,17 +508,7 @@ SetStateEvent::SetStateEvent (double timestamp, container_t container, type_t ty
 void SetStateEvent::print() {
   if (instr_fmt_type == instr_fmt_paje) {
     XBT_DEBUG("%s: event_type=%d, timestamp=%.*f", __FUNCTION__, (int)event_type, TRACE_precision(), timestamp);
-    stream << std::fixed << std::setprecision(TRACE_precision());
-    stream << (int)this->event_type;
-    print_timestamp(this);
-    stream << " " << type->id << " " << container->id;
-    stream << " " << value->id;
-#if HAVE_SMPI
-    if (xbt_cfg_get_boolean("smpi/trace-call-location")) {
-      stream << " \"" << filename << "\" " << linenumber;
-    }
-#endif
-    print_row();
+    paje_writer->setState(timestamp, type->id, container->id, value->id, filename, linenumber);
   } else if (instr_fmt_type == instr_fmt_TI) {
     /* Nothing to do */
   } else {
@@ -537,9 +524,11 @@ PushStateEvent::PushStateEvent (double timestamp, container_t container, type_t
   this->container = container;
   this->value     = value;
   this->extra_     = extra;
+  filename         = nullptr;
+  linenumber       = 0;
 
 #if HAVE_SMPI
-  if (xbt_cfg_get_boolean("smpi/trace-call-location")) {
+  if (trace_call_location.get()) {
     smpi_trace_call_location_t* loc = smpi_trace_get_call_location();
     filename   = loc->filename;
     linenumber = loc->linenumber;
@@ -557,26 +546,8 @@ PushStateEvent::PushStateEvent (double timestamp, container_t container, type_t
 void PushStateEvent::print() {
   if (instr_fmt_type == instr_fmt_paje) {
     XBT_DEBUG("%s: event_type=%d, timestamp=%.*f", __FUNCTION__, (int)event_type, TRACE_precision(), timestamp);
-    stream << std::fixed << std::setprecision(TRACE_precision());
-    stream << (int)this->event_type;
-    print_timestamp(this);
-    stream << " " << type->id << " " << container->id;
-    stream << " " << value->id;
-
-    if (TRACE_display_sizes()) {
-      stream << " ";
-      if (extra_ != nullptr) {
-        stream << static_cast<instr_extra_data>(extra_)->send_size;
-      } else {
-        stream << 0;
-      }
-    }
-#if HAVE_SMPI
-    if (xbt_cfg_get_boolean("smpi/trace-call-location")) {
-      stream << " \"" << filename << "\" " << linenumber;
-    }
-#endif
-    print_row();
+    int size = extra_ != nullptr ? static_cast<instr_extra_data>(extra_)->send_size : 0;
+    paje_writer->pushState(timestamp, type->id, container->id, value->id, size, filename, linenumber);
 
     if (extra_ != nullptr) {
       if (static_cast<instr_extra_data>(extra_)->sendcounts != nullptr)
@@ -597,95 +568,95 @@ void PushStateEvent::print() {
     else
       process_id = xbt_strdup(container->name + 5);
 
-    FILE* trace_file = (FILE*)xbt_dict_get(tracing_files, container->name);
+    std::string line;
 
     switch (extra->type) {
       case TRACING_INIT:
-        fprintf(trace_file, "%s init\n", process_id);
+        ti_print(line, "%s init\n", process_id);
         break;
       case TRACING_FINALIZE:
-        fprintf(trace_file, "%s finalize\n", process_id);
+        ti_print(line, "%s finalize\n", process_id);
         break;
       case TRACING_SEND:
-        fprintf(trace_file, "%s send %d %d %s\n", process_id, extra->dst, extra->send_size, extra->datatype1);
+        ti_print(line, "%s send %d %d %s\n", process_id, extra->dst, extra->send_size, extra->datatype1);
         break;
       case TRACING_ISEND:
-        fprintf(trace_file, "%s Isend %d %d %s\n", process_id, extra->dst, extra->send_size, extra->datatype1);
+        ti_print(line, "%s Isend %d %d %s\n", process_id, extra->dst, extra->send_size, extra->datatype1);
         break;
       case TRACING_RECV:
-        fprintf(trace_file, "%s recv %d %d %s\n", process_id, extra->src, extra->send_size, extra->datatype1);
+        ti_print(line, "%s recv %d %d %s\n", process_id, extra->src, extra->send_size, extra->datatype1);
         break;
       case TRACING_IRECV:
-        fprintf(trace_file, "%s Irecv %d %d %s\n", process_id, extra->src, extra->send_size, extra->datatype1);
+        ti_print(line, "%s Irecv %d %d %s\n", process_id, extra->src, extra->send_size, extra->datatype1);
         break;
       case TRACING_TEST:
-        fprintf(trace_file, "%s test\n", process_id);
+        ti_print(line, "%s test\n", process_id);
         break;
       case TRACING_WAIT:
-        fprintf(trace_file, "%s wait\n", process_id);
+        ti_print(line, "%s wait\n", process_id);
         break;
       case TRACING_WAITALL:
-        fprintf(trace_file, "%s waitAll\n", process_id);
+        ti_print(line, "%s waitAll\n", process_id);
         break;
       case TRACING_BARRIER:
-        fprintf(trace_file, "%s barrier\n", process_id);
+        ti_print(line, "%s barrier\n", process_id);
         break;
       case TRACING_BCAST: // rank bcast size (root) (datatype)
-        fprintf(trace_file, "%s bcast %d ", process_id, extra->send_size);
+        ti_print(line, "%s bcast %d ", process_id, extra->send_size);
         if (extra->root != 0 || (extra->datatype1 && strcmp(extra->datatype1, "")))
-          fprintf(trace_file, "%d %s", extra->root, extra->datatype1);
-        fprintf(trace_file, "\n");
+          ti_print(line, "%d %s", extra->root, extra->datatype1);
+        ti_print(line, "\n");
         break;
       case TRACING_REDUCE: // rank reduce comm_size comp_size (root) (datatype)
-        fprintf(trace_file, "%s reduce %d %f ", process_id, extra->send_size, extra->comp_size);
+        ti_print(line, "%s reduce %d %f ", process_id, extra->send_size, extra->comp_size);
         if (extra->root != 0 || (extra->datatype1 && strcmp(extra->datatype1, "")))
-          fprintf(trace_file, "%d %s", extra->root, extra->datatype1);
-        fprintf(trace_file, "\n");
+          ti_print(line, "%d %s", extra->root, extra->datatype1);
+        ti_print(line, "\n");
         break;
       case TRACING_ALLREDUCE: // rank allreduce comm_size comp_size (datatype)
-        fprintf(trace_file, "%s allReduce %d %f %s\n", process_id, extra->send_size, extra->comp_size,
+        ti_print(line, "%s allReduce %d %f %s\n", process_id, extra->send_size, extra->comp_size,
                 extra->datatype1);
         break;
       case TRACING_ALLTOALL: // rank alltoall send_size recv_size (sendtype) (recvtype)
-        fprintf(trace_file, "%s allToAll %d %d %s %s\n", process_id, extra->send_size, extra->recv_size,
+        ti_print(line, "%s allToAll %d %d %s %s\n", process_id, extra->send_size, extra->recv_size,
                 extra->datatype1, extra->datatype2);
         break;
       case TRACING_ALLTOALLV: // rank alltoallv send_size [sendcounts] recv_size [recvcounts] (sendtype) (recvtype)
-        fprintf(trace_file, "%s allToAllV %d ", process_id, extra->send_size);
+        ti_print(line, "%s allToAllV %d ", process_id, extra->send_size);
         for (int i = 0; i < extra->num_processes; i++)
-          fprintf(trace_file, "%d ", extra->sendcounts[i]);
-        fprintf(trace_file, "%d ", extra->recv_size);
+          ti_print(line, "%d ", extra->sendcounts[i]);
+        ti_print(line, "%d ", extra->recv_size);
         for (int i = 0; i < extra->num_processes; i++)
-          fprintf(trace_file, "%d ", extra->recvcounts[i]);
-        fprintf(trace_file, "%s %s \n", extra->datatype1, extra->datatype2);
+          ti_print(line, "%d ", extra->recvcounts[i]);
+        ti_print(line, "%s %s \n", extra->datatype1, extra->datatype2);
         break;
       case TRACING_GATHER: // rank gather send_size recv_size root (sendtype) (recvtype)
-        fprintf(trace_file, "%s gather %d %d %d %s %s\n", process_id, extra->send_size, extra->recv_size, extra->root,
+        ti_print(line, "%s gather %d %d %d %s %s\n", process_id, extra->send_size, extra->recv_size, extra->root,
                 extra->datatype1, extra->datatype2);
         break;
       case TRACING_ALLGATHERV: // rank allgatherv send_size [recvcounts] (sendtype) (recvtype)
-        fprintf(trace_file, "%s allGatherV %d ", process_id, extra->send_size);
+        ti_print(line, "%s allGatherV %d ", process_id, extra->send_size);
         for (int i = 0; i < extra->num_processes; i++)
-          fprintf(trace_file, "%d ", extra->recvcounts[i]);
-        fprintf(trace_file, "%s %s \n", extra->datatype1, extra->datatype2);
+          ti_print(line, "%d ", extra->recvcounts[i]);
+        ti_print(line, "%s %s \n", extra->datatype1, extra->datatype2);
         break;
       case TRACING_REDUCE_SCATTER: // rank reducescatter [recvcounts] comp_size (sendtype)
-        fprintf(trace_file, "%s reduceScatter ", process_id);
+        ti_print(line, "%s reduceScatter ", process_id);
         for (int i = 0; i < extra->num_processes; i++)
-          fprintf(trace_file, "%d ", extra->recvcounts[i]);
-        fprintf(trace_file, "%f %s\n", extra->comp_size, extra->datatype1);
+          ti_print(line, "%d ", extra->recvcounts[i]);
+        ti_print(line, "%f %s\n", extra->comp_size, extra->datatype1);
         break;
       case TRACING_COMPUTING:
-        fprintf(trace_file, "%s compute %f\n", process_id, extra->comp_size);
+        ti_print(line, "%s compute %f\n", process_id, extra->comp_size);
         break;
       case TRACING_SLEEPING:
-        fprintf(trace_file, "%s sleep %f\n", process_id, extra->sleep_duration);
+        ti_print(line, "%s sleep %f\n", process_id, extra->sleep_duration);
         break;
       case TRACING_GATHERV: // rank gatherv send_size [recvcounts] root (sendtype) (recvtype)
-        fprintf(trace_file, "%s gatherV %d ", process_id, extra->send_size);
+        ti_print(line, "%s gatherV %d ", process_id, extra->send_size);
         for (int i = 0; i < extra->num_processes; i++)
-          fprintf(trace_file, "%d ", extra->recvcounts[i]);
-        fprintf(trace_file, "%d %s %s\n", extra->root, extra->datatype1, extra->datatype2);
+          ti_print(line, "%d ", extra->recvcounts[i]);
+        ti_print(line, "%d %s %s\n", extra->root, extra->datatype1, extra->datatype2);
         break;
       case TRACING_WAITANY:
       case TRACING_SENDRECV:
@@ -704,6 +675,14 @@ void PushStateEvent::print() {
         break;
     }
 
+    if (not line.empty()) {
+      void* trace_file = xbt_dict_get(tracing_files, container->name);
+      if (trace_ti_binary.get())
+        static_cast<simgrid::xbt::ReplayBinaryWriter*>(trace_file)->write_line(line.c_str());
+      else
+        fputs(line.c_str(), static_cast<FILE*>(trace_file));
+    }
+
     if (extra->recvcounts != nullptr)
       xbt_free(extra->recvcounts);
     if (extra->sendcounts != nullptr)
@@ -732,11 +711,7 @@ PopStateEvent::PopStateEvent (double timestamp, container_t container, type_t ty
 void PopStateEvent::print() {
   if (instr_fmt_type == instr_fmt_paje) {
     XBT_DEBUG("%s: event_type=%d, timestamp=%.*f", __FUNCTION__, (int)event_type, TRACE_precision(), timestamp);
-    stream << std::fixed << std::setprecision(TRACE_precision());
-    stream << (int)this->event_type;
-    print_timestamp(this);
-    stream << " " << type->id << " " << container->id;
-    print_row();
+    paje_writer->popState(event_type, timestamp, type->id, container->id);
   } else if (instr_fmt_type == instr_fmt_TI) {
     /* Nothing to do */
   } else {
@@ -754,17 +729,12 @@ ResetStateEvent::ResetStateEvent (double timestamp, container_t container, type_
   XBT_DEBUG("%s: event_type=%d, timestamp=%f", __FUNCTION__, (int)event_type, this->timestamp);
 
   insert_into_buffer (this);
-  delete[] this;
 }
 
 void ResetStateEvent::print() {
   if (instr_fmt_type == instr_fmt_paje) {
     XBT_DEBUG("%s: event_type=%d, timestamp=%.*f", __FUNCTION__, (int)event_type, TRACE_precision(), timestamp);
-    stream << std::fixed << std::setprecision(TRACE_precision());
-    stream << (int)this->event_type;
-    print_timestamp(this);
-    stream << " " << type->id << " " << container->id;
-    print_row();
+    paje_writer->popState(event_type, timestamp, type->id, container->id);
   } else if (instr_fmt_type == instr_fmt_TI) {
     /* Nothing to do */
   } else {
@@ -803,16 +773,7 @@ StartLinkEvent::StartLinkEvent (double timestamp, container_t container, type_t
 void StartLinkEvent::print() {
   if (instr_fmt_type == instr_fmt_paje) {
     XBT_DEBUG("%s: event_type=%d, timestamp=%.*f", __FUNCTION__, (int)event_type, TRACE_precision(), timestamp);
-    stream << std::fixed << std::setprecision(TRACE_precision());
-    stream << (int)this->event_type;
-    print_timestamp(this);
-    stream << " " << type->id << " " << container->id << " " << value;
-    stream << " " << sourceContainer->id << " " << key;
-
-    if (TRACE_display_sizes()) {
-      stream << " " << size;
-    }
-    print_row();
+    paje_writer->startLink(timestamp, type->id, container->id, value, sourceContainer->id, key, size);
   } else if (instr_fmt_type == instr_fmt_TI) {
     /* Nothing to do */
   } else {
@@ -844,12 +805,7 @@ EndLinkEvent::~EndLinkEvent()
 void EndLinkEvent::print() {
   if (instr_fmt_type == instr_fmt_paje) {
     XBT_DEBUG("%s: event_type=%d, timestamp=%.*f", __FUNCTION__, (int)event_type, TRACE_precision(), timestamp);
-    stream << std::fixed << std::setprecision(TRACE_precision());
-    stream << (int)this->event_type;
-    print_timestamp(this);
-    stream << " " << type->id << " " << container->id << " " << value;
-    stream << " " << destContainer->id << " " << key;
-    print_row();
+    paje_writer->endLink(timestamp, type->id, container->id, value, destContainer->id, key);
   } else if (instr_fmt_type == instr_fmt_TI) {
     /* Nothing to do */
   } else {
@@ -873,11 +829,7 @@ NewEvent::NewEvent (double timestamp, container_t container, type_t type, val_t
 void NewEvent::print () {
   if (instr_fmt_type == instr_fmt_paje) {
     XBT_DEBUG("%s: event_type=%d, timestamp=%.*f", __FUNCTION__, (int)event_type, TRACE_precision(), timestamp);
-    stream << std::fixed << std::setprecision(TRACE_precision());
-    stream << (int)this->event_type;
-    print_timestamp(this);
-    stream << " " << type->id << " " << container->id << " " << value->id;
-    print_row();
+    paje_writer->newEvent(timestamp, type->id, container->id, value->id);
   } else if (instr_fmt_type == instr_fmt_TI) {
     /* Nothing to do */
   } else {
@@ -905,6 +857,7 @@ void TRACE_TI_start()
 void TRACE_TI_end()
 {
   xbt_dict_free(&tracing_files);
+  free_event_pool();
   fclose(tracing_file);
   char *filename = TRACE_get_filename();
   XBT_DEBUG("Filename %s is closed", filename);
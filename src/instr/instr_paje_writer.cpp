@@ -0,0 +1,355 @@
+/* Copyright (c) 2010-2017. The SimGrid Team. All rights reserved.          */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#include "src/instr/instr_paje_writer.hpp"
+
+#include <cmath>
+#include <cstring>
+#if HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+void PajeOutput::open(FILE* file, int precision, bool chunked, bool compress)
+{
+  file_      = file;
+  precision_ = precision;
+  chunked_   = chunked;
+  compress_  = compress;
+  for (auto& buffer : buffers_)
+    if (not buffer)
+      buffer.reset(new char[buffer_size]);
+  current_  = handed_.load();
+  pos_      = buffers_[current_ % nb_buffers].get();
+  end_      = pos_ + buffer_size;
+  stopping_ = false;
+  writer_   = std::thread(&PajeOutput::write_buffers, this);
+}
+
+void PajeOutput::close()
+{
+  if (file_ == nullptr)
+    return;
+  hand_over();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  cond_.notify_all();
+  writer_.join();
+  fflush(file_);
+  file_ = nullptr;
+  pos_  = nullptr;
+  end_  = nullptr;
+}
+
+/* Give the current buffer to the writer thread, and wait for the next one to be free */
+void PajeOutput::hand_over()
+{
+  char* buffer = buffers_[current_ % nb_buffers].get();
+  if (pos_ != buffer) {
+    sizes_[current_ % nb_buffers] = pos_ - buffer;
+    current_++;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      handed_.store(current_, std::memory_order_release);
+    }
+    cond_.notify_all();
+    if (current_ - written_.load(std::memory_order_acquire) >= nb_buffers) {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cond_.wait(lock, [this]() { return current_ - written_.load() < nb_buffers; });
+    }
+  }
+  pos_ = buffers_[current_ % nb_buffers].get();
+  end_ = pos_ + buffer_size;
+}
+
+void PajeOutput::write_buffers()
+{
+  std::vector<unsigned char> compressed;
+  unsigned next = written_.load();
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cond_.wait(lock, [this, next]() { return stopping_ || handed_.load() != next; });
+      if (handed_.load() == next) // stopping, and everything was written
+        return;
+    }
+    while (next != handed_.load(std::memory_order_acquire)) {
+      if (chunked_)
+        write_chunk(buffers_[next % nb_buffers].get(), sizes_[next % nb_buffers], compressed);
+      else
+        fwrite(buffers_[next % nb_buffers].get(), 1, sizes_[next % nb_buffers], file_);
+      next++;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        written_.store(next, std::memory_order_release);
+      }
+      cond_.notify_all();
+    }
+  }
+}
+
+/* A chunk is a byte telling whether it is compressed, its size once uncompressed and its size in the file (32 bits,
+ * little endian), and its content */
+void PajeOutput::write_chunk(const char* data, size_t size, std::vector<unsigned char>& compressed)
+{
+  unsigned char header[9];
+  size_t stored = size;
+  header[0]     = 0;
+#if HAVE_ZLIB
+  if (compress_) {
+    uLongf length = compressBound(size);
+    compressed.resize(length);
+    if (compress2(compressed.data(), &length, reinterpret_cast<const Bytef*>(data), size, Z_BEST_SPEED) == Z_OK &&
+        length < size) {
+      header[0] = 1;
+      stored    = length;
+      data      = reinterpret_cast<const char*>(compressed.data());
+    }
+  }
+#endif
+  for (int i = 0; i < 4; i++) {
+    header[1 + i] = (size >> (8 * i)) & 0xff;
+    header[5 + i] = (stored >> (8 * i)) & 0xff;
+  }
+  fwrite(header, 1, sizeof header, file_);
+  fwrite(data, 1, stored, file_);
+}
+
+PajeOutput& PajeOutput::operator<<(const char* str)
+{
+  size_t len = strlen(str);
+  while (len > static_cast<size_t>(end_ - pos_)) {
+    size_t part = end_ - pos_;
+    memcpy(pos_, str, part);
+    pos_ += part;
+    str += part;
+    len -= part;
+    hand_over();
+  }
+  memcpy(pos_, str, len);
+  pos_ += len;
+  return *this;
+}
+
+PajeOutput& PajeOutput::operator<<(int value)
+{
+  reserve(12);
+  unsigned magnitude = value < 0 ? -static_cast<unsigned>(value) : value;
+  if (value < 0)
+    *pos_++ = '-';
+  char digits[10];
+  int n = 0;
+  do {
+    digits[n++] = '0' + magnitude % 10;
+    magnitude /= 10;
+  } while (magnitude > 0);
+  while (n > 0)
+    *pos_++ = digits[--n];
+  return *this;
+}
+
+PajeOutput& PajeOutput::operator<<(double value)
+{
+  static const double powers[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15};
+  static const uint64_t ipowers[] = {1ULL,
+                                     10ULL,
+                                     100ULL,
+                                     1000ULL,
+                                     10000ULL,
+                                     100000ULL,
+                                     1000000ULL,
+                                     10000000ULL,
+                                     100000000ULL,
+                                     1000000000ULL,
+                                     10000000000ULL,
+                                     100000000000ULL,
+                                     1000000000000ULL,
+                                     10000000000000ULL,
+                                     100000000000000ULL,
+                                     1000000000000000ULL};
+  reserve(64);
+  if (precision_ >= 0 && precision_ <= 15 && std::isfinite(value)) {
+    /* Below 2^44, the error on the scaled value is under 2^-9: it is rounded like printf does unless it is too close
+     * to a half */
+    double scaled = std::fabs(value) * powers[precision_];
+    double fraction = scaled - std::floor(scaled);
+    if (scaled < 17592186044416.0 && std::fabs(fraction - 0.5) > 0.01) {
+      uint64_t rounded = static_cast<uint64_t>(scaled + 0.5);
+      uint64_t integer = rounded / ipowers[precision_];
+      uint64_t decimals = rounded % ipowers[precision_];
+      if (std::signbit(value))
+        *pos_++ = '-';
+      char digits[20];
+      int n = 0;
+      do {
+        digits[n++] = '0' + integer % 10;
+        integer /= 10;
+      } while (integer > 0);
+      while (n > 0)
+        *pos_++ = digits[--n];
+      if (precision_ > 0) {
+        *pos_++ = '.';
+        for (int i = precision_ - 1; i >= 0; i--) {
+          pos_[i] = '0' + decimals % 10;
+          decimals /= 10;
+        }
+        pos_ += precision_;
+      }
+      return *this;
+    }
+  }
+  int len = snprintf(pos_, end_ - pos_, "%.*f", precision_, value);
+  if (len >= end_ - pos_) { // Huge number with a huge precision
+    std::unique_ptr<char[]> str(new char[len + 1]);
+    snprintf(str.get(), len + 1, "%.*f", precision_, value);
+    return *this << static_cast<const char*>(str.get());
+  }
+  pos_ += len;
+  return *this;
+}
+
+PajeTextWriter::PajeTextWriter(FILE* file, int precision, bool display_sizes, bool call_location)
+    : file_(file), precision_(precision), display_sizes_(display_sizes), call_location_(call_location)
+{
+}
+
+void PajeTextWriter::start()
+{
+  stream_.open(file_, precision_);
+}
+
+void PajeTextWriter::timestamp(double timestamp)
+{
+  stream_ << " ";
+  /* prevent 0.0000 in the trace - this was the behavior before the transition to c++ */
+  if (timestamp < 1e-12)
+    stream_ << 0;
+  else
+    stream_ << timestamp;
+}
+
+void PajeTextWriter::defineContainerType(const char* id, const char* father, const char* name)
+{
+  stream_ << PAJE_DefineContainerType;
+  stream_ << " " << id << " " << father << " " << name << "\n";
+}
+
+void PajeTextWriter::defineVariableType(const char* id, const char* father, const char* name, const char* color)
+{
+  stream_ << PAJE_DefineVariableType;
+  stream_ << " " << id << " " << father << " " << name;
+  if (color)
+    stream_ << " \"" << color << "\"";
+  stream_ << "\n";
+}
+
+void PajeTextWriter::defineStateType(const char* id, const char* father, const char* name)
+{
+  stream_ << PAJE_DefineStateType;
+  stream_ << " " << id << " " << father << " " << name << "\n";
+}
+
+void PajeTextWriter::defineEventType(const char* id, const char* father, const char* name)
+{
+  stream_ << PAJE_DefineEventType;
+  stream_ << " " << id << " " << father << " " << name << "\n";
+}
+
+void PajeTextWriter::defineLinkType(const char* id, const char* father, const char* source, const char* dest,
+                                    const char* name)
+{
+  stream_ << PAJE_DefineLinkType;
+  stream_ << " " << id << " " << father << " " << source << " " << dest << " " << name << "\n";
+}
+
+void PajeTextWriter::defineEntityValue(const char* id, const char* father, const char* name, const char* color)
+{
+  stream_ << PAJE_DefineEntityValue;
+  stream_ << " " << id << " " << father << " " << name;
+  if (color)
+    stream_ << " \"" << color << "\"";
+  stream_ << "\n";
+}
+
+void PajeTextWriter::createContainer(double timestamp, const char* id, const char* type, const char* father,
+                                     const char* name)
+{
+  stream_ << PAJE_CreateContainer;
+  this->timestamp(timestamp);
+  stream_ << " " << id << " " << type << " " << father << " \"" << name << "\"\n";
+}
+
+void PajeTextWriter::destroyContainer(double timestamp, const char* type, const char* id)
+{
+  stream_ << PAJE_DestroyContainer;
+  this->timestamp(timestamp);
+  stream_ << " " << type << " " << id << "\n";
+}
+
+void PajeTextWriter::variable(e_event_type event, double timestamp, const char* type, const char* container,
+                              double value)
+{
+  stream_ << event;
+  this->timestamp(timestamp);
+  stream_ << " " << type << " " << container << " " << value << "\n";
+}
+
+void PajeTextWriter::setState(double timestamp, const char* type, const char* container, const char* value,
+                              const char* filename, int linenumber)
+{
+  stream_ << PAJE_SetState;
+  this->timestamp(timestamp);
+  stream_ << " " << type << " " << container << " " << value;
+  if (call_location_)
+    stream_ << " \"" << filename << "\" " << linenumber;
+  stream_ << "\n";
+}
+
+void PajeTextWriter::pushState(double timestamp, const char* type, const char* container, const char* value, int size,
+                               const char* filename, int linenumber)
+{
+  stream_ << PAJE_PushState;
+  this->timestamp(timestamp);
+  stream_ << " " << type << " " << container << " " << value;
+  if (display_sizes_)
+    stream_ << " " << size;
+  if (call_location_)
+    stream_ << " \"" << filename << "\" " << linenumber;
+  stream_ << "\n";
+}
+
+void PajeTextWriter::popState(e_event_type event, double timestamp, const char* type, const char* container)
+{
+  stream_ << event;
+  this->timestamp(timestamp);
+  stream_ << " " << type << " " << container << "\n";
+}
+
+void PajeTextWriter::startLink(double timestamp, const char* type, const char* container, const char* value,
+                               const char* source, const char* key, int size)
+{
+  stream_ << PAJE_StartLink;
+  this->timestamp(timestamp);
+  stream_ << " " << type << " " << container << " " << value << " " << source << " " << key;
+  if (display_sizes_)
+    stream_ << " " << size;
+  stream_ << "\n";
+}
+
+void PajeTextWriter::endLink(double timestamp, const char* type, const char* container, const char* value,
+                             const char* dest, const char* key)
+{
+  stream_ << PAJE_EndLink;
+  this->timestamp(timestamp);
+  stream_ << " " << type << " " << container << " " << value << " " << dest << " " << key << "\n";
+}
+
+void PajeTextWriter::newEvent(double timestamp, const char* type, const char* container, const char* value)
+{
+  stream_ << PAJE_NewEvent;
+  this->timestamp(timestamp);
+  stream_ << " " << type << " " << container << " " << value << "\n";
+}
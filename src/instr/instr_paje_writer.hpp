@@ -0,0 +1,199 @@
+/* Copyright (c) 2017. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#ifndef INSTR_PAJE_WRITER_HPP
+#define INSTR_PAJE_WRITER_HPP
+
+#include "src/instr/instr_private.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/* Output of the trace files
+ *
+ * The data is written in place into large buffers, without going through stdio or iostreams. The full buffers are
+ * handed to a thread that writes them to the file while the simulation fills the next ones: appending to the current
+ * buffer takes no lock, the two threads only synchronize when a buffer is handed over or when all buffers are full.
+ *
+ * In chunked mode, each buffer is written as a chunk of the binary traces, that the thread compresses if possible.
+ */
+class PajeOutput {
+public:
+  static constexpr size_t buffer_size = 1 << 20;
+
+  ~PajeOutput() { close(); }
+  void open(FILE* file, int precision, bool chunked = false, bool compress = false);
+  void close();
+
+  /* Room for size bytes in the current buffer, to be filled and committed with advance() */
+  char* reserve(size_t size)
+  {
+    if (static_cast<size_t>(end_ - pos_) < size)
+      hand_over();
+    return pos_;
+  }
+  void advance(char* pos) { pos_ = pos; }
+
+  /* The doubles are printed like "%.*f" would do with the precision given to open() */
+  PajeOutput& operator<<(const char* str);
+  PajeOutput& operator<<(int value);
+  PajeOutput& operator<<(double value);
+
+private:
+  static constexpr unsigned nb_buffers = 4;
+
+  FILE* file_    = nullptr;
+  int precision_ = 6;
+  bool chunked_  = false;
+  bool compress_ = false;
+  std::unique_ptr<char[]> buffers_[nb_buffers];
+  size_t sizes_[nb_buffers];
+  unsigned current_ = 0; // index of the buffer being filled, modulo nb_buffers
+  char* pos_        = nullptr;
+  char* end_        = nullptr;
+
+  std::atomic<unsigned> handed_{0};  // number of buffers handed to the writer so far
+  std::atomic<unsigned> written_{0}; // number of buffers written so far
+  bool stopping_ = false;
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::thread writer_;
+
+  void hand_over();
+  void write_buffers();
+  void write_chunk(const char* data, size_t size, std::vector<unsigned char>& compressed);
+};
+
+/* Backend of the Paje tracing
+ *
+ * The Paje events are given to the writer with the ids (aliases) of their types, containers and values. The textual
+ * preamble of the trace (generator version, comments and event definitions) is written to the file directly, before
+ * start() is called.
+ */
+class PajeWriter {
+public:
+  virtual ~PajeWriter() = default;
+  virtual void start() = 0;
+
+  virtual void defineContainerType(const char* id, const char* father, const char* name)                     = 0;
+  virtual void defineVariableType(const char* id, const char* father, const char* name, const char* color)   = 0;
+  virtual void defineStateType(const char* id, const char* father, const char* name)                         = 0;
+  virtual void defineEventType(const char* id, const char* father, const char* name)                         = 0;
+  virtual void defineLinkType(const char* id, const char* father, const char* source, const char* dest,
+                              const char* name)                                                               = 0;
+  virtual void defineEntityValue(const char* id, const char* father, const char* name, const char* color)    = 0;
+  virtual void createContainer(double timestamp, const char* id, const char* type, const char* father,
+                               const char* name)                                                              = 0;
+  virtual void destroyContainer(double timestamp, const char* type, const char* id)                          = 0;
+  /* SetVariable, AddVariable or SubVariable */
+  virtual void variable(e_event_type event, double timestamp, const char* type, const char* container,
+                        double value)                                                                         = 0;
+  /* The call location is only used with smpi/trace-call-location, and the size with tracing/smpi/display-sizes */
+  virtual void setState(double timestamp, const char* type, const char* container, const char* value,
+                        const char* filename, int linenumber)                                                 = 0;
+  virtual void pushState(double timestamp, const char* type, const char* container, const char* value, int size,
+                         const char* filename, int linenumber)                                                = 0;
+  /* PopState or ResetState */
+  virtual void popState(e_event_type event, double timestamp, const char* type, const char* container)       = 0;
+  virtual void startLink(double timestamp, const char* type, const char* container, const char* value,
+                         const char* source, const char* key, int size)                                       = 0;
+  virtual void endLink(double timestamp, const char* type, const char* container, const char* value,
+                       const char* dest, const char* key)                                                     = 0;
+  virtual void newEvent(double timestamp, const char* type, const char* container, const char* value)        = 0;
+};
+
+/* The regular Paje format, read by the visualization tools */
+class PajeTextWriter : public PajeWriter {
+  FILE* file_;
+  int precision_;
+  bool display_sizes_;
+  bool call_location_;
+  PajeOutput stream_;
+
+  void timestamp(double timestamp);
+
+public:
+  PajeTextWriter(FILE* file, int precision, bool display_sizes, bool call_location);
+  void start() override;
+
+  void defineContainerType(const char* id, const char* father, const char* name) override;
+  void defineVariableType(const char* id, const char* father, const char* name, const char* color) override;
+  void defineStateType(const char* id, const char* father, const char* name) override;
+  void defineEventType(const char* id, const char* father, const char* name) override;
+  void defineLinkType(const char* id, const char* father, const char* source, const char* dest,
+                      const char* name) override;
+  void defineEntityValue(const char* id, const char* father, const char* name, const char* color) override;
+  void createContainer(double timestamp, const char* id, const char* type, const char* father,
+                       const char* name) override;
+  void destroyContainer(double timestamp, const char* type, const char* id) override;
+  void variable(e_event_type event, double timestamp, const char* type, const char* container,
+                double value) override;
+  void setState(double timestamp, const char* type, const char* container, const char* value, const char* filename,
+                int linenumber) override;
+  void pushState(double timestamp, const char* type, const char* container, const char* value, int size,
+                 const char* filename, int linenumber) override;
+  void popState(e_event_type event, double timestamp, const char* type, const char* container) override;
+  void startLink(double timestamp, const char* type, const char* container, const char* value, const char* source,
+                 const char* key, int size) override;
+  void endLink(double timestamp, const char* type, const char* container, const char* value, const char* dest,
+               const char* key) override;
+  void newEvent(double timestamp, const char* type, const char* container, const char* value) override;
+};
+
+/* The binary format (tracing/binary), converted back to Paje with TRACE_binary_to_paje()
+ *
+ * The file starts with a small header and the textual preamble of the Paje trace, followed by chunks of events
+ * compressed with zlib when it is available. Each event is a byte for its type, its date when it differs from the one
+ * of the previous event, and its fields. The numerical ids are stored as varints, and the other strings are defined
+ * once and then referred to by their index.
+ */
+class PajeBinaryWriter : public PajeWriter {
+  FILE* file_;
+  bool display_sizes_;
+  bool call_location_;
+  bool compress_;
+  PajeOutput stream_;
+  double last_timestamp_ = 0;
+  std::unordered_map<std::string, unsigned> strings_;
+
+  uint64_t atom(const char* str);
+  char* begin(char* pos, e_event_type event, double timestamp);
+
+public:
+  PajeBinaryWriter(FILE* file, int precision, bool display_sizes, bool call_location, bool compress);
+  void start() override;
+
+  void defineContainerType(const char* id, const char* father, const char* name) override;
+  void defineVariableType(const char* id, const char* father, const char* name, const char* color) override;
+  void defineStateType(const char* id, const char* father, const char* name) override;
+  void defineEventType(const char* id, const char* father, const char* name) override;
+  void defineLinkType(const char* id, const char* father, const char* source, const char* dest,
+                      const char* name) override;
+  void defineEntityValue(const char* id, const char* father, const char* name, const char* color) override;
+  void createContainer(double timestamp, const char* id, const char* type, const char* father,
+                       const char* name) override;
+  void destroyContainer(double timestamp, const char* type, const char* id) override;
+  void variable(e_event_type event, double timestamp, const char* type, const char* container,
+                double value) override;
+  void setState(double timestamp, const char* type, const char* container, const char* value, const char* filename,
+                int linenumber) override;
+  void pushState(double timestamp, const char* type, const char* container, const char* value, int size,
+                 const char* filename, int linenumber) override;
+  void popState(e_event_type event, double timestamp, const char* type, const char* container) override;
+  void startLink(double timestamp, const char* type, const char* container, const char* value, const char* source,
+                 const char* key, int size) override;
+  void endLink(double timestamp, const char* type, const char* container, const char* value, const char* dest,
+               const char* key) override;
+  void newEvent(double timestamp, const char* type, const char* container, const char* value) override;
+};
+
+#endif
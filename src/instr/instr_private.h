@@ -121,6 +121,9 @@ class PajeEvent {
   virtual void print() = 0;
   void *data;
   virtual ~PajeEvent();
+  /* The events are recycled (see instr_paje_trace.cpp) */
+  static void* operator new(size_t size);
+  static void operator delete(void* ptr, size_t size);
 };
 
 //--------------------------------------------------
@@ -299,6 +302,8 @@ XBT_PRIVATE bool TRACE_display_sizes ();
 XBT_PRIVATE char *TRACE_get_comment ();
 XBT_PRIVATE char *TRACE_get_comment_file ();
 XBT_PRIVATE int TRACE_precision ();
+XBT_PRIVATE bool TRACE_binary();
+XBT_PRIVATE bool TRACE_binary_compress();
 XBT_PRIVATE char *TRACE_get_filename();
 XBT_PRIVATE char *TRACE_get_viva_uncat_conf ();
 XBT_PRIVATE char *TRACE_get_viva_cat_conf ();
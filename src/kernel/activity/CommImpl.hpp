@@ -28,8 +28,9 @@ public:
   double remains();
   void cleanupSurf(); // FIXME: make me protected
 
-  e_smx_comm_type_t type;       /* Type of the communication (SIMIX_COMM_SEND or SIMIX_COMM_RECEIVE) */
-  smx_mailbox_t mbox = nullptr; /* Rendez-vous where the comm is queued */
+  e_smx_comm_type_t type;           /* Type of the communication (SIMIX_COMM_SEND or SIMIX_COMM_RECEIVE) */
+  smx_mailbox_t mbox = nullptr;     /* Rendez-vous where the comm is queued */
+  unsigned long long mbox_rank = 0; /* Order of arrival in that rendez-vous */
 
 #if SIMGRID_HAVE_MC
   smx_mailbox_t mbox_cpy = nullptr; /* Copy of the rendez-vous where the comm is queued, MC needs it for DPOR
@@ -7,15 +7,30 @@
 
 #include "src/kernel/activity/CommImpl.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+#include <boost/functional/hash.hpp>
+
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY(simix_mailbox, simix, "Mailbox implementation");
 
-static xbt_dict_t mailboxes = xbt_dict_new_homogeneous([](void* data) {
-  delete static_cast<smx_mailbox_t>(data);
-});
+namespace {
+/* The mailboxes are indexed by their own name, so that looking for a mailbox does not copy the searched name */
+struct MailboxNameHash {
+  size_t operator()(const char* name) const { return boost::hash_range(name, name + std::strlen(name)); }
+};
+struct MailboxNameEqual {
+  bool operator()(const char* a, const char* b) const { return std::strcmp(a, b) == 0; }
+};
+std::unordered_map<const char*, smx_mailbox_t, MailboxNameHash, MailboxNameEqual> mailboxes;
+}
 
 void SIMIX_mailbox_exit()
 {
-  xbt_dict_free(&mailboxes);
+  for (auto const& elm : mailboxes)
+    delete elm.second;
+  mailboxes.clear();
 }
 
 /******************************************************************************/
@@ -28,18 +43,19 @@ namespace activity {
 /** @brief Returns the mailbox of that name, or nullptr */
 MailboxImpl* MailboxImpl::byNameOrNull(const char* name)
 {
-  return static_cast<smx_mailbox_t>(xbt_dict_get_or_null(mailboxes, name));
+  auto mbox = mailboxes.find(name);
+  return mbox == mailboxes.end() ? nullptr : mbox->second;
 }
 /** @brief Returns the mailbox of that name, newly created on need */
 MailboxImpl* MailboxImpl::byNameOrCreate(const char* name)
 {
   xbt_assert(name, "Mailboxes must have a name");
   /* two processes may have pushed the same mbox_create simcall at the same time */
-  smx_mailbox_t mbox = static_cast<smx_mailbox_t>(xbt_dict_get_or_null(mailboxes, name));
+  smx_mailbox_t mbox = byNameOrNull(name);
   if (not mbox) {
     mbox = new MailboxImpl(name);
     XBT_DEBUG("Creating a mailbox at %p with name %s", mbox, name);
-    xbt_dict_set(mailboxes, mbox->name_, mbox, nullptr);
+    mailboxes.insert({mbox->name_, mbox});
   }
   return mbox;
 }
@@ -55,8 +71,12 @@ void MailboxImpl::setReceiver(s4u::ActorPtr actor)
  */
 void MailboxImpl::push(activity::CommImplPtr comm)
 {
-  comm->mbox = this;
-  this->comm_queue.push_back(std::move(comm));
+  comm->mbox      = this;
+  comm->mbox_rank = pushed_++;
+  if (comm->type == SIMIX_COMM_SEND)
+    this->send_queue.push_back(std::move(comm));
+  else
+    this->recv_queue.push_back(std::move(comm));
 }
 
 /** @brief Removes a communication activity from a mailbox
@@ -70,13 +90,66 @@ void MailboxImpl::remove(smx_activity_t activity)
   xbt_assert(comm->mbox == this, "Comm %p is in mailbox %s, not mailbox %s", comm.get(),
              (comm->mbox ? comm->mbox->name_ : "(null)"), this->name_);
   comm->mbox = nullptr;
-  for (auto it = this->comm_queue.begin(); it != this->comm_queue.end(); it++)
-    if (*it == comm) {
-      this->comm_queue.erase(it);
+  for (auto* queue : {&send_queue, &recv_queue}) {
+    auto it = std::find(queue->begin(), queue->end(), activity);
+    if (it != queue->end()) {
+      queue->erase(it);
       return;
     }
+  }
   xbt_die("Comm %p not found in mailbox %s", comm.get(), this->name_);
 }
+
+smx_activity_t MailboxImpl::front() const
+{
+  if (send_queue.empty())
+    return recv_queue.empty() ? nullptr : recv_queue.front();
+  if (recv_queue.empty())
+    return send_queue.front();
+  auto send = boost::static_pointer_cast<CommImpl>(send_queue.front());
+  auto recv = boost::static_pointer_cast<CommImpl>(recv_queue.front());
+  return send->mbox_rank < recv->mbox_rank ? send_queue.front() : recv_queue.front();
+}
+
+/**
+ *  \brief Checks if there is a communication activity queued in the mailbox matching our needs
+ *  \param type The type of communication we are looking for (comm_send, comm_recv)
+ *  \return The communication activity if found, nullptr otherwise
+ *
+ *  Only the queue holding the communications of the wanted type is searched, in order of arrival.
+ */
+CommImplPtr MailboxImpl::findMatchingComm(e_smx_comm_type_t type, int (*match_fun)(void*, void*, CommImpl*),
+                                          void* this_user_data, CommImplPtr my_synchro, bool done,
+                                          bool remove_matching)
+{
+  boost::circular_buffer_space_optimized<smx_activity_t>* deque;
+  if (done)
+    deque = &done_comm_queue;
+  else
+    deque = (type == SIMIX_COMM_SEND ? &send_queue : &recv_queue);
+
+  for (auto it = deque->begin(); it != deque->end(); it++) {
+    CommImplPtr comm = boost::static_pointer_cast<CommImpl>(*it);
+
+    void* other_user_data = (comm->type == SIMIX_COMM_SEND ? comm->src_data : comm->dst_data);
+    if (comm->type == type && (match_fun == nullptr || match_fun(this_user_data, other_user_data, comm.get())) &&
+        (not comm->match_fun || comm->match_fun(other_user_data, this_user_data, my_synchro.get()))) {
+      XBT_DEBUG("Found a matching communication synchro %p", comm.get());
+      if (remove_matching)
+        deque->erase(it);
+#if SIMGRID_HAVE_MC
+      comm->mbox_cpy = comm->mbox;
+#endif
+      comm->mbox = nullptr;
+      return comm;
+    }
+    XBT_DEBUG("Sorry, communication synchro %p does not match our needs:"
+              " its type is %d but we are looking for a comm of type %d (or maybe the filtering didn't match)",
+              comm.get(), (int)comm->type, (int)type);
+  }
+  XBT_DEBUG("No matching communication synchro found");
+  return nullptr;
+}
 }
 }
 }
@@ -17,11 +17,19 @@ namespace simgrid {
 namespace kernel {
 namespace activity {
 
-/** @brief Implementation of the simgrid::s4u::Mailbox */
-
+/** @brief Implementation of the simgrid::s4u::Mailbox
+ *
+ * The pending sends and receives are kept in separate queues, so that looking for the counterpart of a
+ * communication only goes through the communications of the other type. Their order of arrival is recorded so that
+ * front() still returns the oldest pending communication.
+ */
 class MailboxImpl {
   explicit MailboxImpl(const char* name)
-      : piface_(this), name_(xbt_strdup(name)), comm_queue(MAX_MAILBOX_SIZE), done_comm_queue(MAX_MAILBOX_SIZE)
+      : piface_(this)
+      , name_(xbt_strdup(name))
+      , send_queue(MAX_MAILBOX_SIZE)
+      , recv_queue(MAX_MAILBOX_SIZE)
+      , done_comm_queue(MAX_MAILBOX_SIZE)
   {
   }
 
@@ -33,12 +41,27 @@ public:
   void setReceiver(s4u::ActorPtr actor);
   void push(activity::CommImplPtr comm);
   void remove(smx_activity_t activity);
+  /** @brief Looks for a communication of the given type matching our needs, in the pending ones or in the ones
+   *  already received by the permanent receiver (if done is true) */
+  CommImplPtr findMatchingComm(e_smx_comm_type_t type, int (*match_fun)(void*, void*, CommImpl*), void* this_user_data,
+                               CommImplPtr my_synchro, bool done, bool remove_matching);
+  /** @brief Whether no communication is pending in this mailbox */
+  bool empty() const { return send_queue.empty() && recv_queue.empty(); }
+  /** @brief Amount of pending communications */
+  size_t size() const { return send_queue.size() + recv_queue.size(); }
+  /** @brief The oldest pending communication, or nullptr */
+  smx_activity_t front() const;
+
   simgrid::s4u::Mailbox piface_; // Our interface
   char* name_;
 
   simgrid::simix::ActorImplPtr permanent_receiver; // process which the mailbox is attached to
-  boost::circular_buffer_space_optimized<smx_activity_t> comm_queue;
+  boost::circular_buffer_space_optimized<smx_activity_t> send_queue; // pending sends, in order of arrival
+  boost::circular_buffer_space_optimized<smx_activity_t> recv_queue; // pending receives, in order of arrival
   boost::circular_buffer_space_optimized<smx_activity_t> done_comm_queue; // messages already received in the permanent receive mode
+
+private:
+  unsigned long long pushed_ = 0; // amount of communications pushed so far, to order the two queues
 };
 }
 }
@@ -6,27 +6,18 @@
 #include "src/kernel/routing/DijkstraZone.hpp"
 #include "src/kernel/routing/NetPoint.hpp"
 #include "src/surf/network_interface.hpp"
+#include "xbt/heap.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <float.h>
+#include <thread>
 
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY(surf_route_dijkstra, surf, "Routing part of surf -- dijkstra routing logic");
 
-/* Free functions */
-
-static void route_cache_elem_free(void* e)
-{
-  route_cache_element_t elm = (route_cache_element_t)e;
-  if (elm) {
-    xbt_free(elm->pred_arr);
-    xbt_free(elm);
-  }
-}
+int sg_dijkstra_threads = 0;
 
-static void graph_node_map_elem_free(void* e)
-{
-  graph_node_map_element_t elm = (graph_node_map_element_t)e;
-  xbt_free(elm);
-}
+/* Free functions */
 
 static void graph_edge_data_free(void* e) // FIXME: useless code duplication
 {
@@ -50,8 +41,6 @@ void DijkstraZone::seal()
   /* Create the topology graph */
   if (not routeGraph_)
     routeGraph_ = xbt_graph_new_graph(1, nullptr);
-  if (not graphNodeMap_)
-    graphNodeMap_ = xbt_dict_new_homogeneous(&graph_node_map_elem_free);
 
   /* Add the loopback if needed */
   if (surf_network_model->loopback_ && hierarchy_ == RoutingMode::base) {
@@ -83,6 +72,80 @@ void DijkstraZone::seal()
     graph_node_data_t data = (graph_node_data_t)xbt_graph_node_get_data(node);
     data->graph_id         = cursor;
   }
+
+  /* Flatten the graph, with the amount of links as a cost (the old model assumed 1) */
+  adjacencyStart_.clear();
+  adjacency_.clear();
+  xbt_dynar_foreach (nodes, cursor, node) {
+    adjacencyStart_.push_back(adjacency_.size());
+    xbt_edge_t edge = nullptr;
+    unsigned int cursor2;
+    xbt_dynar_foreach (xbt_graph_node_get_outedges(node), cursor2, edge) {
+      graph_node_data_t data         = (graph_node_data_t)xbt_graph_node_get_data(xbt_graph_edge_get_target(edge));
+      sg_platf_route_cbarg_t e_route = (sg_platf_route_cbarg_t)xbt_graph_edge_get_data(edge);
+      adjacency_.push_back(std::make_pair(data->graph_id, static_cast<double>(e_route->link_list->size())));
+    }
+  }
+  adjacencyStart_.push_back(adjacency_.size());
+
+  routeCache_.clear();
+  if (sg_dijkstra_threads > 0)
+    precomputePredecessors(sg_dijkstra_threads);
+  else if (cached_)
+    routeCache_.resize(xbt_dynar_length(nodes));
+}
+
+void DijkstraZone::computePredecessors(int src, std::vector<int>* pred) const
+{
+  int nr_nodes = adjacencyStart_.size() - 1;
+  std::vector<double> cost(nr_nodes, DBL_MAX); /* link cost from src to other hosts */
+  pred->assign(nr_nodes, 0);                   /* predecessors in path from src */
+  simgrid::xbt::Heap<int> pqueue;
+  pqueue.reserve(nr_nodes);
+
+  /* All the nodes are queued from the start, as in the original implementation: this keeps the order in which the
+   * nodes of same cost are popped, and thus the choice between the routes of same length */
+  cost[src] = 0.0;
+  for (int i = 0; i < nr_nodes; i++)
+    pqueue.push(i, cost[i]);
+
+  while (not pqueue.empty()) {
+    double v_cost = pqueue.top_key();
+    int v         = pqueue.pop();
+    if (v_cost > cost[v]) /* stale entry: v was reached again through a shorter path */
+      continue;
+
+    for (unsigned e = adjacencyStart_[v]; e < adjacencyStart_[v + 1]; e++) {
+      int u          = adjacency_[e].first;
+      double u_cost  = v_cost + adjacency_[e].second;
+      if (u_cost < cost[u]) {
+        (*pred)[u] = v;
+        cost[u]    = u_cost;
+        pqueue.push(u, u_cost);
+      }
+    }
+  }
+}
+
+void DijkstraZone::precomputePredecessors(int nb_threads)
+{
+  int nr_nodes = adjacencyStart_.size() - 1;
+  routeCache_.resize(nr_nodes);
+  nb_threads = std::max(1, std::min(nb_threads, nr_nodes));
+  XBT_VERB("Precompute the routes of %s from its %d nodes on %d threads", getCname(), nr_nodes, nb_threads);
+
+  /* Each source writes its own vector, so the workers only share the index of the next source */
+  std::atomic<int> next_src{0};
+  auto worker = [this, &next_src, nr_nodes]() {
+    for (int src = next_src++; src < nr_nodes; src = next_src++)
+      computePredecessors(src, &routeCache_[src]);
+  };
+  std::vector<std::thread> threads;
+  for (int i = 1; i < nb_threads; i++)
+    threads.emplace_back(worker);
+  worker();
+  for (std::thread& thread : threads)
+    thread.join();
 }
 
 xbt_node_t DijkstraZone::routeGraphNewNode(int id, int graph_id)
@@ -92,16 +155,15 @@ xbt_node_t DijkstraZone::routeGraphNewNode(int id, int graph_id)
   data->graph_id = graph_id;
 
   xbt_node_t node                = xbt_graph_new_node(routeGraph_, data);
-  graph_node_map_element_t elm   = xbt_new0(struct graph_node_map_element, 1);
-  elm->node = node;
-  xbt_dict_set_ext(graphNodeMap_, (char*)(&id), sizeof(int), (xbt_dictelm_t)elm, nullptr);
+  graphNodeMap_[id]              = node;
 
   return node;
 }
 
-graph_node_map_element_t DijkstraZone::nodeMapSearch(int id)
+xbt_node_t DijkstraZone::nodeMapSearch(int id)
 {
-  return (graph_node_map_element_t)xbt_dict_get_or_null_ext(graphNodeMap_, (char*)(&id), sizeof(int));
+  auto elm = graphNodeMap_.find(id);
+  return elm == graphNodeMap_.end() ? nullptr : elm->second;
 }
 
 /* Parsing */
@@ -109,17 +171,8 @@ graph_node_map_element_t DijkstraZone::nodeMapSearch(int id)
 void DijkstraZone::newRoute(int src_id, int dst_id, sg_platf_route_cbarg_t e_route)
 {
   XBT_DEBUG("Load Route from \"%d\" to \"%d\"", src_id, dst_id);
-  xbt_node_t src = nullptr;
-  xbt_node_t dst = nullptr;
-
-  graph_node_map_element_t src_elm = nodeMapSearch(src_id);
-  graph_node_map_element_t dst_elm = nodeMapSearch(dst_id);
-
-  if (src_elm)
-    src = src_elm->node;
-
-  if (dst_elm)
-    dst = dst_elm->node;
+  xbt_node_t src = nodeMapSearch(src_id);
+  xbt_node_t dst = nodeMapSearch(dst_id);
 
   /* add nodes if they don't exist in the graph */
   if (src_id == dst_id && src == nullptr && dst == nullptr) {
@@ -144,16 +197,14 @@ void DijkstraZone::getLocalRoute(NetPoint* src, NetPoint* dst, sg_platf_route_cb
   int src_id = src->id();
   int dst_id = dst->id();
 
-  int* pred_arr     = nullptr;
-  int size          = 0;
   xbt_dynar_t nodes = xbt_graph_get_nodes(routeGraph_);
 
   /* Use the graph_node id mapping set to quickly find the nodes */
-  graph_node_map_element_t src_elm = nodeMapSearch(src_id);
-  graph_node_map_element_t dst_elm = nodeMapSearch(dst_id);
+  xbt_node_t src_elm = nodeMapSearch(src_id);
+  xbt_node_t dst_elm = nodeMapSearch(dst_id);
 
-  int src_node_id = ((graph_node_data_t)xbt_graph_node_get_data(src_elm->node))->graph_id;
-  int dst_node_id = ((graph_node_data_t)xbt_graph_node_get_data(dst_elm->node))->graph_id;
+  int src_node_id = ((graph_node_data_t)xbt_graph_node_get_data(src_elm))->graph_id;
+  int dst_node_id = ((graph_node_data_t)xbt_graph_node_get_data(dst_elm))->graph_id;
 
   /* if the src and dst are the same */
   if (src_node_id == dst_node_id) {
@@ -174,66 +225,14 @@ void DijkstraZone::getLocalRoute(NetPoint* src, NetPoint* dst, sg_platf_route_cb
     }
   }
 
-  route_cache_element_t elm = nullptr;
-  if (routeCache_) { /* cache mode  */
-    elm = (route_cache_element_t)xbt_dict_get_or_null_ext(routeCache_, (char*)(&src_id), sizeof(int));
-  }
-
-  if (elm) { /* cached mode and cache hit */
-    pred_arr = elm->pred_arr;
-  } else { /* not cached mode, or cache miss */
-
-    int nr_nodes      = xbt_dynar_length(nodes);
-    double* cost_arr  = xbt_new0(double, nr_nodes); /* link cost from src to other hosts */
-    pred_arr          = xbt_new0(int, nr_nodes);    /* predecessors in path from src */
-    xbt_heap_t pqueue = xbt_heap_new(nr_nodes, xbt_free_f);
-
-    /* initialize */
-    cost_arr[src_node_id] = 0.0;
-
-    for (int i = 0; i < nr_nodes; i++) {
-      if (i != src_node_id) {
-        cost_arr[i] = DBL_MAX;
-      }
-
-      pred_arr[i] = 0;
-
-      /* initialize priority queue */
-      int* nodeid = xbt_new0(int, 1);
-      *nodeid     = i;
-      xbt_heap_push(pqueue, nodeid, cost_arr[i]);
-    }
-
-    /* apply dijkstra using the indexes from the graph's node array */
-    while (xbt_heap_size(pqueue) > 0) {
-      int* v_id         = static_cast<int*>(xbt_heap_pop(pqueue));
-      xbt_node_t v_node = xbt_dynar_get_as(nodes, *v_id, xbt_node_t);
-      xbt_edge_t edge   = nullptr;
-      unsigned int cursor;
-
-      xbt_dynar_foreach (xbt_graph_node_get_outedges(v_node), cursor, edge) {
-        xbt_node_t u_node                  = xbt_graph_edge_get_target(edge);
-        graph_node_data_t data             = (graph_node_data_t)xbt_graph_node_get_data(u_node);
-        int u_id                           = data->graph_id;
-        sg_platf_route_cbarg_t tmp_e_route = (sg_platf_route_cbarg_t)xbt_graph_edge_get_data(edge);
-        int cost_v_u                       = tmp_e_route->link_list->size(); /* count of links, old model assume 1 */
-
-        if (cost_v_u + cost_arr[*v_id] < cost_arr[u_id]) {
-          pred_arr[u_id] = *v_id;
-          cost_arr[u_id] = cost_v_u + cost_arr[*v_id];
-          int* nodeid    = xbt_new0(int, 1);
-          *nodeid        = u_id;
-          xbt_heap_push(pqueue, nodeid, cost_arr[u_id]);
-        }
-      }
-
-      /* free item popped from pqueue */
-      xbt_free(v_id);
-    }
-
-    xbt_free(cost_arr);
-    xbt_heap_free(pqueue);
-  }
+  /* in cache mode (or once precomputed), the predecessors are computed only once per source */
+  std::vector<int> uncached_pred;
+  std::vector<int>* pred = &uncached_pred;
+  if (not routeCache_.empty())
+    pred = &routeCache_[src_node_id];
+  if (pred->empty())
+    computePredecessors(src_node_id, pred);
+  const std::vector<int>& pred_arr = *pred;
 
   /* compose route path with links */
   NetPoint* gw_src = nullptr;
@@ -278,39 +277,23 @@ void DijkstraZone::getLocalRoute(NetPoint* src, NetPoint* dst, sg_platf_route_cb
       if (lat)
         *lat += static_cast<surf::LinkImpl*>(link)->latency();
     }
-    size++;
   }
 
   if (hierarchy_ == RoutingMode::recursive) {
     route->gw_src = gw_src;
     route->gw_dst = first_gw;
   }
-
-  if (routeCache_ && elm == nullptr) {
-    /* add to predecessor list of the current src-host to cache */
-    elm           = xbt_new0(struct route_cache_element, 1);
-    elm->pred_arr = pred_arr;
-    elm->size     = size;
-    xbt_dict_set_ext(routeCache_, (char*)(&src_id), sizeof(int), (xbt_dictelm_t)elm, nullptr);
-  }
-
-  if (not routeCache_)
-    xbt_free(pred_arr);
 }
 
 DijkstraZone::~DijkstraZone()
 {
   xbt_graph_free_graph(routeGraph_, &xbt_free_f, &graph_edge_data_free, &xbt_free_f);
-  xbt_dict_free(&graphNodeMap_);
-  xbt_dict_free(&routeCache_);
 }
 
 /* Creation routing model functions */
 
-DijkstraZone::DijkstraZone(NetZone* father, const char* name, bool cached) : RoutedZone(father, name)
+DijkstraZone::DijkstraZone(NetZone* father, const char* name, bool cached) : RoutedZone(father, name), cached_(cached)
 {
-  if (cached)
-    routeCache_ = xbt_dict_new_homogeneous(&route_cache_elem_free);
 }
 
 void DijkstraZone::addRoute(sg_platf_route_cbarg_t route)
@@ -325,8 +308,6 @@ void DijkstraZone::addRoute(sg_platf_route_cbarg_t route)
   /* Create the topology graph */
   if (not routeGraph_)
     routeGraph_ = xbt_graph_new_graph(1, nullptr);
-  if (not graphNodeMap_)
-    graphNodeMap_ = xbt_dict_new_homogeneous(&graph_node_map_elem_free);
 
   /* we don't check whether the route already exist, because the algorithm may find another path through some other
    * nodes */
@@ -8,23 +8,15 @@
 
 #include "src/kernel/routing/RoutedZone.hpp"
 
+#include <unordered_map>
+#include <vector>
+
 typedef struct graph_node_data {
   int id;
   int graph_id; /* used for caching internal graph id's */
 } s_graph_node_data_t;
 typedef s_graph_node_data_t* graph_node_data_t;
 
-typedef struct graph_node_map_element {
-  xbt_node_t node;
-} s_graph_node_map_element_t;
-typedef s_graph_node_map_element_t* graph_node_map_element_t;
-
-typedef struct route_cache_element {
-  int* pred_arr;
-  int size;
-} s_route_cache_element_t;
-typedef s_route_cache_element_t* route_cache_element_t;
-
 namespace simgrid {
 namespace kernel {
 namespace routing {
@@ -40,6 +32,10 @@ namespace routing {
  *  using the Dijkstra algorithm. A cache can be used to reduce the computation.
  *
  *  This result in rather small platform file, very fast initialization, and very low memory requirements, but somehow long path resolution times.
+ *
+ *  When network/dijkstra-threads is set, the predecessors of every source are instead computed when sealing the zone,
+ *  one Dijkstra per source being run on that many threads. The initialization is then longer and the memory
+ *  requirements quadratic, but the route resolution does not search anything anymore.
  */
 class XBT_PRIVATE DijkstraZone : public RoutedZone {
 public:
@@ -48,7 +44,7 @@ public:
 
   ~DijkstraZone() override;
   xbt_node_t routeGraphNewNode(int id, int graph_id);
-  graph_node_map_element_t nodeMapSearch(int id);
+  xbt_node_t nodeMapSearch(int id);
   void newRoute(int src_id, int dst_id, sg_platf_route_cbarg_t e_route);
   /* For each vertex (node) already in the graph,
    * make sure it also has a loopback link; this loopback
@@ -64,9 +60,21 @@ public:
   void getLocalRoute(NetPoint* src, NetPoint* dst, sg_platf_route_cbarg_t route, double* lat) override;
   void addRoute(sg_platf_route_cbarg_t route) override;
 
-  xbt_graph_t routeGraph_  = nullptr; /* xbt_graph */
-  xbt_dict_t graphNodeMap_ = nullptr; /* map */
-  xbt_dict_t routeCache_   = nullptr; /* use in cache mode */
+  xbt_graph_t routeGraph_ = nullptr;                  /* xbt_graph */
+  std::unordered_map<int, xbt_node_t> graphNodeMap_; /* netpoint id -> graph node */
+
+private:
+  /** Fill pred with the predecessor of each graph node in the shortest paths from src (a graph id) */
+  void computePredecessors(int src, std::vector<int>* pred) const;
+  void precomputePredecessors(int nb_threads);
+
+  bool cached_ = false;
+  /* Adjacency of the sealed graph: the out-edges of graph node i are adjacency_[adjacencyStart_[i]] to
+   * adjacency_[adjacencyStart_[i+1]-1], as (target graph id, cost) pairs */
+  std::vector<unsigned> adjacencyStart_;
+  std::vector<std::pair<int, double>> adjacency_;
+  /* Predecessors from each source, indexed by graph id (in cache mode, or once precomputed). Empty if not known yet */
+  std::vector<std::vector<int>> routeCache_;
 };
 }
 }
@@ -15,7 +15,6 @@ XBT_LOG_NEW_DEFAULT_SUBCATEGORY(surf_route_floyd, surf, "Routing part of surf");
 
 #define TO_FLOYD_COST(i, j) (costTable_)[(i) + (j)*table_size]
 #define TO_FLOYD_PRED(i, j) (predecessorTable_)[(i) + (j)*table_size]
-#define TO_FLOYD_LINK(i, j) (linkTable_)[(i) + (j)*table_size]
 
 namespace simgrid {
 namespace kernel {
@@ -23,25 +22,9 @@ namespace routing {
 
 FloydZone::FloydZone(NetZone* father, const char* name) : RoutedZone(father, name)
 {
-  predecessorTable_ = nullptr;
-  costTable_        = nullptr;
-  linkTable_        = nullptr;
 }
 
-FloydZone::~FloydZone()
-{
-  if (linkTable_ == nullptr) // Dealing with a parse error in the file?
-    return;
-  int table_size = vertices_.size();
-  /* Delete link_table */
-  for (int i = 0; i < table_size; i++)
-    for (int j = 0; j < table_size; j++)
-      routing_route_free(TO_FLOYD_LINK(i, j));
-  xbt_free(linkTable_);
-
-  xbt_free(predecessorTable_);
-  xbt_free(costTable_);
-}
+FloydZone::~FloydZone() = default;
 
 void FloydZone::getLocalRoute(NetPoint* src, NetPoint* dst, sg_platf_route_cbarg_t route, double* lat)
 {
@@ -50,13 +33,13 @@ void FloydZone::getLocalRoute(NetPoint* src, NetPoint* dst, sg_platf_route_cbarg
   getRouteCheckParams(src, dst);
 
   /* create a result route */
-  std::vector<sg_platf_route_cbarg_t> route_stack;
+  std::vector<const RoutingTable::Route*> route_stack;
   unsigned int cur = dst->id();
   do {
     int pred = TO_FLOYD_PRED(src->id(), cur);
     if (pred == -1)
       THROWF(arg_error, 0, "No route from '%s' to '%s'", src->name().c_str(), dst->name().c_str());
-    route_stack.push_back(TO_FLOYD_LINK(pred, cur));
+    route_stack.push_back(linkTable_.get(pred, cur));
     cur = pred;
   } while (cur != src->id());
 
@@ -67,70 +50,73 @@ void FloydZone::getLocalRoute(NetPoint* src, NetPoint* dst, sg_platf_route_cbarg
 
   sg_netpoint_t prev_dst_gw = nullptr;
   while (not route_stack.empty()) {
-    sg_platf_route_cbarg_t e_route = route_stack.back();
+    const RoutingTable::Route* e_route = route_stack.back();
     route_stack.pop_back();
     if (hierarchy_ == RoutingMode::recursive && prev_dst_gw != nullptr &&
         strcmp(prev_dst_gw->name().c_str(), e_route->gw_src->name().c_str())) {
       getGlobalRoute(prev_dst_gw, e_route->gw_src, route->link_list, lat);
     }
 
-    for (auto link : *e_route->link_list) {
-      route->link_list->push_back(link);
+    surf::LinkImpl* const* links = linkTable_.links(e_route);
+    for (uint32_t i = 0; i < e_route->size; i++) {
+      route->link_list->push_back(links[i]);
       if (lat)
-        *lat += link->latency();
+        *lat += links[i]->latency();
     }
 
     prev_dst_gw = e_route->gw_dst;
   }
 }
 
-void FloydZone::addRoute(sg_platf_route_cbarg_t route)
+/* Create Cost, Predecessor and Link tables */
+void FloydZone::initTables()
 {
-  /* set the size of table routing */
-  int table_size = static_cast<int>(vertices_.size());
+  size_t table_size = vertices_.size();
+  costTable_.assign(table_size * table_size, DBL_MAX); /* link cost from host to host */
+  predecessorTable_.assign(table_size * table_size, -1); /* predecessor host numbers */
+  linkTable_.allocate(table_size);                       /* actual link between src and dst */
+}
+
+void FloydZone::addExtendedRoute(NetPoint* src, NetPoint* dst, sg_platf_route_cbarg_t route, bool reverse)
+{
+  size_t table_size              = vertices_.size();
+  sg_platf_route_cbarg_t e_route = newExtendedRoute(hierarchy_, route, not reverse);
+  linkTable_.set(src->id(), dst->id(), e_route->gw_src, e_route->gw_dst, *e_route->link_list);
+  TO_FLOYD_PRED(src->id(), dst->id()) = src->id();
+  TO_FLOYD_COST(src->id(), dst->id()) = e_route->link_list->size(); /* count of links, old model assume 1 */
+  routing_route_free(e_route);
+}
 
+void FloydZone::addRoute(sg_platf_route_cbarg_t route)
+{
   addRouteCheckParams(route);
 
-  if (not linkTable_) {
-    /* Create Cost, Predecessor and Link tables */
-    costTable_        = xbt_new0(double, table_size* table_size);                  /* link cost from host to host */
-    predecessorTable_ = xbt_new0(int, table_size* table_size);                     /* predecessor host numbers */
-    linkTable_        = xbt_new0(sg_platf_route_cbarg_t, table_size * table_size); /* actual link between src and dst */
-
-    /* Initialize costs and predecessors */
-    for (int i = 0; i < table_size; i++)
-      for (int j = 0; j < table_size; j++) {
-        TO_FLOYD_COST(i, j) = DBL_MAX;
-        TO_FLOYD_PRED(i, j) = -1;
-        TO_FLOYD_LINK(i, j) = nullptr;
-      }
-  }
+  if (not linkTable_.allocated())
+    initTables();
+  xbt_assert(linkTable_.size() == vertices_.size(), "Netzone %s got new points after its first route", getCname());
 
   /* Check that the route does not already exist */
   if (route->gw_dst) // netzone route (to adapt the error message, if any)
-    xbt_assert(nullptr == TO_FLOYD_LINK(route->src->id(), route->dst->id()),
+    xbt_assert(nullptr == linkTable_.get(route->src->id(), route->dst->id()),
                "The route between %s@%s and %s@%s already exists (Rq: routes are symmetrical by default).",
                route->src->name().c_str(), route->gw_src->name().c_str(), route->dst->name().c_str(),
                route->gw_dst->name().c_str());
   else
-    xbt_assert(nullptr == TO_FLOYD_LINK(route->src->id(), route->dst->id()),
+    xbt_assert(nullptr == linkTable_.get(route->src->id(), route->dst->id()),
                "The route between %s and %s already exists (Rq: routes are symmetrical by default).",
                route->src->name().c_str(), route->dst->name().c_str());
 
-  TO_FLOYD_LINK(route->src->id(), route->dst->id()) = newExtendedRoute(hierarchy_, route, 1);
-  TO_FLOYD_PRED(route->src->id(), route->dst->id()) = route->src->id();
-  TO_FLOYD_COST(route->src->id(), route->dst->id()) =
-      (TO_FLOYD_LINK(route->src->id(), route->dst->id()))->link_list->size();
+  addExtendedRoute(route->src, route->dst, route, false);
 
   if (route->symmetrical == true) {
     if (route->gw_dst) // netzone route (to adapt the error message, if any)
       xbt_assert(
-          nullptr == TO_FLOYD_LINK(route->dst->id(), route->src->id()),
+          nullptr == linkTable_.get(route->dst->id(), route->src->id()),
           "The route between %s@%s and %s@%s already exists. You should not declare the reverse path as symmetrical.",
           route->dst->name().c_str(), route->gw_dst->name().c_str(), route->src->name().c_str(),
           route->gw_src->name().c_str());
     else
-      xbt_assert(nullptr == TO_FLOYD_LINK(route->dst->id(), route->src->id()),
+      xbt_assert(nullptr == linkTable_.get(route->dst->id(), route->src->id()),
                  "The route between %s and %s already exists. You should not declare the reverse path as symmetrical.",
                  route->dst->name().c_str(), route->src->name().c_str());
 
@@ -146,10 +132,7 @@ void FloydZone::addRoute(sg_platf_route_cbarg_t route)
       XBT_DEBUG("Load NetzoneRoute from \"%s(%s)\" to \"%s(%s)\"", route->dst->name().c_str(), route->gw_src->name().c_str(),
                 route->src->name().c_str(), route->gw_dst->name().c_str());
 
-    TO_FLOYD_LINK(route->dst->id(), route->src->id()) = newExtendedRoute(hierarchy_, route, 0);
-    TO_FLOYD_PRED(route->dst->id(), route->src->id()) = route->dst->id();
-    TO_FLOYD_COST(route->dst->id(), route->src->id()) =
-        (TO_FLOYD_LINK(route->dst->id(), route->src->id()))->link_list->size(); /* count of links, old model assume 1 */
+    addExtendedRoute(route->dst, route->src, route, true);
   }
 }
 
@@ -158,32 +141,16 @@ void FloydZone::seal()
   /* set the size of table routing */
   size_t table_size = vertices_.size();
 
-  if (not linkTable_) {
-    /* Create Cost, Predecessor and Link tables */
-    costTable_        = xbt_new0(double, table_size* table_size);                  /* link cost from host to host */
-    predecessorTable_ = xbt_new0(int, table_size* table_size);                     /* predecessor host numbers */
-    linkTable_        = xbt_new0(sg_platf_route_cbarg_t, table_size * table_size); /* actual link between src and dst */
-
-    /* Initialize costs and predecessors */
-    for (unsigned int i = 0; i < table_size; i++)
-      for (unsigned int j = 0; j < table_size; j++) {
-        TO_FLOYD_COST(i, j) = DBL_MAX;
-        TO_FLOYD_PRED(i, j) = -1;
-        TO_FLOYD_LINK(i, j) = nullptr;
-      }
-  }
+  if (not linkTable_.allocated())
+    initTables();
+  xbt_assert(linkTable_.size() == table_size, "Netzone %s got new points after its first route", getCname());
 
   /* Add the loopback if needed */
   if (surf_network_model->loopback_ && hierarchy_ == RoutingMode::base) {
+    std::vector<surf::LinkImpl*> loopback{surf_network_model->loopback_};
     for (unsigned int i = 0; i < table_size; i++) {
-      sg_platf_route_cbarg_t e_route = TO_FLOYD_LINK(i, i);
-      if (not e_route) {
-        e_route            = xbt_new0(s_sg_platf_route_cbarg_t, 1);
-        e_route->gw_src    = nullptr;
-        e_route->gw_dst    = nullptr;
-        e_route->link_list = new std::vector<surf::LinkImpl*>();
-        e_route->link_list->push_back(surf_network_model->loopback_);
-        TO_FLOYD_LINK(i, i) = e_route;
+      if (not linkTable_.get(i, i)) {
+        linkTable_.set(i, i, nullptr, nullptr, loopback);
         TO_FLOYD_PRED(i, i) = i;
         TO_FLOYD_COST(i, i) = 1;
       }
@@ -203,6 +170,12 @@ void FloydZone::seal()
       }
     }
   }
+
+  /* The costs are not needed anymore */
+  std::vector<double>().swap(costTable_);
+  linkTable_.compact();
+  XBT_VERB("Routing table of %s: %zu points, %zu distinct routes, %zu bytes", getCname(), table_size,
+           linkTable_.routeCount(), linkTable_.memoryUsage() + predecessorTable_.capacity() * sizeof(int));
 }
 }
 }
@@ -7,6 +7,7 @@
 #define SURF_ROUTING_FLOYD_HPP_
 
 #include "src/kernel/routing/RoutedZone.hpp"
+#include "src/kernel/routing/RoutingTable.hpp"
 
 namespace simgrid {
 namespace kernel {
@@ -31,10 +32,13 @@ public:
   void seal() override;
 
 private:
-  /* vars to compute the Floyd algorithm. */
-  int* predecessorTable_;
-  double* costTable_;
-  sg_platf_route_cbarg_t* linkTable_;
+  void initTables();
+  void addExtendedRoute(NetPoint* src, NetPoint* dst, sg_platf_route_cbarg_t route, bool reverse);
+
+  /* vars to compute the Floyd algorithm. The costs are only needed until the zone is sealed. */
+  std::vector<int> predecessorTable_;
+  std::vector<double> costTable_;
+  RoutingTable linkTable_;
 };
 }
 }
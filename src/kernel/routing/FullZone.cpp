@@ -6,11 +6,10 @@
 #include "src/kernel/routing/FullZone.hpp"
 #include "src/kernel/routing/NetPoint.hpp"
 #include "src/surf/network_interface.hpp"
+#include "src/surf/xml/platf_private.hpp"
 
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY(surf_route_full, surf, "Routing part of surf");
 
-#define TO_ROUTE_FULL(i, j) routingTable_[(i) + (j)*table_size]
-
 namespace simgrid {
 namespace kernel {
 namespace routing {
@@ -20,58 +19,42 @@ FullZone::FullZone(NetZone* father, const char* name) : RoutedZone(father, name)
 
 void FullZone::seal()
 {
-  int table_size = static_cast<int>(vertices_.size());
+  unsigned int table_size = vertices_.size();
 
   /* Create table if needed */
-  if (not routingTable_)
-    routingTable_ = xbt_new0(sg_platf_route_cbarg_t, table_size * table_size);
+  if (not routingTable_.allocated())
+    routingTable_.allocate(table_size);
+  xbt_assert(routingTable_.size() == table_size, "Netzone %s got new points after its first route", getCname());
 
   /* Add the loopback if needed */
   if (surf_network_model->loopback_ && hierarchy_ == RoutingMode::base) {
-    for (int i = 0; i < table_size; i++) {
-      sg_platf_route_cbarg_t e_route = TO_ROUTE_FULL(i, i);
-      if (not e_route) {
-        e_route            = xbt_new0(s_sg_platf_route_cbarg_t, 1);
-        e_route->gw_src    = nullptr;
-        e_route->gw_dst    = nullptr;
-        e_route->link_list = new std::vector<surf::LinkImpl*>();
-        e_route->link_list->push_back(surf_network_model->loopback_);
-        TO_ROUTE_FULL(i, i) = e_route;
-      }
-    }
+    std::vector<surf::LinkImpl*> loopback{surf_network_model->loopback_};
+    for (unsigned int i = 0; i < table_size; i++)
+      if (not routingTable_.get(i, i))
+        routingTable_.set(i, i, nullptr, nullptr, loopback);
   }
-}
 
-FullZone::~FullZone()
-{
-  if (routingTable_) {
-    int table_size = static_cast<int>(vertices_.size());
-    /* Delete routing table */
-    for (int i = 0; i < table_size; i++)
-      for (int j = 0; j < table_size; j++) {
-        if (TO_ROUTE_FULL(i, j)) {
-          delete TO_ROUTE_FULL(i, j)->link_list;
-          xbt_free(TO_ROUTE_FULL(i, j));
-        }
-      }
-    xbt_free(routingTable_);
-  }
+  routingTable_.compact();
+  XBT_VERB("Routing table of %s: %u points, %zu distinct routes, %zu bytes", getCname(), table_size,
+           routingTable_.routeCount(), routingTable_.memoryUsage());
 }
 
+FullZone::~FullZone() = default;
+
 void FullZone::getLocalRoute(NetPoint* src, NetPoint* dst, sg_platf_route_cbarg_t res, double* lat)
 {
   XBT_DEBUG("full getLocalRoute from %s[%d] to %s[%d]", src->cname(), src->id(), dst->cname(), dst->id());
 
-  size_t table_size              = vertices_.size();
-  sg_platf_route_cbarg_t e_route = TO_ROUTE_FULL(src->id(), dst->id());
+  const RoutingTable::Route* e_route = routingTable_.get(src->id(), dst->id());
 
   if (e_route != nullptr) {
-    res->gw_src = e_route->gw_src;
-    res->gw_dst = e_route->gw_dst;
-    for (auto link : *e_route->link_list) {
-      res->link_list->push_back(link);
+    res->gw_src                  = e_route->gw_src;
+    res->gw_dst                  = e_route->gw_dst;
+    surf::LinkImpl* const* links = routingTable_.links(e_route);
+    for (uint32_t i = 0; i < e_route->size; i++) {
+      res->link_list->push_back(links[i]);
       if (lat)
-        *lat += link->latency();
+        *lat += links[i]->latency();
     }
   }
 }
@@ -82,23 +65,24 @@ void FullZone::addRoute(sg_platf_route_cbarg_t route)
   NetPoint* dst = route->dst;
   addRouteCheckParams(route);
 
-  size_t table_size = vertices_.size();
+  unsigned int table_size = vertices_.size();
 
-  if (not routingTable_)
-    routingTable_ = xbt_new0(sg_platf_route_cbarg_t, table_size * table_size);
+  if (not routingTable_.allocated())
+    routingTable_.allocate(table_size);
+  xbt_assert(routingTable_.size() == table_size, "Netzone %s got new points after its first route", getCname());
 
   /* Check that the route does not already exist */
   if (route->gw_dst) // inter-zone route (to adapt the error message, if any)
-    xbt_assert(nullptr == TO_ROUTE_FULL(src->id(), dst->id()),
+    xbt_assert(nullptr == routingTable_.get(src->id(), dst->id()),
                "The route between %s@%s and %s@%s already exists (Rq: routes are symmetrical by default).",
                src->cname(), route->gw_src->cname(), dst->cname(), route->gw_dst->cname());
   else
-    xbt_assert(nullptr == TO_ROUTE_FULL(src->id(), dst->id()),
+    xbt_assert(nullptr == routingTable_.get(src->id(), dst->id()),
                "The route between %s and %s already exists (Rq: routes are symmetrical by default).", src->cname(),
                dst->cname());
 
   /* Add the route to the base */
-  TO_ROUTE_FULL(src->id(), dst->id()) = newExtendedRoute(hierarchy_, route, true);
+  addExtendedRoute(src, dst, route, false);
 
   if (route->symmetrical == true && src != dst) {
     if (route->gw_dst && route->gw_src) {
@@ -108,17 +92,24 @@ void FullZone::addRoute(sg_platf_route_cbarg_t route)
     }
     if (route->gw_dst) // inter-zone route (to adapt the error message, if any)
       xbt_assert(
-          nullptr == TO_ROUTE_FULL(dst->id(), src->id()),
+          nullptr == routingTable_.get(dst->id(), src->id()),
           "The route between %s@%s and %s@%s already exists. You should not declare the reverse path as symmetrical.",
           dst->cname(), route->gw_dst->cname(), src->cname(), route->gw_src->cname());
     else
-      xbt_assert(nullptr == TO_ROUTE_FULL(dst->id(), src->id()),
+      xbt_assert(nullptr == routingTable_.get(dst->id(), src->id()),
                  "The route between %s and %s already exists. You should not declare the reverse path as symmetrical.",
                  dst->cname(), src->cname());
 
-    TO_ROUTE_FULL(dst->id(), src->id()) = newExtendedRoute(hierarchy_, route, false);
+    addExtendedRoute(dst, src, route, true);
   }
 }
+
+void FullZone::addExtendedRoute(NetPoint* src, NetPoint* dst, sg_platf_route_cbarg_t route, bool reverse)
+{
+  sg_platf_route_cbarg_t e_route = newExtendedRoute(hierarchy_, route, not reverse);
+  routingTable_.set(src->id(), dst->id(), e_route->gw_src, e_route->gw_dst, *e_route->link_list);
+  routing_route_free(e_route);
+}
 }
 }
 } // namespace
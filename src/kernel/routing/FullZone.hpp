@@ -7,6 +7,7 @@
 #define SIMGRID_ROUTING_FULL_HPP_
 
 #include "src/kernel/routing/RoutedZone.hpp"
+#include "src/kernel/routing/RoutingTable.hpp"
 
 namespace simgrid {
 namespace kernel {
@@ -18,6 +19,7 @@ namespace routing {
  *  The full communication matrix is provided at creation, so this model
  *  has the highest expressive power and the lowest computational requirements,
  *  but also the highest memory requirements (both in platform file and in memory).
+ *  In memory, the identical routes are only stored once (see RoutingTable).
  */
 class XBT_PRIVATE FullZone : public RoutedZone {
 public:
@@ -28,7 +30,10 @@ public:
   void getLocalRoute(NetPoint* src, NetPoint* dst, sg_platf_route_cbarg_t into, double* latency) override;
   void addRoute(sg_platf_route_cbarg_t route) override;
 
-  sg_platf_route_cbarg_t* routingTable_ = nullptr;
+private:
+  void addExtendedRoute(NetPoint* src, NetPoint* dst, sg_platf_route_cbarg_t route, bool reverse);
+
+  RoutingTable routingTable_;
 };
 }
 }
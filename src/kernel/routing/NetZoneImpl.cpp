@@ -9,11 +9,21 @@
 #include "src/kernel/routing/NetPoint.hpp"
 #include "src/surf/cpu_interface.hpp"
 #include "src/surf/network_interface.hpp"
+#include "surf/surf.h"
 
 #include "xbt/log.h"
 
+#include <algorithm>
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
 XBT_LOG_EXTERNAL_DEFAULT_CATEGORY(surf_route);
 
+int sg_route_cache_size   = 65536;
+int sg_route_cache_shards = 1;
+
 namespace simgrid {
 namespace kernel {
 namespace routing {
@@ -26,6 +36,102 @@ public:
   std::vector<surf::LinkImpl*> links;
 };
 
+/** @brief The routes computed by NetZoneImpl::getGlobalRoute(), with their latency
+ *
+ * At most sg_route_cache_size routes are kept, the least recently used ones being evicted first. The cache is split
+ * in sg_route_cache_shards independent parts (each with its own lock) to reduce the contention when actors running in
+ * parallel retrieve routes. The links of a route are immutable and shared with the callers, so that a hit does not copy
+ * them.
+ *
+ * The cache is configured once, when the platform is complete and before any actor runs: afterward, the set of shards
+ * does not change, and only the content of each shard is accessed (under its lock).
+ */
+class RouteCache {
+  typedef std::pair<NetPoint*, NetPoint*> Key;
+  struct KeyHash {
+    std::size_t operator()(const Key& key) const
+    {
+      return std::hash<NetPoint*>()(key.first) * 31 + std::hash<NetPoint*>()(key.second);
+    }
+  };
+  struct Route {
+    Key key;
+    std::shared_ptr<const std::vector<surf::LinkImpl*>> links;
+    double latency;
+  };
+  struct Shard {
+    std::mutex mutex;
+    std::list<Route> routes; // most recently used first
+    std::unordered_map<Key, std::list<Route>::iterator, KeyHash> index;
+  };
+
+public:
+  std::atomic<unsigned long long> hits{0};
+  std::atomic<unsigned long long> misses{0};
+
+  /** The links of the route from src to dst (and its latency), or nullptr if it is not cached */
+  std::shared_ptr<const std::vector<surf::LinkImpl*>> get(NetPoint* src, NetPoint* dst, double* latency)
+  {
+    Key key{src, dst};
+    Shard& shard = shardOf(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(key);
+    if (it == shard.index.end())
+      return nullptr;
+    shard.routes.splice(shard.routes.begin(), shard.routes, it->second);
+    *latency = it->second->latency;
+    return it->second->links;
+  }
+
+  /** Cache the route from src to dst, and return the links that are cached (another thread may have been faster) */
+  std::shared_ptr<const std::vector<surf::LinkImpl*>> put(NetPoint* src, NetPoint* dst,
+                                                          std::shared_ptr<const std::vector<surf::LinkImpl*>> links,
+                                                          double latency)
+  {
+    Key key{src, dst};
+    Shard& shard = shardOf(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(key);
+    if (it != shard.index.end())
+      return it->second->links;
+    if (shard.routes.size() >= capacity_) {
+      shard.index.erase(shard.routes.back().key);
+      shard.routes.pop_back();
+    }
+    shard.routes.push_front(Route{key, std::move(links), latency});
+    shard.index.insert({key, shard.routes.begin()});
+    return shard.routes.front().links;
+  }
+
+  void clear()
+  {
+    for (Shard& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      shard.routes.clear();
+      shard.index.clear();
+    }
+  }
+
+  /** Set the size of the cache (this drops the cached routes). Not thread-safe: only call it when no actor runs. */
+  void configure(std::size_t size, std::size_t shards)
+  {
+    if (shards != shards_.size())
+      shards_ = std::vector<Shard>(shards);
+    else
+      clear();
+    capacity_ = std::max<std::size_t>(1, size / shards);
+  }
+
+private:
+  Shard& shardOf(const Key& key) { return shards_[KeyHash()(key) % shards_.size()]; }
+
+  std::vector<Shard> shards_;
+  std::size_t capacity_ = 0; // per shard
+};
+
+static RouteCache route_cache;
+static bool route_cache_enabled = false; // Only changed when no actor runs, as the configuration of route_cache
+
 NetZoneImpl::NetZoneImpl(NetZone* father, const char* name) : NetZone(father, name)
 {
   xbt_assert(nullptr == simgrid::s4u::Engine::getInstance()->getNetpointByNameOrNull(name),
@@ -292,14 +398,14 @@ bool NetZoneImpl::getBypassRoute(routing::NetPoint* src, routing::NetPoint* dst,
               "calls to getRoute",
               src->cname(), dst->cname(), bypassedRoute->links.size());
     if (src != key.first)
-      getGlobalRoute(src, bypassedRoute->gw_src, links, latency);
+      computeGlobalRoute(src, bypassedRoute->gw_src, links, latency);
     for (surf::LinkImpl* link : bypassedRoute->links) {
       links->push_back(link);
       if (latency)
         *latency += link->latency();
     }
     if (dst != key.second)
-      getGlobalRoute(bypassedRoute->gw_dst, dst, links, latency);
+      computeGlobalRoute(bypassedRoute->gw_dst, dst, links, latency);
     return true;
   }
   XBT_DEBUG("No bypass route from '%s' to '%s'.", src->cname(), dst->cname());
@@ -308,6 +414,67 @@ bool NetZoneImpl::getBypassRoute(routing::NetPoint* src, routing::NetPoint* dst,
 
 void NetZoneImpl::getGlobalRoute(routing::NetPoint* src, routing::NetPoint* dst,
                                  /* OUT */ std::vector<surf::LinkImpl*>* links, double* latency)
+{
+  /* Leave the accumulators that are already in use to the computation, so that the latencies are summed exactly in
+   * the same order with or without the cache. */
+  if (not route_cache_enabled || not links->empty() || (latency != nullptr && *latency != 0.0)) {
+    computeGlobalRoute(src, dst, links, latency);
+    return;
+  }
+
+  std::shared_ptr<const std::vector<surf::LinkImpl*>> route = getGlobalRoute(src, dst, latency);
+  links->insert(links->end(), route->begin(), route->end());
+}
+
+std::shared_ptr<const std::vector<surf::LinkImpl*>> NetZoneImpl::getGlobalRoute(routing::NetPoint* src,
+                                                                                 routing::NetPoint* dst,
+                                                                                 /* OUT */ double* latency)
+{
+  if (not route_cache_enabled) {
+    std::shared_ptr<std::vector<surf::LinkImpl*>> links = std::make_shared<std::vector<surf::LinkImpl*>>();
+    computeGlobalRoute(src, dst, links.get(), latency);
+    return links;
+  }
+
+  double route_latency = 0.0;
+  std::shared_ptr<const std::vector<surf::LinkImpl*>> links = route_cache.get(src, dst, &route_latency);
+  if (links) {
+    route_cache.hits++;
+  } else {
+    route_cache.misses++;
+    std::shared_ptr<std::vector<surf::LinkImpl*>> computed = std::make_shared<std::vector<surf::LinkImpl*>>();
+    computeGlobalRoute(src, dst, computed.get(), &route_latency);
+    links = route_cache.put(src, dst, std::move(computed), route_latency);
+  }
+  if (latency)
+    *latency += route_latency;
+  return links;
+}
+
+void NetZoneImpl::enableRouteCache()
+{
+  route_cache_enabled = sg_route_cache_size > 0;
+  if (route_cache_enabled)
+    route_cache.configure(sg_route_cache_size, std::max(1, sg_route_cache_shards));
+}
+
+void NetZoneImpl::invalidateRouteCache()
+{
+  route_cache.clear();
+}
+
+unsigned long long NetZoneImpl::routeCacheHits()
+{
+  return route_cache.hits;
+}
+
+unsigned long long NetZoneImpl::routeCacheMisses()
+{
+  return route_cache.misses;
+}
+
+void NetZoneImpl::computeGlobalRoute(routing::NetPoint* src, routing::NetPoint* dst,
+                                     /* OUT */ std::vector<surf::LinkImpl*>* links, double* latency)
 {
   s_sg_platf_route_cbarg_t route;
   memset(&route, 0, sizeof(route));
@@ -343,14 +510,14 @@ void NetZoneImpl::getGlobalRoute(routing::NetPoint* src, routing::NetPoint* dst,
 
   /* If source gateway is not our source, we have to recursively find our way up to this point */
   if (src != route.gw_src)
-    getGlobalRoute(src, route.gw_src, links, latency);
+    computeGlobalRoute(src, route.gw_src, links, latency);
   for (auto link : *route.link_list)
     links->push_back(link);
   delete route.link_list;
 
   /* If dest gateway is not our destination, we have to recursively find our way from this point */
   if (route.gw_dst != dst)
-    getGlobalRoute(route.gw_dst, dst, links, latency);
+    computeGlobalRoute(route.gw_dst, dst, links, latency);
 }
 }
 }
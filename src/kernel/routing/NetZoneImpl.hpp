@@ -7,6 +7,8 @@
 #define SIMGRID_ROUTING_NETZONEIMPL_HPP
 
 #include <map>
+#include <memory>
+#include <vector>
 
 #include "xbt/graph.h"
 
@@ -88,6 +90,28 @@ public:
    */
   static void getGlobalRoute(routing::NetPoint * src, routing::NetPoint * dst,
                              /* OUT */ std::vector<surf::LinkImpl*> * links, double* latency);
+  /* @brief get the route between two nodes in the full platform, without copying it out of the route cache
+   *
+   * @param src where from
+   * @param dst where to
+   * @param latency Accumulator in which the latencies should be added (caller must set it to 0)
+   * @return The links of the route, which must not be modified as they may be shared with the route cache
+   */
+  static std::shared_ptr<const std::vector<surf::LinkImpl*>> getGlobalRoute(routing::NetPoint * src,
+                                                                            routing::NetPoint * dst,
+                                                                            /* OUT */ double* latency);
+
+  /** @brief Start caching the routes computed by getGlobalRoute(), once the platform is complete.
+   *
+   * The network/route-cache and network/route-cache-shards options are read here, so they must be set before the
+   * platform is loaded. No actor may run while this is called. */
+  static void enableRouteCache();
+  /** @brief Forget the routes cached by getGlobalRoute(), to be called when the platform changes */
+  static void invalidateRouteCache();
+  /** @brief Amount of routes that getGlobalRoute() found in its cache */
+  static unsigned long long routeCacheHits();
+  /** @brief Amount of routes that getGlobalRoute() had to compute (and then cached) */
+  static unsigned long long routeCacheMisses();
 
   virtual void getGraph(xbt_graph_t graph, xbt_dict_t nodes, xbt_dict_t edges) = 0;
   enum class RoutingMode {
@@ -99,6 +123,9 @@ public:
   RoutingMode hierarchy_ = RoutingMode::unset;
 
 private:
+  static void computeGlobalRoute(routing::NetPoint * src, routing::NetPoint * dst,
+                                 /* OUT */ std::vector<surf::LinkImpl*> * links, double* latency);
+
   std::map<std::pair<NetPoint*, NetPoint*>, BypassRoute*> bypassRoutes_; // src x dst -> route
   routing::NetPoint* netpoint_ = nullptr;                                // Our representative in the father NetZone
 };
@@ -0,0 +1,73 @@
+/* Copyright (c) 2017. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#include "src/kernel/routing/RoutingTable.hpp"
+#include "xbt/asserts.h"
+
+#include <limits>
+
+namespace simgrid {
+namespace kernel {
+namespace routing {
+
+void RoutingTable::allocate(unsigned int size)
+{
+  xbt_assert(not allocated_, "The routing table is already allocated");
+  allocated_ = true;
+  size_      = size;
+  ids_.assign(static_cast<std::size_t>(size) * size, 0);
+}
+
+void RoutingTable::set(unsigned int src, unsigned int dst, NetPoint* gw_src, NetPoint* gw_dst,
+                       const std::vector<surf::LinkImpl*>& links)
+{
+  /* Intern the links */
+  auto seq = sequences_.find(links);
+  uint32_t first;
+  if (seq != sequences_.end()) {
+    first = seq->second;
+  } else {
+    xbt_assert(links_.size() + links.size() < std::numeric_limits<uint32_t>::max(), "Too many links in the routes");
+    first = static_cast<uint32_t>(links_.size());
+    links_.insert(links_.end(), links.begin(), links.end());
+    sequences_.insert({links, first});
+  }
+
+  /* Intern the route */
+  RouteKey key{gw_src, gw_dst, first, static_cast<uint32_t>(links.size())};
+  auto route = routeIds_.find(key);
+  uint32_t id;
+  if (route != routeIds_.end()) {
+    id = route->second;
+  } else {
+    xbt_assert(routes_.size() < std::numeric_limits<uint32_t>::max() - 1, "Too many routes");
+    routes_.push_back(Route{gw_src, gw_dst, first, static_cast<uint32_t>(links.size())});
+    id = static_cast<uint32_t>(routes_.size());
+    routeIds_.insert({key, id});
+  }
+  ids_[src + static_cast<std::size_t>(dst) * size_] = id;
+}
+
+void RoutingTable::compact()
+{
+  sequences_ = decltype(sequences_)();
+  routeIds_  = decltype(routeIds_)();
+  routes_.shrink_to_fit();
+  links_.shrink_to_fit();
+}
+
+std::size_t RoutingTable::memoryUsage() const
+{
+  std::size_t res = ids_.capacity() * sizeof(uint32_t) + routes_.capacity() * sizeof(Route) +
+                    links_.capacity() * sizeof(surf::LinkImpl*);
+  /* Rough estimate of the interning maps: one node and one bucket per entry */
+  for (auto const& kv : sequences_)
+    res += sizeof(kv) + 2 * sizeof(void*) + kv.first.capacity() * sizeof(surf::LinkImpl*);
+  res += routeIds_.size() * (sizeof(RouteKey) + sizeof(uint32_t) + 2 * sizeof(void*));
+  return res;
+}
+}
+}
+} // namespace
@@ -0,0 +1,81 @@
+/* Copyright (c) 2017. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#ifndef SIMGRID_ROUTING_TABLE_HPP_
+#define SIMGRID_ROUTING_TABLE_HPP_
+
+#include <cstdint>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/functional/hash.hpp>
+
+#include "simgrid/forward.h"
+
+namespace simgrid {
+namespace kernel {
+namespace routing {
+
+/** @ingroup ROUTING_API
+ *  @brief Compact storage of the routes between all pairs of points of a netzone
+ *
+ *  Each pair of points only costs a 32-bit route identifier (0 when there is no route). The routes are interned: the
+ *  pairs having the same gateways and links share the same route, and the routes having the same links share the
+ *  same slice of a single array of links. The interning maps are released by compact(), once the netzone is sealed.
+ */
+class XBT_PRIVATE RoutingTable {
+public:
+  struct Route {
+    NetPoint* gw_src;
+    NetPoint* gw_dst;
+    uint32_t first; /* position of the first link in the array of links */
+    uint32_t size;  /* amount of links */
+  };
+
+  /** Amount of points, the table having a route slot for each pair of them */
+  unsigned int size() const { return size_; }
+  /** Whether allocate() was called */
+  bool allocated() const { return allocated_; }
+  /** Allocate the route slots of the given amount of points (only once) */
+  void allocate(unsigned int size);
+
+  /** The route from src to dst, or nullptr if none */
+  const Route* get(unsigned int src, unsigned int dst) const
+  {
+    uint32_t id = ids_[src + static_cast<std::size_t>(dst) * size_];
+    return id ? &routes_[id - 1] : nullptr;
+  }
+  /** The links of a route (there are route->size of them) */
+  surf::LinkImpl* const* links(const Route* route) const { return links_.data() + route->first; }
+
+  /** Store the route from src to dst */
+  void set(unsigned int src, unsigned int dst, NetPoint* gw_src, NetPoint* gw_dst,
+           const std::vector<surf::LinkImpl*>& links);
+
+  /** Release the memory used to intern the routes. The next routes will not be shared with the previous ones. */
+  void compact();
+
+  /** Amount of distinct routes */
+  std::size_t routeCount() const { return routes_.size(); }
+  /** Amount of bytes used by the table */
+  std::size_t memoryUsage() const;
+
+private:
+  typedef std::tuple<NetPoint*, NetPoint*, uint32_t, uint32_t> RouteKey;
+
+  unsigned int size_ = 0;
+  bool allocated_    = false;
+  std::vector<uint32_t> ids_;          /* route identifier of each pair (src + dst * size_), 0 if none */
+  std::vector<Route> routes_;          /* the route of identifier i is at position i-1 */
+  std::vector<surf::LinkImpl*> links_; /* the links of all routes */
+  std::unordered_map<std::vector<surf::LinkImpl*>, uint32_t, boost::hash<std::vector<surf::LinkImpl*>>> sequences_;
+  std::unordered_map<RouteKey, uint32_t, boost::hash<RouteKey>> routeIds_;
+};
+}
+}
+} // namespaces
+
+#endif /* SIMGRID_ROUTING_TABLE_HPP_ */
@@ -95,6 +95,13 @@ public:
   static constexpr ReadOptions lazy() { return ReadOptions(1); }
 };
 
+/** A read of a scatter/gather read (see AddressSpace::read_bytes_v) */
+struct ReadRequest {
+  void* buffer;
+  std::size_t size;
+  RemotePtr<void> address;
+};
+
 /** A given state of a given process (abstract base class)
  *
  *  Currently, this might either be:
@@ -132,6 +139,23 @@ public:
     RemotePtr<void> address, int process_index = ProcessIndexAny,
     ReadOptions options = ReadOptions::none()) const = 0;
 
+  /** Read several blocks of data from the address space
+   *
+   *  This is the same as calling read_bytes() for each request, but the
+   *  implementation can read all of them at once (one syscall for the
+   *  current state of a process).
+   *
+   *  @param requests      target buffers, sizes and remote addresses of the data
+   *  @param count         number of requests
+   *  @param process_index which process (used for SMPI privatization)
+   */
+  virtual void read_bytes_v(ReadRequest const* requests, std::size_t count,
+    int process_index = ProcessIndexAny) const
+  {
+    for (std::size_t i = 0; i != count; ++i)
+      this->read_bytes(requests[i].buffer, requests[i].size, requests[i].address, process_index);
+  }
+
   /** Read a given data structure from the address space */
   template<class T> inline
   void read(T *buffer, RemotePtr<T> ptr, int process_index = ProcessIndexAny) const
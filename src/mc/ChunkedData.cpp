@@ -6,6 +6,7 @@
 #include <cstddef>
 #include <cstdint>
 
+#include <algorithm>
 #include <vector>
 
 #include "xbt/asserts.h"
@@ -19,39 +20,64 @@ namespace simgrid {
 namespace mc {
 
 /** Take a per-page snapshot of a region
+ *
+ *  With soft-dirty tracking, the pages which were not written since the
+ *  reference snapshot was taken (or restored) are not read again: the
+ *  reference is shared instead.
  *
  *  @param addr            The start of the region (must be at the beginning of a page)
  *  @param page_count      Number of pages of the region
+ *  @param reference       Snapshot of the same region to share the clean pages with (or nullptr)
+ *  @param pagemap         Pagemap entries of the pages of the region (or nullptr)
  *  @return                Snapshot page numbers of this new snapshot
  */
 ChunkedData::ChunkedData(PageStore& store, AddressSpace& as,
-    RemotePtr<void> addr, std::size_t page_count)
+    RemotePtr<void> addr, std::size_t page_count,
+    ChunkedData const* reference, const std::uint64_t* pagemap)
 {
   store_ = &store;
   this->pagenos_.resize(page_count);
-  std::vector<char> buffer(xbt_pagesize);
-
-  for (size_t i = 0; i != page_count; ++i) {
-
-      RemotePtr<void> page = remote((void*)
-        simgrid::mc::mmu::join(i, addr.address()));
-      xbt_assert(simgrid::mc::mmu::split(page.address()).second == 0,
-        "Not at the beginning of a page");
+  xbt_assert(simgrid::mc::mmu::split(addr.address()).second == 0,
+    "Not at the beginning of a page");
+  xbt_assert(reference == nullptr || reference->store_ == store_,
+    "The reference snapshot is in another page store");
 
-        /* Adding another copy (and a syscall) will probably slow things a lot.
-           TODO, optimize this somehow (at least by grouping the syscalls)
-           if needed. Either:
-            - reduce the number of syscalls;
-            - let the application snapshot itself;
-            - move the segments in shared memory (this will break `fork` however).
-        */
+  auto clean = [reference, pagemap](std::size_t i) {
+    return reference && pagemap && i < reference->page_count()
+      && not (pagemap[i] & simgrid::mc::mmu::soft_dirty);
+  };
 
-        as.read_bytes(
-          buffer.data(), xbt_pagesize, page,
-          simgrid::mc::ProcessIndexDisabled);
+  // The pages to read are grouped in order to save syscalls: each batch
+  // is read at once, as one request per run of contiguous pages.
+  const std::size_t max_pages = 64;
+  std::vector<char> buffer(std::min(max_pages, page_count) * xbt_pagesize);
+  std::vector<std::size_t> batch;
+  std::vector<ReadRequest> requests;
 
-      pagenos_[i] = store_->store_page(buffer.data());
+  std::size_t i = 0;
+  while (i != page_count) {
+    batch.clear();
+    requests.clear();
+    for (; i != page_count && batch.size() != max_pages; ++i) {
+      if (clean(i)) {
+        pagenos_[i] = reference->pagenos_[i];
+        store_->ref_page(pagenos_[i]);
+        continue;
+      }
+      char* target = buffer.data() + batch.size() * xbt_pagesize;
+      RemotePtr<void> page = remote((void*) simgrid::mc::mmu::join(i, addr.address()));
+      if (not batch.empty() && batch.back() == i - 1)
+        requests.back().size += xbt_pagesize;
+      else
+        requests.push_back({target, (std::size_t) xbt_pagesize, page});
+      batch.push_back(i);
+    }
+    if (batch.empty())
+      continue;
 
+    as.read_bytes_v(requests.data(), requests.size(), simgrid::mc::ProcessIndexDisabled);
+    for (std::size_t j = 0; j != batch.size(); ++j)
+      pagenos_[batch[j]] = store_->store_page(buffer.data() + j * xbt_pagesize);
   }
 }
 
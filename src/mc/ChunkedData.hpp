@@ -91,6 +91,12 @@ public:
   /** Get a view of the chunk indices */
   const std::size_t* pagenos()      const { return pagenos_.data(); }
 
+  /** Get the hash of a chunk, as computed by the `PageStore` */
+  PageStore::hash_type page_hash(std::size_t i) const
+  {
+    return store_->get_hash(pagenos_[i]);
+  }
+
   /** Get a a pointer to a chunk */
   const void* page(std::size_t i) const
   {
@@ -98,7 +104,8 @@ public:
   }
 
   ChunkedData(PageStore& store, AddressSpace& as,
-    RemotePtr<void> addr, std::size_t page_count);
+    RemotePtr<void> addr, std::size_t page_count,
+    ChunkedData const* reference = nullptr, const std::uint64_t* pagemap = nullptr);
 };
 
 }
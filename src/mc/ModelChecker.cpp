@@ -275,6 +275,8 @@ bool ModelChecker::handle_message(char* buffer, ssize_t size)
     }
 
   case MC_MESSAGE_WAITING:
+    // Forget what was read while the application was running:
+    this->process().clear_cache();
     return false;
 
   case MC_MESSAGE_ASSERTION_FAILED:
@@ -293,6 +295,8 @@ bool ModelChecker::handle_message(char* buffer, ssize_t size)
 void ModelChecker::exit(int status)
 {
   // TODO, terminate the model checker politely instead of exiting rudely
+  if (exitHandler_)
+    exitHandler_(status);
   if (process().running())
     kill(process().pid(), SIGKILL);
   ::exit(status);
@@ -423,6 +427,7 @@ bool ModelChecker::checkDeadlock()
       MC_message_type_name(message.type), (int) message.type, (int) s,
       (int) MC_MESSAGE_DEADLOCK_CHECK_REPLY, (int) sizeof(message)
       );
+  this->process().clear_cache();
   return message.value != 0;
 }
 
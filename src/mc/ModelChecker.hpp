@@ -9,6 +9,7 @@
 
 #include <sys/types.h>
 
+#include <functional>
 #include <memory>
 #include <set>
 #include <string>
@@ -40,6 +41,7 @@ class ModelChecker {
   PageStore page_store_;
   std::unique_ptr<Process> process_;
   Checker* checker_ = nullptr;
+  std::function<void(int status)> exitHandler_;
 public:
   std::shared_ptr<simgrid::mc::Snapshot> parent_snapshot_;
 
@@ -79,6 +81,8 @@ public:
     mc_model_checker->wait_client(mc_model_checker->process());
   }
   void exit(int status);
+  /** Code called before exiting on a property violation (parallel exploration) */
+  void onExit(std::function<void(int status)> handler) { exitHandler_ = std::move(handler); }
 
   bool checkDeadlock();
 
@@ -94,6 +98,8 @@ private:
 public:
   unsigned long visited_states = 0;
   unsigned long executed_transitions = 0;
+  unsigned long state_comparisons = 0;   // calls to snapshot_compare() by the visited states
+  unsigned long avoided_comparisons = 0; // the ones skipped thanks to the state fingerprints
 };
 
 }
@@ -64,6 +64,7 @@ PageStore::PageStore(size_t size) :
   this->capacity_ = size;
   this->memory_ = memory;
   this->page_counts_.resize(size);
+  this->page_hashes_.resize(size);
 }
 
 PageStore::~PageStore()
@@ -119,6 +120,7 @@ void PageStore::resize(std::size_t size)
   this->capacity_ = size;
   this->memory_ = new_memory;
   this->page_counts_.resize(size, 0);
+  this->page_hashes_.resize(size, 0);
 }
 
 /** Allocate a free page
@@ -150,9 +152,7 @@ std::size_t PageStore::alloc_page()
 void PageStore::remove_page(std::size_t pageno)
 {
   this->free_pages_.push_back(pageno);
-  const void* page = this->get_page(pageno);
-  hash_type hash = mc_hash_page(page);
-  this->hash_index_[hash].erase(pageno);
+  this->hash_index_[this->page_hashes_[pageno]].erase(pageno);
 }
 
 /** Store a page in memory */
@@ -188,6 +188,7 @@ std::size_t PageStore::store_page(void* page)
   void* snapshot_page = (void*) this->get_page(pageno);
   memcpy(snapshot_page, page, xbt_pagesize);
   page_set.insert(pageno);
+  page_hashes_[pageno] = hash;
   page_counts_[pageno]++;
   return pageno;
 }
@@ -244,12 +245,14 @@ XBT_TEST_UNIT("base", test_mc_page_store, "Test adding/removing pages in the sto
   size_t pageno2 = store->store_page(data);
   xbt_test_assert(pageno1==pageno2, "Page should be the same");
   xbt_test_assert(store->get_ref(pageno1)==2, "Bad refcount");
+  xbt_test_assert(store->get_hash(pageno1)==store->get_hash(pageno2), "Bad hash");
   xbt_test_assert(store->size()==1, "Bad size");
 
   xbt_test_add("Store a new page");
   new_content(data, pagesize);
   size_t pageno3 = store->store_page(data);
   xbt_test_assert(pageno1 != pageno3, "New page should be different");
+  xbt_test_assert(store->get_hash(pageno1) != store->get_hash(pageno3), "Bad hash");
   xbt_test_assert(store->size()==2, "Bad size");
 
   xbt_test_add("Unref pages");
@@ -91,6 +91,8 @@ private: // Fields:
   std::size_t top_index_;
   /** Page reference count */
   std::vector<std::uint64_t> page_counts_;
+  /** Hash of each page */
+  std::vector<hash_type> page_hashes_;
   /** Index of available pages before the top */
   std::vector<std::size_t> free_pages_;
   /** Index from page hash to page index */
@@ -141,6 +143,13 @@ public: // Methods
    */
   const void* get_page(std::size_t pageno) const;
 
+  /** @brief Get the hash of a page from its page number
+   *
+   *  This is the hash computed when the page was stored: it can be used
+   *  to fingerprint the snapshots without reading the pages again.
+   */
+  hash_type get_hash(std::size_t pageno) const;
+
 public: // Debug/test methods
 
   /** @brief Get the number of references for a page */
@@ -173,6 +182,11 @@ XBT_ALWAYS_INLINE const void* PageStore::get_page(std::size_t pageno) const
   return (void*) simgrid::mc::mmu::join(pageno, (std::uintptr_t) this->memory_);
 }
 
+XBT_ALWAYS_INLINE PageStore::hash_type PageStore::get_hash(std::size_t pageno) const
+{
+  return this->page_hashes_[pageno];
+}
+
 XBT_ALWAYS_INLINE std::size_t PageStore::get_ref(std::size_t pageno)
 {
   return this->page_counts_[pageno];
@@ -6,12 +6,15 @@
 #define _FILE_OFFSET_BITS 64 /* needed for pread_whole to work as expected on 32bits */
 
 #include <assert.h>
+#include <limits.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <errno.h>
 
 #include <sys/ptrace.h>
+#include <sys/uio.h>
 
+#include <algorithm>
 #include <cstdio>
 
 #include <sys/types.h>
@@ -27,15 +30,18 @@
 #include <libunwind.h>
 #include <libunwind-ptrace.h>
 
+#include "src/internal_config.h"
 #include "xbt/base.h"
 #include "xbt/log.h"
 #include <xbt/mmalloc.h>
+#include <mc/mc.h>
 
 #include "src/mc/mc_unw.h"
 #include "src/mc/mc_snapshot.h"
 #include "src/mc/mc_smx.h"
 
 #include "src/mc/Process.hpp"
+#include "src/mc/mc_mmu.h"
 #include "src/mc/AddressSpace.hpp"
 #include "src/mc/ObjectInformation.hpp"
 #include "src/mc/Variable.hpp"
@@ -194,6 +200,46 @@ static void zero_buffer_init()
   close(fd);
 }
 
+static int open_proc_file(pid_t pid, const char* file, int flags)
+{
+  const size_t buffer_size = 50;
+  char buffer[buffer_size];
+  int res = snprintf(buffer, buffer_size, "/proc/%lli/%s", (long long) pid, file);
+  if (res < 0 || (size_t) res >= buffer_size) {
+    errno = ENAMETOOLONG;
+    return -1;
+  }
+  return open(buffer, flags);
+}
+
+/** Check on a page of our own that the kernel tracks the soft-dirty bits (CONFIG_MEM_SOFT_DIRTY)
+ *
+ *  Otherwise, the pages would always look clean and the snapshots would be wrong.
+ */
+static bool soft_dirty_supported()
+{
+  int clear_refs = open("/proc/self/clear_refs", O_WRONLY | O_CLOEXEC);
+  int pagemap    = open("/proc/self/pagemap", O_RDONLY | O_CLOEXEC);
+  void* page     = mmap(nullptr, xbt_pagesize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  bool res       = false;
+  if (clear_refs >= 0 && pagemap >= 0 && page != MAP_FAILED) {
+    *(volatile char*)page = 1;
+    std::uint64_t entry;
+    if (write(clear_refs, "4\n", 2) == 2) {
+      *(volatile char*)page = 2;
+      off_t offset = sizeof(entry) * ((std::uintptr_t)page >> xbt_pagebits);
+      res = pread_whole(pagemap, &entry, sizeof(entry), offset) == sizeof(entry) && (entry & simgrid::mc::mmu::soft_dirty);
+    }
+  }
+  if (page != MAP_FAILED)
+    munmap(page, xbt_pagesize);
+  if (clear_refs >= 0)
+    close(clear_refs);
+  if (pagemap >= 0)
+    close(pagemap);
+  return res;
+}
+
 int open_vm(pid_t pid, int flags)
 {
   const size_t buffer_size = 30;
@@ -232,6 +278,11 @@ void Process::init()
     remote(std_heap_var->address),
     simgrid::mc::ProcessIndexDisabled);
 
+  if (_sg_mc_soft_dirty && not soft_dirty_supported()) {
+    XBT_WARN("The kernel does not track the soft-dirty bits of the pages: model-check/soft-dirty is disabled.");
+    _sg_mc_soft_dirty = 0;
+  }
+
   this->smx_actors_infos.clear();
   this->smx_dead_actors_infos.clear();
   this->unw_addr_space = simgrid::mc::UnwindContext::createUnwindAddressSpace();
@@ -244,6 +295,10 @@ Process::~Process()
 {
   if (this->memory_file >= 0)
     close(this->memory_file);
+  if (this->clear_refs_fd_ >= 0)
+    close(this->clear_refs_fd_);
+  if (this->pagemap_fd_ >= 0)
+    close(this->pagemap_fd_);
 
   if (this->unw_underlying_addr_space != unw_local_addr_space) {
     if (this->unw_underlying_addr_space)
@@ -468,9 +523,8 @@ std::string Process::read_string(RemotePtr<char> address) const
   }
 }
 
-const void *Process::read_bytes(void* buffer, std::size_t size,
-  RemotePtr<void> address, int process_index,
-  ReadOptions options) const
+/** Address of some data of the given SMPI process in the privatization segment */
+RemotePtr<void> Process::privatized_address(RemotePtr<void> address, int process_index) const
 {
   if (process_index != simgrid::mc::ProcessIndexDisabled) {
     std::shared_ptr<simgrid::mc::ObjectInformation> const& info =
@@ -498,11 +552,135 @@ const void *Process::read_bytes(void* buffer, std::size_t size,
     }
 #endif
   }
-  if (pread_whole(this->memory_file, buffer, size, (size_t) address.address()) < 0)
+  return address;
+}
+
+/** Read some blocks of the memory of the application
+ *
+ *  They are read with a single process_vm_readv() when possible, and with
+ *  /proc/pid/mem otherwise: process_vm_readv() cannot read the protected
+ *  pages, and it is not available on all systems.
+ */
+bool Process::read_memory(ReadRequest const* requests, std::size_t count) const
+{
+  std::size_t i = 0;
+#if HAVE_PROCESS_VM_READV
+  while (this->vm_readv_ && i != count) {
+    struct iovec local[IOV_MAX];
+    struct iovec remote[IOV_MAX];
+    std::size_t n = std::min<std::size_t>(count - i, IOV_MAX);
+    ssize_t size = 0;
+    for (std::size_t j = 0; j != n; ++j) {
+      local[j].iov_base  = requests[i + j].buffer;
+      local[j].iov_len   = requests[i + j].size;
+      remote[j].iov_base = (void*)requests[i + j].address.address();
+      remote[j].iov_len  = requests[i + j].size;
+      size += requests[i + j].size;
+    }
+    ssize_t res = process_vm_readv(this->pid_, local, n, remote, n, 0);
+    if (res == size) {
+      i += n;
+      continue;
+    }
+    if (res < 0 && (errno == ENOSYS || errno == EPERM)) {
+      XBT_DEBUG("process_vm_readv() is not available, reading /proc/%lli/mem instead", (long long)this->pid_);
+      this->vm_readv_ = false;
+    }
+    break;
+  }
+#endif
+  for (; i != count; ++i)
+    if (pread_whole(this->memory_file, requests[i].buffer, requests[i].size,
+                    (off_t)requests[i].address.address()) < 0)
+      return false;
+  return true;
+}
+
+/** Get a page of the application from the page cache, reading it if needed
+ *
+ *  @return the content of the page, or nullptr if it cannot be read
+ */
+const char* Process::cached_page(std::uint64_t pageno) const
+{
+  std::size_t slot = pageno % page_cache_size;
+  if (this->page_cache_.empty())
+    this->page_cache_.resize(page_cache_size * xbt_pagesize);
+  char* page = this->page_cache_.data() + slot * xbt_pagesize;
+  if (this->page_cache_tags_[slot] == pageno + 1)
+    return page;
+
+  ReadRequest request = {page, (std::size_t) xbt_pagesize, remote(simgrid::mc::mmu::join(pageno, 0))};
+  if (not this->read_memory(&request, 1)) {
+    this->page_cache_tags_[slot] = 0;
+    return nullptr;
+  }
+  this->page_cache_tags_[slot] = pageno + 1;
+  return page;
+}
+
+void Process::clear_page_cache() const
+{
+  std::lock_guard<std::mutex> lock(this->page_cache_mutex_);
+  std::fill_n(this->page_cache_tags_, page_cache_size, 0);
+}
+
+/** Forget the cached pages overlapping the given area */
+void Process::clear_page_cache(RemotePtr<void> address, std::size_t size) const
+{
+  if (size == 0)
+    return;
+  std::uint64_t first = simgrid::mc::mmu::split(address.address()).first;
+  std::uint64_t last  = simgrid::mc::mmu::split(address.address() + size - 1).first;
+  std::lock_guard<std::mutex> lock(this->page_cache_mutex_);
+  if (last - first >= page_cache_size) {
+    std::fill_n(this->page_cache_tags_, page_cache_size, 0);
+    return;
+  }
+  for (std::uint64_t pageno = first; pageno <= last; ++pageno)
+    if (this->page_cache_tags_[pageno % page_cache_size] == pageno + 1)
+      this->page_cache_tags_[pageno % page_cache_size] = 0;
+}
+
+const void *Process::read_bytes(void* buffer, std::size_t size,
+  RemotePtr<void> address, int process_index,
+  ReadOptions options) const
+{
+  address = this->privatized_address(address, process_index);
+
+  // The small reads go through the page cache:
+  if (size < (std::size_t) xbt_pagesize) {
+    std::lock_guard<std::mutex> lock(this->page_cache_mutex_);
+    char* target = (char*) buffer;
+    std::uint64_t addr = address.address();
+    while (size) {
+      std::pair<std::size_t, std::uintptr_t> split = simgrid::mc::mmu::split(addr);
+      std::size_t n = std::min<std::size_t>(size, xbt_pagesize - split.second);
+      const char* page = this->cached_page(split.first);
+      if (page == nullptr)
+        xbt_die("Read at %p from process %lli failed", (void*)addr, (long long)this->pid_);
+      memcpy(target, page + split.second, n);
+      target += n;
+      addr += n;
+      size -= n;
+    }
+    return buffer;
+  }
+
+  ReadRequest request = {buffer, size, address};
+  if (not this->read_memory(&request, 1))
     xbt_die("Read at %p from process %lli failed", (void*)address.address(), (long long)this->pid_);
   return buffer;
 }
 
+void Process::read_bytes_v(ReadRequest const* requests, std::size_t count, int process_index) const
+{
+  std::vector<ReadRequest> translated(requests, requests + count);
+  for (ReadRequest& request : translated)
+    request.address = this->privatized_address(request.address, process_index);
+  if (not this->read_memory(translated.data(), translated.size()))
+    xbt_die("Read from process %lli failed", (long long)this->pid_);
+}
+
 /** Write data to a process memory
  *
  *  @param buffer   local memory address (source)
@@ -511,6 +689,7 @@ const void *Process::read_bytes(void* buffer, std::size_t size,
  */
 void Process::write_bytes(const void* buffer, size_t len, RemotePtr<void> address)
 {
+  this->clear_page_cache(address, len);
   if (pwrite_whole(this->memory_file, buffer, len,  (size_t)address.address()) < 0)
     xbt_die("Write to process %lli failed", (long long) this->pid_);
 }
@@ -526,6 +705,39 @@ void Process::clear_bytes(RemotePtr<void> address, size_t len)
   }
 }
 
+/** Clear the soft-dirty bits of all the pages of the process
+ *
+ *  The pages written afterwards get their soft-dirty bit set again in the pagemap.
+ */
+void Process::reset_soft_dirty()
+{
+  if (this->clear_refs_fd_ < 0) {
+    this->clear_refs_fd_ = open_proc_file(this->pid_, "clear_refs", O_WRONLY | O_CLOEXEC);
+    if (this->clear_refs_fd_ < 0)
+      xbt_die("Could not open the clear_refs file of process %lli for soft-dirty tracking", (long long)this->pid_);
+  }
+  if (::write(this->clear_refs_fd_, "4\n", 2) != 2)
+    xbt_die("Could not reset the soft-dirty bits of process %lli", (long long)this->pid_);
+}
+
+/** Read the pagemap entries of some pages of the process
+ *
+ *  @param pagemap     buffer of page_count entries
+ *  @param start_page  page number (address >> xbt_pagebits) of the first page
+ *  @param page_count  number of pages
+ */
+void Process::read_pagemap(std::uint64_t* pagemap, std::size_t start_page, std::size_t page_count)
+{
+  if (this->pagemap_fd_ < 0) {
+    this->pagemap_fd_ = open_proc_file(this->pid_, "pagemap", O_RDONLY | O_CLOEXEC);
+    if (this->pagemap_fd_ < 0)
+      xbt_die("Could not open the pagemap file of process %lli for soft-dirty tracking", (long long)this->pid_);
+  }
+  ssize_t size = sizeof(std::uint64_t) * page_count;
+  if (pread_whole(this->pagemap_fd_, pagemap, size, sizeof(std::uint64_t) * start_page) != size)
+    xbt_die("Could not read the pagemap of process %lli", (long long)this->pid_);
+}
+
 void Process::ignore_region(std::uint64_t addr, std::size_t size)
 {
   IgnoredRegion region;
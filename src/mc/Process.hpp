@@ -13,6 +13,7 @@
 #include <type_traits>
 #include <vector>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include <sys/types.h>
@@ -109,6 +110,8 @@ public:
   const void* read_bytes(void* buffer, std::size_t size,
     RemotePtr<void> address, int process_index = ProcessIndexAny,
     ReadOptions options = ReadOptions::none()) const override;
+  void read_bytes_v(ReadRequest const* requests, std::size_t count,
+    int process_index = ProcessIndexAny) const override;
 
   void read_variable(const char* name, void* target, size_t size) const;
   template<class T> void read_variable(const char* name, T* target) const
@@ -133,6 +136,10 @@ public:
   void write_bytes(const void* buffer, size_t len, RemotePtr<void> address);
   void clear_bytes(RemotePtr<void> address, size_t len);
 
+  // Soft-dirty tracking of the written pages (model-check/soft-dirty):
+  void reset_soft_dirty();
+  void read_pagemap(std::uint64_t* pagemap, std::size_t start_page, std::size_t page_count);
+
   // Debug information:
   std::shared_ptr<simgrid::mc::ObjectInformation> find_object_info(RemotePtr<void> addr) const;
   std::shared_ptr<simgrid::mc::ObjectInformation> find_object_info_exec(RemotePtr<void> addr) const;
@@ -157,6 +164,7 @@ public:
   void clear_cache()
   {
     this->cache_flags_ = Process::cache_none;
+    this->clear_page_cache();
   }
 
   Channel const& getChannel() const { return channel_; }
@@ -256,6 +264,12 @@ private:
   void refresh_malloc_info();
   void refresh_simix();
 
+  RemotePtr<void> privatized_address(RemotePtr<void> address, int process_index) const;
+  bool read_memory(ReadRequest const* requests, std::size_t count) const;
+  const char* cached_page(std::uint64_t pageno) const;
+  void clear_page_cache() const;
+  void clear_page_cache(RemotePtr<void> address, std::size_t size) const;
+
 private:
   pid_t pid_ = -1;
   Channel channel_;
@@ -264,6 +278,9 @@ private:
   RemotePtr<void> maestro_stack_start_;
   RemotePtr<void> maestro_stack_end_;
   int memory_file = -1;
+  int clear_refs_fd_ = -1;
+  int pagemap_fd_    = -1;
+  mutable bool vm_readv_ = true;
   std::vector<IgnoredRegion> ignored_regions_;
   bool privatized_ = false;
   std::vector<s_stack_region_t> stack_areas_;
@@ -292,6 +309,20 @@ private:
   /** State of the cache (which variables are up to date) */
   int cache_flags_ = Process::cache_none;
 
+  /** Cache of the pages of the application recently read
+   *
+   *  The small reads (DWARF expressions, stack unwinding, SIMIX
+   *  structures...) read a whole page at once and the next ones in the same
+   *  page are served from here. This is only valid while the application is
+   *  stopped: it is cleared with the other caches and by the writes. The
+   *  mutex protects it from the threads comparing the snapshots, which can
+   *  read the application for the areas missing in the snapshots.
+   */
+  static constexpr std::size_t page_cache_size = 64;
+  mutable std::mutex page_cache_mutex_;
+  mutable std::vector<char> page_cache_;
+  mutable std::uint64_t page_cache_tags_[page_cache_size] = {}; // page number + 1, or 0 when empty
+
 public:
   /** Address of the heap structure in the MCed process. */
   void* heap_address;
@@ -4,8 +4,12 @@
 /* This program is free software; you can redistribute it and/or modify it
  * under the terms of the license (GNU LGPL) which comes with this package. */
 
+#include <cstdint>
 #include <cstdlib>
 
+#include <algorithm>
+#include <vector>
+
 #include <sys/mman.h>
 #ifdef __FreeBSD__
 # define MAP_POPULATE MAP_PREFAULT_READ
@@ -16,6 +20,7 @@
 
 #include "src/mc/ChunkedData.hpp"
 #include "src/mc/RegionSnapshot.hpp"
+#include "src/mc/mc_mmu.h"
 
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY(mc_RegionSnaphot, mc,
                                 "Logging specific to region snapshots");
@@ -115,18 +120,53 @@ RegionSnapshot dense_region(
  * @param start_addr   Address of the region in the simulated process
  * @param permanent_addr Permanent address of this data (for privatized variables, this is the virtual address of the privatized mapping)
  * @param size         Size of the data*
+ * @param reference    Snapshot of this region taken or restored when the soft-dirty bits were reset (or nullptr)
  */
 RegionSnapshot region(
-  RegionType type, void *start_addr, void* permanent_addr, size_t size)
+  RegionType type, void *start_addr, void* permanent_addr, size_t size,
+  RegionSnapshot const* reference)
 {
-  if (_sg_mc_sparse_checkpoint)
-    return sparse_region(type, start_addr, permanent_addr, size);
+  if (_sg_mc_sparse_checkpoint || _sg_mc_soft_dirty)
+    return sparse_region(type, start_addr, permanent_addr, size, reference);
   else
     return dense_region(type, start_addr, permanent_addr, size);
 }
 
+/** Find the pages which were written since the reference snapshot
+ *
+ *  @return whether the pages of the reference can be used
+ */
+bool read_soft_dirty(std::vector<std::uint64_t>& pagemap, RegionSnapshot const* reference,
+  void* start_addr, void* permanent_addr, size_t size)
+{
+  if (not _sg_mc_soft_dirty || reference == nullptr
+      || reference->storage_type() != simgrid::mc::StorageType::Chunked
+      || reference->start().address() != (std::uintptr_t) start_addr
+      || reference->permanent_address().address() != (std::uintptr_t) permanent_addr)
+    return false;
+
+  simgrid::mc::Process* process = &mc_model_checker->process();
+  size_t page_count = simgrid::mc::mmu::chunkCount(size);
+  pagemap.resize(page_count);
+  process->read_pagemap(pagemap.data(),
+    simgrid::mc::mmu::split((std::uintptr_t) permanent_addr).first, page_count);
+
+  // The ignored data was zeroed for the snapshot, maybe without setting the
+  // soft-dirty bits: read those pages anyway.
+  std::uintptr_t start = (std::uintptr_t) start_addr;
+  for (simgrid::mc::IgnoredRegion const& ignored : process->ignored_regions()) {
+    std::uintptr_t first = std::max<std::uintptr_t>(ignored.addr, start);
+    std::uintptr_t last = std::min<std::uintptr_t>(ignored.addr + ignored.size, start + size);
+    if (first < last)
+      for (size_t i = (first - start) >> xbt_pagebits; i <= (last - 1 - start) >> xbt_pagebits; ++i)
+        pagemap[i] |= simgrid::mc::mmu::soft_dirty;
+  }
+  return true;
+}
+
 RegionSnapshot sparse_region(RegionType region_type,
-  void *start_addr, void* permanent_addr, size_t size)
+  void *start_addr, void* permanent_addr, size_t size,
+  RegionSnapshot const* reference)
 {
   simgrid::mc::Process* process = &mc_model_checker->process();
   assert(process != nullptr);
@@ -137,8 +177,13 @@ RegionSnapshot sparse_region(RegionType region_type,
     "Not at the beginning of a page");
   size_t page_count = simgrid::mc::mmu::chunkCount(size);
 
+  std::vector<std::uint64_t> pagemap;
+  bool incremental = read_soft_dirty(pagemap, reference, start_addr, permanent_addr, size);
+
   simgrid::mc::ChunkedData page_data(
-    mc_model_checker->page_store(), *process, permanent_addr, page_count);
+    mc_model_checker->page_store(), *process, permanent_addr, page_count,
+    incremental ? &reference->page_data() : nullptr,
+    incremental ? pagemap.data() : nullptr);
 
   simgrid::mc::RegionSnapshot region(
     region_type, start_addr, permanent_addr, size);
@@ -270,9 +270,13 @@ RegionSnapshot privatized_region(
 RegionSnapshot dense_region(
   RegionType type, void *start_addr, void* data_addr, std::size_t size);
 simgrid::mc::RegionSnapshot sparse_region(
-  RegionType type, void *start_addr, void* data_addr, std::size_t size);
+  RegionType type, void *start_addr, void* data_addr, std::size_t size,
+  RegionSnapshot const* reference = nullptr);
 simgrid::mc::RegionSnapshot region(
-  RegionType type, void *start_addr, void* data_addr, std::size_t size);
+  RegionType type, void *start_addr, void* data_addr, std::size_t size,
+  RegionSnapshot const* reference = nullptr);
+bool read_soft_dirty(std::vector<std::uint64_t>& pagemap, RegionSnapshot const* reference,
+  void* start_addr, void* permanent_addr, std::size_t size);
 
 }
 }
@@ -6,6 +6,9 @@
 
 #include <fcntl.h>
 #include <signal.h>
+#ifdef __linux__
+#include <sys/personality.h>
+#endif
 
 #include <functional>
 
@@ -37,6 +40,9 @@ static void setup_child_environment(int socket)
     throw simgrid::xbt::errno_error("Could not unblock signals");
   if (prctl(PR_SET_PDEATHSIG, SIGHUP) != 0)
     throw simgrid::xbt::errno_error("Could not PR_SET_PDEATHSIG");
+  // The parallel workers share the hashes of the memory of their applications, which must have the same layout:
+  if (_sg_mc_workers > 1 && personality(ADDR_NO_RANDOMIZE) == -1)
+    throw simgrid::xbt::errno_error("Could not disable the address space randomization");
 #endif
 
   int res;
@@ -6,7 +6,11 @@
 #include <unistd.h>
 #include <sys/wait.h>
 
+#include <algorithm>
+#include <iterator>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include <boost/range/algorithm.hpp>
 
@@ -17,6 +21,7 @@
 #include "src/mc/mc_private.h"
 #include "src/mc/Process.hpp"
 #include "src/mc/mc_smx.h"
+#include "src/mc/mc_hash.hpp"
 #include "src/mc/VisitedState.hpp"
 
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY(mc_VisitedState, mc, "Logging specific to state equality detection mechanisms");
@@ -24,15 +29,6 @@ XBT_LOG_NEW_DEFAULT_SUBCATEGORY(mc_VisitedState, mc, "Logging specific to state
 namespace simgrid {
 namespace mc {
 
-static int snapshot_compare(simgrid::mc::VisitedState* state1, simgrid::mc::VisitedState* state2)
-{
-  simgrid::mc::Snapshot* s1 = state1->system_state.get();
-  simgrid::mc::Snapshot* s2 = state2->system_state.get();
-  int num1 = state1->num;
-  int num2 = state2->num;
-  return snapshot_compare(num1, s1, num2, s2);
-}
-
 /** @brief Save the current state */
 VisitedState::VisitedState(unsigned long state_number)
 {
@@ -78,41 +74,67 @@ std::unique_ptr<simgrid::mc::VisitedState> VisitedStates::addVisitedState(
   XBT_DEBUG("Snapshot %p of visited state %d (exploration stack state %d)",
     new_state->system_state.get(), new_state->num, graph_state->num);
 
-  auto range =
+  /* The states are sorted by fingerprint inside each group of states with the same actors count and used heap: only
+   * the states with the same fingerprint can be equal to the new one */
+  auto group =
       boost::range::equal_range(states_, new_state.get(), simgrid::mc::DerefAndCompareByActorsCountAndUsedHeap());
-
-  if (compare_snpashots)
-    for (auto i = range.first; i != range.second; ++i) {
-      auto& visited_state = *i;
-      if (snapshot_compare(visited_state.get(), new_state.get()) == 0) {
-        // The state has been visited:
-
-        std::unique_ptr<simgrid::mc::VisitedState> old_state =
-          std::move(visited_state);
-
-        if (old_state->original_num == -1) // I'm the copy of an original process
-          new_state->original_num = old_state->num;
-        else // I'm the copy of a copy
-          new_state->original_num = old_state->original_num;
-
-        if (dot_output == nullptr)
-          XBT_DEBUG("State %d already visited ! (equal to state %d)",
-                    new_state->num, old_state->num);
-        else
-          XBT_DEBUG("State %d already visited ! (equal to state %d (state %d in dot_output))",
-                    new_state->num, old_state->num, new_state->original_num);
-
-        /* Replace the old state with the new one (with a bigger num)
-           (when the max number of visited states is reached,  the oldest
-           one is removed according to its number (= with the min number) */
-        XBT_DEBUG("Replace visited state %d with the new visited state %d",
-          old_state->num, new_state->num);
-
-        visited_state = std::move(new_state);
-        return old_state;
+  auto range = std::equal_range(group.first, group.second, new_state.get(),
+                                simgrid::mc::DerefAndCompareByActorsCountUsedHeapAndHash());
+
+  if (compare_snpashots) {
+    mc_model_checker->avoided_comparisons +=
+        std::distance(group.first, group.second) - std::distance(range.first, range.second);
+
+    /* Find the first visited state equal to the new one. The states before the first one with the same content are
+     * compared to it by snapshot_compare_first(), in parallel with model-check/compare-threads */
+    auto same = std::find_if(range.first, range.second, [&new_state](std::unique_ptr<VisitedState> const& state) {
+      return simgrid::mc::same_content(*state->system_state, *new_state->system_state);
+    });
+    std::vector<std::pair<int, simgrid::mc::Snapshot*>> candidates;
+    for (auto i = range.first; i != same; ++i)
+      candidates.push_back(std::make_pair((*i)->num, (*i)->system_state.get()));
+    int index = simgrid::mc::snapshot_compare_first(candidates, new_state->num, new_state->system_state.get());
+    auto equal = range.second;
+    if (index >= 0) {
+      mc_model_checker->state_comparisons += index + 1;
+      equal = range.first + index;
+    } else {
+      mc_model_checker->state_comparisons += candidates.size();
+      if (same != range.second) {
+        mc_model_checker->avoided_comparisons++;
+        equal = same;
       }
     }
 
+    if (equal != range.second) {
+      // The state has been visited:
+      auto& visited_state = *equal;
+      std::unique_ptr<simgrid::mc::VisitedState> old_state =
+        std::move(visited_state);
+
+      if (old_state->original_num == -1) // I'm the copy of an original process
+        new_state->original_num = old_state->num;
+      else // I'm the copy of a copy
+        new_state->original_num = old_state->original_num;
+
+      if (dot_output == nullptr)
+        XBT_DEBUG("State %d already visited ! (equal to state %d)",
+                  new_state->num, old_state->num);
+      else
+        XBT_DEBUG("State %d already visited ! (equal to state %d (state %d in dot_output))",
+                  new_state->num, old_state->num, new_state->original_num);
+
+      /* Replace the old state with the new one (with a bigger num)
+         (when the max number of visited states is reached,  the oldest
+         one is removed according to its number (= with the min number) */
+      XBT_DEBUG("Replace visited state %d with the new visited state %d",
+        old_state->num, new_state->num);
+
+      visited_state = std::move(new_state);
+      return old_state;
+    }
+  }
+
   XBT_DEBUG("Insert new visited state %d (total : %lu)", new_state->num, (unsigned long) states_.size());
   states_.insert(range.first, std::move(new_state));
   this->prune();
@@ -329,6 +329,9 @@ void CommunicationDeterminismChecker::logState() // override
   XBT_INFO("Expanded states = %lu", expandedStatesCount_);
   XBT_INFO("Visited states = %lu", mc_model_checker->visited_states);
   XBT_INFO("Executed transitions = %lu", mc_model_checker->executed_transitions);
+  if (_sg_mc_max_visited_states > 0)
+    XBT_INFO("State comparisons = %lu (%lu avoided by the state fingerprints)", mc_model_checker->state_comparisons,
+             mc_model_checker->avoided_comparisons);
   XBT_INFO("Send-deterministic : %s", not this->send_deterministic ? "No" : "Yes");
   if (_sg_mc_comms_determinism)
     XBT_INFO("Recv-deterministic : %s", not this->recv_deterministic ? "No" : "Yes");
@@ -0,0 +1,790 @@
+/* Copyright (c) 2017. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/prctl.h>
+#endif
+
+#include <xbt/log.h>
+#include <xbt/system_error.hpp>
+
+#include "src/mc/Session.hpp"
+#include "src/mc/Transition.hpp"
+#include "src/mc/checker/ParallelSafetyChecker.hpp"
+#include "src/mc/checker/SafetyChecker.hpp"
+#include "src/mc/mc_exit.h"
+#include "src/mc/mc_private.h"
+#include "src/mc/mc_record.h"
+#include "src/mc/mc_safety.h"
+#include "src/mc/mc_snapshot.h"
+
+XBT_LOG_NEW_DEFAULT_SUBCATEGORY(mc_parallel, mc, "Logging specific to the parallel exploration");
+
+namespace simgrid {
+namespace mc {
+
+/* An entry of the table of the visited states: the 128 bits hash of the state, and the smallest path known to it */
+struct VisitedEntry {
+  std::atomic<std::uint64_t> key;
+  std::atomic<std::uint64_t> check;
+  std::atomic<std::uint32_t> path;
+};
+
+/* A transition of a path recorded in the table of the visited states, after the path of its parent node (the empty
+ * path for node 0) */
+struct PathNode {
+  std::uint32_t parent;
+  int pid;
+  int argument;
+};
+
+/* The coordinator and the workers share the smallest counter-example found so far (published by the coordinator),
+ * the number of idle workers, and a table of the visited states. This table is an open addressing hash set of the
+ * hashes of the memory of the states: each entry is claimed by a compare-and-swap on its key, then its check and path
+ * are set. The paths are stored as a tree of transitions, each worker adding the nodes of its own paths. */
+struct ParallelShared {
+  static constexpr std::size_t visited_slots        = 1 << 22;
+  static constexpr std::size_t path_slots           = 1 << 24;
+  static constexpr std::size_t counter_example_size = 1 << 16;
+
+  std::atomic<unsigned> idle_workers;
+  std::atomic<unsigned> counter_example_version;
+  pthread_mutex_t counter_example_mutex;
+  char counter_example[counter_example_size];
+
+  std::atomic<std::size_t> visited_count;
+  VisitedEntry visited[visited_slots];
+  std::atomic<std::uint32_t> path_count;
+  PathNode paths[path_slots];
+};
+
+// ***** Messages between the coordinator and the workers
+
+/* They go through a stream socket, as a header followed by a textual payload */
+enum class ParallelMessage : std::uint32_t {
+  branch,    // both ways: "actor path"
+  done,      // worker: the branch is explored, with the counters of the worker
+  violation, // worker: "status counters\npath\ntextual trace", before exiting
+  stop,      // coordinator: no more branches
+};
+
+struct ParallelMessageHeader {
+  ParallelMessage type;
+  std::uint32_t size;
+};
+
+static void send_message(int socket, ParallelMessage type, std::string const& payload)
+{
+  ParallelMessageHeader header = {type, (std::uint32_t)payload.size()};
+  std::string message((const char*)&header, sizeof(header));
+  message += payload;
+  const char* data = message.data();
+  std::size_t size = message.size();
+  while (size) {
+    ssize_t res = send(socket, data, size, MSG_NOSIGNAL);
+    if (res == -1 && errno == EINTR)
+      continue;
+    if (res <= 0)
+      throw simgrid::xbt::errno_error("Could not send a message of the parallel exploration");
+    data += res;
+    size -= res;
+  }
+}
+
+static bool read_whole(int socket, void* buffer, std::size_t size)
+{
+  char* data = (char*)buffer;
+  while (size) {
+    ssize_t res = read(socket, data, size);
+    if (res == -1 && errno == EINTR)
+      continue;
+    if (res == 0)
+      return false;
+    if (res < 0)
+      throw simgrid::xbt::errno_error("Could not receive a message of the parallel exploration");
+    data += res;
+    size -= res;
+  }
+  return true;
+}
+
+/** Receive a message (false at the end of the stream) */
+static bool receive_message(int socket, ParallelMessage& type, std::string& payload)
+{
+  ParallelMessageHeader header;
+  if (not read_whole(socket, &header, sizeof(header)))
+    return false;
+  type = header.type;
+  payload.resize(header.size);
+  return header.size == 0 || read_whole(socket, &payload[0], header.size);
+}
+
+/* Unlike traceToString(), the values of the transitions are always given and the empty path is allowed */
+static std::string encode_path(RecordTrace const& path)
+{
+  std::ostringstream stream;
+  for (auto i = path.begin(); i != path.end(); ++i) {
+    if (i != path.begin())
+      stream << ';';
+    stream << i->pid << '/' << i->argument;
+  }
+  return stream.str();
+}
+
+static RecordTrace decode_path(const char* data)
+{
+  RecordTrace res;
+  while (*data) {
+    Transition transition;
+    char* end;
+    transition.pid = std::strtol(data, &end, 10);
+    xbt_assert(*end == '/', "Invalid path in the parallel exploration");
+    transition.argument = std::strtol(end + 1, &end, 10);
+    res.push_back(transition);
+    data = *end == ';' ? end + 1 : end;
+  }
+  return res;
+}
+
+static std::string encode_stats(ExplorationStats const& stats)
+{
+  return std::to_string(stats.expanded_states) + ' ' + std::to_string(stats.visited_states) + ' ' +
+         std::to_string(stats.executed_transitions) + ' ' + std::to_string(stats.state_comparisons) + ' ' +
+         std::to_string(stats.avoided_comparisons);
+}
+
+static ExplorationStats decode_stats(std::istream& stream)
+{
+  ExplorationStats stats;
+  stream >> stats.expanded_states >> stats.visited_states >> stats.executed_transitions >> stats.state_comparisons >>
+      stats.avoided_comparisons;
+  return stats;
+}
+
+bool traceLess(RecordTrace const& trace1, RecordTrace const& trace2)
+{
+  return std::lexicographical_compare(trace1.begin(), trace1.end(), trace2.begin(), trace2.end(),
+                                      [](Transition const& t1, Transition const& t2) {
+                                        return t1.pid < t2.pid || (t1.pid == t2.pid && t1.argument < t2.argument);
+                                      });
+}
+
+// ***** Worker
+
+bool ParallelWorker::nextBranch(RecordTrace& path, int& actor)
+{
+  ParallelMessage type;
+  std::string payload;
+  if (not receive_message(socket_, type, payload) || type == ParallelMessage::stop)
+    return false;
+  xbt_assert(type == ParallelMessage::branch, "Unexpected message from the coordinator");
+  char* end;
+  actor = std::strtol(payload.c_str(), &end, 10);
+  path  = decode_path(*end == ' ' ? end + 1 : end);
+  return true;
+}
+
+void ParallelWorker::addBranch(RecordTrace const& path, int actor)
+{
+  send_message(socket_, ParallelMessage::branch, std::to_string(actor) + ' ' + encode_path(path));
+}
+
+void ParallelWorker::branchDone(ExplorationStats const& stats)
+{
+  send_message(socket_, ParallelMessage::done, encode_stats(stats));
+}
+
+void ParallelWorker::reportViolation(int status, RecordTrace const& trace,
+                                     std::vector<std::string> const& textual_trace, ExplorationStats const& stats)
+{
+  std::string payload = std::to_string(status) + ' ' + encode_stats(stats) + '\n' + encode_path(trace);
+  for (std::string const& line : textual_trace)
+    payload += '\n' + line;
+  send_message(socket_, ParallelMessage::violation, payload);
+}
+
+bool ParallelWorker::hungry() const
+{
+  return shared_->idle_workers.load(std::memory_order_relaxed) > 0;
+}
+
+RecordTrace const* ParallelWorker::counterExample()
+{
+  unsigned version = shared_->counter_example_version.load(std::memory_order_acquire);
+  if (version != counterExampleVersion_) {
+    pthread_mutex_lock(&shared_->counter_example_mutex);
+    counterExampleVersion_ = shared_->counter_example_version.load(std::memory_order_relaxed);
+    counterExample_        = decode_path(shared_->counter_example);
+    pthread_mutex_unlock(&shared_->counter_example_mutex);
+  }
+  return counterExampleVersion_ != 0 ? &counterExample_ : nullptr;
+}
+
+/* A 128 bits hash of the memory of a state (after MurmurHash3), fed with 64 bits words. Unlike the fingerprints of
+ * mc_hash.cpp, it is the only thing compared between the states of different workers: it must be collision-free in
+ * practice, rather than fast. */
+class StrongHash {
+  std::uint64_t h1_    = 0x9368e53c2f6af274;
+  std::uint64_t h2_    = 0x586dcd208f7cd3fd;
+  std::uint64_t words_ = 0;
+
+  static std::uint64_t rotl(std::uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+  static std::uint64_t fmix(std::uint64_t k)
+  {
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccd;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53;
+    k ^= k >> 33;
+    return k;
+  }
+
+public:
+  void update(std::uint64_t k)
+  {
+    if (words_++ % 2 == 0) {
+      h1_ ^= rotl(k * 0x87c37b91114253d5, 31) * 0x4cf5ad432745937f;
+      h1_ = (rotl(h1_, 27) + h2_) * 5 + 0x52dce729;
+    } else {
+      h2_ ^= rotl(k * 0x4cf5ad432745937f, 33) * 0x87c37b91114253d5;
+      h2_ = (rotl(h2_, 31) + h1_) * 5 + 0x38495ab5;
+    }
+  }
+  void update_bytes(const void* data, std::size_t size)
+  {
+    const char* bytes = (const char*)data;
+    std::uint64_t word;
+    for (; size >= sizeof(word); size -= sizeof(word), bytes += sizeof(word)) {
+      memcpy(&word, bytes, sizeof(word));
+      this->update(word);
+    }
+    if (size > 0) {
+      word = 0;
+      memcpy(&word, bytes, size);
+      this->update(word ^ (size << 56));
+    }
+  }
+  std::pair<std::uint64_t, std::uint64_t> value() const
+  {
+    std::uint64_t h1 = h1_ ^ words_;
+    std::uint64_t h2 = h2_ ^ words_;
+    h1 += h2;
+    h2 += h1;
+    h1 = fmix(h1);
+    h2 = fmix(h2);
+    h1 += h2;
+    h2 += h1;
+    return {h1, h2};
+  }
+};
+
+static void strong_hash_region(StrongHash& hash, RegionSnapshot const& region)
+{
+  hash.update(region.start().address());
+  hash.update(region.size());
+  switch (region.storage_type()) {
+    case StorageType::NoData:
+    default:
+      break;
+    case StorageType::Flat:
+      hash.update_bytes(region.flat_data().get(), region.size());
+      break;
+    case StorageType::Chunked:
+      for (std::size_t i = 0; i != region.page_data().page_count(); ++i)
+        hash.update_bytes(region.page_data().page(i), xbt_pagesize);
+      break;
+    case StorageType::Privatized:
+      for (RegionSnapshot const& subregion : region.privatized_data())
+        strong_hash_region(hash, subregion);
+      break;
+  }
+}
+
+/* Covers what same_content() compares, except what is local to this model-checker (the DWARF information) */
+static std::pair<std::uint64_t, std::uint64_t> strong_hash(Snapshot const& snapshot)
+{
+  StrongHash hash;
+  hash.update(snapshot.enabled_processes.size());
+  for (pid_t pid : snapshot.enabled_processes)
+    hash.update(pid);
+  hash.update(snapshot.privatization_index);
+  hash.update(snapshot.heap_bytes_used);
+  for (std::size_t size : snapshot.stack_sizes)
+    hash.update(size);
+  for (s_mc_snapshot_stack_t const& stack : snapshot.stacks) {
+    hash.update(stack.process_index);
+    hash.update(stack.local_variables.size());
+    for (s_local_variable_t const& variable : stack.local_variables) {
+      hash.update(variable.ip);
+      hash.update((std::uintptr_t)variable.address);
+    }
+  }
+  for (std::unique_ptr<s_mc_mem_region_t> const& region : snapshot.snapshot_regions)
+    if (region)
+      strong_hash_region(hash, *region);
+  return hash.value();
+}
+
+/* The node of a path in the shared tree, adding the missing ones (0 when the tree is full) */
+std::uint32_t ParallelWorker::recordPath(RecordTrace const& path)
+{
+  std::size_t common = 0;
+  for (auto const& transition : path) {
+    if (common == pathNodes_.size() || pathNodes_[common].first.pid != transition.pid ||
+        pathNodes_[common].first.argument != transition.argument)
+      break;
+    common++;
+  }
+  pathNodes_.resize(common);
+  for (auto transition = path.begin() + common; transition != path.end(); ++transition) {
+    std::uint32_t node = shared_->path_count.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (node >= ParallelShared::path_slots) {
+      shared_->path_count.store(ParallelShared::path_slots, std::memory_order_relaxed);
+      return 0;
+    }
+    // Published with the release store of the entry which refers to it:
+    shared_->paths[node] = {pathNodes_.empty() ? 0 : pathNodes_.back().second, transition->pid, transition->argument};
+    pathNodes_.push_back({*transition, node});
+  }
+  return pathNodes_.empty() ? 0 : pathNodes_.back().second;
+}
+
+RecordTrace ParallelWorker::recordedPath(std::uint32_t node) const
+{
+  RecordTrace res;
+  for (; node != 0; node = shared_->paths[node].parent) {
+    Transition transition;
+    transition.pid      = shared_->paths[node].pid;
+    transition.argument = shared_->paths[node].argument;
+    res.push_back(transition);
+  }
+  std::reverse(res.begin(), res.end());
+  return res;
+}
+
+bool ParallelWorker::visited(Snapshot const& snapshot, RecordTrace const& path)
+{
+  /* The hash covers the memory of the application (with the same layout in all the workers). The key is never 0
+   * (empty entry), the path never 0 once the entry is complete. */
+  std::pair<std::uint64_t, std::uint64_t> hash = strong_hash(snapshot);
+  std::uint64_t key                            = hash.first ? hash.first : 1;
+
+  // Stop adding states when the table is 3/4 full, in order to keep the probing short:
+  bool full = shared_->visited_count.load(std::memory_order_relaxed) >= ParallelShared::visited_slots / 4 * 3;
+  for (std::size_t i = key % ParallelShared::visited_slots;; i = (i + 1) % ParallelShared::visited_slots) {
+    VisitedEntry& entry   = shared_->visited[i];
+    std::uint64_t current = entry.key.load(std::memory_order_acquire);
+    if (current == 0) {
+      if (full)
+        return false;
+      std::uint32_t node = this->recordPath(path);
+      if (node == 0)
+        return false;
+      if (entry.key.compare_exchange_strong(current, key, std::memory_order_acq_rel)) {
+        entry.check.store(hash.second, std::memory_order_relaxed);
+        entry.path.store(node, std::memory_order_release);
+        shared_->visited_count++;
+        return false;
+      }
+      // Another worker claimed this entry in the meantime, current is its key
+    }
+    if (current != key)
+      continue;
+    std::uint32_t stored;
+    while ((stored = entry.path.load(std::memory_order_acquire)) == 0)
+      sched_yield(); // being added
+    if (entry.check.load(std::memory_order_relaxed) != hash.second)
+      continue;
+
+    /* The same state: prune only if it was reached through a smaller path, the one that a sequential exploration
+     * would have taken first. Otherwise, this path becomes the reference for the next visits. */
+    for (;;) {
+      RecordTrace stored_path = this->recordedPath(stored);
+      if (traceLess(stored_path, path))
+        return true;
+      if (not traceLess(path, stored_path))
+        return false; // the same path
+      std::uint32_t node = this->recordPath(path);
+      if (node == 0 || entry.path.compare_exchange_weak(stored, node, std::memory_order_acq_rel))
+        return false;
+    }
+  }
+}
+
+static int run_worker(char* const argv[], int socket, ParallelShared* shared)
+{
+#ifdef __linux__
+  prctl(PR_SET_PDEATHSIG, SIGHUP);
+#endif
+  // The coordinator reports the results:
+  xbt_log_control_set("mc.thres:warning");
+
+  std::unique_ptr<Session> session(Session::spawnvp(argv[0], argv));
+  simgrid::mc::session = session.get();
+  ParallelWorker worker(socket, shared);
+  {
+    SafetyChecker checker(*session);
+    checker.runWorker(worker);
+  }
+  session->close();
+  return SIMGRID_MC_EXIT_SUCCESS;
+}
+
+// ***** Coordinator
+
+namespace {
+
+struct Branch {
+  RecordTrace path;
+  int actor;
+  /* The path followed by the actor: all the executions of the branch are greater than this */
+  RecordTrace key() const
+  {
+    RecordTrace res = path;
+    Transition transition;
+    transition.pid      = actor;
+    transition.argument = INT_MIN;
+    res.push_back(transition);
+    return res;
+  }
+  bool operator<(Branch const& that) const { return traceLess(this->key(), that.key()); }
+};
+
+struct WorkerInfo {
+  pid_t pid  = -1;
+  int socket = -1;
+  bool busy  = false;
+  bool violation = false; // the worker reported a violation and is exiting
+  ExplorationStats stats;
+};
+
+class ParallelSafetyChecker {
+public:
+  ParallelSafetyChecker(char* const argv[], ParallelShared* shared) : argv_(argv), shared_(shared) {}
+  int run();
+
+private:
+  char* const* argv_;
+  ParallelShared* shared_;
+  std::vector<WorkerInfo> workers_;
+  std::set<Branch> branches_; // waiting to be explored, the smallest first
+  std::set<std::string> known_;
+  ExplorationStats stats_; // of the workers which exited
+  unsigned long explored_branches_ = 0;
+
+  bool found_ = false;
+  int status_ = SIMGRID_MC_EXIT_SUCCESS;
+  RecordTrace counterExample_;
+  std::vector<std::string> textualTrace_;
+
+  void spawnWorker(WorkerInfo& worker);
+  void reapWorker(WorkerInfo& worker);
+  void addBranch(Branch branch);
+  void dispatch();
+  bool handleMessage(WorkerInfo& worker);
+  void handleViolation(WorkerInfo& worker, std::string const& payload);
+  void report();
+};
+
+}
+
+void ParallelSafetyChecker::spawnWorker(WorkerInfo& worker)
+{
+  int sockets[2];
+  if (socketpair(AF_LOCAL, SOCK_STREAM | SOCK_CLOEXEC, 0, sockets) == -1)
+    throw simgrid::xbt::errno_error("Could not create socketpair");
+
+  std::fflush(stdout);
+  std::fflush(stderr);
+  pid_t pid = fork();
+  if (pid < 0)
+    throw simgrid::xbt::errno_error("Could not fork a worker of the parallel exploration");
+  if (pid == 0) {
+    for (WorkerInfo const& other : workers_)
+      if (other.socket >= 0)
+        close(other.socket);
+    close(sockets[1]);
+    int res;
+    try {
+      res = run_worker(argv_, sockets[0], shared_);
+    } catch (std::exception& e) {
+      XBT_ERROR("Exception in a worker of the parallel exploration: %s", e.what());
+      res = SIMGRID_MC_EXIT_ERROR;
+    }
+    _exit(res);
+  }
+
+  close(sockets[0]);
+  worker.pid       = pid;
+  worker.socket    = sockets[1];
+  worker.busy      = false;
+  worker.violation = false;
+  worker.stats     = ExplorationStats();
+}
+
+/** Wait for the end of a worker, and count what it explored */
+void ParallelSafetyChecker::reapWorker(WorkerInfo& worker)
+{
+  int status;
+  waitpid(worker.pid, &status, 0);
+  close(worker.socket);
+  worker.socket = -1;
+  stats_.expanded_states += worker.stats.expanded_states;
+  stats_.visited_states += worker.stats.visited_states;
+  stats_.executed_transitions += worker.stats.executed_transitions;
+  stats_.state_comparisons += worker.stats.state_comparisons;
+  stats_.avoided_comparisons += worker.stats.avoided_comparisons;
+}
+
+void ParallelSafetyChecker::addBranch(Branch branch)
+{
+  // The same backtracking point can be found by several workers:
+  if (known_.insert(std::to_string(branch.actor) + ' ' + encode_path(branch.path)).second)
+    branches_.insert(std::move(branch));
+}
+
+/* Give the smallest branches to the idle workers */
+void ParallelSafetyChecker::dispatch()
+{
+  for (WorkerInfo& worker : workers_) {
+    if (worker.busy || worker.violation || worker.socket < 0)
+      continue;
+    // The branches greater than the counter-example cannot give a smaller one:
+    if (found_ && not branches_.empty() && traceLess(counterExample_, branches_.begin()->key()))
+      branches_.clear();
+    if (branches_.empty())
+      break;
+    Branch const& branch = *branches_.begin();
+    XBT_DEBUG("Branch %d after %s given to worker %lli", branch.actor, encode_path(branch.path).c_str(),
+              (long long)worker.pid);
+    send_message(worker.socket, ParallelMessage::branch, std::to_string(branch.actor) + ' ' + encode_path(branch.path));
+    worker.busy = true;
+    branches_.erase(branches_.begin());
+    explored_branches_++;
+  }
+
+  unsigned idle = 0;
+  if (branches_.empty())
+    for (WorkerInfo const& worker : workers_)
+      if (not worker.busy && not worker.violation)
+        idle++;
+  shared_->idle_workers.store(idle, std::memory_order_relaxed);
+}
+
+void ParallelSafetyChecker::handleViolation(WorkerInfo& worker, std::string const& payload)
+{
+  std::istringstream stream(payload);
+  int status;
+  stream >> status;
+  worker.stats = decode_stats(stream);
+  std::string line;
+  std::getline(stream, line);
+  std::getline(stream, line);
+  RecordTrace trace = decode_path(line.c_str());
+  worker.violation = true;
+  worker.busy      = false;
+  XBT_DEBUG("Counter-example %s found by worker %lli", line.c_str(), (long long)worker.pid);
+
+  // Keep the smallest counter-example, whichever worker finds it first:
+  if (found_ && not traceLess(trace, counterExample_))
+    return;
+  found_          = true;
+  status_         = status;
+  counterExample_ = std::move(trace);
+  textualTrace_.clear();
+  while (std::getline(stream, line))
+    textualTrace_.push_back(line);
+
+  std::string encoded = encode_path(counterExample_);
+  if (encoded.size() < ParallelShared::counter_example_size) {
+    pthread_mutex_lock(&shared_->counter_example_mutex);
+    std::strcpy(shared_->counter_example, encoded.c_str());
+    shared_->counter_example_version++;
+    pthread_mutex_unlock(&shared_->counter_example_mutex);
+  }
+}
+
+/** Handle a message of a worker (false when it exited) */
+bool ParallelSafetyChecker::handleMessage(WorkerInfo& worker)
+{
+  ParallelMessage type;
+  std::string payload;
+  if (not receive_message(worker.socket, type, payload))
+    return false;
+  switch (type) {
+    case ParallelMessage::branch: {
+      Branch branch;
+      char* end;
+      branch.actor = std::strtol(payload.c_str(), &end, 10);
+      branch.path  = decode_path(*end == ' ' ? end + 1 : end);
+      this->addBranch(std::move(branch));
+      break;
+    }
+    case ParallelMessage::done: {
+      std::istringstream stream(payload);
+      worker.stats = decode_stats(stream);
+      worker.busy  = false;
+      break;
+    }
+    case ParallelMessage::violation:
+      this->handleViolation(worker, payload);
+      break;
+    default:
+      xbt_die("Unexpected message from a worker of the parallel exploration");
+  }
+  return true;
+}
+
+void ParallelSafetyChecker::report()
+{
+  if (found_) {
+    switch (status_) {
+      case SIMGRID_MC_EXIT_DEADLOCK:
+        XBT_INFO("**************************");
+        XBT_INFO("*** DEAD-LOCK DETECTED ***");
+        XBT_INFO("**************************");
+        break;
+      case SIMGRID_MC_EXIT_PROGRAM_CRASH:
+        XBT_INFO("**************************");
+        XBT_INFO("** CRASH IN THE PROGRAM **");
+        XBT_INFO("**************************");
+        break;
+      default:
+        XBT_INFO("**************************");
+        XBT_INFO("*** PROPERTY NOT VALID ***");
+        XBT_INFO("**************************");
+        break;
+    }
+    XBT_INFO("Counter-example execution trace:");
+    if (status_ != SIMGRID_MC_EXIT_DEADLOCK && MC_record_is_active())
+      XBT_INFO("Path = %s", traceToString(counterExample_).c_str());
+    for (std::string const& line : textualTrace_)
+      XBT_INFO("%s", line.c_str());
+  } else
+    XBT_INFO("No property violation found.");
+}
+
+int ParallelSafetyChecker::run()
+{
+  workers_.resize(_sg_mc_workers);
+  for (WorkerInfo& worker : workers_)
+    this->spawnWorker(worker);
+
+  // The first branch is the whole exploration graph:
+  Branch root;
+  root.actor = -1;
+  this->addBranch(std::move(root));
+  this->dispatch();
+
+  std::vector<pollfd> fds(workers_.size());
+  while (true) {
+    bool busy = std::any_of(workers_.begin(), workers_.end(), [](WorkerInfo const& worker) { return worker.busy; });
+    if (not busy && branches_.empty())
+      break;
+
+    for (std::size_t i = 0; i != workers_.size(); ++i) {
+      fds[i].fd      = workers_[i].socket;
+      fds[i].events  = POLLIN;
+      fds[i].revents = 0;
+    }
+    if (poll(fds.data(), fds.size(), -1) == -1) {
+      if (errno == EINTR)
+        continue;
+      throw simgrid::xbt::errno_error("Could not poll the workers of the parallel exploration");
+    }
+
+    for (std::size_t i = 0; i != workers_.size(); ++i) {
+      WorkerInfo& worker = workers_[i];
+      if (fds[i].revents == 0 || this->handleMessage(worker))
+        continue;
+
+      // The worker exited:
+      this->reapWorker(worker);
+      if (not worker.violation) {
+        XBT_ERROR("A worker of the parallel exploration exited unexpectedly");
+        for (WorkerInfo const& other : workers_)
+          if (other.socket >= 0)
+            kill(other.pid, SIGKILL);
+        return SIMGRID_MC_EXIT_ERROR;
+      }
+      // Replace it for the remaining branches:
+      this->spawnWorker(worker);
+    }
+    this->dispatch();
+  }
+
+  for (WorkerInfo& worker : workers_) {
+    // The workers which reported a violation are exiting by themselves:
+    if (not worker.violation)
+      send_message(worker.socket, ParallelMessage::stop, "");
+    this->reapWorker(worker);
+  }
+
+  this->report();
+  XBT_INFO("Expanded states = %lu", stats_.expanded_states);
+  XBT_INFO("Visited states = %lu", stats_.visited_states);
+  XBT_INFO("Executed transitions = %lu", stats_.executed_transitions);
+  if (_sg_mc_max_visited_states > 0)
+    XBT_INFO("State comparisons = %lu (%lu avoided by the state fingerprints)", stats_.state_comparisons,
+             stats_.avoided_comparisons);
+  XBT_VERB("Explored branches = %lu", explored_branches_);
+  return status_;
+}
+
+int runParallelSafetyChecker(char* const argv[])
+{
+  if (_sg_mc_termination)
+    xbt_die("The parallel exploration (model-check/workers) cannot check non progressive cycles");
+  if (_sg_mc_dot_output_file != nullptr && _sg_mc_dot_output_file[0] != '\0')
+    xbt_die("The parallel exploration (model-check/workers) cannot write a dot output");
+
+  ReductionMode reduction = reduction_mode == ReductionMode::unset ? ReductionMode::dpor : reduction_mode;
+  XBT_INFO("Check a safety property with %d workers. Reduction is: %s.", _sg_mc_workers,
+           reduction == ReductionMode::none ? "none" : "dpor");
+
+  void* memory = mmap(nullptr, sizeof(ParallelShared), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (memory == MAP_FAILED)
+    throw simgrid::xbt::errno_error("Could not map the memory shared by the workers");
+  // The mapping is zeroed: the atomics are already initialized, and only the touched pages of the table are allocated
+  ParallelShared* shared = new (memory) ParallelShared;
+  pthread_mutexattr_t attr;
+  pthread_mutexattr_init(&attr);
+  pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+  pthread_mutex_init(&shared->counter_example_mutex, &attr);
+  pthread_mutexattr_destroy(&attr);
+
+  int res = ParallelSafetyChecker(argv, shared).run();
+
+  pthread_mutex_destroy(&shared->counter_example_mutex);
+  munmap(memory, sizeof(ParallelShared));
+  return res;
+}
+
+}
+}
@@ -0,0 +1,86 @@
+/* Copyright (c) 2017. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#ifndef SIMGRID_MC_PARALLEL_SAFETY_CHECKER_HPP
+#define SIMGRID_MC_PARALLEL_SAFETY_CHECKER_HPP
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "xbt/base.h"
+
+#include "src/mc/mc_forward.hpp"
+#include "src/mc/mc_record.h"
+
+namespace simgrid {
+namespace mc {
+
+/** Counters of a worker of the parallel exploration, summed by the coordinator */
+struct ExplorationStats {
+  unsigned long expanded_states      = 0;
+  unsigned long visited_states       = 0;
+  unsigned long executed_transitions = 0;
+  unsigned long state_comparisons    = 0;
+  unsigned long avoided_comparisons  = 0;
+};
+
+/** Memory shared by the coordinator and the workers (defined in ParallelSafetyChecker.cpp) */
+struct ParallelShared;
+
+/** Link between a worker of the parallel exploration (model-check/workers) and its coordinator
+ *
+ *  A branch is the set of the executions starting with a given path, then a transition of a given actor. The worker
+ *  explores it as the sequential SafetyChecker would, and sends back to the coordinator the backtracking points found
+ *  on the path itself. It also gives some of its backtracking points away when other workers are idle.
+ */
+class XBT_PRIVATE ParallelWorker {
+public:
+  ParallelWorker(int socket, ParallelShared* shared) : socket_(socket), shared_(shared) {}
+
+  /** Wait for the next branch to explore (the first one has no path and a negative actor: the whole graph) */
+  bool nextBranch(RecordTrace& path, int& actor);
+  void addBranch(RecordTrace const& path, int actor);
+  void branchDone(ExplorationStats const& stats);
+  void reportViolation(int status, RecordTrace const& trace, std::vector<std::string> const& textual_trace,
+                       ExplorationStats const& stats);
+
+  /** Whether some workers are waiting for a branch to explore */
+  bool hungry() const;
+  /** Smallest counter-example found so far by the workers, if any */
+  RecordTrace const* counterExample();
+  /** Whether a state with the same memory was already reached by a worker through a smaller path
+   *
+   *  The state is recorded with its path otherwise, so that pruning does not depend on which worker got there first.
+   */
+  bool visited(Snapshot const& snapshot, RecordTrace const& path);
+
+private:
+  int socket_;
+  ParallelShared* shared_;
+  unsigned counterExampleVersion_ = 0;
+  RecordTrace counterExample_;
+  /* The shared nodes of the last path recorded by this worker, reused by the next paths with the same prefix */
+  std::vector<std::pair<Transition, std::uint32_t>> pathNodes_;
+
+  std::uint32_t recordPath(RecordTrace const& path);
+  RecordTrace recordedPath(std::uint32_t node) const;
+};
+
+/** Lexicographic order of the paths, comparing the actors then the values of the transitions */
+XBT_PRIVATE bool traceLess(RecordTrace const& trace1, RecordTrace const& trace2);
+
+/** Explore the state space with _sg_mc_workers checkers, each one with its own model-checked process
+ *
+ *  @param argv command line of the model-checked application (NULL-terminated)
+ *  @return exit code of simgrid-mc
+ */
+XBT_PUBLIC() int runParallelSafetyChecker(char* const argv[]);
+
+}
+}
+
+#endif
@@ -21,6 +21,7 @@
 #include "src/mc/mc_private.h"
 #include "src/mc/mc_record.h"
 #include "src/mc/mc_request.h"
+#include "src/mc/mc_snapshot.h"
 #include "src/mc/mc_smx.h"
 
 #include "src/xbt/mmalloc/mmprivate.h"
@@ -83,15 +84,25 @@ void SafetyChecker::logState() // override
   XBT_INFO("Expanded states = %lu", expandedStatesCount_);
   XBT_INFO("Visited states = %lu", mc_model_checker->visited_states);
   XBT_INFO("Executed transitions = %lu", mc_model_checker->executed_transitions);
+  if (_sg_mc_max_visited_states > 0)
+    XBT_INFO("State comparisons = %lu (%lu avoided by the state fingerprints)", mc_model_checker->state_comparisons,
+             mc_model_checker->avoided_comparisons);
 }
 
 void SafetyChecker::run()
+{
+  this->explore();
+  XBT_INFO("No property violation found.");
+  simgrid::mc::session->logState();
+}
+
+void SafetyChecker::explore()
 {
   /* This function runs the DFS algorithm the state space.
    * We do so iteratively instead of recursively, dealing with the call stack manually.
    * This allows to explore the call stack at wish. */
 
-  while (not stack_.empty()) {
+  while (stack_.size() > prefix_) {
 
     /* Get current state */
     simgrid::mc::State* state = stack_.back().get();
@@ -119,6 +130,27 @@ void SafetyChecker::run()
       continue;
     }
 
+    if (worker_ != nullptr) {
+      // Backtrack if another worker already visited this state
+      if (sharedVisited_) {
+        XBT_DEBUG("State already visited by another worker, exploration stopped on this path.");
+        sharedVisited_ = false;
+        this->backtrack();
+        continue;
+      }
+
+      // Backtrack if all the executions from here are greater than a known counter-example
+      RecordTrace const* counter_example = worker_->counterExample();
+      if (counter_example != nullptr && traceLess(*counter_example, this->getPath(stack_.size() - 1))) {
+        XBT_DEBUG("Greater than the current counter-example, exploration stopped on this path.");
+        this->backtrack();
+        continue;
+      }
+
+      if (worker_->hungry())
+        this->donateBranches(state);
+    }
+
     // Search an enabled transition in the current state; backtrack if the interleave set is empty
     // get_request also sets state.transition to be the one corresponding to the returned req
     smx_simcall_t req = MC_state_get_request(state);
@@ -157,18 +189,14 @@ void SafetyChecker::run()
     if (_sg_mc_max_visited_states > 0)
       visitedState_ = visitedStates_.addVisitedState(expandedStatesCount_, next_state.get(), true);
 
+    if (visitedState_ == nullptr && worker_ != nullptr && _sg_mc_max_visited_states > 0)
+      sharedVisited_ = worker_->visited(*next_state->system_state, this->getPath(stack_.size()));
+
     /* If this is a new state (or if we don't care about state-equality reduction) */
     if (visitedState_ == nullptr) {
 
       /* Get an enabled process and insert it in the interleave set of the next state */
-      for (auto& remoteActor : mc_model_checker->process().actors()) {
-        auto actor = remoteActor.copy.getBuffer();
-        if (simgrid::mc::actor_is_enabled(actor)) {
-          next_state->addInterleavingSet(actor);
-          if (reductionMode_ == simgrid::mc::ReductionMode::dpor)
-            break; // With DPOR, we take the first enabled transition
-        }
-      }
+      this->addInitialInterleave(next_state.get());
 
       if (dot_output != nullptr)
         std::fprintf(dot_output, "\"%d\" -> \"%d\" [%s];\n",
@@ -181,9 +209,130 @@ void SafetyChecker::run()
 
     stack_.push_back(std::move(next_state));
   }
+}
 
-  XBT_INFO("No property violation found.");
-  simgrid::mc::session->logState();
+void SafetyChecker::addInitialInterleave(simgrid::mc::State* state)
+{
+  for (auto& remoteActor : mc_model_checker->process().actors()) {
+    auto actor = remoteActor.copy.getBuffer();
+    if (simgrid::mc::actor_is_enabled(actor)) {
+      state->addInterleavingSet(actor);
+      if (reductionMode_ != simgrid::mc::ReductionMode::none)
+        break; // With DPOR, we take the first enabled transition
+    }
+  }
+}
+
+/** Give the actors of the interleave set of a state which were not considered yet to the other workers
+ *
+ *  The first one is kept, to carry on with the exploration.
+ */
+void SafetyChecker::donateBranches(simgrid::mc::State* state)
+{
+  std::size_t depth = stack_.size() - 1;
+  if (depth == prefix_ && branchActor_ >= 0)
+    return; // This state only holds the actor of the branch
+  bool kept = false;
+  for (auto& remoteActor : mc_model_checker->process().actors()) {
+    auto actor = remoteActor.copy.getBuffer();
+    simgrid::mc::ProcessState& actor_state = state->actorStates[actor->pid];
+    if (not actor_state.isTodo() || not simgrid::mc::actor_is_enabled(actor))
+      continue;
+    if (not kept || actor_state.times_considered != 0) {
+      kept = true;
+      continue;
+    }
+    XBT_DEBUG("Give actor %lu at depth %zu to another worker", actor->pid, depth);
+    worker_->addBranch(this->getPath(depth), actor->pid);
+    actor_state.setDone();
+  }
+}
+
+/** Path of the transitions leading to the state at the given depth of the stack */
+RecordTrace SafetyChecker::getPath(std::size_t depth)
+{
+  RecordTrace res;
+  for (auto const& state : stack_) {
+    if (res.size() == depth)
+      break;
+    res.push_back(state->getTransition());
+  }
+  return res;
+}
+
+ExplorationStats SafetyChecker::getStats()
+{
+  ExplorationStats stats;
+  stats.expanded_states      = expandedStatesCount_;
+  stats.visited_states       = mc_model_checker->visited_states;
+  stats.executed_transitions = mc_model_checker->executed_transitions;
+  stats.state_comparisons    = mc_model_checker->state_comparisons;
+  stats.avoided_comparisons  = mc_model_checker->avoided_comparisons;
+  return stats;
+}
+
+/** Explore the executions starting with a given path then a transition of a given actor
+ *
+ *  The backtracking points found on the path are sent to the coordinator instead of being explored here.
+ */
+void SafetyChecker::runBranch(RecordTrace const& path, int actor)
+{
+  XBT_DEBUG("Explore the branch of actor %d after %s", actor, traceToString(path).c_str());
+  stack_.clear();
+  visitedState_ = nullptr;
+  sharedVisited_ = false;
+  simgrid::mc::session->restoreInitialState();
+
+  std::unique_ptr<simgrid::mc::State> state =
+      std::unique_ptr<simgrid::mc::State>(new simgrid::mc::State(++expandedStatesCount_));
+  if (actor < 0)
+    this->addInitialInterleave(state.get());
+  stack_.push_back(std::move(state));
+
+  for (Transition const& transition : path) {
+    if (MC_state_choose_request(stack_.back().get(), transition) == nullptr)
+      xbt_die("Could not replay the transition %i/%i of the parallel exploration", transition.pid,
+              transition.argument);
+    mc_model_checker->visited_states++;
+    mc_model_checker->executed_transitions++;
+    this->getSession().execute(stack_.back()->transition);
+    stack_.push_back(std::unique_ptr<simgrid::mc::State>(new simgrid::mc::State(++expandedStatesCount_)));
+  }
+  if (actor >= 0)
+    stack_.back()->actorStates[actor].consider();
+
+  prefix_      = path.size();
+  branchActor_ = actor;
+  this->explore();
+  stack_.clear();
+  prefix_      = 0;
+  branchActor_ = -1;
+}
+
+void SafetyChecker::runWorker(ParallelWorker& worker)
+{
+  worker_ = &worker;
+  stack_.clear();
+  expandedStatesCount_ = 0;
+
+  // Send the counter-example to the coordinator before exiting on a property violation:
+  mc_model_checker->onExit([this](int status) {
+    worker_->reportViolation(status, this->getRecordTrace(), this->getTextualTrace(), this->getStats());
+  });
+
+  RecordTrace path;
+  int actor;
+  try {
+    while (worker.nextBranch(path, actor)) {
+      this->runBranch(path, actor);
+      worker.branchDone(this->getStats());
+    }
+  } catch (simgrid::mc::DeadlockError& de) {
+    worker.reportViolation(SIMGRID_MC_EXIT_DEADLOCK, this->getRecordTrace(), this->getTextualTrace(),
+                           this->getStats());
+  }
+  mc_model_checker->onExit(nullptr);
+  worker_ = nullptr;
 }
 
 void SafetyChecker::backtrack()
@@ -203,7 +352,7 @@ void SafetyChecker::backtrack()
      executed before it. If it does then add it to the interleave set of the
      state that executed that previous request. */
 
-  while (not stack_.empty()) {
+  while (stack_.size() > prefix_) {
     std::unique_ptr<simgrid::mc::State> state = std::move(stack_.back());
     stack_.pop_back();
     if (reductionMode_ == simgrid::mc::ReductionMode::dpor) {
@@ -212,8 +361,10 @@ void SafetyChecker::backtrack()
         xbt_die("Mutex is currently not supported with DPOR,  use --cfg=model-check/reduction:none");
 
       const smx_actor_t issuer = MC_smx_simcall_get_issuer(req);
+      std::size_t depth = stack_.size();
       for (auto i = stack_.rbegin(); i != stack_.rend(); ++i) {
         simgrid::mc::State* prev_state = i->get();
+        depth--;
         if (simgrid::mc::request_depend(req, &prev_state->internal_req)) {
           if (XBT_LOG_ISENABLED(mc_safety, xbt_log_priority_debug)) {
             XBT_DEBUG("Dependent Transitions:");
@@ -231,7 +382,11 @@ void SafetyChecker::backtrack()
               state->num);
           }
 
-          if (not prev_state->actorStates[issuer->pid].isDone())
+          if (depth < prefix_ || (depth == prefix_ && branchActor_ >= 0 && (int)issuer->pid != branchActor_)) {
+            // This state belongs to the coordinator of the parallel exploration:
+            if ((int)issuer->pid != prev_state->transition.pid)
+              worker_->addBranch(this->getPath(depth), issuer->pid);
+          } else if (not prev_state->actorStates[issuer->pid].isDone())
             prev_state->addInterleavingSet(issuer);
           else
             XBT_DEBUG("Process %p is in done set", req->issuer);
@@ -320,12 +475,7 @@ SafetyChecker::SafetyChecker(Session& session) : Checker(session)
   XBT_DEBUG("Initial state");
 
   /* Get an enabled actor and insert it in the interleave set of the initial state */
-  for (auto& actor : mc_model_checker->process().actors())
-    if (simgrid::mc::actor_is_enabled(actor.copy.getBuffer())) {
-      initial_state->addInterleavingSet(actor.copy.getBuffer());
-      if (reductionMode_ != simgrid::mc::ReductionMode::none)
-        break;
-    }
+  this->addInitialInterleave(initial_state.get());
 
   stack_.push_back(std::move(initial_state));
 }
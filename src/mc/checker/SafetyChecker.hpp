@@ -14,6 +14,7 @@
 
 #include "src/mc/VisitedState.hpp"
 #include "src/mc/checker/Checker.hpp"
+#include "src/mc/checker/ParallelSafetyChecker.hpp"
 #include "src/mc/mc_forward.hpp"
 #include "src/mc/mc_safety.h"
 
@@ -29,7 +30,15 @@ public:
   RecordTrace getRecordTrace() override;
   std::vector<std::string> getTextualTrace() override;
   void logState() override;
+  /** Explore the branches given by the coordinator of a parallel exploration */
+  void runWorker(ParallelWorker& worker);
 private:
+  void explore();
+  void runBranch(RecordTrace const& path, int actor);
+  void addInitialInterleave(simgrid::mc::State* state);
+  void donateBranches(simgrid::mc::State* state);
+  RecordTrace getPath(std::size_t depth);
+  ExplorationStats getStats();
   void checkNonTermination(simgrid::mc::State* current_state);
   void backtrack();
   void restoreState();
@@ -39,6 +48,13 @@ private:
   simgrid::mc::VisitedStates visitedStates_;
   std::unique_ptr<simgrid::mc::VisitedState> visitedState_;
   unsigned long expandedStatesCount_ = 0;
+
+  /* Parallel exploration: the states of the stack below prefix_ are the path of the current branch, owned by the
+   * coordinator, and the state at prefix_ only explores branchActor_ (unless it is negative) */
+  ParallelWorker* worker_ = nullptr;
+  std::size_t prefix_     = 0;
+  int branchActor_        = -1;
+  bool sharedVisited_     = false;
 };
 
 }
@@ -21,6 +21,7 @@
 
 #include "src/mc/Session.hpp"
 #include "src/mc/checker/Checker.hpp"
+#include "src/mc/checker/ParallelSafetyChecker.hpp"
 #include "src/mc/mc_base.h"
 #include "src/mc/mc_comm_pattern.h"
 #include "src/mc/mc_exit.h"
@@ -71,6 +72,16 @@ int main(int argc, char** argv)
     xbt_log_init(&argc, argv);
     sg_config_init(&argc, argv);
 
+    if (_sg_mc_workers > 1) {
+      if (not _sg_mc_comms_determinism && not _sg_mc_send_determinism &&
+          (_sg_mc_property_file == nullptr || _sg_mc_property_file[0] == '\0')) {
+        int res = simgrid::mc::runParallelSafetyChecker(argv_copy + 1);
+        free(argv_copy);
+        return res;
+      }
+      XBT_WARN("Only the safety properties can be checked in parallel, using a single worker.");
+    }
+
     std::unique_ptr<Session> session =
       std::unique_ptr<Session>(Session::spawnvp(argv_copy[1], argv_copy+1));
     free(argv_copy);
@@ -8,8 +8,12 @@
 #include <cinttypes>
 
 #include <array>
+#include <atomic>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <set>
+#include <thread>
 #include <utility>
 #include <unordered_set>
 
@@ -145,11 +149,21 @@ struct StateComparator {
 
   std::unordered_set<std::pair<void*, void*>, hash<std::pair<void*, void*>>> compared_pointers;
 
+  /* With snapshot_compare_first(), the comparison with the index-th snapshot is useless once a previous one is found
+   * equal */
+  std::atomic<std::size_t> const* first_equal = nullptr;
+  std::size_t index = 0;
+
   void clear()
   {
     compared_pointers.clear();
   }
 
+  bool cancelled() const
+  {
+    return first_equal != nullptr && first_equal->load(std::memory_order_relaxed) < index;
+  }
+
   int initHeapInformation(
     xbt_mheap_t heap1, xbt_mheap_t heap2,
     std::vector<simgrid::mc::IgnoredHeapRegion>* i1,
@@ -354,6 +368,9 @@ int mmalloc_compare_heap(
 
   while (i1 < state.heaplimit) {
 
+    if (state.cancelled())
+      return 1;
+
     const malloc_info* heapinfo1 = (const malloc_info*) MC_region_read(heap_region1, &heapinfo_temp1, &heapinfos1[i1], sizeof(malloc_info));
     const malloc_info* heapinfo2 = (const malloc_info*) MC_region_read(heap_region2, &heapinfo_temp2, &heapinfos2[i1], sizeof(malloc_info));
 
@@ -1503,7 +1520,7 @@ static int compare_local_variables(simgrid::mc::StateComparator& state,
     int res;
     while (cursor < stack1->local_variables.size()) {
       current_var1 = &stack1->local_variables[cursor];
-      current_var2 = &stack1->local_variables[cursor];
+      current_var2 = &stack2->local_variables[cursor];
       if (current_var1->name != current_var2->name
           || current_var1->subprogram != current_var2->subprogram
           || current_var1->ip != current_var2->ip) {
@@ -1546,16 +1563,10 @@ static int compare_local_variables(simgrid::mc::StateComparator& state,
 namespace simgrid {
 namespace mc {
 
-static std::unique_ptr<simgrid::mc::StateComparator> state_comparator;
-
-int snapshot_compare(int num1, simgrid::mc::Snapshot* s1, int num2, simgrid::mc::Snapshot* s2)
+static int compare_snapshots(StateComparator& state_comparator, int num1, simgrid::mc::Snapshot* s1, int num2,
+                             simgrid::mc::Snapshot* s2)
 {
-  // TODO, make this a field of ModelChecker or something similar
-
-  if (state_comparator == nullptr)
-    state_comparator = std::unique_ptr<StateComparator>(new StateComparator());
-  else
-    state_comparator->clear();
+  state_comparator.clear();
 
   simgrid::mc::Process* process = &mc_model_checker->process();
 
@@ -1609,7 +1620,7 @@ int snapshot_compare(int num1, simgrid::mc::Snapshot* s1, int num2, simgrid::mc:
     alloca(sizeof(struct mdesc)), sizeof(struct mdesc),
     remote(process->heap_address),
     simgrid::mc::ProcessIndexMissing, simgrid::mc::ReadOptions::lazy());
-  int res_init = state_comparator->initHeapInformation(heap1, heap2, &s1->to_ignore, &s2->to_ignore);
+  int res_init = state_comparator.initHeapInformation(heap1, heap2, &s1->to_ignore, &s2->to_ignore);
 
   if (res_init == -1) {
 #ifdef MC_DEBUG
@@ -1627,6 +1638,8 @@ int snapshot_compare(int num1, simgrid::mc::Snapshot* s1, int num2, simgrid::mc:
   /* Stacks comparison */
   int diff_local = 0;
   for (unsigned int cursor = 0; cursor < s1->stacks.size(); cursor++) {
+    if (state_comparator.cancelled())
+      return 1;
     mc_snapshot_stack_t stack1 = &s1->stacks[cursor];
     mc_snapshot_stack_t stack2 = &s2->stacks[cursor];
 
@@ -1635,7 +1648,7 @@ int snapshot_compare(int num1, simgrid::mc::Snapshot* s1, int num2, simgrid::mc:
       XBT_DEBUG("(%d - %d) Stacks with different process index (%i vs %i)", num1, num2,
         stack1->process_index, stack2->process_index);
     }
-    else diff_local = compare_local_variables(*state_comparator,
+    else diff_local = compare_local_variables(state_comparator,
       stack1->process_index, s1, s2, stack1, stack2);
     if (diff_local > 0) {
 #ifdef MC_DEBUG
@@ -1673,7 +1686,7 @@ int snapshot_compare(int num1, simgrid::mc::Snapshot* s1, int num2, simgrid::mc:
     std::string const& name = region1->object_info()->file_name;
 
     /* Compare global variables */
-    if (compare_global_variables(*state_comparator, region1->object_info(), simgrid::mc::ProcessIndexDisabled, region1,
+    if (compare_global_variables(state_comparator, region1->object_info(), simgrid::mc::ProcessIndexDisabled, region1,
                                  region2, s1, s2)) {
 
 #ifdef MC_DEBUG
@@ -1692,7 +1705,9 @@ int snapshot_compare(int num1, simgrid::mc::Snapshot* s1, int num2, simgrid::mc:
   }
 
   /* Compare heap */
-  if (simgrid::mc::mmalloc_compare_heap(*state_comparator, s1, s2) > 0) {
+  if (state_comparator.cancelled())
+    return 1;
+  if (simgrid::mc::mmalloc_compare_heap(state_comparator, s1, s2) > 0) {
 
 #ifdef MC_DEBUG
     XBT_DEBUG("(%d - %d) Different heap (mmalloc_compare)", num1, num2);
@@ -1726,5 +1741,145 @@ int snapshot_compare(int num1, simgrid::mc::Snapshot* s1, int num2, simgrid::mc:
   return errors > 0 || hash_result;
 }
 
+static std::unique_ptr<simgrid::mc::StateComparator> state_comparator;
+
+int snapshot_compare(int num1, simgrid::mc::Snapshot* s1, int num2, simgrid::mc::Snapshot* s2)
+{
+  // TODO, make this a field of ModelChecker or something similar
+  if (state_comparator == nullptr)
+    state_comparator = std::unique_ptr<StateComparator>(new StateComparator());
+  return compare_snapshots(*state_comparator, num1, s1, num2, s2);
+}
+
+/** Threads comparing a snapshot with a list of other ones
+ *
+ *  The xbt_parmap is not used here: its workers create SIMIX contexts, which do not exist in the model-checker. Each
+ *  thread has its own StateComparator, and the calling thread takes its share of the work too.
+ */
+class XBT_PRIVATE ComparisonWorkers {
+public:
+  explicit ComparisonWorkers(int nb_threads);
+  ~ComparisonWorkers();
+  int apply(std::vector<std::pair<int, Snapshot*>> const& snapshots, int num, Snapshot* snapshot);
+  int size() const { return threads_.size() + 1; }
+
+private:
+  void work(StateComparator& comparator);
+  void worker_main();
+
+  std::vector<std::thread> threads_;
+  std::mutex mutex_;
+  std::condition_variable start_;
+  std::condition_variable done_;
+  unsigned round_ = 0;
+  unsigned busy_  = 0;
+  bool stop_      = false;
+  std::vector<std::pair<int, Snapshot*>> const* snapshots_ = nullptr;
+  int num_                                                   = 0;
+  Snapshot* snapshot_                                        = nullptr;
+  std::atomic<std::size_t> next_{0};
+  std::atomic<std::size_t> first_equal_{0};
+};
+
+ComparisonWorkers::ComparisonWorkers(int nb_threads)
+{
+  for (int i = 1; i < nb_threads; i++)
+    threads_.emplace_back(&ComparisonWorkers::worker_main, this);
+}
+
+ComparisonWorkers::~ComparisonWorkers()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  start_.notify_all();
+  for (std::thread& thread : threads_)
+    thread.join();
+}
+
+/** Compare the snapshots in order, until none is left or all the remaining ones come after an equal one */
+void ComparisonWorkers::work(StateComparator& comparator)
+{
+  comparator.first_equal = &first_equal_;
+  for (std::size_t i = next_++; i < snapshots_->size() && i < first_equal_.load(); i = next_++) {
+    comparator.index = i;
+    std::pair<int, Snapshot*> const& other = (*snapshots_)[i];
+    if (compare_snapshots(comparator, other.first, other.second, num_, snapshot_) != 0)
+      continue;
+    // Keep the smallest index:
+    std::size_t first = first_equal_.load();
+    while (i < first && not first_equal_.compare_exchange_weak(first, i))
+      ;
+  }
+  comparator.first_equal = nullptr;
+}
+
+void ComparisonWorkers::worker_main()
+{
+  StateComparator comparator;
+  unsigned round = 0;
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    start_.wait(lock, [this, round]() { return stop_ || round_ != round; });
+    if (stop_)
+      return;
+    round = round_;
+    lock.unlock();
+    work(comparator);
+    lock.lock();
+    if (--busy_ == 0)
+      done_.notify_one();
+  }
+}
+
+int ComparisonWorkers::apply(std::vector<std::pair<int, Snapshot*>> const& snapshots, int num, Snapshot* snapshot)
+{
+  if (state_comparator == nullptr)
+    state_comparator = std::unique_ptr<StateComparator>(new StateComparator());
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    snapshots_   = &snapshots;
+    num_         = num;
+    snapshot_    = snapshot;
+    next_        = 0;
+    first_equal_ = snapshots.size();
+    busy_        = threads_.size();
+    round_++;
+  }
+  start_.notify_all();
+  work(*state_comparator);
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_.wait(lock, [this]() { return busy_ == 0; });
+  return first_equal_ == snapshots.size() ? -1 : (int)first_equal_;
+}
+
+static std::unique_ptr<ComparisonWorkers> comparison_workers;
+
+/** Find the first snapshot of a list equal to a given one
+ *
+ *  The comparisons are shared by model-check/compare-threads threads. The
+ *  result is the one of comparing the snapshots one after the other: the
+ *  comparisons with the snapshots following an equal one are cancelled, but
+ *  not the ones with the snapshots before it.
+ *
+ *  @return the index of the first equal snapshot, or -1
+ */
+int snapshot_compare_first(std::vector<std::pair<int, Snapshot*>> const& snapshots, int num, Snapshot* snapshot)
+{
+  if (_sg_mc_compare_threads <= 1 || snapshots.size() <= 1) {
+    for (std::size_t i = 0; i != snapshots.size(); ++i)
+      if (snapshot_compare(snapshots[i].first, snapshots[i].second, num, snapshot) == 0)
+        return i;
+    return -1;
+  }
+
+  if (comparison_workers == nullptr || comparison_workers->size() != _sg_mc_compare_threads)
+    comparison_workers = std::unique_ptr<ComparisonWorkers>(new ComparisonWorkers(_sg_mc_compare_threads));
+  // The heap structure is cached by the main thread only:
+  mc_model_checker->process().get_heap();
+  return comparison_workers->apply(snapshots, num, snapshot);
+}
+
 }
 }
@@ -20,6 +20,7 @@
 #include "src/smpi/private.h"
 #include "xbt/mmalloc.h"
 #include "xbt/module.h"
+#include "xbt/xbt_os_time.h"
 
 #include "src/xbt/mmalloc/mmprivate.h"
 
@@ -57,7 +58,20 @@ namespace mc {
  *
  *  @param region     Target region
  */
-static void restore(mc_mem_region_t region)
+/** Region of the parent snapshot matching a region of another snapshot
+ *
+ *  With soft-dirty tracking, the pages which were not written since the
+ *  parent snapshot was taken or restored are the ones of this region.
+ */
+static mc_mem_region_t parent_region(std::size_t index, std::size_t regions_count)
+{
+  simgrid::mc::Snapshot* parent = mc_model_checker->parent_snapshot_.get();
+  if (not _sg_mc_soft_dirty || parent == nullptr || parent->snapshot_regions.size() != regions_count)
+    return nullptr;
+  return parent->snapshot_regions[index].get();
+}
+
+static void restore(mc_mem_region_t region, mc_mem_region_t reference)
 {
   switch(region->storage_type()) {
   case simgrid::mc::StorageType::NoData:
@@ -71,12 +85,13 @@ static void restore(mc_mem_region_t region)
     break;
 
   case simgrid::mc::StorageType::Chunked:
-    mc_region_restore_sparse(&mc_model_checker->process(), region);
+    mc_region_restore_sparse(&mc_model_checker->process(), region, reference);
     break;
 
   case simgrid::mc::StorageType::Privatized:
+    // The privatized segments are also mapped elsewhere, where their soft-dirty bits are not set:
     for (auto& p : region->privatized_data())
-      restore(&p);
+      restore(&p, nullptr);
     break;
   }
 }
@@ -101,6 +116,7 @@ RegionSnapshot privatized_region(
 
   std::vector<simgrid::mc::RegionSnapshot> data;
   data.reserve(process_count);
+  // No soft-dirty tracking here: see restore()
   for (size_t i = 0; i < process_count; i++)
     data.push_back(simgrid::mc::region(region_type, start_addr,
       privatization_regions[i].address, size));
@@ -133,7 +149,8 @@ void add_region(int index, simgrid::mc::Snapshot* snapshot,
       type, start_addr, permanent_addr, size);
   else
 #endif
-    region = simgrid::mc::region(type, start_addr, permanent_addr, size);
+    region = simgrid::mc::region(type, start_addr, permanent_addr, size,
+      parent_region(index, snapshot->snapshot_regions.size()));
 
   region.object_info(object_info);
   snapshot->snapshot_regions[index]
@@ -554,6 +571,7 @@ static std::vector<s_fd_infos_t> get_current_fds(pid_t pid)
 std::shared_ptr<simgrid::mc::Snapshot> take_snapshot(int num_state)
 {
   XBT_DEBUG("Taking snapshot %i", num_state);
+  double start = xbt_os_time();
 
   simgrid::mc::Process* mc_process = &mc_model_checker->process();
 
@@ -574,24 +592,29 @@ std::shared_ptr<simgrid::mc::Snapshot> take_snapshot(int num_state)
 
   if (_sg_mc_max_visited_states > 0 || strcmp(_sg_mc_property_file, "")) {
     snapshot->stacks = take_snapshot_stacks(snapshot.get());
-    if (_sg_mc_hash)
-      snapshot->hash = simgrid::mc::hash(*snapshot);
-    else
-      snapshot->hash = 0;
+    snapshot->hash = simgrid::mc::hash(*snapshot);
+    snapshot->content_hash = simgrid::mc::hash_content(*snapshot);
   } else
     snapshot->hash = 0;
 
   snapshot_ignore_restore(snapshot.get());
+  if (_sg_mc_soft_dirty) {
+    mc_model_checker->process().reset_soft_dirty();
+    mc_model_checker->parent_snapshot_ = snapshot;
+  }
+  XBT_VERB("Snapshot %i taken in %g ms (%zu pages in the page store)", num_state,
+           (xbt_os_time() - start) * 1000, mc_model_checker->page_store().size());
   return snapshot;
 }
 
 static inline
 void restore_snapshot_regions(simgrid::mc::Snapshot* snapshot)
 {
-  for(std::unique_ptr<s_mc_mem_region_t> const& region : snapshot->snapshot_regions) {
+  const std::size_t regions_count = snapshot->snapshot_regions.size();
+  for (std::size_t i = 0; i != regions_count; ++i) {
     // For privatized, variables we decided it was not necessary to take the snapshot:
-    if (region)
-      restore(region.get());
+    if (snapshot->snapshot_regions[i])
+      restore(snapshot->snapshot_regions[i].get(), parent_region(i, regions_count));
   }
 
 #if HAVE_SMPI
@@ -632,6 +655,10 @@ void restore_snapshot(std::shared_ptr<simgrid::mc::Snapshot> snapshot)
     restore_snapshot_fds(snapshot.get());
   snapshot_ignore_restore(snapshot.get());
   mc_model_checker->process().clear_cache();
+  if (_sg_mc_soft_dirty) {
+    mc_model_checker->process().reset_soft_dirty();
+    mc_model_checker->parent_snapshot_ = snapshot;
+  }
 }
 
 }
@@ -52,6 +52,7 @@ int _sg_do_model_check_record = 0;
 int _sg_mc_checkpoint = 0;
 int _sg_mc_sparse_checkpoint = 0;
 int _sg_mc_ksm = 0;
+int _sg_mc_soft_dirty = 0;
 char *_sg_mc_property_file = nullptr;
 int _sg_mc_hash = 0;
 int _sg_mc_max_depth = 1000;
@@ -61,6 +62,8 @@ int _sg_mc_comms_determinism = 0;
 int _sg_mc_send_determinism = 0;
 int _sg_mc_snapshot_fds = 0;
 int _sg_mc_termination = 0;
+int _sg_mc_workers = 1;
+int _sg_mc_compare_threads = 1;
 
 void _mc_cfg_cb_reduce(const char *name)
 {
@@ -102,6 +105,14 @@ void _mc_cfg_cb_ksm(const char *name)
   _sg_mc_ksm = xbt_cfg_get_boolean(name);
 }
 
+void _mc_cfg_cb_soft_dirty(const char *name)
+{
+  if (_sg_cfg_init_status && not _sg_do_model_check)
+    xbt_die("You are specifying a soft-dirty value after the initialization (through MSG_config?), but model-checking was not activated at config time (through --cfg=model-check:1). This won't work, sorry.");
+
+  _sg_mc_soft_dirty = xbt_cfg_get_boolean(name);
+}
+
 void _mc_cfg_cb_property(const char *name)
 {
   if (_sg_cfg_init_status && not _sg_do_model_check)
@@ -147,6 +158,26 @@ void _mc_cfg_cb_visited(const char *name)
   _sg_mc_max_visited_states = xbt_cfg_get_int(name);
 }
 
+void _mc_cfg_cb_workers(const char *name)
+{
+  if (_sg_cfg_init_status && not _sg_do_model_check)
+    xbt_die("You are specifying a number of workers after the initialization (through MSG_config?), but model-checking was not activated at config time (through --cfg=model-check:1). This won't work, sorry.");
+
+  _sg_mc_workers = xbt_cfg_get_int(name);
+  if (_sg_mc_workers < 1)
+    xbt_die("The number of workers of the model-checker must be positive");
+}
+
+void _mc_cfg_cb_compare_threads(const char *name)
+{
+  if (_sg_cfg_init_status && not _sg_do_model_check)
+    xbt_die("You are specifying a number of comparison threads after the initialization (through MSG_config?), but model-checking was not activated at config time (through --cfg=model-check:1). This won't work, sorry.");
+
+  _sg_mc_compare_threads = xbt_cfg_get_int(name);
+  if (_sg_mc_compare_threads < 1)
+    xbt_die("The number of comparison threads of the model-checker must be positive");
+}
+
 void _mc_cfg_cb_dot_output(const char *name)
 {
   if (_sg_cfg_init_status && not _sg_do_model_check)
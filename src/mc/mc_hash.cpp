@@ -1,4 +1,4 @@
-/* Copyright (c) 2014-2015. The SimGrid Team.
+/* Copyright (c) 2014-2017. The SimGrid Team.
  * All rights reserved.                                                     */
 
 /* This program is free software; you can redistribute it and/or modify it
@@ -7,11 +7,18 @@
 #include <cinttypes>
 
 #include <cstdint>
+#include <cstring>
+
+#include <algorithm>
 
 #include "xbt/log.h"
 
 #include "src/mc/mc_private.h"
 #include "src/mc/mc_snapshot.h"
+#include "src/mc/mc_dwarf.hpp"
+#include "src/mc/ObjectInformation.hpp"
+#include "src/mc/Type.hpp"
+#include "src/mc/Variable.hpp"
 #include "mc/datatypes.h"
 #include "src/mc/mc_hash.hpp"
 #include <mc/mc.h>
@@ -28,9 +35,20 @@ class djb_hash {
 
 public:
   template<class T>
-  void update(T& x)
+  void update(T x)
+  {
+    state_ = (state_ << 5) + state_ + (hash_type) x;
+  }
+  void update_bytes(const void* data, std::size_t size)
   {
-    state_ = (state_ << 5) + state_ + state_;
+    const char* bytes = (const char*) data;
+    std::uint64_t word;
+    for (; size >= sizeof(word); size -= sizeof(word), bytes += sizeof(word)) {
+      memcpy(&word, bytes, sizeof(word));
+      this->update(word);
+    }
+    for (; size > 0; --size, ++bytes)
+      this->update((unsigned char) *bytes);
   }
   hash_type value()
   {
@@ -40,18 +58,180 @@ public:
 
 }
 
+/** Get the type of a global variable if its comparison is a plain memcmp
+ *
+ *  Only those global variables can be hashed: the other ones (pointers,
+ *  structures...) are compared modulo the layout of the heap and two equal
+ *  states could have different bytes there.
+ */
+static simgrid::mc::Type* hashable_type(simgrid::mc::Type* type)
+{
+  while (type && (type->type == DW_TAG_typedef || type->type == DW_TAG_const_type
+                  || type->type == DW_TAG_volatile_type))
+    type = type->subtype;
+  if (type == nullptr || type->byte_size <= 0)
+    return nullptr;
+  switch (type->type) {
+  case DW_TAG_base_type:
+    // The chars are handled as strings by the comparison:
+    return type->name != "char" ? type : nullptr;
+  case DW_TAG_enumeration_type:
+    return type;
+  default:
+    return nullptr;
+  }
+}
+
+static void hash_global_variables(djb_hash& hash, simgrid::mc::ObjectInformation* object_info,
+                                  mc_mem_region_t region)
+{
+  if (region->storage_type() == simgrid::mc::StorageType::Privatized) {
+    for (simgrid::mc::RegionSnapshot& subregion : region->privatized_data())
+      hash_global_variables(hash, object_info, &subregion);
+    return;
+  }
+
+  for (simgrid::mc::Variable const& variable : object_info->global_variables) {
+    simgrid::mc::Type* type = hashable_type(variable.type);
+    if (type == nullptr)
+      continue;
+    std::size_t size = type->byte_size;
+    char* address = (char*) variable.address;
+    char buffer[16];
+    if (size > sizeof(buffer) || address < object_info->start_rw || address + size > object_info->end_rw
+        || not region->contain(remote(address + size - 1)))
+      continue;
+    hash.update_bytes(MC_region_read(region, buffer, address, size), size);
+  }
+}
+
+/** Compute the fingerprint of a state
+ *
+ *  It only covers what must be strictly identical for snapshot_compare() to
+ *  find two states equal: the actors, the size of the heap and of the stacks,
+ *  the frames and the values of the global variables which are compared byte
+ *  per byte. Equal states have the same fingerprint, and states with
+ *  different fingerprints do not need to be compared.
+ */
 hash_type hash(Snapshot const& snapshot)
 {
   XBT_DEBUG("START hash %i", snapshot.num_state);
   djb_hash hash;
-  // TODO, nb_processes
-  // TODO, heap_bytes_used
-  // TODO, root variables
-  // TODO, basic stack frame information
-  // TODO, stack frame local variables
+
+  hash.update(snapshot.enabled_processes.size());
+  for (pid_t pid : snapshot.enabled_processes)
+    hash.update(pid);
+  hash.update(snapshot.heap_bytes_used);
+
+  for (std::size_t size : snapshot.stack_sizes)
+    hash.update(size);
+  for (s_mc_snapshot_stack_t const& stack : snapshot.stacks) {
+    hash.update(stack.process_index);
+    hash.update(stack.local_variables.size());
+    for (s_local_variable_t const& variable : stack.local_variables) {
+      hash.update((std::uintptr_t) variable.subprogram);
+      hash.update(variable.ip);
+    }
+  }
+
+  for (std::unique_ptr<s_mc_mem_region_t> const& region : snapshot.snapshot_regions)
+    if (region && region->region_type() == simgrid::mc::RegionType::Data)
+      hash_global_variables(hash, region->object_info(), region.get());
+
   XBT_DEBUG("END hash %i", snapshot.num_state);
   return hash.value();
 }
 
+static void hash_region_content(djb_hash& hash, simgrid::mc::RegionSnapshot const& region)
+{
+  hash.update(region.start().address());
+  hash.update(region.size());
+  switch (region.storage_type()) {
+  case simgrid::mc::StorageType::NoData:
+  default:
+    break;
+  case simgrid::mc::StorageType::Flat:
+    hash.update_bytes(region.flat_data().get(), region.size());
+    break;
+  case simgrid::mc::StorageType::Chunked:
+    // Reuse the hashes computed when the pages were stored:
+    for (std::size_t i = 0; i != region.page_data().page_count(); ++i)
+      hash.update(region.page_data().page_hash(i));
+    break;
+  case simgrid::mc::StorageType::Privatized:
+    for (simgrid::mc::RegionSnapshot const& subregion : region.privatized_data())
+      hash_region_content(hash, subregion);
+    break;
+  }
+}
+
+hash_type hash_content(Snapshot const& snapshot)
+{
+  djb_hash hash;
+  for (std::unique_ptr<s_mc_mem_region_t> const& region : snapshot.snapshot_regions)
+    if (region)
+      hash_region_content(hash, *region);
+  return hash.value();
+}
+
+static bool same_region_content(simgrid::mc::RegionSnapshot const& region1,
+                                simgrid::mc::RegionSnapshot const& region2)
+{
+  if (region1.start() != region2.start() || region1.size() != region2.size()
+      || region1.storage_type() != region2.storage_type())
+    return false;
+  switch (region1.storage_type()) {
+  case simgrid::mc::StorageType::NoData:
+  default:
+    return true;
+  case simgrid::mc::StorageType::Flat:
+    return memcmp(region1.flat_data().get(), region2.flat_data().get(), region1.size()) == 0;
+  case simgrid::mc::StorageType::Chunked: {
+    // The page store never holds two pages with the same content:
+    simgrid::mc::ChunkedData const& pages1 = region1.page_data();
+    simgrid::mc::ChunkedData const& pages2 = region2.page_data();
+    return pages1.page_count() == pages2.page_count()
+           && std::equal(pages1.pagenos(), pages1.pagenos() + pages1.page_count(), pages2.pagenos());
+  }
+  case simgrid::mc::StorageType::Privatized:
+    return region1.privatized_data().size() == region2.privatized_data().size()
+           && std::equal(region1.privatized_data().begin(), region1.privatized_data().end(),
+                         region2.privatized_data().begin(), same_region_content);
+  }
+}
+
+/** Whether two snapshots hold exactly the same memory
+ *
+ *  Such states are equal, without having to go through snapshot_compare().
+ */
+bool same_content(Snapshot const& s1, Snapshot const& s2)
+{
+  if (s1.content_hash != s2.content_hash || s1.enabled_processes != s2.enabled_processes
+      || s1.privatization_index != s2.privatization_index || s1.stack_sizes != s2.stack_sizes
+      || s1.stacks.size() != s2.stacks.size() || s1.snapshot_regions.size() != s2.snapshot_regions.size())
+    return false;
+
+  for (std::size_t i = 0; i != s1.stacks.size(); ++i) {
+    std::vector<s_local_variable_t> const& variables1 = s1.stacks[i].local_variables;
+    std::vector<s_local_variable_t> const& variables2 = s2.stacks[i].local_variables;
+    if (s1.stacks[i].process_index != s2.stacks[i].process_index || variables1.size() != variables2.size())
+      return false;
+    for (std::size_t j = 0; j != variables1.size(); ++j)
+      if (variables1[j].subprogram != variables2[j].subprogram || variables1[j].ip != variables2[j].ip
+          || variables1[j].name != variables2[j].name || variables1[j].address != variables2[j].address)
+        return false;
+  }
+
+  for (std::size_t i = 0; i != s1.snapshot_regions.size(); ++i) {
+    s_mc_mem_region_t* region1 = s1.snapshot_regions[i].get();
+    s_mc_mem_region_t* region2 = s2.snapshot_regions[i].get();
+    if ((region1 == nullptr) != (region2 == nullptr))
+      return false;
+    if (region1 && not same_region_content(*region1, *region2))
+      return false;
+  }
+  return true;
+}
+
 }
 }
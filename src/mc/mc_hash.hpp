@@ -14,7 +14,11 @@ namespace mc {
 
 typedef std::uint64_t hash_type;
 
+/** Fingerprint of a state: equal states have the same fingerprint */
 XBT_PRIVATE hash_type hash(simgrid::mc::Snapshot const& snapshot);
+/** Hash of the memory of a snapshot, from the hashes of its pages */
+XBT_PRIVATE hash_type hash_content(simgrid::mc::Snapshot const& snapshot);
+XBT_PRIVATE bool same_content(simgrid::mc::Snapshot const& s1, simgrid::mc::Snapshot const& s2);
 
 }
 }
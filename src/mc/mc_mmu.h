@@ -6,6 +6,8 @@
 #ifndef SIMGRID_MC_MMU_H
 #define SIMGRID_MC_MMU_H
 
+#include <cstdint>
+
 #include "xbt/misc.h" // xbt_pagesize...
 
 namespace simgrid {
@@ -51,6 +53,9 @@ static XBT_ALWAYS_INLINE std::uintptr_t join(std::pair<std::size_t, std::uintptr
   return join(value.first, value.second);
 }
 
+/** Bit of the pagemap entries (`/proc/$pid/pagemap`) set when the page was written since the last reset */
+constexpr std::uint64_t soft_dirty = ((std::uint64_t) 1) << 55;
+
 static XBT_ALWAYS_INLINE bool sameChunk(std::uintptr_t a, std::uintptr_t b)
 {
   return (a >> xbt_pagebits) == (b >> xbt_pagebits);
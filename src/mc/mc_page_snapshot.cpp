@@ -9,6 +9,9 @@
 
 #include <unistd.h> // pread, pwrite
 
+#include <cstdint>
+#include <vector>
+
 #include "src/mc/PageStore.hpp"
 #include "src/mc/mc_mmu.h"
 #include "src/mc/mc_private.h"
@@ -27,13 +30,21 @@ extern "C" {
  *  (the modified pages will not be touched).
  *
  *  @param start_addr
- *  @param page_count       Number of pages of the region
- *  @param pagenos
+ *  @param pages_copy       Pages of the snapshot
+ *  @param reference        Pages of the snapshot taken or restored when the soft-dirty bits were reset (or nullptr)
+ *  @param pagemap          Pagemap entries of the pages of the region (or nullptr)
  */
 void mc_restore_page_snapshot_region(simgrid::mc::Process* process,
-  void* start_addr, simgrid::mc::ChunkedData const& pages_copy)
+  void* start_addr, simgrid::mc::ChunkedData const& pages_copy,
+  simgrid::mc::ChunkedData const* reference, const std::uint64_t* pagemap)
 {
   for (size_t i = 0; i != pages_copy.page_count(); ++i) {
+    // The page was not written since the reference, which has the same one:
+    if (reference && pagemap && i < reference->page_count()
+        && reference->pageno(i) == pages_copy.pageno(i)
+        && not (pagemap[i] & simgrid::mc::mmu::soft_dirty))
+      continue;
+
     // Otherwise, copy the page:
     void* target_page = (void*) simgrid::mc::mmu::join(i, (std::uintptr_t) start_addr);
     const void* source_page = pages_copy.page(i);
@@ -43,13 +54,18 @@ void mc_restore_page_snapshot_region(simgrid::mc::Process* process,
 
 // ***** High level API
 
-void mc_region_restore_sparse(simgrid::mc::Process* process, mc_mem_region_t reg)
+void mc_region_restore_sparse(simgrid::mc::Process* process, mc_mem_region_t reg, mc_mem_region_t reference)
 {
   xbt_assert(((reg->permanent_address().address()) & (xbt_pagesize-1)) == 0,
     "Not at the beginning of a page");
   xbt_assert(simgrid::mc::mmu::chunkCount(reg->size()) == reg->page_data().page_count());
+  std::vector<std::uint64_t> pagemap;
+  bool incremental = simgrid::mc::read_soft_dirty(pagemap, reference,
+    (void*) reg->start().address(), (void*) reg->permanent_address().address(), reg->size());
   mc_restore_page_snapshot_region(process,
-    (void*) reg->permanent_address().address(), reg->page_data());
+    (void*) reg->permanent_address().address(), reg->page_data(),
+    incremental ? &reference->page_data() : nullptr,
+    incremental ? pagemap.data() : nullptr);
 }
 
 }
@@ -10,6 +10,10 @@
 #include "xbt/automaton.h"
 
 #ifdef __cplusplus
+#include <tuple>
+#include <utility>
+#include <vector>
+
 #include "src/mc/mc_forward.hpp"
 #include "src/xbt/memory_map.hpp"
 #endif
@@ -26,6 +30,15 @@ struct DerefAndCompareByActorsCountAndUsedHeap {
   }
 };
 
+struct DerefAndCompareByActorsCountUsedHeapAndHash {
+  template<class X, class Y>
+  bool operator()(X const& a, Y const& b)
+  {
+    return std::make_tuple(a->actors_count, a->heap_bytes_used, a->system_state->hash) <
+           std::make_tuple(b->actors_count, b->heap_bytes_used, b->system_state->hash);
+  }
+};
+
 }
 }
 #endif
@@ -59,6 +72,9 @@ XBT_PRIVATE void find_object_address(
 
 XBT_PRIVATE
 int snapshot_compare(int num1, simgrid::mc::Snapshot* s1, int num2, simgrid::mc::Snapshot* s2);
+XBT_PRIVATE
+int snapshot_compare_first(std::vector<std::pair<int, simgrid::mc::Snapshot*>> const& snapshots, int num,
+                           simgrid::mc::Snapshot* snapshot);
 
 // Move is somewhere else (in the LivenessChecker class, in the Session class?):
 extern XBT_PRIVATE xbt_automaton_t property_automaton;
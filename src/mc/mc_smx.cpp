@@ -69,15 +69,15 @@ static void MC_process_refresh_simix_actor_dynar(simgrid::mc::Process* process,
   smx_actor_t* data = (smx_actor_t*)malloc(dynar.elmsize * dynar.used);
   process->read_bytes(data, dynar.elmsize * dynar.used, dynar.data);
 
-  // Load each element of the vector from the MCed process:
+  // Load all the elements of the vector from the MCed process at once:
+  target.resize(dynar.used);
+  std::vector<simgrid::mc::ReadRequest> requests(dynar.used);
   for (unsigned int i = 0; i < dynar.used; ++i) {
-
-    simgrid::mc::ActorInformation info;
-    info.address  = data[i];
-    info.hostname = nullptr;
-    process->read_bytes(&info.copy, sizeof(info.copy), remote(data[i]));
-    target.push_back(std::move(info));
+    target[i].address  = data[i];
+    target[i].hostname = nullptr;
+    requests[i]        = {target[i].copy.getBuffer(), sizeof(target[i].copy), remote(data[i])};
   }
+  process->read_bytes_v(requests.data(), requests.size());
   free(data);
 }
 namespace simgrid {
@@ -231,3 +231,23 @@ smx_simcall_t MC_state_get_request(simgrid::mc::State* state)
   }
   return nullptr;
 }
+
+/* Select the given transition in the state, as MC_state_get_request() would have done
+ *
+ * This is used to replay a path of the exploration graph. Returns nullptr if this transition is not enabled.
+ */
+smx_simcall_t MC_state_choose_request(simgrid::mc::State* state, simgrid::mc::Transition const& transition)
+{
+  for (auto& actor : mc_model_checker->process().actors()) {
+    smx_actor_t issuer = actor.copy.getBuffer();
+    if (issuer->pid != (unsigned long)transition.pid)
+      continue;
+    state->actorStates[issuer->pid].consider();
+    smx_simcall_t res;
+    while ((res = MC_state_get_request_for_process(state, issuer)) != nullptr)
+      if (state->transition.argument == transition.argument)
+        return res;
+    return nullptr;
+  }
+  return nullptr;
+}
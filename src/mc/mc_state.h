@@ -145,5 +145,7 @@ struct XBT_PRIVATE State {
 }
 
 XBT_PRIVATE smx_simcall_t MC_state_get_request(simgrid::mc::State* state);
+XBT_PRIVATE smx_simcall_t MC_state_choose_request(simgrid::mc::State* state,
+                                                  simgrid::mc::Transition const& transition);
 
 #endif
@@ -30,25 +30,13 @@ void MSG_action_exit()
  */
 msg_error_t MSG_action_trace_run(char *path)
 {
-  if (path) {
-    simgrid::xbt::action_fs = new std::ifstream(path, std::ifstream::in);
-  }
+  if (path)
+    simgrid::xbt::replay_trace_open(path);
 
   msg_error_t res = MSG_main();
 
-  if (not simgrid::xbt::action_queues.empty()) {
-    XBT_WARN("Not all actions got consumed. If the simulation ended successfully (without deadlock),"
-             " you may want to add new processes to your deployment file.");
-
-    for (auto actions_of : simgrid::xbt::action_queues) {
-      XBT_WARN("Still %zu actions for %s", actions_of.second->size(), actions_of.first.c_str());
-    }
-  }
-
-  if (path) {
-    delete simgrid::xbt::action_fs;
-    simgrid::xbt::action_fs = nullptr;
-  }
+  if (path)
+    simgrid::xbt::replay_trace_close();
 
   return res;
 }
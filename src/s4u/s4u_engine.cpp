@@ -143,6 +143,7 @@ void Engine::netpointRegister(simgrid::kernel::routing::NetPoint* point)
 {
 //  simgrid::simix::kernelImmediate([&]{ FIXME: this segfaults in set_thread
   pimpl->netpoints_[point->name()] = point;
+  simgrid::kernel::routing::NetZoneImpl::invalidateRouteCache();
 //  });
 }
 /** @brief Unregister a given netpoint */
@@ -150,10 +151,21 @@ void Engine::netpointUnregister(simgrid::kernel::routing::NetPoint* point)
 {
   simgrid::simix::kernelImmediate([this, point] {
     pimpl->netpoints_.erase(point->name());
+    simgrid::kernel::routing::NetZoneImpl::invalidateRouteCache();
     delete point;
   });
 }
 
+unsigned long long Engine::getRouteCacheHits()
+{
+  return simgrid::kernel::routing::NetZoneImpl::routeCacheHits();
+}
+
+unsigned long long Engine::getRouteCacheMisses()
+{
+  return simgrid::kernel::routing::NetZoneImpl::routeCacheMisses();
+}
+
 bool Engine::isInitialized()
 {
   return Engine::instance_ != nullptr;
@@ -39,7 +39,7 @@ MailboxPtr Mailbox::byName(std::string name)
 
 bool Mailbox::empty()
 {
-  return pimpl_->comm_queue.empty();
+  return pimpl_->empty();
 }
 
 bool Mailbox::listen()
@@ -49,7 +49,7 @@ bool Mailbox::listen()
 
 smx_activity_t Mailbox::front()
 {
-  return pimpl_->comm_queue.empty() ? nullptr : pimpl_->comm_queue.front();
+  return pimpl_->front();
 }
 
 void Mailbox::setReceiver(ActorPtr actor) {
@@ -258,10 +258,12 @@ static void _sg_cfg_cb_contexts_parallel_mode(const char *name)
     SIMIX_context_set_parallel_mode(XBT_PARMAP_FUTEX);
   } else if (not strcmp(mode_name, "busy_wait")) {
     SIMIX_context_set_parallel_mode(XBT_PARMAP_BUSY_WAIT);
+  } else if (not strcmp(mode_name, "work_stealing")) {
+    SIMIX_context_set_parallel_mode(XBT_PARMAP_WORK_STEALING);
   }
   else {
     xbt_die("Command line setting of the parallel synchronization mode should "
-            "be one of \"posix\", \"futex\" or \"busy_wait\"");
+            "be one of \"posix\", \"futex\", \"busy_wait\" or \"work_stealing\"");
   }
 }
 
@@ -339,6 +341,14 @@ void sg_config_init(int *argc, char **argv)
                             "processes on each host, at higher level. (default: -1 means no such limitation)");
   xbt_cfg_register_alias("maxmin/concurrency-limit", "maxmin/concurrency_limit");
 
+  simgrid::config::bindFlag(sg_surf_calendar_queue, "surf/calendar-queue",
+                            "Keep the events of the traces in a calendar queue instead of a heap (faster with many "
+                            "traces, but the simultaneous events are not applied in the same order)");
+
+  simgrid::config::bindFlag(sg_maxmin_soa, "maxmin/soa",
+                            "Solve the maxmin systems on contiguous arrays instead of walking the intrusive lists "
+                            "(faster on very large systems)");
+
   /* The parameters of network models */
 
   // real default for "network/sender-gap" is set in network_smpi.cpp:
@@ -360,6 +370,14 @@ void sg_config_init(int *argc, char **argv)
       sg_weight_S_parameter, {"network/weight-S", "network/weight_S"},
       "Correction factor to apply to the weight of competing streams (default value set by network model)");
 
+  simgrid::config::bindFlag(sg_route_cache_size, "network/route-cache",
+                            "Maximal amount of routes kept in cache once the platform is loaded (0 to disable)");
+  simgrid::config::bindFlag(sg_route_cache_shards, "network/route-cache-shards",
+                            "Amount of independently locked parts of the route cache (more helps parallel actors)");
+  simgrid::config::bindFlag(sg_dijkstra_threads, "network/dijkstra-threads",
+                            "Number of threads precomputing all the routes of the Dijkstra zones when sealing them "
+                            "(0 to compute the routes on need)");
+
   /* Inclusion path */
   simgrid::config::declareFlag<std::string>("path", "Lookup path for inclusions in platform and deployment XML files",
                                             "", [](std::string const& path) {
@@ -390,6 +408,8 @@ void sg_config_init(int *argc, char **argv)
 
     xbt_cfg_register_boolean("model-check/sparse-checkpoint", "no", _mc_cfg_cb_sparse_checkpoint, "Use sparse per-page snapshots.");
     xbt_cfg_register_boolean("model-check/ksm", "no", _mc_cfg_cb_ksm, "Kernel same-page merging");
+    xbt_cfg_register_boolean("model-check/soft-dirty", "no", _mc_cfg_cb_soft_dirty,
+        "Only read the pages written since the previous snapshot (implies per-page snapshots)");
 
     xbt_cfg_register_string("model-check/property","", _mc_cfg_cb_property,
         "Name of the file containing the property, as formated by the ltl2ba program.");
@@ -416,6 +436,12 @@ void sg_config_init(int *argc, char **argv)
     xbt_cfg_register_int("model-check/visited", 0, _mc_cfg_cb_visited,
         "Specify the number of visited state stored for state comparison reduction. If value=5, the last 5 visited states are stored. If value=0 (the default), all states are stored.");
 
+    xbt_cfg_register_int("model-check/workers", 1, _mc_cfg_cb_workers,
+        "Number of worker checkers exploring the state space in parallel (safety properties only)");
+
+    xbt_cfg_register_int("model-check/compare-threads", 1, _mc_cfg_cb_compare_threads,
+        "Number of threads comparing a new state with the visited states");
+
     xbt_cfg_register_string("model-check/dot-output", "", _mc_cfg_cb_dot_output, "Name of dot output file corresponding to graph state");
     xbt_cfg_register_alias("model-check/dot-output","model-check/dot_output");
     xbt_cfg_register_boolean("model-check/termination", "no", _mc_cfg_cb_termination, "Whether to enable non progressive cycle detection");
@@ -448,10 +474,10 @@ void sg_config_init(int *argc, char **argv)
     /* synchronization mode for parallel user contexts */
 #if HAVE_FUTEX_H
     xbt_cfg_register_string("contexts/synchro", "futex",     _sg_cfg_cb_contexts_parallel_mode,
-        "Synchronization mode to use when running contexts in parallel (either futex, posix or busy_wait)");
+        "Synchronization mode to use when running contexts in parallel (either futex, posix, busy_wait or work_stealing)");
 #else //No futex on mac and posix is unimplememted yet
     xbt_cfg_register_string("contexts/synchro", "busy_wait", _sg_cfg_cb_contexts_parallel_mode,
-        "Synchronization mode to use when running contexts in parallel (either futex, posix or busy_wait)");
+        "Synchronization mode to use when running contexts in parallel (either futex, posix, busy_wait or work_stealing)");
 #endif
 
     xbt_cfg_register_boolean("network/crosstraffic", "yes", _sg_cfg_cb__surf_network_crosstraffic,
@@ -5,11 +5,14 @@
 /* This program is free software; you can redistribute it and/or modify it
  * under the terms of the license (GNU LGPL) which comes with this package. */
 
+#include <algorithm>
 #include <cerrno>
 #include <cstring>
 
+#include <mutex>
 #include <utility>
 #include <string>
+#include <vector>
 
 #include <xbt/config.hpp>
 #include <xbt/log.h>
@@ -93,6 +96,145 @@ static int smx_parallel_contexts = 1;
 static int smx_parallel_threshold = 2;
 static e_xbt_parmap_mode_t smx_parallel_synchronization_mode = XBT_PARMAP_DEFAULT;
 
+static simgrid::config::Flag<int> context_stack_pool(
+    "contexts/stack-pool", "Maximal amount of released context stacks kept for the next contexts (0: no pool)", 128);
+static simgrid::config::Flag<int> context_stack_region(
+    "contexts/stack-region", "Size (in MiB) of a memory region reserved for all the context stacks (0: no region)", 0);
+
+static void* stack_allocate();
+static void stack_free(void* stack);
+
+namespace {
+/** @brief Recycles the context stacks, with their guard pages already in place
+ *
+ * Allocating a protected stack costs an allocation and two mprotect() calls, and the same again on release. The
+ * released stacks are thus kept (up to contexts/stack-pool of them) and given to the next contexts as is.
+ *
+ * With contexts/stack-region, the stacks are carved in one large region mapped once, whose pages are only committed
+ * when touched. Its stacks are always recycled, and the region is only unmapped at exit. The stacks are allocated
+ * separately once the region is full.
+ */
+class StackPool {
+public:
+  void* get();
+  bool put(void* stack);
+  void* carve();
+  bool inRegion(void* stack) const
+  {
+    return region_ != nullptr && static_cast<char*>(stack) >= region_ &&
+           static_cast<char*>(stack) < region_ + region_size_;
+  }
+  void clear();
+
+  /* Statistics */
+  size_t allocated = 0; // stacks allocated (not found in the pool)
+  size_t reused    = 0; // stacks taken from the pool
+  size_t in_use    = 0;
+  size_t peak      = 0; // maximal amount of stacks in use at the same time
+
+private:
+  std::mutex mutex_;
+  std::vector<void*> free_; // stacks (past their guard pages) ready to reuse
+  size_t stack_size_ = 0;   // size of the pooled stacks, that are flushed if the stack size changes
+  size_t guard_size_ = 0;
+
+  char* region_       = nullptr;
+  size_t region_size_ = 0;
+  size_t region_used_ = 0;
+};
+StackPool stack_pool;
+
+/** Returns a pooled stack, or nullptr */
+void* StackPool::get()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (stack_size_ != static_cast<size_t>(smx_context_stack_size) ||
+      guard_size_ != static_cast<size_t>(smx_context_guard_size)) {
+    xbt_assert(in_use == 0 || free_.empty(), "The size of the context stacks changed after their creation");
+    free_.clear(); // Only possible before the first stack
+    stack_size_ = smx_context_stack_size;
+    guard_size_ = smx_context_guard_size;
+  }
+  in_use++;
+  if (in_use > peak)
+    peak = in_use;
+  if (free_.empty()) {
+    allocated++;
+    return nullptr;
+  }
+  reused++;
+  void* stack = free_.back();
+  free_.pop_back();
+  return stack;
+}
+
+/** Keeps a released stack for the next contexts, unless the pool is full. Returns whether the stack was kept. */
+bool StackPool::put(void* stack)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  in_use--;
+  if (not inRegion(stack) && free_.size() >= static_cast<size_t>(std::max(0, context_stack_pool.get())))
+    return false;
+  free_.push_back(stack);
+  return true;
+}
+
+/** Takes a new stack (past its guard pages) from the region, or returns nullptr if there is no room left */
+void* StackPool::carve()
+{
+#ifndef _WIN32
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (region_ == nullptr && region_size_ == 0) {
+    region_size_ = static_cast<size_t>(context_stack_region) << 20;
+    if (region_size_ > 0) {
+      void* region = mmap(nullptr, region_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+                          -1, 0);
+      if (region == MAP_FAILED) {
+        XBT_WARN("Cannot reserve %d MiB for the context stacks: %s", context_stack_region.get(), strerror(errno));
+        region_size_ = 1; // Don't try again
+      } else {
+        region_ = static_cast<char*>(region);
+      }
+    }
+  }
+  size_t size = smx_context_guard_size + smx_context_stack_size;
+  size        = (size + xbt_pagesize - 1) & ~static_cast<size_t>(xbt_pagesize - 1); // Keep the guards page-aligned
+  if (region_ == nullptr || region_used_ + size > region_size_)
+    return nullptr;
+  char* stack = region_ + region_used_;
+  region_used_ += size;
+  return stack;
+#else
+  return nullptr;
+#endif
+}
+
+/** Frees the pooled stacks, and the region if no stack is still used */
+void StackPool::clear()
+{
+  if (allocated > 0)
+    XBT_VERB("Context stacks: %zu allocated, %zu reused, at most %zu in use (%zu KiB)", allocated, reused, peak,
+             peak * (stack_size_ + guard_size_) / 1024);
+  std::vector<void*> stacks;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stacks.swap(free_);
+  }
+  for (void* stack : stacks)
+    if (not inRegion(stack))
+      stack_free(stack);
+#ifndef _WIN32
+  if (region_ != nullptr && in_use == 0) {
+    munmap(region_, region_size_);
+    region_      = nullptr;
+    region_size_ = 0;
+    region_used_ = 0;
+  }
+#endif
+  allocated = reused = peak = 0;
+}
+}
+
 /**
  * This function is called by SIMIX_global_init() to initialize the context module.
  */
@@ -161,9 +303,11 @@ void SIMIX_context_mod_exit()
 {
   delete simix_global->context_factory;
   simix_global->context_factory = nullptr;
+  stack_pool.clear();
 }
 
-void *SIMIX_context_stack_new()
+/** Allocates a stack (past its guard pages, if any) */
+static void* stack_allocate()
 {
   void *stack;
 
@@ -210,6 +354,48 @@ void *SIMIX_context_stack_new()
   } else {
     stack = xbt_malloc0(smx_context_stack_size);
   }
+  return stack;
+}
+
+/** Frees a stack allocated by stack_allocate() */
+static void stack_free(void* stack)
+{
+#ifndef _WIN32
+  if (smx_context_guard_size > 0 && not MC_is_active()) {
+    stack = (char *)stack - smx_context_guard_size;
+    if (mprotect(stack, smx_context_guard_size, PROT_READ | PROT_WRITE) == -1) {
+      XBT_WARN("Failed to remove page protection: %s", strerror(errno));
+      /* try to pursue anyway */
+    }
+#if SIMGRID_HAVE_MC
+    /* Retrieve the saved pointer.  See stack_allocate above. */
+    stack = *((void **)stack - 1);
+#endif
+  }
+#endif /* not windows */
+
+  xbt_free(stack);
+}
+
+void *SIMIX_context_stack_new()
+{
+  void* stack = nullptr;
+
+  if (not MC_is_active()) { // The model checker compares the heaps, so don't keep old stacks around
+    stack = stack_pool.get();
+    if (stack == nullptr) {
+      stack = stack_pool.carve();
+#ifndef _WIN32
+      if (stack != nullptr && smx_context_guard_size > 0) {
+        if (mprotect(stack, smx_context_guard_size, PROT_NONE) == -1)
+          xbt_die("Failed to protect stack: %s.", strerror(errno));
+        stack = (char*)stack + smx_context_guard_size;
+      }
+#endif
+    }
+  }
+  if (stack == nullptr)
+    stack = stack_allocate();
 
 #if HAVE_VALGRIND_H
   unsigned int valgrind_stack_id = VALGRIND_STACK_REGISTER(stack, (char *)stack + smx_context_stack_size);
@@ -230,21 +416,21 @@ void SIMIX_context_stack_delete(void *stack)
   VALGRIND_STACK_DEREGISTER(valgrind_stack_id);
 #endif
 
-#ifndef _WIN32
-  if (smx_context_guard_size > 0 && not MC_is_active()) {
-    stack = (char *)stack - smx_context_guard_size;
-    if (mprotect(stack, smx_context_guard_size, PROT_READ | PROT_WRITE) == -1) {
-      XBT_WARN("Failed to remove page protection: %s", strerror(errno));
-      /* try to pursue anyway */
-    }
-#if SIMGRID_HAVE_MC
-    /* Retrieve the saved pointer.  See SIMIX_context_stack_new above. */
-    stack = *((void **)stack - 1);
-#endif
-  }
-#endif /* not windows */
+  if (MC_is_active() || not stack_pool.put(stack))
+    stack_free(stack);
+}
 
-  xbt_free(stack);
+/**
+ * @brief Returns the statistics of the context stacks
+ * @param allocated amount of stacks that were allocated (not found in the pool)
+ * @param reused amount of stacks that were taken from the pool
+ * @param peak_size maximal size (in bytes, guard pages included) of the stacks used at the same time
+ */
+void SIMIX_context_stack_stats(size_t* allocated, size_t* reused, size_t* peak_size)
+{
+  *allocated = stack_pool.allocated;
+  *reused    = stack_pool.reused;
+  *peak_size = stack_pool.peak * (smx_context_stack_size + smx_context_guard_size);
 }
 
 /** @brief Returns whether some parallel threads are used for the user contexts. */
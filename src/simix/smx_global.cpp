@@ -11,6 +11,7 @@
 #include "src/internal_config.h"
 
 #include <xbt/functional.hpp>
+#include <xbt/heap.hpp>
 
 #include "simgrid/s4u/Engine.hpp"
 #include "simgrid/s4u/Host.hpp"
@@ -51,17 +52,22 @@ XBT_LOG_NEW_CATEGORY(simix, "All SIMIX categories");
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY(simix_kernel, simix, "Logging specific to SIMIX (kernel)");
 
 std::unique_ptr<simgrid::simix::Global> simix_global;
-static xbt_heap_t simix_timers = nullptr;
 
 /** @brief Timer datatype */
 typedef struct s_smx_timer {
   double date = 0.0;
+  int index   = -1; /* position in simix_timers, -1 if not there */
   simgrid::xbt::Task<void()> callback;
 
   s_smx_timer()=default;
   s_smx_timer(double date, simgrid::xbt::Task<void()> callback) : date(date), callback(std::move(callback)) {}
 } s_smx_timer_t;
 
+struct TimerHeapIndex {
+  void operator()(smx_timer_t timer, int i) const { timer->index = i; }
+};
+static simgrid::xbt::Heap<smx_timer_t, TimerHeapIndex> simix_timers;
+
 void (*SMPI_switch_data_segment)(int) = nullptr;
 
 int _sg_do_verbose_exit = 1;
@@ -155,7 +161,7 @@ static void install_segvhandler()
 /********************************* SIMIX **************************************/
 double SIMIX_timer_next()
 {
-  return xbt_heap_size(simix_timers) > 0 ? xbt_heap_maxkey(simix_timers) : -1.0;
+  return simix_timers.empty() ? -1.0 : simix_timers.top_key();
 }
 
 static void kill_process(smx_actor_t process)
@@ -241,11 +247,6 @@ void SIMIX_global_init(int *argc, char **argv)
     });
   }
 
-  if (not simix_timers)
-    simix_timers = xbt_heap_new(8, [](void* p) {
-      delete static_cast<smx_timer_t>(p);
-    });
-
   if (xbt_cfg_get_boolean("clean-atexit"))
     atexit(SIMIX_clean);
 
@@ -290,8 +291,8 @@ void SIMIX_clean()
   /* Exit the SIMIX network module */
   SIMIX_mailbox_exit();
 
-  xbt_heap_free(simix_timers);
-  simix_timers = nullptr;
+  while (not simix_timers.empty())
+    delete simix_timers.pop();
   /* Free the remaining data structures */
   xbt_dynar_free(&simix_global->process_to_run);
   xbt_dynar_free(&simix_global->process_that_ran);
@@ -374,11 +375,11 @@ static void SIMIX_wake_processes()
 static bool SIMIX_execute_timers()
 {
   bool result = false;
-  while (xbt_heap_size(simix_timers) > 0 && SIMIX_get_clock() >= SIMIX_timer_next()) {
+  while (not simix_timers.empty() && SIMIX_get_clock() >= simix_timers.top_key()) {
     result = true;
      //FIXME: make the timers being real callbacks
      // (i.e. provide dispatchers that read and expand the args)
-     smx_timer_t timer = (smx_timer_t) xbt_heap_pop(simix_timers);
+     smx_timer_t timer = simix_timers.pop();
      try {
        timer->callback();
      }
@@ -580,20 +581,21 @@ void SIMIX_run()
 smx_timer_t SIMIX_timer_set(double date, void (*callback)(void*), void *arg)
 {
   smx_timer_t timer = new s_smx_timer_t(date, [=](){ callback(arg); });
-  xbt_heap_push(simix_timers, timer, date);
+  simix_timers.push(timer, date);
   return timer;
 }
 
 smx_timer_t SIMIX_timer_set(double date, simgrid::xbt::Task<void()> callback)
 {
   smx_timer_t timer = new s_smx_timer_t(date, std::move(callback));
-  xbt_heap_push(simix_timers, timer, date);
+  simix_timers.push(timer, date);
   return timer;
 }
 
 /** @brief cancels a timer that was added earlier */
 void SIMIX_timer_remove(smx_timer_t timer) {
-  xbt_heap_rm_elm(simix_timers, timer, timer->date);
+  if (timer->index >= 0)
+    simix_timers.remove(timer->index);
 }
 
 /** @brief Returns the date at which the timer will trigger (or 0 if nullptr timer) */
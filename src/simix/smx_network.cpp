@@ -28,46 +28,6 @@ static void SIMIX_waitany_remove_simcall_from_actions(smx_simcall_t simcall);
 static void SIMIX_comm_copy_data(smx_activity_t comm);
 static void SIMIX_comm_start(simgrid::kernel::activity::CommImplPtr synchro);
 
-/**
- *  \brief Checks if there is a communication activity queued in a deque matching our needs
- *  \param type The type of communication we are looking for (comm_send, comm_recv)
- *  \return The communication activity if found, nullptr otherwise
- */
-static simgrid::kernel::activity::CommImplPtr
-_find_matching_comm(boost::circular_buffer_space_optimized<smx_activity_t>* deque, e_smx_comm_type_t type,
-                    int (*match_fun)(void*, void*, simgrid::kernel::activity::CommImpl*), void* this_user_data,
-                    simgrid::kernel::activity::CommImplPtr my_synchro, bool remove_matching)
-{
-  void* other_user_data = nullptr;
-
-  for(auto it = deque->begin(); it != deque->end(); it++){
-    simgrid::kernel::activity::CommImplPtr comm =
-        boost::dynamic_pointer_cast<simgrid::kernel::activity::CommImpl>(std::move(*it));
-
-    if (comm->type == SIMIX_COMM_SEND) {
-      other_user_data = comm->src_data;
-    } else if (comm->type == SIMIX_COMM_RECEIVE) {
-      other_user_data = comm->dst_data;
-    }
-    if (comm->type == type && (match_fun == nullptr || match_fun(this_user_data, other_user_data, comm.get())) &&
-        (not comm->match_fun || comm->match_fun(other_user_data, this_user_data, my_synchro.get()))) {
-      XBT_DEBUG("Found a matching communication synchro %p", comm.get());
-      if (remove_matching)
-        deque->erase(it);
-#if SIMGRID_HAVE_MC
-      comm->mbox_cpy = comm->mbox;
-#endif
-      comm->mbox = nullptr;
-      return comm;
-    }
-    XBT_DEBUG("Sorry, communication synchro %p does not match our needs:"
-              " its type is %d but we are looking for a comm of type %d (or maybe the filtering didn't match)",
-              comm.get(), (int)comm->type, (int)type);
-  }
-  XBT_DEBUG("No matching communication synchro found");
-  return nullptr;
-}
-
 /******************************************************************************/
 /*                          Communication synchros                            */
 /******************************************************************************/
@@ -101,7 +61,7 @@ XBT_PRIVATE smx_activity_t simcall_HANDLER_comm_isend(
    *
    * If it is not found then push our communication into the rendez-vous point */
   simgrid::kernel::activity::CommImplPtr other_comm =
-      _find_matching_comm(&mbox->comm_queue, SIMIX_COMM_RECEIVE, match_fun, data, this_comm, /*remove_matching*/ true);
+      mbox->findMatchingComm(SIMIX_COMM_RECEIVE, match_fun, data, this_comm, /*done*/ false, /*remove_matching*/ true);
 
   if (not other_comm) {
     other_comm = std::move(this_comm);
@@ -188,8 +148,8 @@ SIMIX_comm_irecv(smx_actor_t dst_proc, smx_mailbox_t mbox, void* dst_buff, size_
 
     XBT_DEBUG("We have a comm that has probably already been received, trying to match it, to skip the communication");
     //find a match in the list of already received comms
-    other_comm = _find_matching_comm(&mbox->done_comm_queue, SIMIX_COMM_SEND, match_fun, data, this_synchro,
-                                     /*remove_matching*/ true);
+    other_comm = mbox->findMatchingComm(SIMIX_COMM_SEND, match_fun, data, this_synchro, /*done*/ true,
+                                        /*remove_matching*/ true);
     //if not found, assume the receiver came first, register it to the mailbox in the classical way
     if (not other_comm) {
       XBT_DEBUG("We have messages in the permanent receive list, but not the one we are looking for, pushing request into list");
@@ -210,11 +170,11 @@ SIMIX_comm_irecv(smx_actor_t dst_proc, smx_mailbox_t mbox, void* dst_buff, size_
      * ourself so that the other side also gets a chance of choosing if it wants to match with us.
      *
      * If it is not found then push our communication into the rendez-vous point */
-    other_comm = _find_matching_comm(&mbox->comm_queue, SIMIX_COMM_SEND, match_fun, data, this_synchro,
-                                     /*remove_matching*/ true);
+    other_comm = mbox->findMatchingComm(SIMIX_COMM_SEND, match_fun, data, this_synchro, /*done*/ false,
+                                        /*remove_matching*/ true);
 
     if (other_comm == nullptr) {
-      XBT_DEBUG("Receive pushed first (%zu comm enqueued so far)", mbox->comm_queue.size());
+      XBT_DEBUG("Receive pushed first (%zu comm enqueued so far)", mbox->size());
       other_comm = std::move(this_synchro);
       mbox->push(other_comm);
     } else {
@@ -256,7 +216,7 @@ smx_activity_t simcall_HANDLER_comm_iprobe(smx_simcall_t simcall, smx_mailbox_t
 smx_activity_t SIMIX_comm_iprobe(smx_actor_t dst_proc, smx_mailbox_t mbox, int type, simix_match_func_t match_fun,
                                  void* data)
 {
-  XBT_DEBUG("iprobe from %p %p", mbox, &mbox->comm_queue);
+  XBT_DEBUG("iprobe from %p", mbox);
   simgrid::kernel::activity::CommImplPtr this_comm;
   int smx_type;
   if(type == 1){
@@ -269,13 +229,13 @@ smx_activity_t SIMIX_comm_iprobe(smx_actor_t dst_proc, smx_mailbox_t mbox, int t
   smx_activity_t other_synchro=nullptr;
   if (mbox->permanent_receiver != nullptr && not mbox->done_comm_queue.empty()) {
     XBT_DEBUG("first check in the permanent recv mailbox, to see if we already got something");
-    other_synchro = _find_matching_comm(&mbox->done_comm_queue,
-      (e_smx_comm_type_t) smx_type, match_fun, data, this_comm,/*remove_matching*/false);
+    other_synchro = mbox->findMatchingComm((e_smx_comm_type_t)smx_type, match_fun, data, this_comm, /*done*/ true,
+                                           /*remove_matching*/ false);
   }
   if (not other_synchro) {
     XBT_DEBUG("check if we have more luck in the normal mailbox");
-    other_synchro = _find_matching_comm(&mbox->comm_queue,
-      (e_smx_comm_type_t) smx_type, match_fun, data, this_comm,/*remove_matching*/false);
+    other_synchro = mbox->findMatchingComm((e_smx_comm_type_t)smx_type, match_fun, data, this_comm, /*done*/ false,
+                                           /*remove_matching*/ false);
   }
 
   return other_synchro;
@@ -10,6 +10,7 @@
 #include <unordered_map>
 #include <vector>
 #include "src/internal_config.h"
+#include <xbt/config.hpp>
 
 /**
  * Get the address of the beginning of the memory page where addr is located.
@@ -28,6 +29,19 @@ XBT_PRIVATE int smpi_process_papi_event_set();
 
 extern std::unordered_map<std::string, double> location2speedup;
 
+/** @brief Statistics of a sampled block (see the SMPI_SAMPLE_ macros) */
+typedef struct {
+  double threshold; /* maximal stderr requested (if positive) */
+  double relstderr; /* observed stderr so far */
+  double mean;      /* mean of benched times, to be used if the block is disabled */
+  double sum;       /* sum of benched times (to compute the mean and stderr) */
+  double sum_pow2;  /* sum of the square of the benched times (to compute the stderr) */
+  int iters;        /* amount of requested iterations */
+  int count;        /* amount of iterations done so far */
+  int benching;     /* 1: we are benchmarking; 0: we have enough data, no bench anymore */
+  bool initialized; /* false until the block is first entered */
+} smpi_sample_data_t;
+
 /** @brief Returns the last call location (filename, linenumber). Process-specific. */
 extern "C" {
 XBT_PUBLIC(smpi_trace_call_location_t*) smpi_process_get_call_location();
@@ -43,5 +57,14 @@ typedef enum {
 
 extern XBT_PRIVATE int smpi_privatize_global_variables;
 
+/* Options read on every message or computation block */
+extern XBT_PRIVATE simgrid::config::Handle<int> smpi_cfg_async_small_thresh;
+extern XBT_PRIVATE simgrid::config::Handle<int> smpi_cfg_detached_send_thresh;
+extern XBT_PRIVATE simgrid::config::Handle<bool> smpi_cfg_grow_injected_times;
+extern XBT_PRIVATE simgrid::config::Handle<double> smpi_cfg_iprobe_cpu_usage;
+extern XBT_PRIVATE simgrid::config::Handle<bool> smpi_cfg_simulate_computation;
+extern XBT_PRIVATE simgrid::config::Handle<std::string> smpi_cfg_comp_adjustment_file;
+extern XBT_PRIVATE simgrid::config::Handle<std::string> smpi_cfg_papi_events;
+
 #endif
 
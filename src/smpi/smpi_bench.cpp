@@ -16,6 +16,15 @@
 #endif
 #include <math.h> // sqrt
 
+#include <atomic>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #if HAVE_PAPI
 #include <papi.h>
 #endif
@@ -23,18 +32,25 @@
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY(smpi_bench, smpi, "Logging specific to SMPI (benchmarking)");
 
 
-xbt_dict_t samples = nullptr;         /* Allocated on first use */
-
 double smpi_cpu_threshold = -1;
 double smpi_host_speed;
 
 shared_malloc_type smpi_cfg_shared_malloc = shmalloc_global;
+simgrid::config::Handle<int> smpi_cfg_async_small_thresh("smpi/async-small-thresh");
+simgrid::config::Handle<int> smpi_cfg_detached_send_thresh("smpi/send-is-detached-thresh");
+simgrid::config::Handle<bool> smpi_cfg_grow_injected_times("smpi/grow-injected-times");
+simgrid::config::Handle<double> smpi_cfg_iprobe_cpu_usage("smpi/iprobe-cpu-usage");
+simgrid::config::Handle<bool> smpi_cfg_simulate_computation("smpi/simulate-computation");
+simgrid::config::Handle<std::string> smpi_cfg_comp_adjustment_file("smpi/comp-adjustment-file");
+simgrid::config::Handle<std::string> smpi_cfg_papi_events("smpi/papi-events");
 double smpi_total_benched_time = 0;
 smpi_privatization_region_t smpi_privatization_regions;
 
+static void sample_sites_destroy();
+
 void smpi_bench_destroy()
 {
-  xbt_dict_free(&samples);
+  sample_sites_destroy();
 }
 
 extern "C" XBT_PUBLIC(void) smpi_execute_flops_(double *flops);
@@ -95,7 +111,7 @@ void smpi_bench_begin()
     return;
 
 #if HAVE_PAPI
-  if (xbt_cfg_get_string("smpi/papi-events")[0] != '\0') {
+  if (not smpi_cfg_papi_events.get().empty()) {
     int event_set = smpi_process()->papi_event_set();
     // PAPI_start sets everything to 0! See man(3) PAPI_start
     if (PAPI_LOW_LEVEL_INITED == PAPI_is_initialized()) {
@@ -124,7 +140,7 @@ void smpi_bench_end()
    * An MPI function has been called and now is the right time to update
    * our PAPI counters for this process.
    */
-  if (xbt_cfg_get_string("smpi/papi-events")[0] != '\0') {
+  if (not smpi_cfg_papi_events.get().empty()) {
     papi_counter_t& counter_data        = smpi_process()->papi_counters();
     int event_set                       = smpi_process()->papi_event_set();
     std::vector<long long> event_values = std::vector<long long>(counter_data.size());
@@ -149,7 +165,7 @@ void smpi_bench_end()
     xbt_die("Aborting.");
   }
 
-  if (xbt_cfg_get_string("smpi/comp-adjustment-file")[0] != '\0') { // Maybe we need to artificially speed up or slow
+  if (not smpi_cfg_comp_adjustment_file.get().empty()) { // Maybe we need to artificially speed up or slow
     // down our computation based on our statistical analysis.
 
     smpi_trace_call_location_t* loc                            = smpi_process()->call_location();
@@ -161,12 +177,12 @@ void smpi_bench_end()
   }
 
   // Simulate the benchmarked computation unless disabled via command-line argument
-  if (xbt_cfg_get_boolean("smpi/simulate-computation")) {
+  if (smpi_cfg_simulate_computation.get()) {
     smpi_execute(xbt_os_timer_elapsed(timer)/speedup);
   }
 
 #if HAVE_PAPI
-  if (xbt_cfg_get_string("smpi/papi-events")[0] != '\0' && TRACE_smpi_is_enabled()) {
+  if (not smpi_cfg_papi_events.get().empty() && TRACE_smpi_is_enabled()) {
     char container_name[INSTR_DEFAULT_STR_SIZE];
     smpi_container(smpi_process()->index(), container_name, INSTR_DEFAULT_STR_SIZE);
     container_t container        = PJ_container_get(container_name);
@@ -271,26 +287,90 @@ unsigned long long smpi_rastro_timestamp ()
 }
 
 /* ****************************** Functions related to the SMPI_SAMPLE_ macros ************************************/
-typedef struct {
-  double threshold; /* maximal stderr requested (if positive) */
-  double relstderr; /* observed stderr so far */
-  double mean;      /* mean of benched times, to be used if the block is disabled */
-  double sum;       /* sum of benched times (to compute the mean and stderr) */
-  double sum_pow2;  /* sum of the square of the benched times (to compute the stderr) */
-  int iters;        /* amount of requested iterations */
-  int count;        /* amount of iterations done so far */
-  int benching;     /* 1: we are benchmarking; 0: we have enough data, no bench anymore */
-} local_data_t;
-
-static char *sample_location(int global, const char *file, int line) {
-  if (global) {
-    return bprintf("%s:%d", file, line);
-  } else {
-    return bprintf("%s:%d:%d", file, line, smpi_process()->index());
+
+/* Each sampled block gets a site index when it is first entered. The statistics of the SMPI_SAMPLE_GLOBAL blocks are
+ * shared by all processes, those of the SMPI_SAMPLE_LOCAL blocks are kept by each process in a flat array. Both are
+ * indexed by site.
+ *
+ * The sites are found without lock from the address of the __FILE__ literal and the line of the block. The lookup
+ * table is never modified once published: registering a site makes a new copy of it under sample_sites_mutex, which
+ * replaces the former one. The former tables are only freed with the rest of SMPI, as other threads (with parallel
+ * contexts) may still be reading them. The same block may be reached through several __FILE__ addresses (e.g. in the
+ * copies of the binary made by the dlopen privatization), so the sites are registered by file name and line. */
+namespace {
+struct SampleSites {
+  struct KeyHash {
+    std::size_t operator()(const std::pair<const char*, int>& key) const
+    {
+      return std::hash<const char*>()(key.first) * 31 + key.second;
+    }
+  };
+  std::unordered_map<std::pair<const char*, int>, int, KeyHash> ids; /* (__FILE__ address, line) -> site */
+  std::vector<std::pair<const char*, int>> names;                     /* site -> (file, line) */
+  std::vector<smpi_sample_data_t*> global;                            /* site -> SMPI_SAMPLE_GLOBAL statistics */
+};
+}
+
+static std::atomic<const SampleSites*> sample_sites{nullptr};
+static std::vector<std::unique_ptr<const SampleSites>> sample_sites_versions; /* all the tables published so far */
+static std::map<std::pair<std::string, int>, int> sample_site_ids;          /* (file name, line) -> site */
+static std::deque<smpi_sample_data_t> samples_global;                       /* never moved once handed out */
+static std::mutex sample_sites_mutex;
+
+static int sample_register(const char* file, int line)
+{
+  std::pair<const char*, int> key{file, line};
+  const SampleSites* sites = sample_sites.load(std::memory_order_acquire);
+  if (sites != nullptr) {
+    auto it = sites->ids.find(key);
+    if (it != sites->ids.end())
+      return it->second;
+  }
+
+  std::lock_guard<std::mutex> lock(sample_sites_mutex);
+  sites = sample_sites.load(std::memory_order_relaxed);
+  if (sites != nullptr) { // Another thread may have been faster
+    auto it = sites->ids.find(key);
+    if (it != sites->ids.end())
+      return it->second;
+  }
+  SampleSites* next = sites ? new SampleSites(*sites) : new SampleSites();
+  auto res          = sample_site_ids.insert({{file, line}, static_cast<int>(next->names.size())});
+  int site          = res.first->second;
+  if (res.second) {
+    samples_global.emplace_back();
+    next->names.push_back(key);
+    next->global.push_back(&samples_global.back());
   }
+  next->ids.insert({key, site});
+  XBT_DEBUG("Sampled block %s:%d is site %d", file, line, site);
+  sample_sites_versions.emplace_back(next);
+  sample_sites.store(next, std::memory_order_release);
+  return site;
+}
+
+static void sample_sites_destroy()
+{
+  std::lock_guard<std::mutex> lock(sample_sites_mutex);
+  sample_sites.store(nullptr);
+  sample_sites_versions.clear();
+  sample_site_ids.clear();
+  samples_global.clear();
 }
 
-static int sample_enough_benchs(local_data_t *data) {
+static smpi_sample_data_t* sample_data(int global, int site, const char* step)
+{
+  const SampleSites* sites = sample_sites.load(std::memory_order_acquire);
+  xbt_assert(sites != nullptr && site >= 0 && static_cast<unsigned>(site) < sites->names.size(),
+             "Y U NO use SMPI_SAMPLE_* macros? Stop messing directly with smpi_sample_* functions!");
+  XBT_DEBUG("%s %s:%d", step, sites->names[site].first, sites->names[site].second);
+  if (global)
+    return sites->global[site];
+  return smpi_process()->sample(site);
+}
+
+static int sample_enough_benchs(smpi_sample_data_t* data)
+{
   int res = data->count >= data->iters;
   if (data->threshold>0.0) {
     if (data->count <2)
@@ -303,21 +383,17 @@ static int sample_enough_benchs(local_data_t *data) {
   return res;
 }
 
-void smpi_sample_1(int global, const char *file, int line, int iters, double threshold)
+int smpi_sample_1(int global, const char* file, int line, int iters, double threshold)
 {
-  char *loc = sample_location(global, file, line);
+  int site = sample_register(file, line);
 
   smpi_bench_end();     /* Take time from previous, unrelated computation into account */
   smpi_process()->set_sampling(1);
 
-  if (samples==nullptr)
-    samples = xbt_dict_new_homogeneous(free);
-
-  local_data_t *data = static_cast<local_data_t *>(xbt_dict_get_or_null(samples, loc));
-  if (data==nullptr) {
+  smpi_sample_data_t* data = sample_data(global, site, "sample1");
+  if (not data->initialized) {
     xbt_assert(threshold>0 || iters>0,
         "You should provide either a positive amount of iterations to bench, or a positive maximal stderr (or both)");
-    data = static_cast<local_data_t *>( xbt_new(local_data_t, 1));
     data->count = 0;
     data->sum = 0.0;
     data->sum_pow2 = 0.0;
@@ -325,34 +401,30 @@ void smpi_sample_1(int global, const char *file, int line, int iters, double thr
     data->threshold = threshold;
     data->benching = 1; // If we have no data, we need at least one
     data->mean = 0;
-    xbt_dict_set(samples, loc, data, nullptr);
-    XBT_DEBUG("XXXXX First time ever on benched nest %s.",loc);
+    data->initialized = true;
+    XBT_DEBUG("XXXXX First time ever on benched nest %s:%d.", file, line);
   } else {
     if (data->iters != iters || data->threshold != threshold) {
-      XBT_ERROR("Asked to bench block %s with different settings %d, %f is not %d, %f. "
+      XBT_ERROR("Asked to bench block %s:%d with different settings %d, %f is not %d, %f. "
                 "How did you manage to give two numbers at the same line??",
-                loc, data->iters, data->threshold, iters, threshold);
+                file, line, data->iters, data->threshold, iters, threshold);
       THROW_IMPOSSIBLE;
     }
 
     // if we already have some data, check whether sample_2 should get one more bench or whether it should emulate
     // the computation instead
     data->benching = (sample_enough_benchs(data) == 0);
-    XBT_DEBUG("XXXX Re-entering the benched nest %s. %s", loc,
+    XBT_DEBUG("XXXX Re-entering the benched nest %s:%d. %s", file, line,
               (data->benching ? "more benching needed" : "we have enough data, skip computes"));
   }
-  xbt_free(loc);
+  return site;
 }
 
-int smpi_sample_2(int global, const char *file, int line)
+int smpi_sample_2(int global, int site)
 {
-  char *loc = sample_location(global, file, line);
   int res;
 
-  xbt_assert(samples, "Y U NO use SMPI_SAMPLE_* macros? Stop messing directly with smpi_sample_* functions!");
-  local_data_t *data = static_cast<local_data_t *>(xbt_dict_get(samples, loc));
-  XBT_DEBUG("sample2 %s",loc);
-  xbt_free(loc);
+  smpi_sample_data_t* data = sample_data(global, site, "sample2");
 
   if (data->benching==1) {
     // we need to run a new bench
@@ -373,14 +445,9 @@ int smpi_sample_2(int global, const char *file, int line)
   return res;
 }
 
-void smpi_sample_3(int global, const char *file, int line)
+void smpi_sample_3(int global, int site)
 {
-  char *loc = sample_location(global, file, line);
-
-  xbt_assert(samples, "Y U NO use SMPI_SAMPLE_* macros? Stop messing directly with smpi_sample_* functions!");
-  local_data_t *data = static_cast<local_data_t *>(xbt_dict_get(samples, loc));
-  XBT_DEBUG("sample3 %s",loc);
-  xbt_free(loc);
+  smpi_sample_data_t* data = sample_data(global, site, "sample3");
 
   if (data->benching==0)
     THROW_IMPOSSIBLE;
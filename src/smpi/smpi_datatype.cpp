@@ -116,12 +116,16 @@ Datatype::Datatype(char* name, int size,MPI_Aint lb, MPI_Aint ub, int flags) : n
 #endif
 }
 
-Datatype::Datatype(Datatype *datatype, int* ret) : name_(nullptr), lb_(datatype->lb_), ub_(datatype->ub_), flags_(datatype->flags_), refcount_(1)
+Datatype::Datatype(Datatype *datatype, int* ret) : name_(nullptr), size_(datatype->size_), lb_(datatype->lb_), ub_(datatype->ub_), flags_(datatype->flags_), refcount_(1)
 {
   flags_ &= ~DT_FLAG_PREDEFINED;
   *ret = MPI_SUCCESS;
   if(datatype->name_)
     name_ = xbt_strdup(datatype->name_);
+  if (flags_ & DT_FLAG_DERIVED) { // keep the original, which knows the layout, even if the application frees it
+    duplicated_ = datatype;
+    datatype->ref();
+  }
 
   if (not datatype->attributes()->empty()) {
     int flag;
@@ -158,6 +162,8 @@ Datatype::~Datatype(){
   cleanup_attr<Datatype>();
 
   xbt_free(name_);
+  if (duplicated_ != nullptr)
+    unref(duplicated_);
 }
 
 
@@ -188,6 +194,58 @@ void Datatype::unref(MPI_Datatype datatype)
 void Datatype::commit()
 {
   flags_ |= DT_FLAG_COMMITED;
+  if (flags_ & DT_FLAG_DERIVED)
+    blocks();
+}
+
+/* Flatten the type description once into a list of contiguous runs, so that (un)serializing only has to walk it.
+ * Committing is where this is expected to happen, but an uncommitted derived type may still be (un)serialized. */
+const std::vector<Datatype::Block>& Datatype::blocks()
+{
+  if (not flattened_) {
+    flatten(blocks_, 0);
+    blocks_.shrink_to_fit();
+    flattened_ = true;
+    XBT_DEBUG("Datatype %p flattened into %zu contiguous blocks", this, blocks_.size());
+  }
+  return blocks_;
+}
+
+//Only reached for duplicates of derived types, which have the layout of their original.
+void Datatype::flatten(std::vector<Block>& blocks, MPI_Aint offset)
+{
+  if (duplicated_ != nullptr)
+    duplicated_->flatten(blocks, offset);
+  else if (size_ > 0) // no description to follow: a single run from the lower bound, as memcpy would do
+    blocks.push_back({offset + lb_, static_cast<MPI_Aint>(size_), this});
+}
+
+/* Append the runs of @a count consecutive elements of @a type, merging each one with the previous run when they are
+ * adjacent in memory and hold the same basic type. */
+void Datatype::append_blocks(MPI_Datatype type, int count, MPI_Aint offset, std::vector<Block>& blocks)
+{
+  if (type->flags_ & DT_FLAG_DERIVED) {
+    for (int i = 0; i < count; i++)
+      type->flatten(blocks, offset + i * type->get_extent());
+    return;
+  }
+  if (type->size_ == 0 || count <= 0)
+    return;
+  MPI_Aint size = type->size_;
+  MPI_Aint stride = type->get_extent();
+  int runs = 1;
+  if (stride == size) { // consecutive elements are contiguous: a single run
+    size *= count;
+  } else {
+    runs = count;
+  }
+  for (int i = 0; i < runs; i++) {
+    MPI_Aint start = offset + i * stride;
+    if (not blocks.empty() && blocks.back().type == type && blocks.back().offset + blocks.back().length == start)
+      blocks.back().length += size;
+    else
+      blocks.push_back({start, size, type});
+  }
 }
 
 
@@ -297,20 +355,68 @@ int Datatype::copy(void *sendbuf, int sendcount, MPI_Datatype sendtype,
   return sendcount > recvcount ? MPI_ERR_TRUNCATE : MPI_SUCCESS;
 }
 
-//Default serialization method : memcpy.
+//Default serialization method : memcpy. Derived types copy each of the blocks computed when flattening them.
 void Datatype::serialize( void* noncontiguous_buf, void *contiguous_buf, int count){
   char* contiguous_buf_char = static_cast<char*>(contiguous_buf);
-  char* noncontiguous_buf_char = static_cast<char*>(noncontiguous_buf)+lb_;
-  memcpy(contiguous_buf_char, noncontiguous_buf_char, count*size_);
+  if (not(flags_ & DT_FLAG_DERIVED)) {
+    char* noncontiguous_buf_char = static_cast<char*>(noncontiguous_buf)+lb_;
+    memcpy(contiguous_buf_char, noncontiguous_buf_char, count*size_);
+    return;
+  }
 
+  const std::vector<Block>& plan = blocks();
+  MPI_Aint extent = get_extent();
+  if (plan.size() == 1 && plan[0].length == extent) { // the elements are laid out contiguously
+    memcpy(contiguous_buf_char, static_cast<char*>(noncontiguous_buf) + plan[0].offset, count * extent);
+    return;
+  }
+  for (int i = 0; i < count; i++) {
+    char* noncontiguous_buf_char = static_cast<char*>(noncontiguous_buf) + i * extent;
+    for (auto const& block : plan) {
+      memcpy(contiguous_buf_char, noncontiguous_buf_char + block.offset, block.length);
+      contiguous_buf_char += block.length;
+    }
+  }
 }
 
 void Datatype::unserialize( void* contiguous_buf, void *noncontiguous_buf, int count, MPI_Op op){
   char* contiguous_buf_char = static_cast<char*>(contiguous_buf);
-  char* noncontiguous_buf_char = static_cast<char*>(noncontiguous_buf)+lb_;
-  int n=count;
-  if(op!=MPI_OP_NULL)
-    op->apply( contiguous_buf_char, noncontiguous_buf_char, &n, this);
+  if (not(flags_ & DT_FLAG_DERIVED)) {
+    char* noncontiguous_buf_char = static_cast<char*>(noncontiguous_buf)+lb_;
+    int n=count;
+    if(op!=MPI_OP_NULL)
+      op->apply( contiguous_buf_char, noncontiguous_buf_char, &n, this);
+    return;
+  }
+  if (op == MPI_OP_NULL)
+    return;
+
+  const std::vector<Block>& plan = blocks();
+  MPI_Aint extent = get_extent();
+  if (op == MPI_REPLACE) { // plain copies, no need to go through the operation for each block
+    if (smpi_process()->replaying())
+      return;
+    if (plan.size() == 1 && plan[0].length == extent) {
+      memcpy(static_cast<char*>(noncontiguous_buf) + plan[0].offset, contiguous_buf_char, count * extent);
+      return;
+    }
+    for (int i = 0; i < count; i++) {
+      char* noncontiguous_buf_char = static_cast<char*>(noncontiguous_buf) + i * extent;
+      for (auto const& block : plan) {
+        memcpy(noncontiguous_buf_char + block.offset, contiguous_buf_char, block.length);
+        contiguous_buf_char += block.length;
+      }
+    }
+    return;
+  }
+  for (int i = 0; i < count; i++) {
+    char* noncontiguous_buf_char = static_cast<char*>(noncontiguous_buf) + i * extent;
+    for (auto const& block : plan) {
+      int n = block.length / block.type->size();
+      op->apply(contiguous_buf_char, noncontiguous_buf_char + block.offset, &n, block.type);
+      contiguous_buf_char += block.length;
+    }
+  }
 }
 
 int Datatype::create_contiguous(int count, MPI_Datatype old_type, MPI_Aint lb, MPI_Datatype* new_type){
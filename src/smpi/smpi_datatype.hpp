@@ -9,6 +9,8 @@
 #include "src/smpi/smpi_f2c.hpp"
 #include "src/smpi/smpi_keyvals.hpp"
 
+#include <vector>
+
 #define DT_FLAG_DESTROYED     0x0001  /**< user destroyed but some other layers still have a reference */
 #define DT_FLAG_COMMITED      0x0002  /**< ready to be used for a send/recv operation */
 #define DT_FLAG_CONTIGUOUS    0x0004  /**< contiguous datatype */
@@ -76,6 +78,14 @@ namespace simgrid{
 namespace smpi{
 
 class Datatype : public F2C, public Keyval{
+  public:
+    /** A contiguous run of a flattened datatype: @a length bytes of @a type elements, @a offset bytes into the buffer */
+    struct Block {
+      MPI_Aint offset;
+      MPI_Aint length;
+      MPI_Datatype type;
+    };
+
   private:
     char* name_;
     size_t size_;
@@ -83,6 +93,14 @@ class Datatype : public F2C, public Keyval{
     MPI_Aint ub_;
     int flags_;
     int refcount_;
+    std::vector<Block> blocks_;
+    bool flattened_ = false;
+    MPI_Datatype duplicated_ = nullptr; // the derived type that this one is a duplicate of, if any
+
+    const std::vector<Block>& blocks();
+
+  protected:
+    static void append_blocks(MPI_Datatype type, int count, MPI_Aint offset, std::vector<Block>& blocks);
 
   public:
     static std::unordered_map<int, smpi_key_elem> keyvals_;
@@ -111,6 +129,8 @@ class Datatype : public F2C, public Keyval{
     void set_name(char* name);
     static int copy(void *sendbuf, int sendcount, MPI_Datatype sendtype,
                     void *recvbuf, int recvcount, MPI_Datatype recvtype);
+    /** Appends the contiguous runs of one element of this datatype, located @a offset bytes into the buffer */
+    virtual void flatten(std::vector<Block>& blocks, MPI_Aint offset);
     virtual void serialize( void* noncontiguous, void *contiguous,
                             int count);
     virtual void unserialize( void* contiguous, void *noncontiguous,
@@ -28,6 +28,10 @@
 #if HAVE_SENDFILE
 #include <sys/sendfile.h>
 #endif
+#ifdef __linux__
+#include <linux/fs.h> /* FICLONE */
+#include <sys/ioctl.h>
+#endif
 
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY(smpi_kernel, smpi, "Logging specific to SMPI (kernel)");
 #include <boost/tokenizer.hpp>
@@ -541,8 +545,6 @@ int smpi_main(const char* executable, int argc, char *argv[])
   SIMIX_global_init(&argc, argv);
   MSG_init(&argc,argv);
 
-  SMPI_switch_data_segment = &smpi_switch_data_segment;
-
   simgrid::s4u::Host::onCreation.connect([](simgrid::s4u::Host& host) {
     host.extension_set(new simgrid::smpi::SmpiHost(&host));
   });
@@ -553,6 +555,17 @@ int smpi_main(const char* executable, int argc, char *argv[])
 
   smpi_init_options();
 
+  if (smpi_privatize_global_variables == SMPI_PRIVATIZE_MMAP && SIMIX_context_is_parallel()) {
+    XBT_WARN("The mmap privatization remaps the data segment shared by all threads, and cannot run in parallel. "
+             "Switching to dlopen privatization instead.");
+    smpi_privatize_global_variables = SMPI_PRIVATIZE_DLOPEN;
+  }
+
+  // Only the mmap privatization has to switch the data segment when switching between processes: with dlopen, each
+  // process runs its own copy of the binary.
+  if (smpi_privatize_global_variables == SMPI_PRIVATIZE_MMAP)
+    SMPI_switch_data_segment = &smpi_switch_data_segment;
+
   if (smpi_privatize_global_variables == SMPI_PRIVATIZE_DLOPEN) {
 
     std::string executable_copy = executable;
@@ -576,32 +589,40 @@ int smpi_main(const char* executable, int argc, char *argv[])
         int fdout = open(target_executable.c_str(), O_CREAT | O_RDWR, S_IRWXU);
         xbt_assert(fdout >= 0, "Cannot write into %s", target_executable.c_str());
 
+#ifdef FICLONE
+        // On the filesystems that support it (btrfs, xfs), the copy shares the blocks of the binary: no data is copied
+        if (ioctl(fdout, FICLONE, fdin) == 0) {
+          XBT_VERB("Cloned %s into %s", executable_copy.c_str(), target_executable.c_str());
+        } else
+#endif
+        {
 #if HAVE_SENDFILE
-        ssize_t sent_size = sendfile(fdout, fdin, NULL, fdin_size);
-        xbt_assert(sent_size == fdin_size,
-                   "Error while copying %s: only %zd bytes copied instead of %ld (errno: %d -- %s)",
-                   target_executable.c_str(), sent_size, fdin_size, errno, strerror(errno));
+          ssize_t sent_size = sendfile(fdout, fdin, NULL, fdin_size);
+          xbt_assert(sent_size == fdin_size,
+                     "Error while copying %s: only %zd bytes copied instead of %ld (errno: %d -- %s)",
+                     target_executable.c_str(), sent_size, fdin_size, errno, strerror(errno));
 #else
-        XBT_VERB("Copy %d bytes into %s", static_cast<int>(fdin_size), target_executable.c_str());
-        const int bufsize = 1024 * 1024 * 4;
-        char buf[bufsize];
-        while (int got = read(fdin, buf, bufsize)) {
-          if (got == -1) {
-            xbt_assert(errno == EINTR, "Cannot read from %s", executable_copy.c_str());
-          } else {
-            char* p  = buf;
-            int todo = got;
-            while (int done = write(fdout, p, todo)) {
-              if (done == -1) {
-                xbt_assert(errno == EINTR, "Cannot write into %s", target_executable.c_str());
-              } else {
-                p += done;
-                todo -= done;
+          XBT_VERB("Copy %d bytes into %s", static_cast<int>(fdin_size), target_executable.c_str());
+          const int bufsize = 1024 * 1024 * 4;
+          char buf[bufsize];
+          while (int got = read(fdin, buf, bufsize)) {
+            if (got == -1) {
+              xbt_assert(errno == EINTR, "Cannot read from %s", executable_copy.c_str());
+            } else {
+              char* p  = buf;
+              int todo = got;
+              while (int done = write(fdout, p, todo)) {
+                if (done == -1) {
+                  xbt_assert(errno == EINTR, "Cannot write into %s", target_executable.c_str());
+                } else {
+                  p += done;
+                  todo -= done;
+                }
               }
             }
           }
-        }
 #endif
+        }
         close(fdin);
         close(fdout);
 
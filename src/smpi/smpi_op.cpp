@@ -9,6 +9,8 @@
 #include "src/smpi/smpi_op.hpp"
 #include "src/smpi/smpi_process.hpp"
 
+#include <unordered_map>
+
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY(smpi_op, smpi, "Logging specific to SMPI (op)");
 
 #define MAX_OP(a, b)  (b) = (a) < (b) ? (b) : (a)
@@ -24,21 +26,50 @@ XBT_LOG_NEW_DEFAULT_SUBCATEGORY(smpi_op, smpi, "Logging specific to SMPI (op)");
 #define MAXLOC_OP(a, b)  (b) = (a.value) < (b.value) ? (b) : ((a.value) == (b.value) ? ((a.index) < (b.index) ? (a) : (b)) : (a))
 #define MINLOC_OP(a, b)  (b) = (a.value) < (b.value) ? (a) : ((a.value) == (b.value) ? ((a.index) < (b.index) ? (a) : (b)) : (b))
 
-#define APPLY_FUNC(a, b, length, type, func) \
-{                                          \
-  int i;                                   \
-  type* x = (type*)(a);                    \
-  type* y = (type*)(b);                    \
-  for(i = 0; i < *(length); i++) {         \
-    func(x[i], y[i]);                      \
-  }                                        \
+/* The reduction loops are instantiated for each operation and datatype. The buffers never overlap, which lets the
+ * compiler vectorize the loops. On x86, each loop is also compiled for AVX2, and the best version is selected when
+ * the library is loaded (through an ifunc) depending on the running CPU. */
+#if defined(__GNUC__) && not defined(__clang__) && __GNUC__ >= 6 && (defined(__x86_64__) || defined(__i386__)) &&     \
+    defined(__linux__)
+#define SMPI_OP_TARGET_CLONES __attribute__((target_clones("avx2", "default")))
+#else
+#define SMPI_OP_TARGET_CLONES
+#endif
+
+template <class T, class F>
+SMPI_OP_TARGET_CLONES void smpi_op_apply_loop(const void* a, void* b, int length)
+{
+  const T* __restrict x = static_cast<const T*>(a);
+  T* __restrict y       = static_cast<T*>(b);
+  F func;
+  for (int i = 0; i < length; i++)
+    func(x[i], y[i]);
 }
 
-#define APPLY_OP_LOOP(dtype, type, op) \
-  if (*datatype == dtype) {\
-    APPLY_FUNC(a, b, length, type, op)\
-  } else \
-
+#define CREATE_OP_FUNCTOR(name, op)                                                                                    \
+  struct name {                                                                                                        \
+    template <class T> void operator()(const T& a, T& b) const { op(a, b); }                                          \
+  };
+
+CREATE_OP_FUNCTOR(max_op, MAX_OP)
+CREATE_OP_FUNCTOR(min_op, MIN_OP)
+CREATE_OP_FUNCTOR(sum_op, SUM_OP)
+CREATE_OP_FUNCTOR(prod_op, PROD_OP)
+CREATE_OP_FUNCTOR(land_op, LAND_OP)
+CREATE_OP_FUNCTOR(lor_op, LOR_OP)
+CREATE_OP_FUNCTOR(lxor_op, LXOR_OP)
+CREATE_OP_FUNCTOR(band_op, BAND_OP)
+CREATE_OP_FUNCTOR(bor_op, BOR_OP)
+CREATE_OP_FUNCTOR(bxor_op, BXOR_OP)
+CREATE_OP_FUNCTOR(maxloc_op, MAXLOC_OP)
+CREATE_OP_FUNCTOR(minloc_op, MINLOC_OP)
+
+/* Each predefined operation maps the datatypes it accepts to the loop instantiated for them. The table is built on the
+ * first use of the operation, so that applying it costs a single lookup instead of a comparison per datatype. */
+typedef void (*smpi_op_loop)(const void* a, void* b, int length);
+typedef std::unordered_map<MPI_Datatype, smpi_op_loop> smpi_op_table;
+
+#define APPLY_OP_LOOP(dtype, type, op) {(dtype), &smpi_op_apply_loop<type, op>},
 
 #define APPLY_BASIC_OP_LOOP(op)\
 APPLY_OP_LOOP(MPI_CHAR, char,op)\
@@ -97,93 +128,87 @@ APPLY_OP_LOOP(MPI_2DOUBLE, double_double,op)\
 APPLY_OP_LOOP(MPI_LONG_DOUBLE_INT, long_double_int,op)\
 APPLY_OP_LOOP(MPI_2LONG, long_long,op)
 
-#define APPLY_END_OP_LOOP(op)\
-  {\
-    xbt_die("Failed to apply " #op " to type %s", (*datatype)->name());\
-  }
+static void smpi_op_apply(const smpi_op_table& table, const char* name, void* a, void* b, int* length,
+                          MPI_Datatype* datatype)
+{
+  auto loop = table.find(*datatype);
+  if (loop == table.end())
+    xbt_die("Failed to apply %s to type %s", name, (*datatype)->name());
+  loop->second(a, b, *length);
+}
 
 static void max_func(void *a, void *b, int *length, MPI_Datatype * datatype)
 {
-  APPLY_BASIC_OP_LOOP(MAX_OP)
-  APPLY_FLOAT_OP_LOOP(MAX_OP)
-  APPLY_END_OP_LOOP(MAX_OP)
+  static const smpi_op_table table = {APPLY_BASIC_OP_LOOP(max_op) APPLY_FLOAT_OP_LOOP(max_op)};
+  smpi_op_apply(table, "MAX_OP", a, b, length, datatype);
 }
 
 static void min_func(void *a, void *b, int *length, MPI_Datatype * datatype)
 {
-  APPLY_BASIC_OP_LOOP(MIN_OP)
-  APPLY_FLOAT_OP_LOOP(MIN_OP)
-  APPLY_END_OP_LOOP(MIN_OP)
+  static const smpi_op_table table = {APPLY_BASIC_OP_LOOP(min_op) APPLY_FLOAT_OP_LOOP(min_op)};
+  smpi_op_apply(table, "MIN_OP", a, b, length, datatype);
 }
 
 static void sum_func(void *a, void *b, int *length, MPI_Datatype * datatype)
 {
-  APPLY_BASIC_OP_LOOP(SUM_OP)
-  APPLY_FLOAT_OP_LOOP(SUM_OP)
-  APPLY_COMPLEX_OP_LOOP(SUM_OP)
-  APPLY_END_OP_LOOP(SUM_OP)
+  static const smpi_op_table table = {APPLY_BASIC_OP_LOOP(sum_op) APPLY_FLOAT_OP_LOOP(sum_op)
+                                          APPLY_COMPLEX_OP_LOOP(sum_op)};
+  smpi_op_apply(table, "SUM_OP", a, b, length, datatype);
 }
 
 static void prod_func(void *a, void *b, int *length, MPI_Datatype * datatype)
 {
-  APPLY_BASIC_OP_LOOP(PROD_OP)
-  APPLY_FLOAT_OP_LOOP(PROD_OP)
-  APPLY_COMPLEX_OP_LOOP(PROD_OP)
-  APPLY_END_OP_LOOP(PROD_OP)
+  static const smpi_op_table table = {APPLY_BASIC_OP_LOOP(prod_op) APPLY_FLOAT_OP_LOOP(prod_op)
+                                          APPLY_COMPLEX_OP_LOOP(prod_op)};
+  smpi_op_apply(table, "PROD_OP", a, b, length, datatype);
 }
 
 static void land_func(void *a, void *b, int *length, MPI_Datatype * datatype)
 {
-  APPLY_BASIC_OP_LOOP(LAND_OP)
-  APPLY_BOOL_OP_LOOP(LAND_OP)
-  APPLY_END_OP_LOOP(LAND_OP)
+  static const smpi_op_table table = {APPLY_BASIC_OP_LOOP(land_op) APPLY_BOOL_OP_LOOP(land_op)};
+  smpi_op_apply(table, "LAND_OP", a, b, length, datatype);
 }
 
 static void lor_func(void *a, void *b, int *length, MPI_Datatype * datatype)
 {
-  APPLY_BASIC_OP_LOOP(LOR_OP)
-  APPLY_BOOL_OP_LOOP(LOR_OP)
-  APPLY_END_OP_LOOP(LOR_OP)
+  static const smpi_op_table table = {APPLY_BASIC_OP_LOOP(lor_op) APPLY_BOOL_OP_LOOP(lor_op)};
+  smpi_op_apply(table, "LOR_OP", a, b, length, datatype);
 }
 
 static void lxor_func(void *a, void *b, int *length, MPI_Datatype * datatype)
 {
-  APPLY_BASIC_OP_LOOP(LXOR_OP)
-  APPLY_BOOL_OP_LOOP(LXOR_OP)
-  APPLY_END_OP_LOOP(LXOR_OP)
+  static const smpi_op_table table = {APPLY_BASIC_OP_LOOP(lxor_op) APPLY_BOOL_OP_LOOP(lxor_op)};
+  smpi_op_apply(table, "LXOR_OP", a, b, length, datatype);
 }
 
 static void band_func(void *a, void *b, int *length, MPI_Datatype * datatype)
 {
-  APPLY_BASIC_OP_LOOP(BAND_OP)
-  APPLY_BOOL_OP_LOOP(BAND_OP)
-  APPLY_END_OP_LOOP(BAND_OP)
+  static const smpi_op_table table = {APPLY_BASIC_OP_LOOP(band_op) APPLY_BOOL_OP_LOOP(band_op)};
+  smpi_op_apply(table, "BAND_OP", a, b, length, datatype);
 }
 
 static void bor_func(void *a, void *b, int *length, MPI_Datatype * datatype)
 {
-  APPLY_BASIC_OP_LOOP(BOR_OP)
-  APPLY_BOOL_OP_LOOP(BOR_OP)
-  APPLY_END_OP_LOOP(BOR_OP)
+  static const smpi_op_table table = {APPLY_BASIC_OP_LOOP(bor_op) APPLY_BOOL_OP_LOOP(bor_op)};
+  smpi_op_apply(table, "BOR_OP", a, b, length, datatype);
 }
 
 static void bxor_func(void *a, void *b, int *length, MPI_Datatype * datatype)
 {
-  APPLY_BASIC_OP_LOOP(BXOR_OP)
-  APPLY_BOOL_OP_LOOP(BXOR_OP)
-  APPLY_END_OP_LOOP(BXOR_OP)
+  static const smpi_op_table table = {APPLY_BASIC_OP_LOOP(bxor_op) APPLY_BOOL_OP_LOOP(bxor_op)};
+  smpi_op_apply(table, "BXOR_OP", a, b, length, datatype);
 }
 
 static void minloc_func(void *a, void *b, int *length, MPI_Datatype * datatype)
 {
-  APPLY_PAIR_OP_LOOP(MINLOC_OP)
-  APPLY_END_OP_LOOP(MINLOC_OP)
+  static const smpi_op_table table = {APPLY_PAIR_OP_LOOP(minloc_op)};
+  smpi_op_apply(table, "MINLOC_OP", a, b, length, datatype);
 }
 
 static void maxloc_func(void *a, void *b, int *length, MPI_Datatype * datatype)
 {
-  APPLY_PAIR_OP_LOOP(MAXLOC_OP)
-  APPLY_END_OP_LOOP(MAXLOC_OP)
+  static const smpi_op_table table = {APPLY_PAIR_OP_LOOP(maxloc_op)};
+  smpi_op_apply(table, "MAXLOC_OP", a, b, length, datatype);
 }
 
 static void replace_func(void *a, void *b, int *length, MPI_Datatype * datatype)
@@ -50,7 +50,7 @@ Process::Process(int index, msg_bar_t finalization_barrier)
     MC_ignore_heap(timer_, xbt_os_timer_size());
 
 #if HAVE_PAPI
-  if (xbt_cfg_get_string("smpi/papi-events")[0] != '\0') {
+  if (not smpi_cfg_papi_events.get().empty()) {
     // TODO: Implement host/process/thread based counters. This implementation
     // just always takes the values passed via "default", like this:
     // "default:COUNTER1:COUNTER2:COUNTER3;".
@@ -252,6 +252,13 @@ int Process::sampling()
   return sampling_;
 }
 
+smpi_sample_data_t* Process::sample(int site)
+{
+  if (static_cast<unsigned>(site) >= samples_.size())
+    samples_.resize(site + 1);
+  return &samples_[site];
+}
+
 msg_bar_t Process::finalization_barrier(){
   return finalization_barrier_;
 }
@@ -8,6 +8,7 @@
 #define SMPI_PROCESS_HPP
 
 #include "src/instr/instr_smpi.h"
+#include "src/smpi/private.hpp"
 #include "simgrid/s4u/Mailbox.hpp"
 #include "xbt/synchro.h"
 
@@ -30,6 +31,7 @@ class Process {
     int index_            = MPI_UNDEFINED;
     char state_;
     int sampling_                   = 0; /* inside an SMPI_SAMPLE_ block? */
+    std::vector<smpi_sample_data_t> samples_; /* SMPI_SAMPLE_LOCAL statistics, indexed by sample site */
     char* instance_id_              = nullptr;
     bool replaying_                 = false; /* is the process replaying a trace */
     msg_bar_t finalization_barrier_;
@@ -70,6 +72,7 @@ class Process {
     void set_comm_intra(MPI_Comm comm);
     void set_sampling(int s);
     int sampling();
+    smpi_sample_data_t* sample(int site);
     msg_bar_t finalization_barrier();
     int return_value();
     void set_return_value(int val);
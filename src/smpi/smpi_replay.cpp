@@ -87,9 +87,27 @@ static double parse_double(const char *string)
   return value;
 }
 
-static MPI_Datatype decode_datatype(const char *const action)
+/* The numbers of the binary traces are given as they are, without parsing their token */
+static double parse_double(const char* const* action, int i)
 {
-  switch(atoi(action)) {
+  double value;
+  if (simgrid::xbt::replay_action_number(action, i, &value))
+    return value;
+  return parse_double(action[i]);
+}
+
+/* Same as atoi(): the fractional part is dropped */
+static int parse_int(const char* const* action, int i)
+{
+  double value;
+  if (simgrid::xbt::replay_action_number(action, i, &value))
+    return static_cast<int>(value);
+  return atoi(action[i]);
+}
+
+static MPI_Datatype decode_datatype(int datatype)
+{
+  switch(datatype) {
     case 0:
       MPI_CURRENT_TYPE=MPI_DOUBLE;
       break;
@@ -183,7 +201,7 @@ static void action_finalize(const char *const *action)
 
 static void action_comm_size(const char *const *action)
 {
-  communicator_size = parse_double(action[2]);
+  communicator_size = parse_double(action, 2);
   log_timed_action (action, smpi_process()->simulated_elapsed());
 }
 
@@ -201,7 +219,7 @@ static void action_compute(const char *const *action)
 {
   CHECK_ACTION_PARAMS(action, 1, 0)
   double clock = smpi_process()->simulated_elapsed();
-  double flops= parse_double(action[2]);
+  double flops= parse_double(action, 2);
   int rank = smpi_process()->index();
   instr_extra_data extra = xbt_new0(s_instr_extra_data_t,1);
   extra->type=TRACING_COMPUTING;
@@ -217,12 +235,12 @@ static void action_compute(const char *const *action)
 static void action_send(const char *const *action)
 {
   CHECK_ACTION_PARAMS(action, 2, 1)
-  int to = atoi(action[2]);
-  double size=parse_double(action[3]);
+  int to = parse_int(action, 2);
+  double size=parse_double(action, 3);
   double clock = smpi_process()->simulated_elapsed();
 
   if(action[4])
-    MPI_CURRENT_TYPE=decode_datatype(action[4]);
+    MPI_CURRENT_TYPE=decode_datatype(parse_int(action, 4));
   else
     MPI_CURRENT_TYPE= MPI_DEFAULT_TYPE;
 
@@ -249,12 +267,12 @@ static void action_send(const char *const *action)
 static void action_Isend(const char *const *action)
 {
   CHECK_ACTION_PARAMS(action, 2, 1)
-  int to = atoi(action[2]);
-  double size=parse_double(action[3]);
+  int to = parse_int(action, 2);
+  double size=parse_double(action, 3);
   double clock = smpi_process()->simulated_elapsed();
 
   if(action[4])
-    MPI_CURRENT_TYPE=decode_datatype(action[4]);
+    MPI_CURRENT_TYPE=decode_datatype(parse_int(action, 4));
   else
     MPI_CURRENT_TYPE= MPI_DEFAULT_TYPE;
 
@@ -281,13 +299,13 @@ static void action_Isend(const char *const *action)
 
 static void action_recv(const char *const *action) {
   CHECK_ACTION_PARAMS(action, 2, 1)
-  int from = atoi(action[2]);
-  double size=parse_double(action[3]);
+  int from = parse_int(action, 2);
+  double size=parse_double(action, 3);
   double clock = smpi_process()->simulated_elapsed();
   MPI_Status status;
 
   if(action[4])
-    MPI_CURRENT_TYPE=decode_datatype(action[4]);
+    MPI_CURRENT_TYPE=decode_datatype(parse_int(action, 4));
   else
     MPI_CURRENT_TYPE= MPI_DEFAULT_TYPE;
 
@@ -321,12 +339,12 @@ static void action_recv(const char *const *action) {
 static void action_Irecv(const char *const *action)
 {
   CHECK_ACTION_PARAMS(action, 2, 1)
-  int from = atoi(action[2]);
-  double size=parse_double(action[3]);
+  int from = parse_int(action, 2);
+  double size=parse_double(action, 3);
   double clock = smpi_process()->simulated_elapsed();
 
   if(action[4])
-    MPI_CURRENT_TYPE=decode_datatype(action[4]);
+    MPI_CURRENT_TYPE=decode_datatype(parse_int(action, 4));
   else
     MPI_CURRENT_TYPE= MPI_DEFAULT_TYPE;
 
@@ -465,16 +483,16 @@ static void action_barrier(const char *const *action){
 static void action_bcast(const char *const *action)
 {
   CHECK_ACTION_PARAMS(action, 1, 2)
-  double size = parse_double(action[2]);
+  double size = parse_double(action, 2);
   double clock = smpi_process()->simulated_elapsed();
   int root=0;
   /* Initialize MPI_CURRENT_TYPE in order to decrease the number of the checks */
   MPI_CURRENT_TYPE= MPI_DEFAULT_TYPE;
 
   if(action[3]) {
-    root= atoi(action[3]);
+    root= parse_int(action, 3);
     if(action[4])
-      MPI_CURRENT_TYPE=decode_datatype(action[4]);
+      MPI_CURRENT_TYPE=decode_datatype(parse_int(action, 4));
   }
 
   int rank = smpi_process()->index();
@@ -497,16 +515,16 @@ static void action_bcast(const char *const *action)
 static void action_reduce(const char *const *action)
 {
   CHECK_ACTION_PARAMS(action, 2, 2)
-  double comm_size = parse_double(action[2]);
-  double comp_size = parse_double(action[3]);
+  double comm_size = parse_double(action, 2);
+  double comp_size = parse_double(action, 3);
   double clock = smpi_process()->simulated_elapsed();
   int root=0;
   MPI_CURRENT_TYPE= MPI_DEFAULT_TYPE;
 
   if(action[4]) {
-    root= atoi(action[4]);
+    root= parse_int(action, 4);
     if(action[5])
-      MPI_CURRENT_TYPE=decode_datatype(action[5]);
+      MPI_CURRENT_TYPE=decode_datatype(parse_int(action, 5));
   }
 
   int rank = smpi_process()->index();
@@ -531,11 +549,11 @@ static void action_reduce(const char *const *action)
 
 static void action_allReduce(const char *const *action) {
   CHECK_ACTION_PARAMS(action, 2, 1)
-  double comm_size = parse_double(action[2]);
-  double comp_size = parse_double(action[3]);
+  double comm_size = parse_double(action, 2);
+  double comp_size = parse_double(action, 3);
 
   if(action[4])
-    MPI_CURRENT_TYPE=decode_datatype(action[4]);
+    MPI_CURRENT_TYPE=decode_datatype(parse_int(action, 4));
   else
     MPI_CURRENT_TYPE= MPI_DEFAULT_TYPE;
 
@@ -561,13 +579,13 @@ static void action_allToAll(const char *const *action) {
   CHECK_ACTION_PARAMS(action, 2, 2) //two mandatory (send and recv volumes) and two optional (corresponding datatypes)
   double clock = smpi_process()->simulated_elapsed();
   int comm_size = MPI_COMM_WORLD->size();
-  int send_size = parse_double(action[2]);
-  int recv_size = parse_double(action[3]);
+  int send_size = parse_double(action, 2);
+  int recv_size = parse_double(action, 3);
   MPI_Datatype MPI_CURRENT_TYPE2 = MPI_DEFAULT_TYPE;
 
   if(action[4] && action[5]) {
-    MPI_CURRENT_TYPE=decode_datatype(action[4]);
-    MPI_CURRENT_TYPE2=decode_datatype(action[5]);
+    MPI_CURRENT_TYPE=decode_datatype(parse_int(action, 4));
+    MPI_CURRENT_TYPE2=decode_datatype(parse_int(action, 5));
   }
   else
     MPI_CURRENT_TYPE=MPI_DEFAULT_TYPE;
@@ -604,12 +622,12 @@ static void action_gather(const char *const *action) {
   CHECK_ACTION_PARAMS(action, 2, 3)
   double clock = smpi_process()->simulated_elapsed();
   int comm_size = MPI_COMM_WORLD->size();
-  int send_size = parse_double(action[2]);
-  int recv_size = parse_double(action[3]);
+  int send_size = parse_double(action, 2);
+  int recv_size = parse_double(action, 3);
   MPI_Datatype MPI_CURRENT_TYPE2 = MPI_DEFAULT_TYPE;
   if(action[4] && action[5]) {
-    MPI_CURRENT_TYPE=decode_datatype(action[5]);
-    MPI_CURRENT_TYPE2=decode_datatype(action[6]);
+    MPI_CURRENT_TYPE=decode_datatype(parse_int(action, 5));
+    MPI_CURRENT_TYPE2=decode_datatype(parse_int(action, 6));
   } else {
     MPI_CURRENT_TYPE=MPI_DEFAULT_TYPE;
   }
@@ -617,7 +635,7 @@ static void action_gather(const char *const *action) {
   void *recv = nullptr;
   int root=0;
   if(action[4])
-    root=atoi(action[4]);
+    root=parse_int(action, 4);
   int rank = MPI_COMM_WORLD->rank();
 
   if(rank==root)
@@ -652,27 +670,27 @@ static void action_gatherv(const char *const *action) {
   double clock = smpi_process()->simulated_elapsed();
   int comm_size = MPI_COMM_WORLD->size();
   CHECK_ACTION_PARAMS(action, comm_size+1, 2)
-  int send_size = parse_double(action[2]);
+  int send_size = parse_double(action, 2);
   int disps[comm_size];
   int recvcounts[comm_size];
   int recv_sum=0;
 
   MPI_Datatype MPI_CURRENT_TYPE2 = MPI_DEFAULT_TYPE;
   if(action[4+comm_size] && action[5+comm_size]) {
-    MPI_CURRENT_TYPE=decode_datatype(action[4+comm_size]);
-    MPI_CURRENT_TYPE2=decode_datatype(action[5+comm_size]);
+    MPI_CURRENT_TYPE=decode_datatype(parse_int(action, 4+comm_size));
+    MPI_CURRENT_TYPE2=decode_datatype(parse_int(action, 5+comm_size));
   } else
     MPI_CURRENT_TYPE=MPI_DEFAULT_TYPE;
 
   void *send = smpi_get_tmp_sendbuffer(send_size* MPI_CURRENT_TYPE->size());
   void *recv = nullptr;
   for(int i=0;i<comm_size;i++) {
-    recvcounts[i] = atoi(action[i+3]);
+    recvcounts[i] = parse_int(action, i+3);
     recv_sum=recv_sum+recvcounts[i];
     disps[i]=0;
   }
 
-  int root=atoi(action[3+comm_size]);
+  int root=parse_int(action, 3+comm_size);
   int rank = MPI_COMM_WORLD->rank();
 
   if(rank==root)
@@ -708,17 +726,17 @@ static void action_reducescatter(const char *const *action) {
   double clock = smpi_process()->simulated_elapsed();
   int comm_size = MPI_COMM_WORLD->size();
   CHECK_ACTION_PARAMS(action, comm_size+1, 1)
-  int comp_size = parse_double(action[2+comm_size]);
+  int comp_size = parse_double(action, 2+comm_size);
   int recvcounts[comm_size];
   int rank = smpi_process()->index();
   int size = 0;
   if(action[3+comm_size])
-    MPI_CURRENT_TYPE=decode_datatype(action[3+comm_size]);
+    MPI_CURRENT_TYPE=decode_datatype(parse_int(action, 3+comm_size));
   else
     MPI_CURRENT_TYPE= MPI_DEFAULT_TYPE;
 
   for(int i=0;i<comm_size;i++) {
-    recvcounts[i] = atoi(action[i+2]);
+    recvcounts[i] = parse_int(action, i+2);
     size+=recvcounts[i];
   }
 
@@ -755,14 +773,14 @@ static void action_allgather(const char *const *action) {
   double clock = smpi_process()->simulated_elapsed();
 
   CHECK_ACTION_PARAMS(action, 2, 2)
-  int sendcount=atoi(action[2]);
-  int recvcount=atoi(action[3]);
+  int sendcount=parse_int(action, 2);
+  int recvcount=parse_int(action, 3);
 
   MPI_Datatype MPI_CURRENT_TYPE2 = MPI_DEFAULT_TYPE;
 
   if(action[4] && action[5]) {
-    MPI_CURRENT_TYPE = decode_datatype(action[4]);
-    MPI_CURRENT_TYPE2 = decode_datatype(action[5]);
+    MPI_CURRENT_TYPE = decode_datatype(parse_int(action, 4));
+    MPI_CURRENT_TYPE2 = decode_datatype(parse_int(action, 5));
   } else
     MPI_CURRENT_TYPE = MPI_DEFAULT_TYPE;
 
@@ -798,22 +816,22 @@ static void action_allgatherv(const char *const *action) {
 
   int comm_size = MPI_COMM_WORLD->size();
   CHECK_ACTION_PARAMS(action, comm_size+1, 2)
-  int sendcount=atoi(action[2]);
+  int sendcount=parse_int(action, 2);
   int recvcounts[comm_size];
   int disps[comm_size];
   int recv_sum=0;
   MPI_Datatype MPI_CURRENT_TYPE2 = MPI_DEFAULT_TYPE;
 
   if(action[3+comm_size] && action[4+comm_size]) {
-    MPI_CURRENT_TYPE = decode_datatype(action[3+comm_size]);
-    MPI_CURRENT_TYPE2 = decode_datatype(action[4+comm_size]);
+    MPI_CURRENT_TYPE = decode_datatype(parse_int(action, 3+comm_size));
+    MPI_CURRENT_TYPE2 = decode_datatype(parse_int(action, 4+comm_size));
   } else
     MPI_CURRENT_TYPE = MPI_DEFAULT_TYPE;
 
   void *sendbuf = smpi_get_tmp_sendbuffer(sendcount* MPI_CURRENT_TYPE->size());
 
   for(int i=0;i<comm_size;i++) {
-    recvcounts[i] = atoi(action[i+3]);
+    recvcounts[i] = parse_int(action, i+3);
     recv_sum=recv_sum+recvcounts[i];
     disps[i] = 0;
   }
@@ -859,11 +877,11 @@ static void action_allToAllv(const char *const *action) {
 
   MPI_Datatype MPI_CURRENT_TYPE2 = MPI_DEFAULT_TYPE;
 
-  int send_buf_size=parse_double(action[2]);
-  int recv_buf_size=parse_double(action[3+comm_size]);
+  int send_buf_size=parse_double(action, 2);
+  int recv_buf_size=parse_double(action, 3+comm_size);
   if(action[4+2*comm_size] && action[5+2*comm_size]) {
-    MPI_CURRENT_TYPE=decode_datatype(action[4+2*comm_size]);
-    MPI_CURRENT_TYPE2=decode_datatype(action[5+2*comm_size]);
+    MPI_CURRENT_TYPE=decode_datatype(parse_int(action, 4+2*comm_size));
+    MPI_CURRENT_TYPE2=decode_datatype(parse_int(action, 5+2*comm_size));
   }
   else
     MPI_CURRENT_TYPE=MPI_DEFAULT_TYPE;
@@ -872,8 +890,8 @@ static void action_allToAllv(const char *const *action) {
   void *recvbuf  = smpi_get_tmp_recvbuffer(recv_buf_size* MPI_CURRENT_TYPE2->size());
 
   for(int i=0;i<comm_size;i++) {
-    sendcounts[i] = atoi(action[i+3]);
-    recvcounts[i] = atoi(action[i+4+comm_size]);
+    sendcounts[i] = parse_int(action, i+3);
+    recvcounts[i] = parse_int(action, i+4+comm_size);
     senddisps[i] = 0;
     recvdisps[i] = 0;
   }
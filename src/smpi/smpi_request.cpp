@@ -334,7 +334,7 @@ void Request::start()
 
     simgrid::smpi::Process* process = smpi_process_remote(dst_);
 
-    int async_small_thresh = xbt_cfg_get_int("smpi/async-small-thresh");
+    int async_small_thresh = smpi_cfg_async_small_thresh.get();
 
     xbt_mutex_t mut = process->mailboxes_mutex();
     if (async_small_thresh != 0 || (flags_ & RMA) != 0)
@@ -393,7 +393,7 @@ void Request::start()
 
     void* buf = buf_;
     if ((flags_ & SSEND) == 0 && ( (flags_ & RMA) != 0
-        || static_cast<int>(size_) < xbt_cfg_get_int("smpi/send-is-detached-thresh") ) ) {
+        || static_cast<int>(size_) < smpi_cfg_detached_send_thresh.get() ) ) {
       void *oldbuf = nullptr;
       detached_ = 1;
       XBT_DEBUG("Send request %p is detached", this);
@@ -428,7 +428,7 @@ void Request::start()
       XBT_DEBUG("sending size of %zu : sleep %f ", size_, sleeptime);
     }
 
-    int async_small_thresh = xbt_cfg_get_int("smpi/async-small-thresh");
+    int async_small_thresh = smpi_cfg_async_small_thresh.get();
 
     xbt_mutex_t mut=process->mailboxes_mutex();
 
@@ -510,7 +510,7 @@ int Request::test(MPI_Request * request, MPI_Status * status) {
       nsleeps=1;//reset the number of sleeps we will do next time
       if (*request != MPI_REQUEST_NULL && ((*request)->flags_ & PERSISTENT)==0)
       *request = MPI_REQUEST_NULL;
-    } else if (xbt_cfg_get_boolean("smpi/grow-injected-times")){
+    } else if (smpi_cfg_grow_injected_times.get()){
       nsleeps++;
     }
   }
@@ -626,7 +626,7 @@ void Request::iprobe(int source, int tag, MPI_Comm comm, int* flag, MPI_Status*
   // This can speed up the execution of certain applications by an order of magnitude, such as HPL
   static int nsleeps = 1;
   double speed        = simgrid::s4u::Actor::self()->getHost()->getSpeed();
-  double maxrate = xbt_cfg_get_double("smpi/iprobe-cpu-usage");
+  double maxrate = smpi_cfg_iprobe_cpu_usage.get();
   MPI_Request request = new Request(nullptr, 0, MPI_CHAR, source == MPI_ANY_SOURCE ? MPI_ANY_SOURCE :
                  comm->group()->index(source), comm->rank(), tag, comm, PERSISTENT | RECV);
   if (smpi_iprobe_sleep > 0) {
@@ -638,7 +638,7 @@ void Request::iprobe(int source, int tag, MPI_Comm comm, int* flag, MPI_Status*
 
   request->print_request("New iprobe");
   // We have to test both mailboxes as we don't know if we will receive one one or another
-  if (xbt_cfg_get_int("smpi/async-small-thresh") > 0){
+  if (smpi_cfg_async_small_thresh.get() > 0){
       mailbox = smpi_process()->mailbox_small();
       XBT_DEBUG("Trying to probe the perm recv mailbox");
       request->action_ = simcall_comm_iprobe(mailbox, 0, &match_recv, static_cast<void*>(request));
@@ -665,7 +665,7 @@ void Request::iprobe(int source, int tag, MPI_Comm comm, int* flag, MPI_Status*
   }
   else {
     *flag = 0;
-    if (xbt_cfg_get_boolean("smpi/grow-injected-times"))
+    if (smpi_cfg_grow_injected_times.get())
       nsleeps++;
   }
   unref(&request);
@@ -102,6 +102,11 @@ public:
   boost::intrusive::list_member_hook<> action_ti_hook;
 };
 
+struct CpuTiActionHeapIndex {
+  void operator()(CpuTiAction* action, int i) const { action->updateIndexHeap(i); }
+};
+typedef simgrid::xbt::Heap<CpuTiAction*, CpuTiActionHeapIndex> CpuTiActionHeap;
+
 typedef boost::intrusive::member_hook<CpuTiAction, boost::intrusive::list_member_hook<>, &CpuTiAction::action_ti_hook> ActionTiListOptions;
 typedef boost::intrusive::list<CpuTiAction, ActionTiListOptions > ActionTiList;
 
@@ -152,7 +157,7 @@ public:
 
   ActionList *runningActionSetThatDoesNotNeedBeingChecked_;
   CpuTiList *modifiedCpu_;
-  xbt_heap_t tiActionHeap_;
+  CpuTiActionHeap tiActionHeap_;
 
 protected:
   void NotifyResourceTurnedOn(simgrid::surf::Resource*){};
@@ -24,6 +24,7 @@ typedef struct s_dyn_light {
 } s_dyn_light_t, *dyn_light_t;
 
 double sg_maxmin_precision = 0.00001; /* Change this with --cfg=maxmin/precision:VALUE */
+bool sg_maxmin_soa         = false;   /* Change this with --cfg=maxmin/soa:yes */
 double sg_surf_precision   = 0.00001; /* Change this with --cfg=surf/precision:VALUE */
 int sg_concurrency_limit   = -1;      /* Change this with --cfg=maxmin/concurrency-limit:VALUE */
 
@@ -31,7 +32,6 @@ static void *lmm_variable_mallocator_new_f();
 static void lmm_variable_mallocator_free_f(void *var);
 #define lmm_variable_mallocator_reset_f ((void_f_pvoid_t)nullptr)
 static void lmm_update_modified_set(lmm_system_t sys, lmm_constraint_t cnst);
-static void lmm_remove_all_modified_set(lmm_system_t sys);
 static int Global_debug_id = 1;
 static int Global_const_debug_id = 1;
 
@@ -45,8 +45,6 @@ static void lmm_disable_var(lmm_system_t sys, lmm_variable_t var);
 static int lmm_concurrency_slack(lmm_constraint_t cnstr);
 static int lmm_cnstrs_min_concurrency_slack(lmm_variable_t var);
 
-static void lmm_check_concurrency(lmm_system_t sys);
-
 inline int lmm_element_concurrency(lmm_element_t elem) {
   //Ignore element with weight less than one (e.g. cross-traffic)
   return (elem->consumption_weight >= 1) ? 1 : 0;
@@ -105,6 +103,9 @@ lmm_system_t lmm_system_new(bool selective_update)
 
   l->solve_fun = &lmm_solve;
 
+  if (sg_maxmin_soa)
+    lmm_soa_storage_new(l);
+
   return l;
 }
 
@@ -129,6 +130,7 @@ void lmm_system_free(lmm_system_t sys)
     lmm_cnst_free(sys, cnst);
 
   xbt_mallocator_free(sys->variable_mallocator);
+  lmm_soa_storage_free(sys);
   free(sys);
 }
 
@@ -169,6 +171,8 @@ static inline void lmm_variable_remove(lmm_system_t sys, lmm_variable_t var)
       lmm_on_disabled_var(sys,elem->constraint);
   }
 
+  if (sys->soa_storage)
+    lmm_soa_variable_remove(sys, var);
   var->cnsts_number = 0;
 
   lmm_check_concurrency(sys);
@@ -179,12 +183,16 @@ static inline void lmm_variable_remove(lmm_system_t sys, lmm_variable_t var)
 static void lmm_var_free(lmm_system_t sys, lmm_variable_t var)
 {
   lmm_variable_remove(sys, var);
+  if (sys->soa_storage)
+    lmm_soa_variable_free(sys, var);
   xbt_mallocator_release(sys->variable_mallocator, var);
 }
 
 static inline void lmm_cnst_free(lmm_system_t sys, lmm_constraint_t cnst)
 {
   make_constraint_inactive(sys, cnst);
+  if (sys->soa_storage)
+    lmm_soa_constraint_free(sys, cnst);
   free(cnst);
 }
 
@@ -206,7 +214,10 @@ lmm_constraint_t lmm_constraint_new(lmm_system_t sys, void *id, double bound_val
   cnst->concurrency_limit  = sg_concurrency_limit;
   cnst->usage = 0;
   cnst->sharing_policy = 1; /* FIXME: don't hardcode the value */
+  cnst->soa_index      = -1;
   insert_constraint(sys, cnst);
+  if (sys->soa_storage)
+    lmm_soa_constraint_new(sys, cnst);
 
   return cnst;
 }
@@ -297,6 +308,7 @@ lmm_variable_t lmm_variable_new(lmm_system_t sys, simgrid::surf::Action* id, dou
     var->cnsts[i].constraint = nullptr;
     var->cnsts[i].variable = nullptr;
     var->cnsts[i].consumption_weight               = 0.0;
+    var->cnsts[i].soa_index                        = -1;
   }
   var->cnsts_size = number_of_constraints;
   var->cnsts_number = 0;
@@ -306,6 +318,7 @@ lmm_variable_t lmm_variable_new(lmm_system_t sys, simgrid::surf::Action* id, dou
   var->concurrency_share = 1;
   var->value = 0.0;
   var->visited = sys->visited_counter - 1;
+  var->soa_index = -1;
   var->mu = 0.0;
   var->new_mu = 0.0;
   var->func_f = func_f_def;
@@ -322,6 +335,9 @@ lmm_variable_t lmm_variable_new(lmm_system_t sys, simgrid::surf::Action* id, dou
   else
     xbt_swag_insert_at_tail(var, &(sys->variable_set));
 
+  if (sys->soa_storage)
+    lmm_soa_variable_new(sys, var);
+
   XBT_OUT(" returns %p", var);
   return var;
 }
@@ -384,6 +400,8 @@ void lmm_shrink(lmm_system_t sys, lmm_constraint_t cnst, lmm_variable_t var)
     lmm_decrease_concurrency(elem);
 
   xbt_swag_remove(elem, &(elem->constraint->active_element_set));
+  if (sys->soa_storage)
+    lmm_soa_element_free(sys, elem);
   elem->constraint = nullptr;
   elem->variable = nullptr;
   elem->consumption_weight = 0;
@@ -444,6 +462,9 @@ void lmm_expand(lmm_system_t sys, lmm_constraint_t cnst, lmm_variable_t var, dou
   } else
     xbt_swag_insert_at_tail(elem, &(elem->constraint->disabled_element_set));
 
+  if (sys->soa_storage)
+    lmm_soa_element_new(sys, elem);
+
   if (not sys->selective_update_active) {
     make_constraint_active(sys, cnst);
   } else if (elem->consumption_weight > 0 || var->sharing_weight > 0) {
@@ -478,6 +499,8 @@ void lmm_expand_add(lmm_system_t sys, lmm_constraint_t cnst, lmm_variable_t var,
       var->cnsts[i].consumption_weight += value;
     else
       var->cnsts[i].consumption_weight = MAX(var->cnsts[i].consumption_weight, value);
+    if (sys->soa_storage)
+      lmm_soa_element_update(sys, &var->cnsts[i]);
 
     //We need to check that increasing value of the element does not cross the concurrency limit
     if (var->sharing_weight) {
@@ -722,6 +745,11 @@ void lmm_solve(lmm_system_t sys)
   double min_usage = -1;
   double min_bound = -1;
 
+  if (sys->soa_storage) {
+    lmm_solve_soa(sys);
+    return;
+  }
+
   if (not sys->modified)
     return;
 
@@ -948,6 +976,8 @@ void lmm_update_variable_bound(lmm_system_t sys, lmm_variable_t var, double boun
 {
   sys->modified = 1;
   var->bound = bound;
+  if (sys->soa_storage)
+    lmm_soa_variable_update(sys, var);
 
   if (var->cnsts_number)
     lmm_update_modified_set(sys, var->cnsts[0].constraint);
@@ -1011,6 +1041,8 @@ void lmm_enable_var(lmm_system_t sys, lmm_variable_t var){
     xbt_swag_insert_at_head(elem, &(elem->constraint->enabled_element_set));
     lmm_increase_concurrency(elem);
   }
+  if (sys->soa_storage)
+    lmm_soa_variable_enable(sys, var);
   if (var->cnsts_number)
     lmm_update_modified_set(sys, var->cnsts[0].constraint);
 
@@ -1044,6 +1076,8 @@ void lmm_disable_var(lmm_system_t sys, lmm_variable_t var){
   var->sharing_weight = 0.0;
   var->staged_weight=0.0;
   var->value = 0.0;
+  if (sys->soa_storage)
+    lmm_soa_variable_disable(sys, var);
   lmm_check_concurrency(sys);
 }
 
@@ -1126,6 +1160,8 @@ void lmm_update_variable_weight(lmm_system_t sys, lmm_variable_t var, double wei
     lmm_disable_var(sys,var);
   } else {
     var->sharing_weight = weight;
+    if (sys->soa_storage)
+      lmm_soa_variable_update(sys, var);
   }
 
   lmm_check_concurrency(sys);
@@ -1143,6 +1179,8 @@ void lmm_update_constraint_bound(lmm_system_t sys, lmm_constraint_t cnst, double
   sys->modified = 1;
   lmm_update_modified_set(sys, cnst);
   cnst->bound = bound;
+  if (sys->soa_storage)
+    lmm_soa_constraint_update(sys, cnst);
 }
 
 int lmm_constraint_used(lmm_system_t sys, lmm_constraint_t cnst)
@@ -1202,7 +1240,7 @@ static void lmm_update_modified_set(lmm_system_t sys, lmm_constraint_t cnst)
  *
  *  \param sys the lmm_system_t
  */
-static void lmm_remove_all_modified_set(lmm_system_t sys)
+void lmm_remove_all_modified_set(lmm_system_t sys)
 {
   //We cleverly un-flag all variables just by incrementing sys->visited_counter
   //In effect, the var->visited value will no more be equal to sys->visited counter
@@ -11,6 +11,12 @@
 #include "xbt/mallocator.h"
 #include "surf_interface.hpp"
 
+namespace simgrid {
+namespace surf {
+class LmmSoaStorage;
+}
+}
+
 /** @ingroup SURF_lmm
  * @brief LMM element
  * Elements can be seen as glue between constraint objects and variable objects.
@@ -30,6 +36,7 @@ typedef struct lmm_element {
   //   - if CPU, then probably 1.
   //   - If network, then 1 in forward direction and 0.05 backward for the ACKs
   double consumption_weight;
+  int soa_index; /* slot in the contiguous storage of lmm_solve_soa(), -1 when the system has none */
 } s_lmm_element_t;
 #define make_elem_active(elem) xbt_swag_insert_at_head(elem,&(elem->constraint->active_element_set))
 #define make_elem_inactive(elem) xbt_swag_remove(elem,&(elem->constraint->active_element_set))
@@ -71,6 +78,7 @@ typedef struct lmm_constraint {
   double lambda;
   double new_lambda;
   lmm_constraint_light_t cnst_light;
+  int soa_index; /* slot in the contiguous storage of lmm_solve_soa(), -1 when the system has none */
 } s_lmm_constraint_t;
 
 /** @ingroup SURF_lmm
@@ -100,6 +108,7 @@ typedef struct lmm_variable {
   simgrid::surf::Action* id;
   int id_int;
   unsigned visited;             /* used by lmm_update_modified_set */
+  int soa_index;                /* slot in the contiguous storage of lmm_solve_soa(), -1 when the system has none */
   /* \begin{For Lagrange only} */
   double mu;
   double new_mu;
@@ -130,6 +139,8 @@ typedef struct lmm_system {
   xbt_mallocator_t variable_mallocator;
 
   void (*solve_fun)(lmm_system_t self);
+
+  simgrid::surf::LmmSoaStorage* soa_storage; /* arrays of lmm_solve_soa(), only with maxmin/soa */
 } s_lmm_system_t;
 
 #define extract_variable(sys) xbt_swag_extract(&(sys->variable_set))
@@ -151,6 +162,25 @@ typedef struct lmm_system {
  */
 //XBT_PRIVATE void lmm_print(lmm_system_t sys);
 
+XBT_PRIVATE void lmm_remove_all_modified_set(lmm_system_t sys);
+XBT_PRIVATE void lmm_check_concurrency(lmm_system_t sys);
+
+/* Keep the contiguous storage of lmm_solve_soa() up to date, when the system has one */
+XBT_PRIVATE void lmm_soa_storage_new(lmm_system_t sys);
+XBT_PRIVATE void lmm_soa_storage_free(lmm_system_t sys);
+XBT_PRIVATE void lmm_soa_constraint_new(lmm_system_t sys, lmm_constraint_t cnst);
+XBT_PRIVATE void lmm_soa_constraint_free(lmm_system_t sys, lmm_constraint_t cnst);
+XBT_PRIVATE void lmm_soa_constraint_update(lmm_system_t sys, lmm_constraint_t cnst);
+XBT_PRIVATE void lmm_soa_variable_new(lmm_system_t sys, lmm_variable_t var);
+XBT_PRIVATE void lmm_soa_variable_free(lmm_system_t sys, lmm_variable_t var);
+XBT_PRIVATE void lmm_soa_variable_update(lmm_system_t sys, lmm_variable_t var);
+XBT_PRIVATE void lmm_soa_variable_remove(lmm_system_t sys, lmm_variable_t var);
+XBT_PRIVATE void lmm_soa_variable_enable(lmm_system_t sys, lmm_variable_t var);
+XBT_PRIVATE void lmm_soa_variable_disable(lmm_system_t sys, lmm_variable_t var);
+XBT_PRIVATE void lmm_soa_element_new(lmm_system_t sys, lmm_element_t elem);
+XBT_PRIVATE void lmm_soa_element_free(lmm_system_t sys, lmm_element_t elem);
+XBT_PRIVATE void lmm_soa_element_update(lmm_system_t sys, lmm_element_t elem);
+
 extern XBT_PRIVATE double (*func_f_def) (lmm_variable_t, double);
 extern XBT_PRIVATE double (*func_fp_def) (lmm_variable_t, double);
 extern XBT_PRIVATE double (*func_fpi_def) (lmm_variable_t, double);
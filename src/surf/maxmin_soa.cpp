@@ -0,0 +1,566 @@
+/* Copyright (c) 2017. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#include "maxmin_private.hpp"
+#include "xbt/log.h"
+#include "xbt/sysdep.h"
+
+#include <algorithm>
+#include <vector>
+
+XBT_LOG_EXTERNAL_DEFAULT_CATEGORY(surf_maxmin);
+
+namespace simgrid {
+namespace surf {
+
+/** @ingroup SURF_lmm
+ * @brief Contiguous storage of a LMM system, used by lmm_solve_soa()
+ *
+ * Constraints, variables and elements are addressed by a slot index (their `soa_index`), which is given when they are
+ * created and released when they are freed. The arrays below are updated by the lmm_* functions at each change of the
+ * system, so that the solver never walks the swags of the elements.
+ *
+ * The enabled and active elements of each constraint are kept in doubly linked lists of indices, which are updated
+ * exactly like the enabled_element_set and active_element_set swags of lmm_solve(): both solvers visit the elements
+ * in the same order, and compute the same values. The elements of each variable are linked in the order of its
+ * `cnsts` array.
+ *
+ * The active elements, the remaining and usage of the constraints only live in these arrays: the corresponding fields
+ * of the lmm structures are not maintained when the system has a contiguous storage.
+ */
+class LmmSoaStorage {
+public:
+  int new_cnst();
+  int new_elem();
+  int new_var();
+
+  void enable(int e);
+  void disable(int e);
+  void activate(int e);
+  void deactivate(int e);
+
+  std::vector<lmm_constraint_t> cnst;
+  std::vector<double> cnst_bound;
+  std::vector<double> cnst_remaining;
+  std::vector<double> cnst_usage;
+  std::vector<char> cnst_shared;
+  std::vector<int> cnst_light; /* position in the light set, -1 if not there */
+  std::vector<int> cnst_enabled_head;
+  std::vector<int> cnst_active_head;
+  std::vector<int> cnst_active_count;
+  std::vector<int> free_cnst;
+
+  std::vector<int> elem_cnst;
+  std::vector<int> elem_var;
+  std::vector<double> elem_weight;
+  std::vector<char> elem_state; /* ELEM_ENABLED and ELEM_ACTIVE */
+  std::vector<int> elem_enabled_prev;
+  std::vector<int> elem_enabled_next;
+  std::vector<int> elem_active_prev;
+  std::vector<int> elem_active_next;
+  std::vector<int> elem_var_next;
+  std::vector<int> free_elem;
+
+  std::vector<lmm_variable_t> var;
+  std::vector<double> var_weight;
+  std::vector<double> var_bound;
+  std::vector<double> var_value; /* same as var->value */
+  std::vector<char> var_saturated;
+  std::vector<int> var_elem_head;
+  std::vector<int> var_elem_tail;
+  std::vector<int> free_var;
+
+  /* compact index sets of the solve */
+  std::vector<int> solved;                 /* constraints of the solved list */
+  std::vector<int> light;                  /* constraints that can still be saturated */
+  std::vector<double> light_remaining_over_usage;
+  std::vector<int> saturated_cnst;         /* positions in light */
+  std::vector<int> saturated_var;
+};
+}
+}
+
+#define ELEM_ENABLED 1
+#define ELEM_ACTIVE 2
+
+/* Insert at the head of a list of indices, like xbt_swag_insert_at_head() */
+static inline void lmm_soa_list_insert(std::vector<int>& prev, std::vector<int>& next, int* head, int e)
+{
+  prev[e] = -1;
+  next[e] = *head;
+  if (*head >= 0)
+    prev[*head] = e;
+  *head = e;
+}
+
+static inline void lmm_soa_list_remove(std::vector<int>& prev, std::vector<int>& next, int* head, int e)
+{
+  if (prev[e] >= 0)
+    next[prev[e]] = next[e];
+  else
+    *head = next[e];
+  if (next[e] >= 0)
+    prev[next[e]] = prev[e];
+}
+
+int simgrid::surf::LmmSoaStorage::new_cnst()
+{
+  if (not free_cnst.empty()) {
+    int c = free_cnst.back();
+    free_cnst.pop_back();
+    return c;
+  }
+  cnst.push_back(nullptr);
+  cnst_bound.push_back(0.0);
+  cnst_remaining.push_back(0.0);
+  cnst_usage.push_back(0.0);
+  cnst_shared.push_back(1);
+  cnst_light.push_back(-1);
+  cnst_enabled_head.push_back(-1);
+  cnst_active_head.push_back(-1);
+  cnst_active_count.push_back(0);
+  return cnst.size() - 1;
+}
+
+int simgrid::surf::LmmSoaStorage::new_elem()
+{
+  if (not free_elem.empty()) {
+    int e = free_elem.back();
+    free_elem.pop_back();
+    return e;
+  }
+  elem_cnst.push_back(-1);
+  elem_var.push_back(-1);
+  elem_weight.push_back(0.0);
+  elem_state.push_back(0);
+  elem_enabled_prev.push_back(-1);
+  elem_enabled_next.push_back(-1);
+  elem_active_prev.push_back(-1);
+  elem_active_next.push_back(-1);
+  elem_var_next.push_back(-1);
+  return elem_cnst.size() - 1;
+}
+
+int simgrid::surf::LmmSoaStorage::new_var()
+{
+  if (not free_var.empty()) {
+    int v = free_var.back();
+    free_var.pop_back();
+    return v;
+  }
+  var.push_back(nullptr);
+  var_weight.push_back(0.0);
+  var_bound.push_back(0.0);
+  var_value.push_back(0.0);
+  var_saturated.push_back(0);
+  var_elem_head.push_back(-1);
+  var_elem_tail.push_back(-1);
+  return var.size() - 1;
+}
+
+void simgrid::surf::LmmSoaStorage::enable(int e)
+{
+  if (not(elem_state[e] & ELEM_ENABLED)) {
+    elem_state[e] |= ELEM_ENABLED;
+    lmm_soa_list_insert(elem_enabled_prev, elem_enabled_next, &cnst_enabled_head[elem_cnst[e]], e);
+  }
+}
+
+void simgrid::surf::LmmSoaStorage::disable(int e)
+{
+  if (elem_state[e] & ELEM_ENABLED) {
+    elem_state[e] &= ~ELEM_ENABLED;
+    lmm_soa_list_remove(elem_enabled_prev, elem_enabled_next, &cnst_enabled_head[elem_cnst[e]], e);
+  }
+}
+
+void simgrid::surf::LmmSoaStorage::activate(int e)
+{
+  if (not(elem_state[e] & ELEM_ACTIVE)) {
+    elem_state[e] |= ELEM_ACTIVE;
+    lmm_soa_list_insert(elem_active_prev, elem_active_next, &cnst_active_head[elem_cnst[e]], e);
+    cnst_active_count[elem_cnst[e]]++;
+  }
+}
+
+void simgrid::surf::LmmSoaStorage::deactivate(int e)
+{
+  if (elem_state[e] & ELEM_ACTIVE) {
+    elem_state[e] &= ~ELEM_ACTIVE;
+    lmm_soa_list_remove(elem_active_prev, elem_active_next, &cnst_active_head[elem_cnst[e]], e);
+    cnst_active_count[elem_cnst[e]]--;
+  }
+}
+
+void lmm_soa_storage_new(lmm_system_t sys)
+{
+  sys->soa_storage = new simgrid::surf::LmmSoaStorage();
+}
+
+void lmm_soa_storage_free(lmm_system_t sys)
+{
+  delete sys->soa_storage;
+  sys->soa_storage = nullptr;
+}
+
+void lmm_soa_constraint_new(lmm_system_t sys, lmm_constraint_t cnst)
+{
+  simgrid::surf::LmmSoaStorage* s = sys->soa_storage;
+  int c                           = s->new_cnst();
+  cnst->soa_index                 = c;
+  s->cnst[c]                      = cnst;
+  s->cnst_bound[c]                = cnst->bound;
+  s->cnst_remaining[c]            = 0.0;
+  s->cnst_usage[c]                = 0.0;
+  s->cnst_shared[c]               = cnst->sharing_policy != 0;
+}
+
+void lmm_soa_constraint_free(lmm_system_t sys, lmm_constraint_t cnst)
+{
+  simgrid::surf::LmmSoaStorage* s = sys->soa_storage;
+  int c                           = cnst->soa_index;
+  s->cnst[c]                      = nullptr;
+  s->cnst_enabled_head[c]         = -1;
+  s->cnst_active_head[c]          = -1;
+  s->cnst_active_count[c]         = 0;
+  s->free_cnst.push_back(c);
+  cnst->soa_index = -1;
+}
+
+void lmm_soa_constraint_update(lmm_system_t sys, lmm_constraint_t cnst)
+{
+  sys->soa_storage->cnst_bound[cnst->soa_index] = cnst->bound;
+}
+
+void lmm_soa_variable_new(lmm_system_t sys, lmm_variable_t var)
+{
+  simgrid::surf::LmmSoaStorage* s = sys->soa_storage;
+  int v                           = s->new_var();
+  var->soa_index                  = v;
+  s->var[v]                       = var;
+  s->var_weight[v]                = var->sharing_weight;
+  s->var_bound[v]                 = var->bound;
+  s->var_value[v]                 = var->value;
+  s->var_elem_head[v]             = -1;
+  s->var_elem_tail[v]             = -1;
+}
+
+void lmm_soa_variable_free(lmm_system_t sys, lmm_variable_t var)
+{
+  simgrid::surf::LmmSoaStorage* s = sys->soa_storage;
+  s->var[var->soa_index]          = nullptr;
+  s->free_var.push_back(var->soa_index);
+  var->soa_index = -1;
+}
+
+void lmm_soa_variable_update(lmm_system_t sys, lmm_variable_t var)
+{
+  simgrid::surf::LmmSoaStorage* s = sys->soa_storage;
+  s->var_weight[var->soa_index]   = var->sharing_weight;
+  s->var_bound[var->soa_index]    = var->bound;
+  s->var_value[var->soa_index]    = var->value;
+}
+
+/* Release all the elements of the variable, as lmm_variable_remove() does */
+void lmm_soa_variable_remove(lmm_system_t sys, lmm_variable_t var)
+{
+  simgrid::surf::LmmSoaStorage* s = sys->soa_storage;
+  int v                           = var->soa_index;
+  for (int e = s->var_elem_head[v]; e >= 0; e = s->elem_var_next[e]) {
+    s->disable(e);
+    s->deactivate(e);
+    s->elem_state[e] = 0;
+    s->free_elem.push_back(e);
+  }
+  for (int i = 0; i < var->cnsts_number; i++)
+    var->cnsts[i].soa_index = -1;
+  s->var_elem_head[v] = -1;
+  s->var_elem_tail[v] = -1;
+}
+
+/* Move the elements of the variable to the enabled lists, in the order of lmm_enable_var() */
+void lmm_soa_variable_enable(lmm_system_t sys, lmm_variable_t var)
+{
+  simgrid::surf::LmmSoaStorage* s = sys->soa_storage;
+  int v                           = var->soa_index;
+  s->var_weight[v]                = var->sharing_weight;
+  for (int e = s->var_elem_head[v]; e >= 0; e = s->elem_var_next[e])
+    s->enable(e);
+}
+
+void lmm_soa_variable_disable(lmm_system_t sys, lmm_variable_t var)
+{
+  simgrid::surf::LmmSoaStorage* s = sys->soa_storage;
+  int v                           = var->soa_index;
+  for (int e = s->var_elem_head[v]; e >= 0; e = s->elem_var_next[e]) {
+    s->disable(e);
+    s->deactivate(e);
+  }
+  s->var_weight[v] = var->sharing_weight;
+  s->var_value[v]  = var->value;
+}
+
+/* Map the element appended by lmm_expand() at the end of the constraints of its variable */
+void lmm_soa_element_new(lmm_system_t sys, lmm_element_t elem)
+{
+  simgrid::surf::LmmSoaStorage* s = sys->soa_storage;
+  int e                           = s->new_elem();
+  int v                           = elem->variable->soa_index;
+  elem->soa_index                 = e;
+  s->elem_cnst[e]                 = elem->constraint->soa_index;
+  s->elem_var[e]                  = v;
+  s->elem_weight[e]               = elem->consumption_weight;
+  s->elem_state[e]                = 0;
+  s->elem_var_next[e]             = -1;
+  if (s->var_elem_tail[v] >= 0)
+    s->elem_var_next[s->var_elem_tail[v]] = e;
+  else
+    s->var_elem_head[v] = e;
+  s->var_elem_tail[v] = e;
+  if (elem->variable->sharing_weight > 0)
+    s->enable(e);
+}
+
+/* Release the element removed by lmm_shrink() */
+void lmm_soa_element_free(lmm_system_t sys, lmm_element_t elem)
+{
+  simgrid::surf::LmmSoaStorage* s = sys->soa_storage;
+  int e                           = elem->soa_index;
+  int v                           = s->elem_var[e];
+  s->disable(e);
+  s->deactivate(e);
+  s->elem_state[e] = 0;
+
+  int prev = -1;
+  for (int f = s->var_elem_head[v]; f != e; f = s->elem_var_next[f])
+    prev = f;
+  if (prev >= 0)
+    s->elem_var_next[prev] = s->elem_var_next[e];
+  else
+    s->var_elem_head[v] = s->elem_var_next[e];
+  if (s->var_elem_tail[v] == e)
+    s->var_elem_tail[v] = prev;
+
+  s->free_elem.push_back(e);
+  elem->soa_index = -1;
+}
+
+void lmm_soa_element_update(lmm_system_t sys, lmm_element_t elem)
+{
+  sys->soa_storage->elem_weight[elem->soa_index] = elem->consumption_weight;
+}
+
+static inline void lmm_soa_saturated_constraint_update(simgrid::surf::LmmSoaStorage* s, double usage, int pos,
+                                                        double* min_usage)
+{
+  xbt_assert(usage > 0, "Impossible");
+
+  if (*min_usage < 0 || *min_usage > usage) {
+    *min_usage = usage;
+    s->saturated_cnst.clear();
+    s->saturated_cnst.push_back(pos);
+  } else if (*min_usage == usage) {
+    s->saturated_cnst.push_back(pos);
+  }
+}
+
+/* Add active variables (i.e. variables that need to be set) from the set of constraints to saturate */
+static inline void lmm_soa_saturated_variable_update(simgrid::surf::LmmSoaStorage* s)
+{
+  for (int pos : s->saturated_cnst) {
+    int c = s->light[pos];
+    for (int e = s->cnst_active_head[c]; e >= 0; e = s->elem_active_next[e]) {
+      int v = s->elem_var[e];
+      xbt_assert(s->var_weight[v] > 0);
+      if (s->elem_weight[e] > 0 && not s->var_saturated[v]) {
+        s->var_saturated[v] = 1;
+        s->saturated_var.push_back(v);
+      }
+    }
+  }
+}
+
+/* Remove the constraint from the light set if it is saturated, or refresh its remaining over usage ratio */
+static inline void lmm_soa_light_update(simgrid::surf::LmmSoaStorage* s, int c)
+{
+  int index = s->cnst_light[c];
+  if (not double_positive(s->cnst_usage[c], sg_maxmin_precision) ||
+      not double_positive(s->cnst_remaining[c], s->cnst_bound[c] * sg_maxmin_precision)) {
+    if (index >= 0) {
+      int last                             = s->light.size() - 1;
+      s->light[index]                      = s->light[last];
+      s->light_remaining_over_usage[index] = s->light_remaining_over_usage[last];
+      s->cnst_light[s->light[index]]       = index;
+      s->cnst_light[c]                     = -1;
+      s->light.pop_back();
+      s->light_remaining_over_usage.pop_back();
+    }
+  } else if (index >= 0) {
+    s->light_remaining_over_usage[index] = s->cnst_remaining[c] / s->cnst_usage[c];
+  }
+}
+
+static inline void lmm_soa_set_value(simgrid::surf::LmmSoaStorage* s, int v, double value)
+{
+  s->var_value[v]  = value;
+  s->var[v]->value = value;
+}
+
+void lmm_solve_soa(lmm_system_t sys)
+{
+  void* _cnst;
+
+  if (not sys->modified)
+    return;
+
+  xbt_assert(sys->soa_storage, "This lmm system was not created with maxmin/soa");
+  simgrid::surf::LmmSoaStorage* s = sys->soa_storage;
+
+  XBT_IN("(sys=%p)", sys);
+
+  xbt_swag_t cnst_list = sys->selective_update_active ? &(sys->modified_constraint_set) : &(sys->active_constraint_set);
+  XBT_DEBUG("Active constraints : %d", xbt_swag_size(cnst_list));
+
+  /* Init: Only modified code portions: reset the value of active variables. The sharing policy is read here as
+   * lmm_constraint_shared() does not know the system. */
+  s->solved.clear();
+  xbt_swag_foreach(_cnst, cnst_list) {
+    lmm_constraint_t cnst = static_cast<lmm_constraint_t>(_cnst);
+    int c                 = cnst->soa_index;
+    s->cnst_shared[c]     = cnst->sharing_policy != 0;
+    s->solved.push_back(c);
+    for (int e = s->cnst_enabled_head[c]; e >= 0; e = s->elem_enabled_next[e]) {
+      xbt_assert(s->var_weight[s->elem_var[e]] > 0.0);
+      lmm_soa_set_value(s, s->elem_var[e], 0.0);
+    }
+  }
+
+  double min_usage = -1;
+  double min_bound = -1;
+  s->light.clear();
+  s->light_remaining_over_usage.clear();
+  s->saturated_cnst.clear();
+
+  /* Collect constraints that actually need to be saturated (i.e remaining and usage are strictly positive) */
+  for (int c : s->solved) {
+    s->cnst_remaining[c] = s->cnst_bound[c];
+    if (not double_positive(s->cnst_remaining[c], s->cnst_bound[c] * sg_maxmin_precision))
+      continue;
+    double usage = 0;
+    for (int e = s->cnst_enabled_head[c]; e >= 0; e = s->elem_enabled_next[e]) {
+      if (s->elem_weight[e] <= 0)
+        continue;
+      int v = s->elem_var[e];
+      if (s->cnst_shared[c])
+        usage += s->elem_weight[e] / s->var_weight[v];
+      else if (usage < s->elem_weight[e] / s->var_weight[v])
+        usage = s->elem_weight[e] / s->var_weight[v];
+
+      s->activate(e);
+      simgrid::surf::Action* action = s->var[v]->id;
+      if (sys->keep_track && not action->is_linked())
+        sys->keep_track->push_back(*action);
+    }
+    s->cnst_usage[c] = usage;
+
+    if (usage > 0) {
+      s->cnst_light[c] = s->light.size();
+      s->light.push_back(c);
+      s->light_remaining_over_usage.push_back(s->cnst_remaining[c] / usage);
+      lmm_soa_saturated_constraint_update(s, s->light_remaining_over_usage.back(), s->light.size() - 1, &min_usage);
+      xbt_assert(s->cnst_active_count[c] > 0, "There is no sense adding a constraint that has no active element!");
+    }
+  }
+
+  lmm_soa_saturated_variable_update(s);
+
+  /* Saturated variables update */
+  do {
+    /* First check if some of these variables could reach their upper bound and update min_bound accordingly. */
+    for (int v : s->saturated_var) {
+      double bound = s->var_bound[v] * s->var_weight[v];
+      if ((s->var_bound[v] > 0) && (bound < min_usage)) {
+        if (min_bound < 0)
+          min_bound = bound;
+        else
+          min_bound = std::min(min_bound, bound);
+      }
+    }
+
+    for (int v : s->saturated_var) {
+      s->var_saturated[v] = 0;
+      if (min_bound < 0) {
+        // If no variable could reach its bound, deal iteratively the constraints usage (at worst one constraint is
+        // saturated at each cycle)
+        lmm_soa_set_value(s, v, min_usage / s->var_weight[v]);
+      } else if (double_equals(min_bound, s->var_bound[v] * s->var_weight[v], sg_maxmin_precision)) {
+        // If there exist a variable that can reach its bound, only update it (and other with the same bound) for now.
+        lmm_soa_set_value(s, v, s->var_bound[v]);
+      } else {
+        // Variables which bound is different are not considered for this cycle, but they will be afterwards.
+        continue;
+      }
+      XBT_DEBUG("Setting var (%d) value to %f", s->var[v]->id_int, s->var_value[v]);
+
+      /* Update the usage of contraints where this variable is involved */
+      for (int e = s->var_elem_head[v]; e >= 0; e = s->elem_var_next[e]) {
+        int c = s->elem_cnst[e];
+        if (s->cnst_shared[c]) {
+          // Remember: shared constraints require that sum(elem->value * var->value) < cnst->bound
+          double_update(&s->cnst_remaining[c], s->elem_weight[e] * s->var_value[v],
+                        s->cnst_bound[c] * sg_maxmin_precision);
+          double_update(&s->cnst_usage[c], s->elem_weight[e] / s->var_weight[v], sg_maxmin_precision);
+          lmm_soa_light_update(s, c);
+          s->deactivate(e);
+        } else {
+          // Remember: non-shared constraints only require that max(elem->value * var->value) < cnst->bound
+          s->deactivate(e);
+          double usage = 0.0;
+          for (int f = s->cnst_enabled_head[c]; f >= 0; f = s->elem_enabled_next[f]) {
+            int w = s->elem_var[f];
+            if (s->var_value[w] > 0)
+              continue;
+            if (s->elem_weight[f] > 0)
+              usage = std::max(usage, s->elem_weight[f] / s->var_weight[w]);
+          }
+          s->cnst_usage[c] = usage;
+          lmm_soa_light_update(s, c);
+          xbt_assert(s->cnst_light[c] < 0 || s->cnst_active_count[c] > 0,
+                     "Should not keep a maximum constraint that has no active element! You want to check the maxmin "
+                     "precision and possible rounding effects.");
+        }
+      }
+    }
+    s->saturated_var.clear();
+
+    /* Find out which variables reach the maximum */
+    min_usage = -1;
+    min_bound = -1;
+    s->saturated_cnst.clear();
+    for (unsigned pos = 0; pos < s->light.size(); pos++) {
+      xbt_assert(s->cnst_active_count[s->light[pos]] > 0,
+                 "Cannot saturate more a constraint that has no active element! You may want to change the maxmin "
+                 "precision (--cfg=maxmin/precision:<new_value>) because of possible rounding effects.\n\tFor the "
+                 "record, the usage of this constraint is %g while the maxmin precision to which it is compared is %g.",
+                 s->cnst_usage[s->light[pos]], sg_maxmin_precision);
+      lmm_soa_saturated_constraint_update(s, s->light_remaining_over_usage[pos], pos, &min_usage);
+    }
+
+    lmm_soa_saturated_variable_update(s);
+
+  } while (not s->light.empty());
+
+  sys->modified = 0;
+  if (sys->selective_update_active)
+    lmm_remove_all_modified_set(sys);
+
+  if (XBT_LOG_ISENABLED(surf_maxmin, xbt_log_priority_debug)) {
+    lmm_print(sys);
+  }
+
+  lmm_check_concurrency(sys);
+
+  XBT_OUT();
+}
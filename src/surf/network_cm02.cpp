@@ -10,6 +10,7 @@
 #include "simgrid/s4u/Host.hpp"
 #include "simgrid/sg_config.h"
 #include "src/instr/instr_private.h" // TRACE_is_enabled(). FIXME: remove by subscribing tracing to the surf signals
+#include "src/kernel/routing/NetZoneImpl.hpp"
 
 XBT_LOG_EXTERNAL_DEFAULT_CATEGORY(surf_network);
 
@@ -154,8 +155,6 @@ NetworkCm02Model::NetworkCm02Model()
   loopback_     = createLink("__loopback__", 498000000, 0.000015, SURF_LINK_FATPIPE);
 
   if (updateMechanism_ == UM_LAZY) {
-    actionHeap_ = xbt_heap_new(8, nullptr);
-    xbt_heap_set_update_callback(actionHeap_, surf_action_lmm_update_index_heap);
     modifiedSet_ = new ActionLmmList();
     maxminSystem_->keep_track = modifiedSet_;
   }
@@ -174,10 +173,9 @@ LinkImpl* NetworkCm02Model::createLink(const char* name, double bandwidth, doubl
 
 void NetworkCm02Model::updateActionsStateLazy(double now, double /*delta*/)
 {
-  while ((xbt_heap_size(actionHeap_) > 0)
-         && (double_equals(xbt_heap_maxkey(actionHeap_), now, sg_surf_precision))) {
+  while (not actionHeap_.empty() && double_equals(actionHeap_.top_key(), now, sg_surf_precision)) {
 
-    NetworkCm02Action *action = static_cast<NetworkCm02Action*> (xbt_heap_pop(actionHeap_));
+    NetworkCm02Action* action = static_cast<NetworkCm02Action*>(actionHeap_.pop());
     XBT_DEBUG("Something happened to action %p", action);
     if (TRACE_is_enabled()) {
       int n = lmm_get_number_of_cnst_from_var(maxminSystem_, action->getVariable());
@@ -273,12 +271,13 @@ Action* NetworkCm02Model::communicate(s4u::Host* src, s4u::Host* dst, double siz
 {
   int failed = 0;
   double latency = 0.0;
-  std::vector<LinkImpl*>* back_route = nullptr;
-  std::vector<LinkImpl*>* route = new std::vector<LinkImpl*>();
+  std::shared_ptr<const std::vector<LinkImpl*>> back_route;
 
   XBT_IN("(%s,%s,%g,%g)", src->getCname(), dst->getCname(), size, rate);
 
-  src->routeTo(dst, route, &latency);
+  /* The routes are shared with the route cache: do not copy nor modify them */
+  std::shared_ptr<const std::vector<LinkImpl*>> route =
+      kernel::routing::NetZoneImpl::getGlobalRoute(src->pimpl_netpoint, dst->pimpl_netpoint, &latency);
   xbt_assert(not route->empty() || latency,
              "You're trying to send data from %s to %s but there is no connecting path between these two hosts.",
              src->getCname(), dst->getCname());
@@ -288,8 +287,7 @@ Action* NetworkCm02Model::communicate(s4u::Host* src, s4u::Host* dst, double siz
       failed = 1;
 
   if (sg_network_crosstraffic == 1) {
-    back_route = new std::vector<LinkImpl*>();
-    dst->routeTo(src, back_route, nullptr);
+    back_route = kernel::routing::NetZoneImpl::getGlobalRoute(dst->pimpl_netpoint, src->pimpl_netpoint, nullptr);
     for (auto link: *back_route)
       if (link->isOff())
         failed = 1;
@@ -359,8 +357,6 @@ Action* NetworkCm02Model::communicate(s4u::Host* src, s4u::Host* dst, double siz
     //lmm_variable_concurrency_share_set(action->getVariable(),2);
   }
 
-  delete route;
-  delete back_route;
   XBT_OUT();
 
   simgrid::s4u::Link::onCommunicate(action, src, dst);
@@ -462,6 +458,7 @@ void NetworkCm02Link::setLatency(double value)
   int numelem = 0;
 
   latency_.peak = value;
+  simgrid::kernel::routing::NetZoneImpl::invalidateRouteCache(); // The cached routes have the former latency
 
   while ((var = lmm_get_var_from_cnst_safe(model()->getMaxminSystem(), constraint(), &elem, &nextelem, &numelem))) {
     NetworkCm02Action *action = static_cast<NetworkCm02Action*>(lmm_variable_id(var));
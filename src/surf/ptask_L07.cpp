@@ -12,6 +12,7 @@
 #include "ptask_L07.hpp"
 
 #include "cpu_interface.hpp"
+#include "src/kernel/routing/NetZoneImpl.hpp"
 
 XBT_LOG_EXTERNAL_DEFAULT_CATEGORY(surf_host);
 XBT_LOG_EXTERNAL_CATEGORY(xbt_cfg);
@@ -381,6 +382,7 @@ void LinkL07::setLatency(double value)
   lmm_element_t elem = nullptr;
 
   latency_.peak = value;
+  simgrid::kernel::routing::NetZoneImpl::invalidateRouteCache(); // The cached routes have the former latency
   while ((var = lmm_get_var_from_cnst(model()->getMaxminSystem(), constraint(), &elem))) {
     action = static_cast<L07Action*>(lmm_variable_id(var));
     action->updateBound();
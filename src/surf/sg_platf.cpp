@@ -428,11 +428,13 @@ void sg_platf_new_mount(sg_platf_mount_cbarg_t mount){
 void sg_platf_new_route(sg_platf_route_cbarg_t route)
 {
   routing_get_current()->addRoute(route);
+  simgrid::kernel::routing::NetZoneImpl::invalidateRouteCache();
 }
 
 void sg_platf_new_bypassRoute(sg_platf_route_cbarg_t bypassRoute)
 {
   routing_get_current()->addBypassRoute(bypassRoute);
+  simgrid::kernel::routing::NetZoneImpl::invalidateRouteCache();
 }
 
 void sg_platf_new_process(sg_platf_process_cbarg_t process)
@@ -534,6 +536,7 @@ void sg_platf_new_peer(sg_platf_peer_cbarg_t peer)
 void sg_platf_begin() { /* Do nothing: just for symmetry of user code */ }
 
 void sg_platf_end() {
+  simgrid::kernel::routing::NetZoneImpl::enableRouteCache(); // The routes should not change anymore
   simgrid::s4u::onPlatformCreated();
 }
 
@@ -674,6 +677,7 @@ void sg_platf_new_AS_seal()
 {
   xbt_assert(current_routing, "Cannot seal the current AS: none under construction");
   current_routing->seal();
+  simgrid::kernel::routing::NetZoneImpl::invalidateRouteCache();
   simgrid::s4u::NetZone::onSeal(*current_routing);
   current_routing = static_cast<simgrid::kernel::routing::NetZoneImpl*>(current_routing->getFather());
 }
@@ -136,6 +136,7 @@ std::ifstream* surf_ifsopen(const char* name)
   xbt_assert(name);
   if (__surf_is_absolute_file_path(name)) { /* don't mess with absolute file names */
     fs->open(name, std::ifstream::in);
+    return fs;
   }
 
   /* search relative files in the path */
@@ -422,7 +423,6 @@ Model::Model()
   doneActionSet_ = new ActionList();
 
   modifiedSet_ = nullptr;
-  actionHeap_ = nullptr;
   updateMechanism_ = UM_UNDEFINED;
   selectiveUpdate_ = 0;
 }
@@ -499,8 +499,8 @@ double Model::nextOccuringEventLazy(double now)
   }
 
   //hereafter must have already the min value for this resource model
-  if (xbt_heap_size(actionHeap_) > 0) {
-    double min = xbt_heap_maxkey(actionHeap_) - now;
+  if (not actionHeap_.empty()) {
+    double min = actionHeap_.top_key() - now;
     XBT_DEBUG("minimum with the HEAP %f", min);
     return min;
   } else {
@@ -624,11 +624,6 @@ const char *surf_action_state_names[6] = {
   "SURF_ACTION_NOT_IN_THE_SYSTEM"
 };
 
-/* added to manage the communication action's heap */
-void surf_action_lmm_update_index_heap(void *action, int i) {
-  static_cast<simgrid::surf::Action*>(action)->updateIndexHeap(i);
-}
-
 namespace simgrid {
 namespace surf {
 
@@ -822,27 +817,27 @@ bool Action::isSuspended()
  * LATENCY = this is a heap entry to warn us when the latency is payed
  * MAX_DURATION =this is a heap entry to warn us when the max_duration limit is reached
  */
-void Action::heapInsert(xbt_heap_t heap, double key, enum heap_action_type hat)
+void Action::heapInsert(ActionHeap& heap, double key, enum heap_action_type hat)
 {
   hat_ = hat;
-  xbt_heap_push(heap, this, key);
+  heap.push(this, key);
 }
 
-void Action::heapRemove(xbt_heap_t heap)
+void Action::heapRemove(ActionHeap& heap)
 {
   hat_ = NOTSET;
   if (indexHeap_ >= 0) {
-    xbt_heap_remove(heap, indexHeap_);
+    heap.remove(indexHeap_);
   }
 }
 
-void Action::heapUpdate(xbt_heap_t heap, double key, enum heap_action_type hat)
+void Action::heapUpdate(ActionHeap& heap, double key, enum heap_action_type hat)
 {
   hat_ = hat;
   if (indexHeap_ >= 0) {
-    xbt_heap_update(heap, indexHeap_, key);
+    heap.update(indexHeap_, key);
   }else{
-    xbt_heap_push(heap, this, key);
+    heap.push(this, key);
   }
 }
 
@@ -6,6 +6,7 @@
 #ifndef SURF_MODEL_H_
 #define SURF_MODEL_H_
 
+#include "xbt/heap.hpp"
 #include "xbt/signal.hpp"
 
 #include "src/surf/surf_private.h"
@@ -71,8 +72,6 @@ XBT_PUBLIC_DATA(xbt_dict_t) traces_set_list;
  * Action *
  **********/
 
-XBT_PRIVATE void surf_action_lmm_update_index_heap(void *action, int i);
-
 /** \ingroup SURF_models
  *  \brief List of initialized models
  */
@@ -81,6 +80,10 @@ XBT_PUBLIC_DATA(std::vector<surf_model_t>*) all_existing_models;
 namespace simgrid {
 namespace surf {
 
+struct ActionHeapIndex;
+/** @brief Heap of the actions of a lazy model, ordered by the date of their next event */
+typedef simgrid::xbt::Heap<Action*, ActionHeapIndex> ActionHeap;
+
 /** @ingroup SURF_interface
  * @brief SURF action interface class
  * @details An action is an event generated by a resource (e.g.: a communication for the network)
@@ -230,9 +233,9 @@ private:
   /* LMM */
 public:
   virtual void updateRemainingLazy(double now);
-  void heapInsert(xbt_heap_t heap, double key, enum heap_action_type hat);
-  void heapRemove(xbt_heap_t heap);
-  void heapUpdate(xbt_heap_t heap, double key, enum heap_action_type hat);
+  void heapInsert(ActionHeap& heap, double key, enum heap_action_type hat);
+  void heapRemove(ActionHeap& heap);
+  void heapUpdate(ActionHeap& heap, double key, enum heap_action_type hat);
   void updateIndexHeap(int i);
   lmm_variable_t getVariable() {return variable_;}
   double getLastUpdate() {return lastUpdate_;}
@@ -246,12 +249,17 @@ protected:
   double lastValue_ = 0;
   double lastUpdate_ = 0;
   int suspended_ = 0;
-  int indexHeap_;
+  int indexHeap_ = -1;
   enum heap_action_type hat_ = NOTSET;
 };
 
 typedef Action::ActionList ActionList;
 
+/** @brief Keeps track of the position of the actions in their ActionHeap */
+struct ActionHeapIndex {
+  void operator()(Action* action, int i) const { action->updateIndexHeap(i); }
+};
+
 typedef boost::intrusive::member_hook<
   Action, boost::intrusive::list_member_hook<>, &Action::action_lmm_hook> ActionLmmOptions;
 typedef boost::intrusive::list<Action, ActionLmmOptions> ActionLmmList;
@@ -295,7 +303,7 @@ public:
   e_UM_t getUpdateMechanism() {return updateMechanism_;}
 
   /** @brief Get Action heap */
-  xbt_heap_t getActionHeap() {return actionHeap_;}
+  ActionHeap& getActionHeap() { return actionHeap_; }
 
   /**
    * @brief Share the resources between the actions
@@ -329,7 +337,7 @@ protected:
   lmm_system_t maxminSystem_ = nullptr;
   e_UM_t updateMechanism_ = UM_UNDEFINED;
   bool selectiveUpdate_;
-  xbt_heap_t actionHeap_;
+  ActionHeap actionHeap_;
 
 private:
   ActionList* readyActionSet_; /**< Actions in state SURF_ACTION_READY */
@@ -9,6 +9,7 @@
 #include "xbt/log.h"
 #include "xbt/str.h"
 
+#include "src/internal_config.h"
 #include "src/surf/surf_interface.hpp"
 #include "src/surf/trace_mgr.hpp"
 #include "surf_private.h"
@@ -16,17 +17,44 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/join.hpp>
 #include <boost/algorithm/string/split.hpp>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
+#include <map>
 #include <math.h>
 #include <sstream>
+#include <stdexcept>
+#include <sys/stat.h>
 #include <unordered_map>
+#if HAVE_MMAP
+#include <sys/mman.h>
+#endif
 
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY(surf_trace, surf, "Surf trace management");
 
 namespace tmgr = simgrid::trace_mgr;
 
+bool sg_surf_calendar_queue = false; /* Change this with --cfg=surf/calendar-queue:yes */
+
 static std::unordered_map<const char*, tmgr::trace*> trace_list;
 
+/* The binary traces are made of this header, followed by the dated values as stored in the event_list of the trace:
+ * the first one is the placeholder, the dates are the delays between events, and the last one is the periodicity. */
+struct BinaryTraceHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t byte_order; /* traces written on a machine of another endianness are refused */
+  uint64_t count;      /* amount of dated values */
+};
+static const char binary_trace_magic[8]       = "SGTRACE";
+static const uint32_t binary_trace_version    = 1;
+static const uint32_t binary_trace_byte_order = 0x01020304;
+static_assert(sizeof(tmgr::DatedValue) == 2 * sizeof(double), "The dated values are written as pairs of doubles");
+
+/* The binary trace files currently loaded, by device and inode, so that all their traces share the same memory */
+static std::map<std::pair<dev_t, ino_t>, std::weak_ptr<const void>> binary_trace_files;
+
 static inline bool doubleEq(double d1, double d2)
 {
   return fabs(d1 - d2) < 0.0001;
@@ -44,17 +72,42 @@ std::ostream& operator<<(std::ostream& out, const DatedValue& e)
   return out;
 }
 
+const DatedValue& DatedValueList::at(std::size_t i) const
+{
+  if (i >= size_)
+    throw std::out_of_range("DatedValueList::at");
+  return data_[i];
+}
+
+void DatedValueList::assign(std::vector<DatedValue> values)
+{
+  storage_.reset();
+  values_ = std::move(values);
+  data_   = values_.data();
+  size_   = values_.size();
+}
+
+void DatedValueList::assign(std::shared_ptr<const void> storage, const DatedValue* data, std::size_t size)
+{
+  values_.clear();
+  storage_ = std::move(storage);
+  data_    = data;
+  size_    = size;
+}
+
 trace::trace()
 {
   /* Add the first fake event storing the time at which the trace begins */
-  tmgr::DatedValue val(0, -1);
-  event_list.push_back(val);
+  event_list.assign(std::vector<DatedValue>{DatedValue(0, -1)});
 }
 trace::~trace()                  = default;
 future_evt_set::future_evt_set() = default;
 simgrid::trace_mgr::future_evt_set::~future_evt_set()
 {
-  xbt_heap_free(heap_);
+  while (not heap_.empty())
+    xbt_free(heap_.pop());
+  while (not calendar_queue_.empty())
+    xbt_free(calendar_queue_.pop());
 }
 }
 }
@@ -62,8 +115,8 @@ simgrid::trace_mgr::future_evt_set::~future_evt_set()
 tmgr_trace_t tmgr_trace_new_from_string(const char* name, std::string input, double periodicity)
 {
   int linecount = 0;
-  tmgr_trace_t trace           = new simgrid::trace_mgr::trace();
-  tmgr::DatedValue* last_event = &(trace->event_list.back());
+  tmgr_trace_t trace = new simgrid::trace_mgr::trace();
+  std::vector<tmgr::DatedValue> events(trace->event_list.begin(), trace->event_list.end());
 
   xbt_assert(trace_list.find(name) == trace_list.end(), "Refusing to define trace %s twice", name);
 
@@ -83,32 +136,110 @@ tmgr_trace_t tmgr_trace_new_from_string(const char* name, std::string input, dou
     xbt_assert(sscanf(val.c_str(), "%lg  %lg\n", &event.date_, &event.value_) == 2, "%s:%d: Syntax error in trace\n%s",
                name, linecount, input.c_str());
 
-    xbt_assert(last_event->date_ <= event.date_,
+    tmgr::DatedValue& last_event = events.back();
+    xbt_assert(last_event.date_ <= event.date_,
                "%s:%d: Invalid trace: Events must be sorted, but time %g > time %g.\n%s", name, linecount,
-               last_event->date_, event.date_, input.c_str());
-    last_event->date_ = event.date_ - last_event->date_;
+               last_event.date_, event.date_, input.c_str());
+    last_event.date_ = event.date_ - last_event.date_;
 
-    trace->event_list.push_back(event);
-    last_event = &(trace->event_list.back());
+    events.push_back(event);
   }
-  if (last_event) {
-    if (periodicity > 0) {
-      last_event->date_ = periodicity + trace->event_list.at(0).date_;
-    } else {
-      last_event->date_ = -1;
-    }
+  if (periodicity > 0) {
+    events.back().date_ = periodicity + events.at(0).date_;
+  } else {
+    events.back().date_ = -1;
   }
+  trace->event_list.assign(std::move(events));
 
   trace_list.insert({xbt_strdup(name), trace});
 
   return trace;
 }
 
+/* Map the dated values of a binary trace, or share the mapping of another trace of the same file */
+static tmgr_trace_t tmgr_trace_new_from_binary(const char* filename, FILE* file, const BinaryTraceHeader& header)
+{
+  /* The file may come from anywhere: these checks must remain when built with NDEBUG */
+  if (header.version != binary_trace_version)
+    xbt_die("%s: Unsupported version %u of binary trace (expected %u)", filename, (unsigned)header.version,
+            (unsigned)binary_trace_version);
+  if (header.byte_order != binary_trace_byte_order)
+    xbt_die("%s: Binary trace written on a machine of other endianness", filename);
+  if (header.count == 0)
+    xbt_die("%s: Your trace should have at least one event!", filename);
+  if (header.count > (SIZE_MAX - sizeof header) / sizeof(tmgr::DatedValue))
+    xbt_die("%s: Invalid binary trace: too many events (%llu)", filename, (unsigned long long)header.count);
+
+  struct stat st;
+  if (fstat(fileno(file), &st) != 0)
+    xbt_die("%s: Cannot stat binary trace: %s", filename, strerror(errno));
+  std::size_t length = sizeof(BinaryTraceHeader) + header.count * sizeof(tmgr::DatedValue);
+  if (static_cast<std::size_t>(st.st_size) < length)
+    xbt_die("%s: Truncated binary trace (%zu bytes instead of %zu)", filename, static_cast<std::size_t>(st.st_size),
+            length);
+
+  std::shared_ptr<const void> storage = binary_trace_files[{st.st_dev, st.st_ino}].lock();
+  if (storage) {
+    XBT_DEBUG("Reuse the mapping of binary trace %s", filename);
+  } else {
+#if HAVE_MMAP
+    void* addr = mmap(nullptr, length, PROT_READ, MAP_SHARED, fileno(file), 0);
+    if (addr == MAP_FAILED)
+      xbt_die("%s: Cannot map binary trace: %s", filename, strerror(errno));
+    storage = std::shared_ptr<const void>(addr, [length](const void* p) { munmap(const_cast<void*>(p), length); });
+#else
+    char* buffer = new char[length];
+    rewind(file);
+    if (fread(buffer, length, 1, file) != 1) {
+      delete[] buffer;
+      xbt_die("%s: Cannot read binary trace", filename);
+    }
+    storage = std::shared_ptr<const void>(buffer, [](const void* p) { delete[] static_cast<const char*>(p); });
+#endif
+    binary_trace_files[{st.st_dev, st.st_ino}] = storage;
+  }
+
+  tmgr_trace_t trace = new simgrid::trace_mgr::trace();
+  auto data = reinterpret_cast<const tmgr::DatedValue*>(static_cast<const char*>(storage.get()) + sizeof header);
+  trace->event_list.assign(std::move(storage), data, header.count);
+  trace_list.insert({xbt_strdup(filename), trace});
+
+  return trace;
+}
+
+void tmgr_trace_save_binary(tmgr_trace_t trace, const char* filename)
+{
+  BinaryTraceHeader header;
+  memcpy(header.magic, binary_trace_magic, sizeof binary_trace_magic);
+  header.version    = binary_trace_version;
+  header.byte_order = binary_trace_byte_order;
+  header.count      = trace->event_list.size();
+
+  FILE* file = fopen(filename, "wb");
+  xbt_assert(file, "Cannot open file '%s' for writing: %s", filename, strerror(errno));
+  bool written = fwrite(&header, sizeof header, 1, file) == 1 &&
+                 fwrite(trace->event_list.begin(), sizeof(tmgr::DatedValue), header.count, file) == header.count;
+  written = (fclose(file) == 0) && written;
+  xbt_assert(written, "Cannot write binary trace '%s': %s", filename, strerror(errno));
+}
+
 tmgr_trace_t tmgr_trace_new_from_file(const char *filename)
 {
   xbt_assert(filename && filename[0], "Cannot parse a trace from the null or empty filename");
   xbt_assert(trace_list.find(filename) == trace_list.end(), "Refusing to define trace %s twice", filename);
 
+  FILE* file = surf_fopen(filename, "rb");
+  xbt_assert(file, "Cannot open file '%s' (path=%s)", filename, (boost::join(surf_path, ":")).c_str());
+  BinaryTraceHeader header;
+  bool binary = fread(&header, sizeof header, 1, file) == 1 &&
+                memcmp(header.magic, binary_trace_magic, sizeof binary_trace_magic) == 0;
+  if (binary) {
+    tmgr_trace_t trace = tmgr_trace_new_from_binary(filename, file, header);
+    fclose(file);
+    return trace;
+  }
+  fclose(file);
+
   std::ifstream* f = surf_ifsopen(filename);
   xbt_assert(not f->fail(), "Cannot open file '%s' (path=%s)", filename, (boost::join(surf_path, ":")).c_str());
 
@@ -131,17 +262,28 @@ tmgr_trace_event_t simgrid::trace_mgr::future_evt_set::add_trace(tmgr_trace_t tr
 
   xbt_assert((trace_iterator->idx < trace->event_list.size()), "Your trace should have at least one event!");
 
-  xbt_heap_push(heap_, trace_iterator, 0. /*start_time*/);
+  /* The configuration is parsed after the creation of the future event set, but before the platform */
+  if (empty())
+    calendar_ = sg_surf_calendar_queue;
+  push(trace_iterator, 0. /*start_time*/);
 
   return trace_iterator;
 }
 
+void simgrid::trace_mgr::future_evt_set::push(tmgr_trace_event_t trace_iterator, double date)
+{
+  if (calendar_)
+    calendar_queue_.push(trace_iterator, date);
+  else
+    heap_.push(trace_iterator, date);
+}
+
 /** @brief returns the date of the next occurring event (pure function) */
 double simgrid::trace_mgr::future_evt_set::next_date() const
 {
-  if (xbt_heap_size(heap_))
-    return (xbt_heap_maxkey(heap_));
-  return -1.0;
+  if (empty())
+    return -1.0;
+  return calendar_ ? calendar_queue_.top_key() : heap_.top_key();
 }
 
 /** @brief Retrieves the next occurring event, or nullptr if none happens before #date */
@@ -152,9 +294,9 @@ tmgr_trace_event_t simgrid::trace_mgr::future_evt_set::pop_leq(double date, doub
   if (event_date > date)
     return nullptr;
 
-  tmgr_trace_event_t trace_iterator = (tmgr_trace_event_t)xbt_heap_pop(heap_);
-  if (trace_iterator == nullptr)
+  if (empty())
     return nullptr;
+  tmgr_trace_event_t trace_iterator = calendar_ ? calendar_queue_.pop() : heap_.pop();
 
   tmgr_trace_t trace = trace_iterator->trace;
   *resource = trace_iterator->resource;
@@ -164,10 +306,10 @@ tmgr_trace_event_t simgrid::trace_mgr::future_evt_set::pop_leq(double date, doub
   *value = dateVal.value_;
 
   if (trace_iterator->idx < trace->event_list.size() - 1) {
-    xbt_heap_push(heap_, trace_iterator, event_date + dateVal.date_);
+    push(trace_iterator, event_date + dateVal.date_);
     trace_iterator->idx++;
   } else if (dateVal.date_ > 0) { /* Last element. Shall we loop? */
-    xbt_heap_push(heap_, trace_iterator, event_date + dateVal.date_);
+    push(trace_iterator, event_date + dateVal.date_);
     trace_iterator->idx = 1; /* idx=0 is a placeholder to store when events really start */
   } else {                   /* If we don't loop, we don't need this trace_event anymore */
     trace_iterator->free_me = 1;
@@ -7,8 +7,10 @@
 #define SURF_TMGR_H
 
 #include "simgrid/forward.h"
-#include "xbt/heap.h"
+#include "src/xbt/calendar_queue.hpp"
+#include "xbt/heap.hpp"
 #include "xbt/sysdep.h"
+#include <memory>
 #include <vector>
 
 SG_BEGIN_DECL()
@@ -35,6 +37,8 @@ XBT_PUBLIC(void) tmgr_finalize();
 
 XBT_PUBLIC(tmgr_trace_t) tmgr_trace_new_from_file(const char* filename);
 XBT_PUBLIC(tmgr_trace_t) tmgr_trace_new_from_string(const char* id, std::string input, double periodicity);
+/** @brief Save a trace in the binary format, that tmgr_trace_new_from_file() maps in memory instead of parsing it */
+XBT_PUBLIC(void) tmgr_trace_save_binary(tmgr_trace_t trace, const char* filename);
 
 SG_END_DECL()
 
@@ -63,6 +67,41 @@ public:
 };
 std::ostream& operator<<(std::ostream& out, const DatedValue& e);
 
+/** @brief The dated values of a trace, with the read-only interface of a std::vector
+ *
+ * The values parsed from a textual trace are owned by the list. The ones of a binary trace are a view on the file,
+ * mapped read-only in memory: the pages are only loaded when the events are reached, and the mapping is shared by all
+ * the traces of that file.
+ */
+XBT_PUBLIC_CLASS DatedValueList {
+public:
+  typedef const DatedValue* const_iterator;
+
+  DatedValueList() = default;
+  DatedValueList(const DatedValueList&) = delete;
+  DatedValueList& operator=(const DatedValueList&) = delete;
+
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  const DatedValue& operator[](std::size_t i) const { return data_[i]; }
+  const DatedValue& at(std::size_t i) const;
+  const DatedValue& front() const { return data_[0]; }
+  const DatedValue& back() const { return data_[size_ - 1]; }
+  const_iterator begin() const { return data_; }
+  const_iterator end() const { return data_ + size_; }
+
+  /** Take the ownership of the given values */
+  void assign(std::vector<DatedValue> values);
+  /** Refer to values stored elsewhere, that the given storage keeps alive */
+  void assign(std::shared_ptr<const void> storage, const DatedValue* data, std::size_t size);
+
+private:
+  std::vector<DatedValue> values_;
+  std::shared_ptr<const void> storage_;
+  const DatedValue* data_ = nullptr;
+  std::size_t size_       = 0;
+};
+
 /** @brief A trace_iterator links a trace to a resource */
 XBT_PUBLIC_CLASS trace_event{
 
@@ -79,7 +118,7 @@ public:
   explicit trace();
   virtual ~trace();
 //private:
-  std::vector<DatedValue> event_list;
+  DatedValueList event_list;
 };
 
 /** @brief Future Event Set (collection of iterators over the traces)
@@ -93,8 +132,14 @@ public:
   tmgr_trace_event_t add_trace(tmgr_trace_t trace, simgrid::surf::Resource * resource);
 
 private:
-  // TODO: use a boost type for the heap (or a ladder queue)
-  xbt_heap_t heap_ = xbt_heap_new(8, xbt_free_f); /* Content: only trace_events (yep, 8 is an arbitrary value) */
+  bool empty() const { return calendar_ ? calendar_queue_.empty() : heap_.empty(); }
+  void push(tmgr_trace_event_t trace_iterator, double date);
+
+  /* Content: only trace_events, that we own. They are in the heap, unless surf/calendar-queue was set when the first
+   * trace was added. The calendar queue is faster, but does not handle the simultaneous events in the same order. */
+  bool calendar_ = false;
+  simgrid::xbt::Heap<tmgr_trace_event_t> heap_;
+  simgrid::xbt::CalendarQueue<tmgr_trace_event_t> calendar_queue_;
 };
 
 }} // namespace simgrid::trace_mgr
@@ -15,7 +15,9 @@ bool init_unit_test(); // boost forget to give this prototype on NetBSD, which d
 #include "xbt/log.h"
 #include "xbt/misc.h"
 
+#include <cstdlib>
 #include <math.h>
+#include <unistd.h>
 
 namespace utf  = boost::unit_test;
 namespace tmgr = simgrid::trace_mgr;
@@ -34,9 +36,16 @@ public:
   bool isUsed() { return true; }
 };
 
-static void trace2vector(const char* str, std::vector<tmgr::DatedValue>* whereto)
+static void trace2vector(const char* str, std::vector<tmgr::DatedValue>* whereto, bool binary = false)
 {
   simgrid::trace_mgr::trace* trace = tmgr_trace_new_from_string("TheName", str, 0);
+  if (binary) { // Go through a binary trace file
+    char filename[] = "/tmp/unit_tmgr_XXXXXX";
+    close(mkstemp(filename));
+    tmgr_trace_save_binary(trace, filename);
+    trace = tmgr_trace_new_from_file(filename);
+    unlink(filename);
+  }
   XBT_VERB("---------------------------------------------------------");
   XBT_VERB("data>>\n%s<<data\n", str);
   for (auto evt : trace->event_list)
@@ -148,6 +157,20 @@ BOOST_AUTO_TEST_CASE(two_evt_start0_loop)
   BOOST_CHECK_EQUAL_COLLECTIONS(want.begin(), want.end(), got.begin(), got.end());
 }
 
+BOOST_AUTO_TEST_CASE(binary_trace)
+{
+  const char* input = "1.0 1.0\n"
+                      "3.0 3.0\n"
+                      "LOOPAFTER 2\n";
+  std::vector<tmgr::DatedValue> got;
+  trace2vector(input, &got, true);
+
+  std::vector<tmgr::DatedValue> want;
+  trace2vector(input, &want);
+
+  BOOST_CHECK_EQUAL_COLLECTIONS(want.begin(), want.end(), got.begin(), got.end());
+}
+
 static bool init_function()
 {
   // do your own initialization here (and return true on success)
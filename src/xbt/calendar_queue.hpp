@@ -0,0 +1,204 @@
+/* Copyright (c) 2017. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#ifndef SIMGRID_XBT_CALENDAR_QUEUE_HPP
+#define SIMGRID_XBT_CALENDAR_QUEUE_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <xbt/asserts.h>
+
+namespace simgrid {
+namespace xbt {
+
+/** @brief A calendar queue of (key, value) pairs, smallest key first
+ *
+ *  The keys are hashed into a ring of buckets of `width` each, like the days of a calendar: a bucket holds the items
+ *  of the same day of every year. When the items are popped in order and the new keys are not far from the popped
+ *  ones (as with the events of the traces), push() and pop() take O(1) amortized time instead of O(log n) for a heap.
+ *
+ *  The ring is resized when the amount of items doubles or halves, and the width is estimated again from the
+ *  smallest keys when the days become too crowded or too sparse (at most once every size() operations).
+ *
+ *  The items of same key are popped in the order in which they were pushed. This is not the order of
+ *  simgrid::xbt::Heap (nor xbt_heap_t), so replacing a heap by this queue changes the order of the simultaneous events.
+ *  That is why the future event set of the traces only uses it when surf/calendar-queue is set.
+ */
+template <class T> class CalendarQueue {
+  struct Item {
+    double key;
+    unsigned long long order;
+    T value;
+  };
+  /* The items of a bucket, sorted; the ones before `head` were already popped */
+  struct Bucket {
+    std::vector<Item> items;
+    std::size_t head = 0;
+    bool empty() const { return head == items.size(); }
+    std::size_t size() const { return items.size() - head; }
+    const Item& front() const { return items[head]; }
+  };
+  static bool before(const Item& a, const Item& b) { return a.key < b.key || (a.key == b.key && a.order < b.order); }
+
+public:
+  CalendarQueue() : buckets_(min_buckets) {}
+
+  bool empty() const { return size_ == 0; }
+  std::size_t size() const { return size_; }
+
+  /** The smallest key of the queue */
+  double top_key() const { return first().key; }
+  /** The value of smallest key */
+  const T& top() const { return first().value; }
+
+  void push(T value, double key)
+  {
+    size_++;
+    ops_++;
+    if (size_ > 2 * buckets_.size())
+      resize(2 * buckets_.size());
+    std::size_t crowd = insert(Item{key, order_++, std::move(value)});
+    if (day_of(key) < day_) /* earlier than the current day */
+      cursor_valid_ = false;
+    if (crowd > crowded && ops_ > patience_ * size_)
+      resize(buckets_.size());
+  }
+
+  /** Extract the value of smallest key */
+  T pop()
+  {
+    first();
+    Bucket& bucket = buckets_[bucket_];
+    T value        = std::move(bucket.items[bucket.head].value);
+    bucket.head++;
+    if (bucket.empty()) {
+      bucket.items.clear();
+      bucket.head = 0;
+    } else if (bucket.head > crowded && 2 * bucket.head > bucket.items.size()) {
+      bucket.items.erase(bucket.items.begin(), bucket.items.begin() + bucket.head);
+      bucket.head = 0;
+    }
+    size_--;
+    ops_++;
+    if (buckets_.size() > min_buckets && size_ < buckets_.size() / 2)
+      resize(buckets_.size() / 2);
+    else if (sparse_ && ops_ > patience_ * size_)
+      resize(buckets_.size());
+    return value;
+  }
+
+private:
+  static constexpr std::size_t min_buckets = 16;
+  static constexpr std::size_t crowded     = 32;
+
+  long long day_of(double key) const { return static_cast<long long>(std::floor(key / width_)); }
+  std::size_t bucket_of(long long day) const
+  {
+    long long nb = buckets_.size();
+    return ((day % nb) + nb) % nb;
+  }
+
+  /** Insert an item in its bucket, and return the size of that bucket */
+  std::size_t insert(Item item)
+  {
+    Bucket& bucket = buckets_[bucket_of(day_of(item.key))];
+    if (bucket.empty() || not before(item, bucket.items.back()))
+      bucket.items.push_back(std::move(item));
+    else
+      bucket.items.insert(std::upper_bound(bucket.items.begin() + bucket.head, bucket.items.end(), item, before),
+                          std::move(item));
+    return bucket.size();
+  }
+
+  /** Move the cursor to the bucket of the smallest item, and return that item */
+  const Item& first() const
+  {
+    xbt_assert(size_ > 0, "Empty calendar queue");
+    if (cursor_valid_ && not buckets_[bucket_].empty() && day_of(buckets_[bucket_].front().key) == day_)
+      return buckets_[bucket_].front();
+
+    if (cursor_valid_) {
+      /* Walk the days of the current year, starting from the current one */
+      long long day = day_;
+      for (std::size_t n = 0; n < buckets_.size(); n++, day++) {
+        const Bucket& bucket = buckets_[bucket_of(day)];
+        if (not bucket.empty() && day_of(bucket.front().key) == day) {
+          day_    = day;
+          bucket_ = bucket_of(day);
+          return bucket.front();
+        }
+      }
+    }
+
+    /* Nothing this year (or the cursor is lost): search the smallest item directly */
+    sparse_          = cursor_valid_;
+    const Item* best = nullptr;
+    for (std::size_t i = 0; i < buckets_.size(); i++)
+      if (not buckets_[i].empty() && (best == nullptr || before(buckets_[i].front(), *best))) {
+        best    = &buckets_[i].front();
+        bucket_ = i;
+      }
+    day_          = day_of(best->key);
+    cursor_valid_ = true;
+    return *best;
+  }
+
+  /** Change the amount of buckets, and estimate the width again from the smallest keys */
+  void resize(std::size_t nb_buckets)
+  {
+    std::vector<Item> items;
+    items.reserve(size_);
+    for (Bucket& bucket : buckets_)
+      for (std::size_t i = bucket.head; i < bucket.items.size(); i++)
+        items.push_back(std::move(bucket.items[i]));
+
+    if (items.size() > 1) {
+      /* Average gap between the smallest keys, or between all keys if the smallest ones are equal */
+      auto by_key        = [](const Item& a, const Item& b) { return a.key < b.key; };
+      std::size_t sample = std::min<std::size_t>(items.size(), 1024);
+      std::nth_element(items.begin(), items.begin() + (sample - 1), items.end(), by_key);
+      double low   = std::min_element(items.begin(), items.begin() + sample, by_key)->key;
+      double high  = std::max_element(items.begin(), items.end(), by_key)->key;
+      double width = 3.0 * (items[sample - 1].key - low) / (sample - 1);
+      if (width <= 0)
+        width = 3.0 * (high - low) / (items.size() - 1);
+      /* Estimate less often if it does not help */
+      patience_ = (width > 0 && width != width_) ? 1 : 2 * patience_;
+      if (width > 0)
+        width_ = width;
+      /* Keep the days within the range of long long */
+      width_ = std::max(width_, std::max(std::fabs(low), std::fabs(high)) * 1e-15);
+    }
+
+    buckets_.clear();
+    buckets_.resize(nb_buckets);
+    std::sort(items.begin(), items.end(), before);
+    for (Item& item : items)
+      insert(std::move(item));
+    cursor_valid_ = false;
+    sparse_       = false;
+    ops_          = 0;
+  }
+
+  std::vector<Bucket> buckets_;
+  std::size_t size_         = 0;
+  std::size_t ops_          = 0; /* operations since the last resize */
+  std::size_t patience_     = 1; /* the width is estimated again after patience_ * size_ operations */
+  unsigned long long order_ = 0;
+  double width_             = 1.0;
+  /* Cursor: the day (key / width) of the smallest item, and its bucket */
+  mutable long long day_      = 0;
+  mutable std::size_t bucket_ = 0;
+  mutable bool cursor_valid_  = false;
+  mutable bool sparse_        = false; /* whether a whole year was empty */
+};
+}
+}
+
+#endif
@@ -11,6 +11,7 @@
 #include <climits>
 
 #include <functional>
+#include <mutex>
 #include <stdexcept>
 #include <string>
 #include <typeinfo>
@@ -187,6 +188,8 @@ class TypedConfigurationElement : public ConfigurationElement {
 private:
   T content;
   std::function<void(T&)> callback;
+  // Bound handles, called with the new value, or nullptr when going away:
+  std::vector<std::function<void(T const*)>> watchers;
 
 public:
   TypedConfigurationElement(const char* key, const char* desc, T value = T())
@@ -201,7 +204,11 @@ public:
     : ConfigurationElement(key, desc), content(std::move(value)),
       callback(std::move(callback))
   {}
-  ~TypedConfigurationElement()=default;
+  ~TypedConfigurationElement()
+  {
+    for (auto const& watcher : watchers)
+      watcher(nullptr);
+  }
 
   std::string getStringValue() override;
   const char* getTypeName() override;
@@ -213,10 +220,18 @@ public:
       this->old_callback(key.c_str());
     if (this->callback)
       this->callback(this->content);
+    for (auto const& watcher : watchers)
+      watcher(&this->content);
   }
 
   T const& getValue() const { return content; }
 
+  void watch(std::function<void(T const*)> watcher)
+  {
+    watcher(&this->content);
+    watchers.push_back(std::move(watcher));
+  }
+
   void setValue(T value)
   {
     this->content = std::move(value);
@@ -431,6 +446,32 @@ template XBT_PUBLIC(double const&) getConfig<double>(const char* name);
 template XBT_PUBLIC(bool const&) getConfig<bool>(const char* name);
 template XBT_PUBLIC(std::string const&) getConfig<std::string>(const char* name);
 
+// ***** Handle *****
+
+template<class T>
+XBT_PUBLIC(void) bindHandle(Handle<T>& handle)
+{
+  static std::mutex mutex;
+  std::lock_guard<std::mutex> lock(mutex);
+  if (handle.bound_.load(std::memory_order_relaxed))
+    return;
+  xbt_assert(simgrid_config, "Cannot bind the option '%s' before the configuration is initialized", handle.name_);
+  auto& elm = dynamic_cast<TypedConfigurationElement<T>&>((*simgrid_config)[handle.name_]);
+  elm.watch([&handle](T const* value) {
+    if (value)
+      handle.value_ = *value;
+    else
+      handle.bound_.store(false, std::memory_order_release);
+  });
+  XBT_DEBUG("Bound a handle to the option '%s'", handle.name_);
+  handle.bound_.store(true, std::memory_order_release);
+}
+
+template XBT_PUBLIC(void) bindHandle(Handle<int>& handle);
+template XBT_PUBLIC(void) bindHandle(Handle<double>& handle);
+template XBT_PUBLIC(void) bindHandle(Handle<bool>& handle);
+template XBT_PUBLIC(void) bindHandle(Handle<std::string>& handle);
+
 // ***** alias *****
 
 void alias(const char* realname, const char* aliasname)
@@ -910,4 +951,31 @@ XBT_TEST_UNIT("c++flags", test_config_cxx_flags, "C++ flags")
   simgrid_config = temp;
 }
 
+XBT_TEST_UNIT("handles", test_config_handles, "C++ handles")
+{
+  auto temp = simgrid_config;
+  make_set();
+  static simgrid::config::Handle<int> speed("speed");
+  static simgrid::config::Handle<std::string> user("user");
+
+  xbt_test_add("Read through handles");
+  xbt_cfg_set_parse("speed:42 user:bidule");
+  xbt_test_assert(speed.get() == 42, "Check int handle");
+  xbt_test_assert(user.get() == "bidule", "Check string handle");
+
+  xbt_test_add("Change the values after binding");
+  xbt_cfg_set_parse("speed:12 user:toto");
+  xbt_test_assert(speed.get() == 12, "Check int handle after change");
+  xbt_test_assert(user.get() == "toto", "Check string handle after change");
+
+  xbt_test_add("Bind again to a new config set");
+  xbt_cfg_free(&simgrid_config);
+  make_set();
+  xbt_test_assert(speed.get() == 0, "Check int handle in the new set");
+  xbt_test_assert(user.get() == "", "Check string handle in the new set");
+
+  xbt_cfg_free(&simgrid_config);
+  simgrid_config = temp;
+}
+
 #endif                          /* SIMGRID_TEST */
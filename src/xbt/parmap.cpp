@@ -5,6 +5,10 @@
 
 #include <atomic>
 #include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <new>
+#include <vector>
 
 #include "src/internal_config.h"
 #if HAVE_UNISTD_H
@@ -58,6 +62,33 @@ static void xbt_parmap_busy_worker_signal(xbt_parmap_t parmap);
 static void xbt_parmap_busy_master_signal(xbt_parmap_t parmap);
 static void xbt_parmap_busy_worker_wait(xbt_parmap_t parmap, unsigned round);
 
+static void xbt_parmap_steal_master_wait(xbt_parmap_t parmap);
+static void xbt_parmap_steal_worker_signal(xbt_parmap_t parmap);
+static void xbt_parmap_steal_master_signal(xbt_parmap_t parmap);
+static void xbt_parmap_steal_worker_wait(xbt_parmap_t parmap, unsigned round);
+static void* xbt_parmap_steal_next(xbt_parmap_t parmap);
+
+/** Amount of times that the work stealing threads check for a change before sleeping */
+#define XBT_PARMAP_SPIN_COUNT 4096
+
+/** Index of the current thread in its parmap (0 for the controller) */
+static XBT_THREAD_LOCAL unsigned xbt_parmap_worker_id = 0;
+
+/**
+ * \brief Range of the data that a worker still has to process, in work stealing mode
+ *
+ * The owner takes its elements from the front, while idle workers steal the back half of the range. Both bounds are
+ * packed in a single word so that every change is a single compare-and-swap. Each range has its own cache line.
+ */
+typedef struct alignas(64) s_xbt_parmap_deque {
+  std::atomic<std::uint64_t> range; /**< front index in the high half, end index in the low half */
+} s_xbt_parmap_deque_t;
+
+static inline std::uint64_t xbt_parmap_range(unsigned front, unsigned end)
+{
+  return static_cast<std::uint64_t>(front) << 32 | end;
+}
+
 /**
  * \brief Parallel map structure
  */
@@ -84,6 +115,11 @@ typedef struct s_xbt_parmap {
   void (*worker_signal_f)(xbt_parmap_t);  /**< signal the master that a worker has done the work */
   void (*master_signal_f)(xbt_parmap_t);  /**< wakes the workers threads to process tasks */
   void (*worker_wait_f)(xbt_parmap_t, unsigned); /**< waits for more work */
+
+  /* work stealing only */
+  s_xbt_parmap_deque_t* deques;   /**< data that each worker still has to process */
+  void* deques_memory;            /**< allocated memory holding the deques */
+  std::atomic<unsigned> sleeping; /**< number of threads blocked on a futex */
 } s_xbt_parmap_t;
 
 /**
@@ -96,6 +132,49 @@ typedef struct s_xbt_parmap_thread_data{
 
 typedef s_xbt_parmap_thread_data_t *xbt_parmap_thread_data_t;
 
+#if HAVE_PTHREAD_SETAFFINITY
+/**
+ * \brief Lists the cores on which the workers are bound, one NUMA node after the other.
+ *
+ * The successive workers are thus on the same node as much as possible, and the work stealing threads, which first
+ * try to steal from the next workers, mostly take data from their own node.
+ */
+static std::vector<int> xbt_parmap_cores()
+{
+  std::vector<int> cores;
+  std::vector<bool> listed(xbt_os_get_numcores(), false);
+  for (int node = 0;; node++) {
+    char path[64];
+    snprintf(path, sizeof path, "/sys/devices/system/node/node%d/cpulist", node);
+    FILE* file = fopen(path, "r");
+    if (file == nullptr)
+      break;
+    int first;
+    while (fscanf(file, "%d", &first) == 1) { // format: 0-3,8-11
+      int last = first;
+      int c    = fgetc(file);
+      if (c == '-') {
+        if (fscanf(file, "%d", &last) != 1)
+          break;
+        c = fgetc(file);
+      }
+      for (int cpu = first; cpu <= last; cpu++)
+        if (cpu < static_cast<int>(listed.size()) && not listed[cpu]) {
+          listed[cpu] = true;
+          cores.push_back(cpu);
+        }
+      if (c != ',')
+        break;
+    }
+    fclose(file);
+  }
+  for (unsigned cpu = 0; cpu < listed.size(); cpu++) // No NUMA information, or some cores are not listed
+    if (not listed[cpu])
+      cores.push_back(cpu);
+  return cores;
+}
+#endif
+
 /**
  * \brief Creates a parallel map object
  * \param num_workers number of worker threads to create
@@ -112,12 +191,21 @@ xbt_parmap_t xbt_parmap_new(unsigned int num_workers, e_xbt_parmap_mode_t mode)
 
   parmap->num_workers = num_workers;
   parmap->status = XBT_PARMAP_WORK;
+  /* new[] does not have to honor the alignment of the deques before C++17: align them by hand */
+  const size_t align    = alignof(s_xbt_parmap_deque_t);
+  parmap->deques_memory = xbt_malloc(num_workers * sizeof(s_xbt_parmap_deque_t) + align - 1);
+  uintptr_t deques      = (reinterpret_cast<uintptr_t>(parmap->deques_memory) + align - 1) & ~(align - 1);
+  parmap->deques        = reinterpret_cast<s_xbt_parmap_deque_t*>(deques);
+  for (unsigned i = 0; i < num_workers; i++)
+    new (&parmap->deques[i]) s_xbt_parmap_deque_t();
+  parmap->sleeping    = 0;
   xbt_parmap_set_mode(parmap, mode);
 
   /* Create the pool of worker threads */
   parmap->workers[0] = nullptr;
 #if HAVE_PTHREAD_SETAFFINITY
-  int core_bind = 0;
+  std::vector<int> cores = xbt_parmap_cores();
+  unsigned core_bind     = 0;
 #endif
   for (unsigned int i = 1; i < num_workers; i++) {
     xbt_parmap_thread_data_t data = xbt_new0(s_xbt_parmap_thread_data_t, 1);
@@ -125,8 +213,8 @@ xbt_parmap_t xbt_parmap_new(unsigned int num_workers, e_xbt_parmap_mode_t mode)
     data->worker_id = i;
     parmap->workers[i] = xbt_os_thread_create(nullptr, xbt_parmap_worker_main, data, nullptr);
 #if HAVE_PTHREAD_SETAFFINITY
-    xbt_os_thread_bind(parmap->workers[i], core_bind);
-    if (core_bind != xbt_os_get_numcores() - 1)
+    xbt_os_thread_bind(parmap->workers[i], cores[core_bind]);
+    if (core_bind != cores.size() - 1)
       core_bind++;
     else
       core_bind = 0;
@@ -158,6 +246,7 @@ void xbt_parmap_destroy(xbt_parmap_t parmap)
   xbt_os_mutex_destroy(parmap->done_mutex);
 
   xbt_free(parmap->workers);
+  xbt_free(parmap->deques_memory); // the deques are trivially destructible
   delete parmap;
 }
 
@@ -210,6 +299,17 @@ static void xbt_parmap_set_mode(xbt_parmap_t parmap, e_xbt_parmap_mode_t mode)
       parmap->master_signal_f = &xbt_parmap_busy_master_signal;
       parmap->worker_wait_f   = &xbt_parmap_busy_worker_wait;
 
+      xbt_os_cond_destroy(parmap->ready_cond);
+      xbt_os_mutex_destroy(parmap->ready_mutex);
+      xbt_os_cond_destroy(parmap->done_cond);
+      xbt_os_mutex_destroy(parmap->done_mutex);
+      break;
+    case XBT_PARMAP_WORK_STEALING:
+      parmap->master_wait_f   = &xbt_parmap_steal_master_wait;
+      parmap->worker_signal_f = &xbt_parmap_steal_worker_signal;
+      parmap->master_signal_f = &xbt_parmap_steal_master_signal;
+      parmap->worker_wait_f   = &xbt_parmap_steal_worker_wait;
+
       xbt_os_cond_destroy(parmap->ready_cond);
       xbt_os_mutex_destroy(parmap->ready_mutex);
       xbt_os_cond_destroy(parmap->done_cond);
@@ -235,6 +335,12 @@ void xbt_parmap_apply(xbt_parmap_t parmap, void_f_pvoid_t fun, xbt_dynar_t data)
   parmap->fun = fun;
   parmap->data = data;
   parmap->index = 0;
+  if (parmap->mode == XBT_PARMAP_WORK_STEALING) { // Give the same share of the data to each worker
+    std::uint64_t length = xbt_dynar_length(data);
+    for (unsigned i = 0; i < parmap->num_workers; i++)
+      parmap->deques[i].range = xbt_parmap_range(length * i / parmap->num_workers,
+                                                 length * (i + 1) / parmap->num_workers);
+  }
   parmap->master_signal_f(parmap); // maestro runs futex_wait to wake all the minions (the working threads)
   xbt_parmap_work(parmap);         // maestro works with its minions
   parmap->master_wait_f(parmap);   // When there is no more work to do, then maestro waits for the last minion to stop
@@ -250,6 +356,8 @@ void xbt_parmap_apply(xbt_parmap_t parmap, void_f_pvoid_t fun, xbt_dynar_t data)
  */
 void* xbt_parmap_next(xbt_parmap_t parmap)
 {
+  if (parmap->mode == XBT_PARMAP_WORK_STEALING)
+    return xbt_parmap_steal_next(parmap);
   unsigned int index = parmap->index++;
   if (index < xbt_dynar_length(parmap->data)) {
     return xbt_dynar_get_as(parmap->data, index, void*);
@@ -259,6 +367,12 @@ void* xbt_parmap_next(xbt_parmap_t parmap)
 
 static void xbt_parmap_work(xbt_parmap_t parmap)
 {
+  if (parmap->mode == XBT_PARMAP_WORK_STEALING) {
+    void* elm;
+    while ((elm = xbt_parmap_steal_next(parmap)) != nullptr)
+      parmap->fun(elm);
+    return;
+  }
   unsigned int index = parmap->index++;
   while (index < xbt_dynar_length(parmap->data)){
     parmap->fun(xbt_dynar_get_as(parmap->data, index, void*));
@@ -277,6 +391,7 @@ static void *xbt_parmap_worker_main(void *arg)
   unsigned round = 0;
   smx_context_t context = SIMIX_context_new(std::function<void()>(), nullptr, nullptr);
   SIMIX_context_set_current(context);
+  xbt_parmap_worker_id = data->worker_id;
 
   XBT_DEBUG("New worker thread created");
 
@@ -506,3 +621,132 @@ static void xbt_parmap_busy_worker_wait(xbt_parmap_t parmap, unsigned round)
     xbt_os_thread_yield();
   }
 }
+
+/**
+ * \brief Returns the next element to process in work stealing mode.
+ *
+ * The current worker first takes the front element of its own range. Once it is empty, it steals the back half of
+ * the range of the first worker that still has some data, starting with its neighbors.
+ *
+ * \param parmap a parmap
+ * \return the next element to process, or nullptr if all the ranges are empty
+ */
+static void* xbt_parmap_steal_next(xbt_parmap_t parmap)
+{
+  unsigned id                      = xbt_parmap_worker_id;
+  std::atomic<std::uint64_t>& mine = parmap->deques[id].range;
+
+  std::uint64_t range = mine.load();
+  while ((range >> 32) < (range & 0xffffffff)) {
+    unsigned front = range >> 32;
+    if (mine.compare_exchange_weak(range, range + (static_cast<std::uint64_t>(1) << 32)))
+      return xbt_dynar_get_as(parmap->data, front, void*);
+  }
+
+  for (unsigned i = 1; i < parmap->num_workers; i++) {
+    std::atomic<std::uint64_t>& theirs = parmap->deques[(id + i) % parmap->num_workers].range;
+    range                              = theirs.load();
+    while ((range >> 32) < (range & 0xffffffff)) {
+      unsigned front = range >> 32;
+      unsigned end   = range & 0xffffffff;
+      unsigned half  = front + (end - front) / 2;
+      if (theirs.compare_exchange_weak(range, xbt_parmap_range(front, half))) {
+        /* Our range is empty, so nobody else modifies it */
+        mine.store(xbt_parmap_range(half + 1, end));
+        return xbt_dynar_get_as(parmap->data, half, void*);
+      }
+    }
+  }
+  return nullptr;
+}
+
+/**
+ * \brief Waits until the given counter of the parmap differs from the given value.
+ *
+ * The thread first spins for a while, as the rounds of the simulation are often very short. It then blocks on a
+ * futex (or yields its core when they are not available).
+ */
+static void xbt_parmap_steal_wait_change(xbt_parmap_t parmap, unsigned* counter, unsigned value)
+{
+  for (int i = 0; i < XBT_PARMAP_SPIN_COUNT; i++)
+    if (__atomic_load_n(counter, __ATOMIC_ACQUIRE) != value)
+      return;
+  while (__atomic_load_n(counter, __ATOMIC_ACQUIRE) == value) {
+#if HAVE_FUTEX_H
+    parmap->sleeping++;
+    futex_wait(counter, value);
+    parmap->sleeping--;
+#else
+    xbt_os_thread_yield();
+#endif
+  }
+}
+
+/**
+ * \brief Starts the parmap: waits for all workers to be ready and returns.
+ *
+ * This function is called by the controller thread.
+ *
+ * \param parmap a parmap
+ */
+static void xbt_parmap_steal_master_wait(xbt_parmap_t parmap)
+{
+  unsigned count = __atomic_load_n(&parmap->thread_counter, __ATOMIC_ACQUIRE);
+  while (count < parmap->num_workers) {
+    xbt_parmap_steal_wait_change(parmap, &parmap->thread_counter, count);
+    count = __atomic_load_n(&parmap->thread_counter, __ATOMIC_ACQUIRE);
+  }
+}
+
+/**
+ * \brief Ends the parmap: wakes the controller thread when all workers terminate.
+ *
+ * This function is called by all worker threads when they end (not including the controller).
+ *
+ * \param parmap a parmap
+ */
+static void xbt_parmap_steal_worker_signal(xbt_parmap_t parmap)
+{
+#if HAVE_FUTEX_H
+  unsigned count = __sync_add_and_fetch(&parmap->thread_counter, 1);
+  if (count == parmap->num_workers && parmap->sleeping > 0)
+    futex_wake(&parmap->thread_counter, INT_MAX);
+#else
+  __sync_add_and_fetch(&parmap->thread_counter, 1);
+#endif
+}
+
+/**
+ * \brief Wakes all workers and waits for them to finish the tasks.
+ *
+ * This function is called by the controller thread.
+ *
+ * \param parmap a parmap
+ */
+static void xbt_parmap_steal_master_signal(xbt_parmap_t parmap)
+{
+  parmap->thread_counter = 1;
+  __sync_add_and_fetch(&parmap->work, 1);
+#if HAVE_FUTEX_H
+  /* Only the workers that stopped spinning need a system call */
+  if (parmap->sleeping > 0)
+    futex_wake(&parmap->work, INT_MAX);
+#endif
+}
+
+/**
+ * \brief Waits for some work to process.
+ *
+ * This function is called by each worker thread (not including the controller) when it has no more work to do.
+ *
+ * \param parmap a parmap
+ * \param round  the expected round number
+ */
+static void xbt_parmap_steal_worker_wait(xbt_parmap_t parmap, unsigned round)
+{
+  unsigned work = __atomic_load_n(&parmap->work, __ATOMIC_ACQUIRE);
+  while (work != round) {
+    xbt_parmap_steal_wait_change(parmap, &parmap->work, work);
+    work = __atomic_load_n(&parmap->work, __ATOMIC_ACQUIRE);
+  }
+}
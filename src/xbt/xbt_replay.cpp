@@ -4,11 +4,29 @@
 /* This program is free software; you can redistribute it and/or modify it
  * under the terms of the license (GNU LGPL) which comes with this package. */
 
+#include "simgrid/modelchecker.h"
+#include "src/internal_config.h"
 #include "xbt/ex.hpp"
 #include "xbt/log.h"
 #include "xbt/replay.hpp"
 
-#include <boost/algorithm/string.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#if HAVE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY(replay,xbt,"Replay trace reader");
 
@@ -18,108 +36,794 @@ namespace xbt {
 std::ifstream* action_fs = nullptr;
 std::unordered_map<std::string, action_fun> action_funs;
 
-static void read_and_trim_line(std::ifstream* fs, std::string* line)
+/* The binary traces are made of:
+ *  - a header: the magic string, and the format version on one byte;
+ *  - the chunks: sequences of actions of a given actor. Each action is its opcode, its number of arguments and the
+ *    arguments, all of them varints. The two lower bits of an argument tell how to read it: an integer (zigzag-encoded
+ *    in the upper bits), a double (in the 8 bytes that follow), a string (its length in the upper bits, then its
+ *    characters), or a decimal number (its digits as a zigzag-encoded integer in the upper bits, then the number of
+ *    digits after the point on one byte);
+ *  - the footer: the opcode table (the action names), the actor names and the index of the chunks (actor, offset,
+ *    length), each table being preceded by its size;
+ *  - the offset of the footer on 8 bytes (little endian), followed by the magic string again.
+ */
+static const char binary_replay_magic[8]       = "SGTIBIN";
+static const unsigned char binary_replay_version = 2; // version 1 had no decimal numbers
+static const size_t binary_replay_chunk_size     = 1 << 16;
+
+enum { binary_arg_integer = 0, binary_arg_double = 1, binary_arg_string = 2, binary_arg_decimal = 3 };
+
+/* The decimal numbers have at most 22 digits after the point and 2^53 as digits, so that dividing them by the exact
+ * power of ten gives the same double as strtod() */
+static const unsigned binary_max_decimals      = 22;
+static const int64_t binary_max_decimal_digits = INT64_C(1) << 53;
+static const double powers_of_ten[binary_max_decimals + 1] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                                              1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                                              1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+static void put_varint(std::string& out, uint64_t value)
+{
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+static uint64_t zigzag(int64_t value)
+{
+  return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+static int64_t unzigzag(uint64_t value)
+{
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+static void put_string(std::string& out, const std::string& str)
+{
+  put_varint(out, str.size());
+  out.append(str);
+}
+
+static void put_uint64(std::string& out, uint64_t value)
+{
+  for (int i = 0; i < 8; i++)
+    out.push_back(static_cast<char>(value >> (8 * i)));
+}
+
+static uint64_t get_uint64(const char* p)
 {
+  uint64_t value = 0;
+  for (int i = 0; i < 8; i++)
+    value |= static_cast<uint64_t>(static_cast<unsigned char>(p[i])) << (8 * i);
+  return value;
+}
+
+/* Reads a varint at @a p, without going past @a end. The binary traces come from files: all their checks must remain
+ * when built with NDEBUG. */
+static uint64_t get_varint(const char*& p, const char* end)
+{
+  uint64_t value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (p >= end)
+      xbt_die("Truncated binary trace");
+    unsigned char byte = *p++;
+    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (byte < 0x80)
+      return value;
+  }
+  xbt_die("Corrupted binary trace: varint longer than 64 bits");
+}
+
+static std::string get_string(const char*& p, const char* end)
+{
+  uint64_t length = get_varint(p, end);
+  if (length > static_cast<uint64_t>(end - p))
+    xbt_die("Truncated binary trace");
+  std::string str(p, length);
+  p += length;
+  return str;
+}
+
+/* Whether a token is an integer that can be written back exactly as it is: no sign for zero, no leading zeros */
+static bool parse_integer(const char* token, int64_t* value)
+{
+  const char* c = token + (*token == '-' ? 1 : 0);
+  size_t digits = strspn(c, "0123456789");
+  if (digits == 0 || digits > 18 || c[digits] != '\0' || (c[0] == '0' && (digits > 1 || c != token)))
+    return false;
+  *value = strtoll(token, nullptr, 10);
+  return true;
+}
+
+/* Whether a token is a plain decimal number that can be written back without exponent: atoi() must still read the
+ * same integer part in it, and strtod() the same value */
+static bool parse_real(const char* token, double* value)
+{
+  const char* c = token + (*token == '-' ? 1 : 0);
+  size_t digits = strspn(c, "0123456789");
+  if (c[digits] == '.')
+    digits += 1 + strspn(c + digits + 1, "0123456789");
+  if (digits == 0 || c[digits] != '\0')
+    return false;
+  *value = strtod(token, nullptr);
+  return std::fabs(*value) < 1e15 && (*value == 0 || std::fabs(*value) >= 1e-4);
+}
+
+/* Whether a token accepted by parse_real() can be stored as a decimal number, and then written back as it is */
+static bool parse_decimal(const char* token, int64_t* digits, unsigned* decimals)
+{
+  const char* c = token + (*token == '-' ? 1 : 0);
+  const char* point = strchr(c, '.');
+  if (point == nullptr || strlen(point + 1) > binary_max_decimals || strlen(c) > 18)
+    return false;
+  int64_t value = 0;
+  for (; *c != '\0'; c++)
+    if (*c != '.')
+      value = value * 10 + (*c - '0');
+  if (value > binary_max_decimal_digits)
+    return false;
+  *digits   = *token == '-' ? -value : value;
+  *decimals = strlen(point + 1);
+  return true;
+}
+
+/* Writes @a digits with a point before the @a decimals last ones, followed by a '\0' */
+static void format_decimal(char* out, int64_t digits, unsigned decimals)
+{
+  uint64_t magnitude = digits < 0 ? -static_cast<uint64_t>(digits) : digits;
+  char buffer[48];
+  unsigned n = 0;
   do {
-    std::getline(*fs, *line);
-    boost::trim(*line);
-  } while (not fs->eof() && (line->length() == 0 || line->front() == '#'));
-  XBT_DEBUG("got from trace: %s", line->c_str());
+    if (n == decimals && n > 0)
+      buffer[n++] = '.';
+    buffer[n++] = '0' + magnitude % 10;
+    magnitude /= 10;
+  } while (magnitude > 0 || n <= decimals);
+  if (digits < 0)
+    *out++ = '-';
+  while (n > 0)
+    *out++ = buffer[--n];
+  *out = '\0';
 }
 
+/** @brief A trace file, mapped read-only in memory
+ *
+ * Each action is copied out of the mapping into a small block of memory where its separators are replaced by '\0'.
+ * The mapping is never written, so the pages of the lines that were consumed can be given back to the system. The
+ * tokens of an action remain valid until the next call to next().
+ *
+ * Binary traces are decoded chunk by chunk instead, only the chunks of the given actor if any, into the same block.
+ * Without mmap(), the file is read in memory at once.
+ */
 class ReplayReader {
-  std::ifstream* fs;
-  std::string line;
+  struct Chunk {
+    unsigned actor;
+    const char* begin;
+    const char* end;
+  };
+
+  char* data_         = nullptr;
+  size_t size_        = 0;
+  bool mapped_        = false;
+  const char* pos_    = nullptr;
+  const char* end_    = nullptr;
+  char* released_     = nullptr; // start of the part of the mapping that was not given back yet
+
+  bool binary_ = false;
+  std::vector<std::string> opcode_names_;
+  std::vector<std::string> actor_names_;
+  std::vector<Chunk> chunks_;
+  size_t next_chunk_   = 0;
+  const char* cursor_  = nullptr;
+  const char* chunk_end_ = nullptr;
+  unsigned chunk_actor_  = 0;
+  std::vector<std::unique_ptr<char[]>> blocks_; // the decoded tokens
+  size_t block_used_ = 0;
+
+  void load(std::istream& stream);
+  void release();
+  void load_binary(const char* actor);
+  bool next_binary(std::vector<const char*>& action, std::vector<double>* numbers);
+  char* allocate(size_t size);
 
 public:
-  explicit ReplayReader(const char* filename)
-  {
-    XBT_VERB("Prepare to replay file '%s'", filename);
-    fs = new std::ifstream(filename, std::ifstream::in);
-    xbt_assert(fs->is_open(), "Cannot read replay file '%s'", filename);
+  explicit ReplayReader(const char* filename, const char* actor = nullptr);
+  explicit ReplayReader(std::istream& stream);
+  ~ReplayReader();
+  /** Fills @a action with the null-terminated tokens of the next action, returns false at the end of the trace
+   *
+   * If @a numbers is given, it is filled with the values of the tokens of binary traces that are numbers, and NAN for
+   * the other tokens. It is left empty for textual traces. */
+  bool next(std::vector<const char*>& action, std::vector<double>* numbers = nullptr);
+};
+
+ReplayReader::ReplayReader(const char* filename, const char* actor)
+{
+  XBT_VERB("Prepare to replay file '%s'", filename);
+#if HAVE_MMAP
+  int fd = open(filename, O_RDONLY);
+  if (fd < 0)
+    xbt_die("Cannot read replay file '%s': %s", filename, strerror(errno));
+  struct stat st;
+  if (fstat(fd, &st) != 0)
+    xbt_die("Cannot stat replay file '%s': %s", filename, strerror(errno));
+  size_ = st.st_size;
+  if (size_ > 0) {
+    void* map = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED)
+      xbt_die("Cannot map replay file '%s': %s", filename, strerror(errno));
+    madvise(map, size_, MADV_SEQUENTIAL); // aggressive read-ahead
+    data_   = static_cast<char*>(map);
+    mapped_ = true;
   }
-  ~ReplayReader()
-  {
-    delete fs;
+  close(fd);
+  pos_      = data_;
+  end_      = data_ + size_;
+  released_ = data_;
+#else
+  std::ifstream stream(filename, std::ifstream::binary);
+  if (not stream.is_open())
+    xbt_die("Cannot read replay file '%s'", filename);
+  load(stream);
+#endif
+  load_binary(actor);
+}
+
+ReplayReader::ReplayReader(std::istream& stream)
+{
+  load(stream);
+  load_binary(nullptr);
+}
+
+ReplayReader::~ReplayReader()
+{
+#if HAVE_MMAP
+  if (mapped_) {
+    munmap(data_, size_);
+    return;
   }
-  bool get(ReplayAction* action);
-};
+#endif
+  delete[] data_;
+}
+
+/* Read the whole content of @a stream in memory */
+void ReplayReader::load(std::istream& stream)
+{
+  std::string content{std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()};
+  size_ = content.size();
+  data_ = new char[size_];
+  memcpy(data_, content.data(), size_);
+  pos_ = data_;
+  end_ = data_ + size_;
+}
+
+/* Give the pages of the lines that were already replayed back to the system, by chunks of a few megabytes */
+void ReplayReader::release()
+{
+#if HAVE_MMAP
+  const size_t chunk = 1 << 24;
+  if (static_cast<size_t>(pos_ - released_) < 2 * chunk)
+    return;
+  size_t length = (pos_ - released_) / chunk * chunk - chunk;
+  madvise(released_, length, MADV_DONTNEED);
+  released_ += length;
+#endif
+}
 
-bool ReplayReader::get(ReplayAction* action)
+/* Read the tables of a binary trace, keeping only the chunks of @a actor if given */
+void ReplayReader::load_binary(const char* actor)
 {
-  read_and_trim_line(fs, &line);
+  const size_t trailer_size = 8 + sizeof binary_replay_magic;
+  if (size_ < sizeof binary_replay_magic + 1 + trailer_size ||
+      memcmp(data_, binary_replay_magic, sizeof binary_replay_magic) != 0)
+    return;
+  if (data_[sizeof binary_replay_magic] < 1 || data_[sizeof binary_replay_magic] > binary_replay_version)
+    xbt_die("Unsupported version %d of binary trace (expected at most %d)", data_[sizeof binary_replay_magic],
+            binary_replay_version);
+  const char* end = data_ + size_ - trailer_size;
+  if (memcmp(end + 8, binary_replay_magic, sizeof binary_replay_magic) != 0)
+    xbt_die("Truncated binary trace");
+  uint64_t footer = get_uint64(end);
+  if (footer < sizeof binary_replay_magic + 1 || footer > static_cast<uint64_t>(end - data_))
+    xbt_die("Corrupted binary trace: footer at offset %llu", (unsigned long long)footer);
 
-  boost::split(*action, line, boost::is_any_of(" \t"), boost::token_compress_on);
-  return not fs->eof();
+  const char* p = data_ + footer;
+  uint64_t count = get_varint(p, end);
+  for (uint64_t i = 0; i < count; i++)
+    opcode_names_.push_back(get_string(p, end));
+  count = get_varint(p, end);
+  for (uint64_t i = 0; i < count; i++)
+    actor_names_.push_back(get_string(p, end));
+  count = get_varint(p, end);
+  for (uint64_t i = 0; i < count; i++) {
+    unsigned chunk_actor = get_varint(p, end);
+    uint64_t offset      = get_varint(p, end);
+    uint64_t length      = get_varint(p, end);
+    if (chunk_actor >= actor_names_.size() || offset < sizeof binary_replay_magic + 1 || offset > footer ||
+        length > footer - offset)
+      xbt_die("Corrupted binary trace: chunk %llu of actor %u at offset %llu, length %llu", (unsigned long long)i,
+              chunk_actor, (unsigned long long)offset, (unsigned long long)length);
+    if (actor == nullptr || actor_names_[chunk_actor] == actor)
+      chunks_.push_back({chunk_actor, data_ + offset, data_ + offset + length});
+  }
+  XBT_DEBUG("Binary trace with %zu opcodes, %zu actors, %zu chunks to read", opcode_names_.size(), actor_names_.size(),
+            chunks_.size());
+  binary_ = true;
+}
+
+/* Room for the tokens being decoded, in blocks of a megabyte */
+char* ReplayReader::allocate(size_t size)
+{
+  const size_t block_size = 1 << 20;
+  if (blocks_.empty() || block_used_ + size > block_size) {
+    blocks_.emplace_back(new char[std::max(size, block_size)]);
+    block_used_ = 0;
+  }
+  char* res = blocks_.back().get() + block_used_;
+  block_used_ += size;
+  return res;
 }
 
-static ReplayAction* get_action(char* name)
+bool ReplayReader::next_binary(std::vector<const char*>& action, std::vector<double>* numbers)
 {
-  ReplayAction* action;
+  while (cursor_ == chunk_end_) {
+    if (next_chunk_ == chunks_.size())
+      return false;
+    cursor_      = chunks_[next_chunk_].begin;
+    chunk_end_   = chunks_[next_chunk_].end;
+    chunk_actor_ = chunks_[next_chunk_].actor;
+    next_chunk_++;
+  }
 
-  std::queue<ReplayAction*>* myqueue = nullptr;
-  if (action_queues.find(std::string(name)) != action_queues.end())
-    myqueue = action_queues.at(std::string(name));
-  if (myqueue == nullptr || myqueue->empty()) { // Nothing stored for me. Read the file further
-    // Read lines until I reach something for me (which breaks in loop body) or end of file reached
-    while (true) {
-      std::string action_line;
-      read_and_trim_line(action_fs, &action_line);
-      if (action_fs->eof())
+  uint64_t opcode = get_varint(cursor_, chunk_end_);
+  if (opcode >= opcode_names_.size())
+    xbt_die("Corrupted binary trace: opcode %llu out of %zu", (unsigned long long)opcode, opcode_names_.size());
+  action.push_back(actor_names_[chunk_actor_].c_str());
+  action.push_back(opcode_names_[opcode].c_str());
+  if (numbers)
+    numbers->assign(2, NAN);
+  uint64_t argc = get_varint(cursor_, chunk_end_);
+  for (uint64_t i = 0; i < argc; i++) {
+    uint64_t header = get_varint(cursor_, chunk_end_);
+    char* token;
+    double number = NAN;
+    switch (header & 3) {
+      case binary_arg_integer: {
+        int64_t value = unzigzag(header >> 2);
+        number        = static_cast<double>(value);
+        token         = allocate(21);
+        format_decimal(token, value, 0);
         break;
-      /* we cannot split in place here because we parse&store several lines for the colleagues... */
-      action = new ReplayAction();
-      boost::split(*action, action_line, boost::is_any_of(" \t"), boost::token_compress_on);
-
-      // if it's for me, I'm done
-      std::string evtname = action->front();
-      if (evtname.compare(name) == 0) {
-        return action;
+      }
+      case binary_arg_decimal: {
+        if (cursor_ == chunk_end_)
+          xbt_die("Truncated binary trace");
+        int64_t digits    = unzigzag(header >> 2);
+        unsigned decimals = static_cast<unsigned char>(*cursor_++);
+        if (decimals > binary_max_decimals || digits > binary_max_decimal_digits || -digits > binary_max_decimal_digits)
+          xbt_die("Corrupted binary trace: decimal number %lld with %u decimals", (long long)digits, decimals);
+        number = static_cast<double>(digits) / powers_of_ten[decimals];
+        token  = allocate(48);
+        format_decimal(token, digits, decimals);
+        break;
+      }
+      case binary_arg_double: {
+        if (chunk_end_ - cursor_ < 8)
+          xbt_die("Truncated binary trace");
+        uint64_t bits = get_uint64(cursor_);
+        cursor_ += 8;
+        double value;
+        memcpy(&value, &bits, sizeof value);
+        number = value;
+        token  = allocate(32);
+        snprintf(token, 32, "%.15g", value);
+        if (strtod(token, nullptr) != value) // not enough digits to read the same value back
+          snprintf(token, 32, "%.17g", value);
+        break;
+      }
+      case binary_arg_string: {
+        uint64_t length = header >> 2;
+        if (length > static_cast<uint64_t>(chunk_end_ - cursor_))
+          xbt_die("Truncated binary trace");
+        token = allocate(length + 1);
+        memcpy(token, cursor_, length);
+        token[length] = '\0';
+        cursor_ += length;
+        break;
+      }
+      default:
+        xbt_die("Corrupted binary trace");
+    }
+    action.push_back(token);
+    if (numbers)
+      numbers->push_back(number);
+  }
+  action.push_back(nullptr);
+  return true;
+}
+
+bool ReplayReader::next(std::vector<const char*>& action, std::vector<double>* numbers)
+{
+  action.clear();
+  if (numbers)
+    numbers->clear();
+  if (blocks_.size() > 1) // The tokens of the previous action are not needed anymore: keep one block for the next ones
+    blocks_.erase(blocks_.begin(), blocks_.end() - 1);
+  block_used_ = 0;
+  if (binary_)
+    return next_binary(action, numbers);
+  if (mapped_)
+    release();
+
+  while (pos_ < end_) {
+    const char* start = pos_;
+    const char* stop  = static_cast<const char*>(memchr(pos_, '\n', end_ - pos_));
+    if (stop == nullptr) // The last line has no newline
+      stop = end_;
+    pos_ = stop == end_ ? end_ : stop + 1;
+
+    while (start < stop && (*start == ' ' || *start == '\t' || *start == '\r'))
+      start++;
+    if (start == stop || *start == '#')
+      continue;
+    char* line = allocate(stop - start + 1);
+    memcpy(line, start, stop - start);
+    char* line_end = line + (stop - start);
+    *line_end      = '\0';
+    char* c        = line;
+    while (c < line_end) {
+      action.push_back(c);
+      while (c < line_end && *c != ' ' && *c != '\t' && *c != '\r')
+        c++;
+      while (c < line_end && (*c == ' ' || *c == '\t' || *c == '\r'))
+        *c++ = '\0';
+    }
+    XBT_DEBUG("got from trace: %s (%zu tokens)", action.front(), action.size());
+    action.push_back(nullptr);
+    return true;
+  }
+  return false;
+}
+
+ReplayBinaryWriter::ReplayBinaryWriter(const char* filename) : file_(fopen(filename, "wb"))
+{
+  xbt_assert(file_ != nullptr, "Cannot write binary trace '%s': %s", filename, strerror(errno));
+  fwrite(binary_replay_magic, sizeof binary_replay_magic, 1, file_);
+  fputc(binary_replay_version, file_);
+  offset_ = sizeof binary_replay_magic + 1;
+}
+
+ReplayBinaryWriter::~ReplayBinaryWriter()
+{
+  for (unsigned actor = 0; actor < pending_.size(); actor++)
+    flush(actor);
+
+  std::string footer;
+  put_varint(footer, opcode_names_.size());
+  for (auto const& name : opcode_names_)
+    put_string(footer, name);
+  put_varint(footer, actor_names_.size());
+  for (auto const& name : actor_names_)
+    put_string(footer, name);
+  put_varint(footer, chunks_.size());
+  for (auto const& chunk : chunks_) {
+    put_varint(footer, chunk.actor);
+    put_varint(footer, chunk.offset);
+    put_varint(footer, chunk.length);
+  }
+  put_uint64(footer, offset_);
+  footer.append(binary_replay_magic, sizeof binary_replay_magic);
+  fwrite(footer.data(), footer.size(), 1, file_);
+  fclose(file_);
+}
+
+void ReplayBinaryWriter::flush(unsigned actor)
+{
+  std::string& actions = pending_[actor];
+  if (actions.empty())
+    return;
+  fwrite(actions.data(), actions.size(), 1, file_);
+  chunks_.push_back({actor, offset_, actions.size()});
+  offset_ += actions.size();
+  actions.clear();
+}
+
+void ReplayBinaryWriter::write(const char* const* action)
+{
+  xbt_assert(action[0] != nullptr && action[1] != nullptr, "Cannot write an action without name in a binary trace");
+  auto actor = actors_.find(action[0]);
+  if (actor == actors_.end()) {
+    actor = actors_.insert({action[0], actor_names_.size()}).first;
+    actor_names_.push_back(action[0]);
+    pending_.emplace_back();
+  }
+  auto opcode = opcodes_.find(action[1]);
+  if (opcode == opcodes_.end()) {
+    opcode = opcodes_.insert({action[1], opcode_names_.size()}).first;
+    opcode_names_.push_back(action[1]);
+  }
+
+  std::string& out = pending_[actor->second];
+  put_varint(out, opcode->second);
+  unsigned argc = 0;
+  while (action[argc + 2] != nullptr)
+    argc++;
+  put_varint(out, argc);
+  for (const char* const* arg = action + 2; *arg != nullptr; arg++) {
+    int64_t integer;
+    double real;
+    unsigned decimals;
+    if (parse_integer(*arg, &integer)) {
+      put_varint(out, zigzag(integer) << 2 | binary_arg_integer);
+    } else if (parse_real(*arg, &real)) {
+      if (real == std::trunc(real)) { // written back the same way as integers
+        put_varint(out, zigzag(static_cast<int64_t>(real)) << 2 | binary_arg_integer);
+      } else if (parse_decimal(*arg, &integer, &decimals)) {
+        put_varint(out, zigzag(integer) << 2 | binary_arg_decimal);
+        out.push_back(static_cast<char>(decimals));
       } else {
-        // Else, I have to store it for the relevant colleague
-        std::queue<ReplayAction*>* otherqueue = nullptr;
-        if (action_queues.find(evtname) != action_queues.end())
-          otherqueue = action_queues.at(evtname);
-        else { // Damn. Create the queue of that guy
-          otherqueue = new std::queue<ReplayAction*>();
-          action_queues.insert({evtname, otherqueue});
-        }
-        otherqueue->push(action);
+        uint64_t bits;
+        memcpy(&bits, &real, sizeof bits);
+        put_varint(out, binary_arg_double);
+        put_uint64(out, bits);
       }
+    } else {
+      size_t length = strlen(*arg);
+      put_varint(out, length << 2 | binary_arg_string);
+      out.append(*arg, length);
+    }
+  }
+  if (out.size() >= binary_replay_chunk_size)
+    flush(actor->second);
+}
+
+void ReplayBinaryWriter::write_line(const char* line)
+{
+  std::string copy(line);
+  std::vector<const char*> action;
+  char* saveptr = nullptr;
+  for (char* token = strtok_r(&copy[0], " \t\r\n", &saveptr); token != nullptr;
+       token     = strtok_r(nullptr, " \t\r\n", &saveptr))
+    action.push_back(token);
+  if (action.empty() || action.front()[0] == '#')
+    return;
+  action.push_back(nullptr);
+  write(action.data());
+}
+
+/** @brief The trace shared by all actors
+ *
+ * A background thread tokenizes the file ahead of the simulation and sorts the actions by actor. Each actor has a
+ * queue of actions, each of them stored as its tokens followed by a '\0', along with the values of its numbers for
+ * binary traces. When too many bytes are waiting, the thread pauses until they get consumed, unless an actor is
+ * waiting for its next action. The tokens and numbers given to an actor remain valid until its next call to get().
+ */
+class SharedReplayReader {
+  struct QueuedAction {
+    std::string tokens;
+    std::vector<double> numbers;
+  };
+  struct ActionQueue {
+    std::deque<QueuedAction> actions;
+    QueuedAction current; // the action that the actor is replaying
+  };
+
+  ReplayReader reader_;
+  std::unordered_map<std::string, ActionQueue> queues_;
+  std::mutex mutex_;
+  std::condition_variable actions_available_; // signaled by the parser
+  std::condition_variable actions_consumed_;  // signaled by the actors
+  size_t queued_bytes_  = 0;
+  int waiting_actors_   = 0;
+  bool done_            = false;
+  bool stopping_        = false;
+  std::thread parser_;
+
+  static const size_t max_queued_bytes = 1 << 26;
+  static const size_t batch_size       = 1024;
+
+  void start();
+  bool parse_batch(std::unique_lock<std::mutex>& lock);
+
+public:
+  explicit SharedReplayReader(const char* filename);
+  explicit SharedReplayReader(std::istream& stream);
+  ~SharedReplayReader();
+  bool get(const char* actor, std::vector<const char*>& action, const std::vector<double>** numbers);
+  void drop(const char* actor);
+  void report_leftovers();
+};
+
+SharedReplayReader::SharedReplayReader(const char* filename) : reader_(filename)
+{
+  start();
+}
+
+SharedReplayReader::SharedReplayReader(std::istream& stream) : reader_(stream)
+{
+  start();
+}
+
+void SharedReplayReader::start()
+{
+  if (MC_is_active()) // The checked application must remain single-threaded: parse on demand in get()
+    return;
+  parser_ = std::thread([this]() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (not stopping_ && parse_batch(lock)) {
+      actions_available_.notify_all();
+      actions_consumed_.wait(lock, [this]() {
+        return stopping_ || waiting_actors_ > 0 || queued_bytes_ < max_queued_bytes;
+      });
+    }
+    actions_available_.notify_all();
+  });
+}
+
+SharedReplayReader::~SharedReplayReader()
+{
+  if (parser_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
     }
-    // end of file reached while searching in vain for more work
-  } else {
-    // Get something from my queue and return it
-    action = myqueue->front();
-    myqueue->pop();
-    return action;
+    actions_consumed_.notify_all();
+    parser_.join();
+  }
+}
+
+/* Warn about the actions that were never claimed by any actor */
+void SharedReplayReader::report_leftovers()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  bool first = true;
+  for (auto const& queue : queues_) {
+    if (queue.second.actions.empty())
+      continue;
+    if (first)
+      XBT_WARN("Not all actions got consumed. If the simulation ended successfully (without deadlock),"
+               " you may want to add new processes to your deployment file.");
+    first = false;
+    XBT_WARN("Still %zu actions for %s", queue.second.actions.size(), queue.first.c_str());
+  }
+}
+
+/* Tokenize a batch of actions with the lock released, and sort them into the queues. Returns false at the end of the
+ * trace. */
+bool SharedReplayReader::parse_batch(std::unique_lock<std::mutex>& lock)
+{
+  if (done_)
+    return false;
+  std::vector<QueuedAction> batch;
+  std::vector<const char*> action;
+  std::vector<double> numbers;
+  lock.unlock();
+  while (batch.size() < batch_size && reader_.next(action, &numbers)) {
+    std::string tokens;
+    for (auto token = action.begin(); *token != nullptr; ++token)
+      tokens.append(*token, strlen(*token) + 1);
+    batch.push_back({std::move(tokens), numbers});
   }
-  return nullptr;
+  lock.lock();
+
+  for (QueuedAction& queued : batch) {
+    queued_bytes_ += queued.tokens.size() + queued.numbers.size() * sizeof(double);
+    queues_[queued.tokens.c_str()].actions.push_back(std::move(queued));
+  }
+  if (batch.size() < batch_size)
+    done_ = true;
+  return not done_;
+}
+
+bool SharedReplayReader::get(const char* actor, std::vector<const char*>& action, const std::vector<double>** numbers)
+{
+  action.clear();
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto queue = queues_.find(actor);
+  while (queue == queues_.end() || queue->second.actions.empty()) {
+    if (done_)
+      return false;
+    if (parser_.joinable()) {
+      waiting_actors_++;
+      actions_consumed_.notify_all();
+      actions_available_.wait(lock);
+      waiting_actors_--;
+    } else {
+      parse_batch(lock);
+    }
+    queue = queues_.find(actor);
+  }
+
+  QueuedAction& current = queue->second.current;
+  current               = std::move(queue->second.actions.front());
+  queue->second.actions.pop_front();
+  size_t size = current.tokens.size() + current.numbers.size() * sizeof(double);
+  if (queued_bytes_ >= max_queued_bytes && queued_bytes_ - size < max_queued_bytes)
+    actions_consumed_.notify_all();
+  queued_bytes_ -= size;
+  const std::string& tokens = current.tokens;
+  for (const char* token = tokens.c_str(); token < tokens.c_str() + tokens.size(); token += strlen(token) + 1)
+    action.push_back(token);
+  action.push_back(nullptr);
+  *numbers = &current.numbers;
+  return true;
+}
+
+/* Forget about the queue of an actor that is done */
+void SharedReplayReader::drop(const char* actor)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto queue = queues_.find(actor);
+  if (queue != queues_.end() && queue->second.actions.empty())
+    queues_.erase(queue);
+}
+
+static std::unique_ptr<SharedReplayReader> shared_reader;
+static std::ifstream* shared_reader_fs = nullptr; // the stream that shared_reader was read from, if any
+static std::mutex shared_reader_mutex;
+
+void replay_trace_open(const char* filename)
+{
+  std::lock_guard<std::mutex> lock(shared_reader_mutex);
+  shared_reader.reset(new SharedReplayReader(filename));
+  shared_reader_fs = nullptr;
 }
 
-static void handle_action(ReplayAction* action)
+void replay_trace_close()
 {
-  XBT_DEBUG("%s replays a %s action", action->at(0).c_str(), action->at(1).c_str());
-  char** c_action     = new char*[action->size() + 1];
-  action_fun function = action_funs.at(action->at(1));
-  int i               = 0;
-  for (auto arg : *action) {
-    c_action[i] = xbt_strdup(arg.c_str());
-    i++;
+  std::lock_guard<std::mutex> lock(shared_reader_mutex);
+  if (shared_reader)
+    shared_reader->report_leftovers();
+  shared_reader.reset();
+  shared_reader_fs = nullptr;
+}
+
+/* The reader of the unique trace file, if any. It is read from action_fs if the trace was not opened by name. */
+static SharedReplayReader* get_shared_reader()
+{
+  std::lock_guard<std::mutex> lock(shared_reader_mutex);
+  if (action_fs != nullptr && action_fs != shared_reader_fs) {
+    shared_reader.reset(new SharedReplayReader(*action_fs));
+    shared_reader_fs = action_fs;
   }
-  c_action[i] = nullptr;
+  return shared_reader.get();
+}
+
+void replay_trace_foreach(const char* filename, std::function<void(const char* const*)> const& f)
+{
+  ReplayReader reader(filename);
+  std::vector<const char*> action;
+  while (reader.next(action))
+    f(action.data());
+}
+
+/* The action being handled on this thread, for replay_action_number(). An actor may be suspended in the middle of its
+ * action and resumed after another one changed it: the tokens of the action tell whether it is still current. */
+static thread_local const char* const* current_action          = nullptr;
+static thread_local const std::vector<double>* current_numbers = nullptr;
+
+bool replay_action_number(const char* const* action, int i, double* value)
+{
+  if (action != current_action || i < 0 || static_cast<size_t>(i) >= current_numbers->size() ||
+      std::isnan((*current_numbers)[i]))
+    return false;
+  *value = (*current_numbers)[i];
+  return true;
+}
+
+static void handle_action(std::vector<const char*>& action, const std::vector<double>& numbers)
+{
+  XBT_DEBUG("%s replays a %s action", action[0], action[1]);
+  action_fun function = action_funs.at(action[1]);
+  current_action      = action.data();
+  current_numbers     = &numbers;
   try {
-    function(c_action);
+    function(action.data());
   } catch (xbt_ex& e) {
-    for (unsigned int j = 0; j < action->size(); j++)
-      xbt_free(c_action[j]);
-    delete[] c_action;
-    action->clear();
     xbt_die("Replay error:\n %s", e.what());
   }
-  for (unsigned int j = 0; j < action->size(); j++)
-    xbt_free(c_action[j]);
-  delete[] c_action;
 }
 
 /**
@@ -128,35 +832,26 @@ static void handle_action(ReplayAction* action)
  */
 int replay_runner(int argc, char* argv[])
 {
-  if (simgrid::xbt::action_fs) { // A unique trace file
-    while (true) {
-      simgrid::xbt::ReplayAction* evt = simgrid::xbt::get_action(argv[0]);
-      if (evt == nullptr)
-        break;
-      simgrid::xbt::handle_action(evt);
-      delete evt;
-    }
-    if (action_queues.find(std::string(argv[0])) != action_queues.end()) {
-      std::queue<ReplayAction*>* myqueue = action_queues.at(std::string(argv[0]));
-      delete myqueue;
-      action_queues.erase(std::string(argv[0]));
-    }
+  std::vector<const char*> action;
+  SharedReplayReader* shared = get_shared_reader();
+  if (shared) { // A unique trace file
+    const std::vector<double>* numbers;
+    while (shared->get(argv[0], action, &numbers))
+      simgrid::xbt::handle_action(action, *numbers);
+    shared->drop(argv[0]);
   } else { // Should have got my trace file in argument
-    simgrid::xbt::ReplayAction* evt = new simgrid::xbt::ReplayAction();
     xbt_assert(argc >= 2, "No '%s' agent function provided, no simulation-wide trace file provided, "
                           "and no process-wide trace file provided in deployment file. Aborting.",
                argv[0]);
-    simgrid::xbt::ReplayReader* reader = new simgrid::xbt::ReplayReader(argv[1]);
-    while (reader->get(evt)) {
-      if (evt->front().compare(argv[0]) == 0) {
-        simgrid::xbt::handle_action(evt);
+    simgrid::xbt::ReplayReader reader(argv[1], argv[0]);
+    std::vector<double> numbers;
+    while (reader.next(action, &numbers)) {
+      if (strcmp(action[0], argv[0]) == 0) {
+        simgrid::xbt::handle_action(action, numbers);
       } else {
         XBT_WARN("Ignore trace element not for me");
       }
-      evt->clear();
     }
-    delete evt;
-    delete reader;
   }
   return 0;
 }
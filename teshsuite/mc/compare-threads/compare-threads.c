@@ -0,0 +1,54 @@
+/* Copyright (c) 2017. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+/* A model where many visited states share the same fingerprint, to compare them in model-check/compare-threads
+ *
+ * The fingerprint of a state does not cover the content of the heap. The application allocates its buffers before
+ * the first MC_random(), and then only writes into them: all the states have the same heap size and the same frames,
+ * so a new state is compared with all the visited ones. The values drawn are summed in the heap, so that different
+ * paths lead to equal states. Each value is also kept in a part of the heap ignored by the comparisons: the equal
+ * states differ in memory, and are only found equal by comparing them.
+ */
+
+#include <simgrid/modelchecker.h>
+#include <simgrid/msg.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+XBT_LOG_NEW_DEFAULT_CATEGORY(compare_threads, "Messages specific for this test");
+
+static int nb_steps;
+
+static int app(int argc, char* argv[])
+{
+  int* sum     = malloc(sizeof(int));
+  char* values = malloc(nb_steps);
+  MC_ignore_heap(values, nb_steps);
+  *sum = 0;
+  memset(values, 0, nb_steps);
+
+  /* The values drawn are not stored in local variables, which are compared too */
+  for (int i = 0; i < nb_steps; i++) {
+    values[i] = (char)MC_random(0, 2);
+    *sum += values[i];
+  }
+
+  free(values);
+  free(sum);
+  return 0;
+}
+
+int main(int argc, char* argv[])
+{
+  MSG_init(&argc, argv);
+  xbt_assert(argc == 3, "Usage: %s platform_file nb_steps", argv[0]);
+  nb_steps = atoi(argv[2]);
+  xbt_assert(nb_steps > 0, "The number of steps must be positive");
+
+  MSG_create_environment(argv[1]);
+  MSG_process_create("app", app, NULL, MSG_get_host_by_name("Tremblay"));
+  return MSG_main();
+}
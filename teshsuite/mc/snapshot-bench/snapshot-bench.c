@@ -0,0 +1,56 @@
+/* Copyright (c) 2017. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+/* Benchmark of the snapshots of the model-checker, depending on the size of the heap
+ *
+ * The application allocates a heap of the given size (in MiB) and explores all the outcomes of a few MC_random(),
+ * writing a single page of this heap at each step. Run it in simgrid-mc with --cfg=model-check/visited so that a
+ * snapshot is taken at each state, and with --log=mc_checkpoint.thres:verbose to get the time taken by each snapshot.
+ * With --cfg=model-check/soft-dirty:yes, only the pages written since the previous snapshot should be read.
+ *
+ * The tests only check that both ways of taking the snapshots explore the same states, on a small heap. The timings
+ * depend on the host, so the benchmark itself is run by hand on a larger heap, for example:
+ *   simgrid-mc ./snapshot-bench small_platform.xml 16 5 --cfg=model-check/visited:1000
+ *              --cfg=model-check/soft-dirty:yes --log=mc_checkpoint.thres:verbose
+ */
+
+#include <simgrid/modelchecker.h>
+#include <simgrid/msg.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+XBT_LOG_NEW_DEFAULT_CATEGORY(snapshot_bench, "Messages specific for this benchmark");
+
+static size_t heap_size;
+static int nb_steps;
+
+static int app(int argc, char* argv[])
+{
+  char* data = malloc(heap_size);
+  memset(data, 1, heap_size);
+
+  size_t stride = heap_size / nb_steps;
+  for (int i = 0; i < nb_steps; i++) {
+    int x = MC_random(0, 1);
+    data[i * stride + x]++;
+  }
+
+  free(data);
+  return 0;
+}
+
+int main(int argc, char* argv[])
+{
+  MSG_init(&argc, argv);
+  xbt_assert(argc == 4, "Usage: %s platform_file heap_size_in_MiB nb_steps", argv[0]);
+  heap_size = (size_t)atol(argv[2]) << 20;
+  nb_steps  = atoi(argv[3]);
+  xbt_assert(heap_size > 0 && nb_steps > 0, "The heap size and the number of steps must be positive");
+
+  MSG_create_environment(argv[1]);
+  MSG_process_create("app", app, NULL, MSG_get_host_by_name("Tremblay"));
+  return MSG_main();
+}
@@ -0,0 +1,61 @@
+/* Copyright (c) 2017. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+/* Measures the cost of the tracing: processes update a variable and push/pop a state of their host in a loop, so that
+ * most of the simulation time is spent generating and writing the trace. The time to write the events that are still
+ * buffered at the end of the simulation is included. Tracing must be enabled, with tracing/platform:yes. */
+
+#include "instr/instr_interface.h"
+#include "simgrid/msg.h"
+#include "xbt/xbt_os_time.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int nb_steps;
+
+static int tracer(int argc, char* argv[])
+{
+  const char* hostname = MSG_host_get_name(MSG_host_self());
+  for (int i = 0; i < nb_steps; i++) {
+    TRACE_host_variable_add(hostname, "load", 1);
+    TRACE_host_push_state(hostname, "activity", "work");
+    MSG_process_sleep(0.001);
+    TRACE_host_pop_state(hostname, "activity");
+    TRACE_host_variable_sub(hostname, "load", 1);
+  }
+  return 0;
+}
+
+int main(int argc, char* argv[])
+{
+  MSG_init(&argc, argv);
+  xbt_assert(argc >= 4, "Usage: %s platform_file <processes> <steps> [perf]", argv[0]);
+  MSG_create_environment(argv[1]);
+  int nb_processes = atoi(argv[2]);
+  nb_steps         = atoi(argv[3]);
+  int perf         = argc > 4 && !strcmp(argv[4], "perf");
+
+  TRACE_host_variable_declare("load");
+  TRACE_host_state_declare("activity");
+  TRACE_host_state_declare_value("activity", "work", "1 0 0");
+
+  xbt_dynar_t hosts = MSG_hosts_as_dynar();
+  for (int i = 0; i < nb_processes; i++)
+    MSG_process_create("tracer", tracer, NULL, xbt_dynar_get_as(hosts, i % xbt_dynar_length(hosts), msg_host_t));
+  xbt_dynar_free(&hosts);
+
+  double start = xbt_os_time();
+  msg_error_t res = MSG_main();
+  TRACE_end();
+  double elapsed = xbt_os_time() - start;
+
+  long nb_events = 4L * nb_processes * nb_steps;
+  printf("%d processes did %d steps (%ld traced events)\n", nb_processes, nb_steps, nb_events);
+  if (perf)
+    printf("%g microseconds per event\n", elapsed * 1e6 / nb_events);
+  return res != MSG_OK;
+}
@@ -0,0 +1,41 @@
+/* Copyright (c) 2017. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#include "simgrid/s4u.hpp"
+
+XBT_LOG_NEW_DEFAULT_CATEGORY(s4u_test, "Messages specific for this s4u test");
+
+/* Retrieve the routes between all pairs of hosts twice, and check that the second time gives the same routes */
+int main(int argc, char* argv[])
+{
+  simgrid::s4u::Engine* e = new simgrid::s4u::Engine(&argc, argv);
+  xbt_assert(argc == 2, "Usage: %s platform_file", argv[0]);
+  e->loadPlatform(argv[1]);
+
+  std::vector<simgrid::s4u::Host*> hosts;
+  e->getHostList(&hosts);
+
+  unsigned long long hits   = e->getRouteCacheHits();
+  unsigned long long misses = e->getRouteCacheMisses();
+  int routes                = 0;
+  for (simgrid::s4u::Host* src : hosts)
+    for (simgrid::s4u::Host* dst : hosts) {
+      std::vector<simgrid::s4u::Link*> first_links;
+      std::vector<simgrid::s4u::Link*> second_links;
+      double first_latency  = 0;
+      double second_latency = 0;
+      src->routeTo(dst, &first_links, &first_latency);
+      src->routeTo(dst, &second_links, &second_latency);
+      xbt_assert(first_links == second_links && first_latency == second_latency,
+                 "Route from %s to %s changed: %zu links (latency: %g) then %zu links (latency: %g)", src->getCname(),
+                 dst->getCname(), first_links.size(), first_latency, second_links.size(), second_latency);
+      routes++;
+    }
+  XBT_INFO("%d routes retrieved twice: %llu cache hits, %llu cache misses", routes, e->getRouteCacheHits() - hits,
+           e->getRouteCacheMisses() - misses);
+
+  delete e;
+  return 0;
+}
@@ -1,18 +1,50 @@
-/* Copyright (c) 2008-2015. The SimGrid Team.
+/* Copyright (c) 2008-2015, 2017. The SimGrid Team.
  * All rights reserved.                                                     */
 
 /* This program is free software; you can redistribute it and/or modify it
  * under the terms of the license (GNU LGPL) which comes with this package. */
 
 //for i in $(seq 1 100); do teshsuite/simdag/platforms/evaluate_get_route_time ../examples/platforms/cluster.xml 1 2> /tmp/null ; done
+//
+// With a second argument, measure the mean lookup time over that many random routes instead. Use
+// --cfg=network/route-cache:0 to measure the routing tables of the netzones rather than the route cache.
 
 
 #include <stdio.h>
+#include <stdlib.h>
 #include "simgrid/simdag.h"
 #include "xbt/xbt_os_time.h"
 
 #define BILLION  1000000000L;
 
+/* Mean time of a lookup over the given amount of random routes (with a fixed seed, to compare the routings) */
+static void evaluate_lookups(sg_host_t *hosts, int host_count, int lookups)
+{
+  xbt_os_timer_t timer = xbt_os_timer_new();
+  xbt_dynar_t route = xbt_dynar_new(sizeof(SD_link_t), NULL);
+  int *pairs = xbt_new(int, 2 * lookups);
+
+  srand(0);
+  for (int k = 0; k < lookups; k++) {
+    pairs[2 * k]     = rand() % host_count;
+    pairs[2 * k + 1] = rand() % host_count;
+  }
+
+  xbt_os_cputimer_start(timer);
+  for (int k = 0; k < lookups; k++) {
+    xbt_dynar_reset(route);
+    sg_host_route(hosts[pairs[2 * k]], hosts[pairs[2 * k + 1]], route);
+  }
+  xbt_os_cputimer_stop(timer);
+
+  printf("%d lookups among %d hosts\t\t%g us per lookup\n", lookups, host_count,
+         xbt_os_timer_elapsed(timer) * 1e6 / lookups);
+
+  xbt_free(pairs);
+  xbt_dynar_free(&route);
+  xbt_os_timer_free(timer);
+}
+
 int main(int argc, char **argv)
 {
   int i;
@@ -25,6 +57,13 @@ int main(int argc, char **argv)
   sg_host_t *hosts = sg_host_list();
   int host_count = sg_host_count();
 
+  if (argc > 2) {
+    evaluate_lookups(hosts, host_count, atoi(argv[2]));
+    xbt_free(hosts);
+    xbt_os_timer_free(timer);
+    return 0;
+  }
+
   /* Random number initialization */
   srand( (int) (xbt_os_time()*1000) );
 
@@ -0,0 +1,41 @@
+/* Copyright (c) 2017. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+/* Checks that the stacks of the dead actors are given to the next ones */
+
+#include <simgrid/s4u.hpp>
+#include <simgrid/simix.h>
+
+XBT_LOG_NEW_DEFAULT_CATEGORY(test, "my log messages");
+
+static void sleeper()
+{
+  simgrid::s4u::this_actor::sleep_for(1);
+}
+
+static void master()
+{
+  for (int wave = 0; wave < 10; wave++) {
+    for (int i = 0; i < 10; i++)
+      simgrid::s4u::Actor::createActor("sleeper", simgrid::s4u::Host::current(), sleeper);
+    simgrid::s4u::this_actor::sleep_for(2);
+  }
+
+  size_t allocated;
+  size_t reused;
+  size_t peak_size;
+  SIMIX_context_stack_stats(&allocated, &reused, &peak_size);
+  XBT_INFO("%zu stacks allocated, %zu reused, at most %zu used at the same time", allocated, reused,
+           peak_size / (smx_context_stack_size + smx_context_guard_size));
+}
+
+int main(int argc, char* argv[])
+{
+  simgrid::s4u::Engine e(&argc, argv);
+  e.loadPlatform(argv[1]);
+  simgrid::s4u::Actor::createActor("master", simgrid::s4u::Host::by_name("Tremblay"), master);
+  e.run();
+  return 0;
+}
@@ -31,16 +31,17 @@ int main(int argc, char *argv[])
   MPI_Comm_size(MPI_COMM_WORLD, &n);
   double d = 2.0;
   for (int i = 0; i < 5; i++) {
-    /* I want no more than n + 1 benchs (thres < 0) */
-    SMPI_SAMPLE_GLOBAL(n + 1, -1) {
-      if (verbose)
-        fprintf(stderr, "(%12.6f) [rank:%d]", MPI_Wtime(), smpi_process_index());
-      else
-        fprintf(stderr, "(0)");
-      fprintf(stderr, " Run the first computation. It's globally benched, "
-              "and I want no more than %d benchmarks (thres<0)\n", n + 1);
-      d = compute(2.0);
-     }
+    /* I want no more than n + 1 benchs (thres < 0). The macros are single statements, as the body of this if. */
+    if (d > 0)
+      SMPI_SAMPLE_GLOBAL(n + 1, -1) {
+        if (verbose)
+          fprintf(stderr, "(%12.6f) [rank:%d]", MPI_Wtime(), smpi_process_index());
+        else
+          fprintf(stderr, "(0)");
+        fprintf(stderr, " Run the first computation. It's globally benched, "
+                "and I want no more than %d benchmarks (thres<0)\n", n + 1);
+        d = compute(2.0);
+      }
   }
 
   n = 0;
@@ -0,0 +1,87 @@
+/* Copyright (c) 2017. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+/* Micro-benchmark of the predefined reduction operators, applied with MPI_Reduce_local() on real buffers.
+ * The results are checked against a naive loop, and the program fails if any result is wrong. The host time of each
+ * reduction is only displayed with a "perf" argument, as it depends on the machine running the simulation. */
+
+#include <mpi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#undef clock_gettime /* We want to measure the real time, not the simulated one */
+
+static double wall_time(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+#define BENCH(type, mpi_type, op, mpi_op, name)                                                                        \
+  {                                                                                                                    \
+    type* in    = (type*)malloc(count * sizeof(type));                                                                 \
+    type* inout = (type*)malloc(count * sizeof(type));                                                                 \
+    type* ref   = (type*)malloc(count * sizeof(type));                                                                 \
+    for (int i = 0; i < count; i++) {                                                                                  \
+      in[i]    = (type)(i % 17 + 1);                                                                                   \
+      inout[i] = (type)(i % 13 + 1);                                                                                   \
+      ref[i]   = op(in[i], inout[i]);                                                                                  \
+    }                                                                                                                  \
+    MPI_Reduce_local(in, inout, count, mpi_type, mpi_op);                                                              \
+    if (memcmp(inout, ref, count * sizeof(type)) != 0) {                                                               \
+      printf("Wrong result for %s\n", name);                                                                           \
+      errors++;                                                                                                        \
+    }                                                                                                                  \
+    if (perf) {                                                                                                        \
+      double start = wall_time();                                                                                      \
+      for (int r = 0; r < rounds; r++)                                                                                 \
+        MPI_Reduce_local(in, inout, count, mpi_type, mpi_op);                                                          \
+      double elapsed = wall_time() - start;                                                                            \
+      printf("%-21s %8d elements: %8.3f us (%.3f ns per element)\n", name, count, elapsed * 1e6 / rounds,              \
+             elapsed * 1e9 / ((double)rounds * count));                                                                \
+    }                                                                                                                  \
+    free(in);                                                                                                          \
+    free(inout);                                                                                                       \
+    free(ref);                                                                                                         \
+  }
+
+#define SUM(a, b) ((a) + (b))
+#define PROD(a, b) ((a) * (b))
+#undef MAX
+#define MAX(a, b) ((a) < (b) ? (b) : (a))
+#undef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#define BAND(a, b) ((a) & (b))
+#define BXOR(a, b) ((a) ^ (b))
+
+int main(int argc, char** argv)
+{
+  int sizes[] = {16, 1024, 1048576};
+  int errors  = 0;
+
+  MPI_Init(&argc, &argv);
+  int perf = argc > 1 && strcmp(argv[1], "perf") == 0;
+
+  for (unsigned s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+    int count  = sizes[s];
+    int rounds = 16 * 1048576 / count;
+    BENCH(int, MPI_INT, SUM, MPI_SUM, "MPI_SUM MPI_INT");
+    BENCH(double, MPI_DOUBLE, SUM, MPI_SUM, "MPI_SUM MPI_DOUBLE");
+    BENCH(float, MPI_FLOAT, PROD, MPI_PROD, "MPI_PROD MPI_FLOAT");
+    BENCH(double, MPI_DOUBLE, MAX, MPI_MAX, "MPI_MAX MPI_DOUBLE");
+    BENCH(long, MPI_LONG, MIN, MPI_MIN, "MPI_MIN MPI_LONG");
+    BENCH(unsigned, MPI_UNSIGNED, BAND, MPI_BAND, "MPI_BAND MPI_UNSIGNED");
+    BENCH(char, MPI_CHAR, BXOR, MPI_BXOR, "MPI_BXOR MPI_CHAR");
+  }
+
+  if (errors == 0)
+    printf("All the reductions are right\n");
+
+  MPI_Finalize();
+  return errors != 0;
+}
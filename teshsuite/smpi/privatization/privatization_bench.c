@@ -0,0 +1,71 @@
+/* Copyright (c) 2017. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+/* Measures the cost of switching between the SMPI processes, which depends on the privatization schema: the mmap one
+ * remaps the data segment at each switch while the dlopen one has nothing to do.
+ *
+ * The processes pass a token around a ring, each of them checking its private global variable at each step. The program
+ * fails if any process saw a wrong value. The real time is only reported with an extra "perf" argument, as it depends
+ * on the host running the simulation. */
+
+#include <mpi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#undef clock_gettime /* We want to measure the real time, not the simulated one */
+
+static int myvalue = 0;
+
+static double wall_time(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char** argv)
+{
+  int rank;
+  int size;
+  int errors = 0;
+  int total_errors;
+
+  MPI_Init(&argc, &argv);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+  int rounds = argc > 1 ? atoi(argv[1]) : 1000;
+  int perf   = argc > 2 && strcmp(argv[2], "perf") == 0;
+  int next   = (rank + 1) % size;
+  int prev   = (rank + size - 1) % size;
+
+  MPI_Barrier(MPI_COMM_WORLD);
+  double start = wall_time();
+  for (int i = 0; i < rounds; i++) {
+    int token;
+    myvalue = rank + i;
+    MPI_Sendrecv(&i, 1, MPI_INT, next, 0, &token, 1, MPI_INT, prev, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    if (myvalue != rank + i || token != i)
+      errors++;
+  }
+  MPI_Barrier(MPI_COMM_WORLD);
+  double elapsed = wall_time() - start;
+
+  MPI_Reduce(&errors, &total_errors, 1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+  if (rank == 0) {
+    if (total_errors != 0)
+      printf("Privatization error: %d wrong values\n", total_errors);
+    else
+      printf("%d rounds of %d processes: all the private values are right\n", rounds, size);
+    if (perf)
+      printf("%d rounds of %d processes in %.3f s (%.2f us per process and round)\n", rounds, size, elapsed,
+             elapsed * 1e6 / ((double)rounds * size));
+  }
+
+  MPI_Finalize();
+  return rank == 0 && total_errors != 0;
+}
@@ -0,0 +1,77 @@
+/* Copyright (c) 2017. The SimGrid Team.
+ * All rights reserved.                                                     */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+/* Sends with duplicates of derived datatypes, which must have the same layout as their original: an indexed type with a
+ * nonzero lower bound, and a vector of it. The originals are freed before use. */
+
+#include <stdio.h>
+#include "mpi.h"
+
+int main(int argc, char *argv[])
+{
+  int rank;
+  int size;
+  MPI_Datatype type;
+  MPI_Datatype type2;
+  MPI_Datatype dup;
+  MPI_Datatype dup2;
+  int blocklen[2]     = {2, 1};
+  int displacement[2] = {2, 5};
+  int buffer[24];
+  int type_size;
+  int dup_size;
+  MPI_Aint lb;
+  MPI_Aint extent;
+  MPI_Status status;
+
+  MPI_Init(&argc, &argv);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  if (size < 2) {
+    printf("Please run with 2 processes.\n");
+    MPI_Finalize();
+    return 1;
+  }
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  MPI_Type_indexed(2, blocklen, displacement, MPI_INT, &type);
+  MPI_Type_commit(&type);
+  MPI_Type_dup(type, &dup);
+  MPI_Type_vector(2, 1, 2, type, &type2);
+  MPI_Type_commit(&type2);
+  MPI_Type_dup(type2, &dup2);
+
+  MPI_Type_size(type, &type_size);
+  MPI_Type_size(dup, &dup_size);
+  MPI_Type_get_extent(dup, &lb, &extent);
+  if (rank == 0)
+    printf("size %d, dup size %d, dup lb %d, dup extent %d\n", type_size, dup_size, (int)lb, (int)extent);
+  MPI_Type_free(&type);
+  MPI_Type_free(&type2);
+
+  for (int round = 0; round < 2; round++) {
+    MPI_Datatype sent = round == 0 ? dup : dup2;
+    if (rank == 0) {
+      for (int i = 0; i < 24; i++)
+        buffer[i] = i;
+      MPI_Send(buffer, 1, sent, 1, 123, MPI_COMM_WORLD);
+    }
+    if (rank == 1) {
+      for (int i = 0; i < 24; i++)
+        buffer[i] = -1;
+      MPI_Recv(buffer, 1, sent, 0, 123, MPI_COMM_WORLD, &status);
+      printf("%s:", round == 0 ? "indexed" : "vector");
+      for (int i = 0; i < 24; i++)
+        printf(" %d", buffer[i]);
+      printf("\n");
+      fflush(stdout);
+    }
+  }
+
+  MPI_Type_free(&dup);
+  MPI_Type_free(&dup2);
+  MPI_Finalize();
+  return 0;
+}
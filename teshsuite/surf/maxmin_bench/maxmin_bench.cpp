@@ -18,6 +18,7 @@
 #include <stdint.h>
 
 double date;
+double build_date;
 int64_t seedx = 0;
 
 static int myrand() {
@@ -36,12 +37,13 @@ static unsigned int int_random(int max)
 }
 
 static void test(int nb_cnst, int nb_var, int nb_elem, unsigned int pw_base_limit, unsigned int pw_max_limit,
-                 float rate_no_limit, int max_share, int mode)
+                 float rate_no_limit, int max_share, int mode, void (*solve)(lmm_system_t), double* values)
 {
   lmm_constraint_t cnst[nb_cnst];
   lmm_variable_t var[nb_var];
   int used[nb_cnst];
 
+  build_date       = xbt_os_time() * 1000000;
   lmm_system_t Sys = lmm_system_new(1);
 
   for (int i = 0; i < nb_cnst; i++) {
@@ -77,11 +79,17 @@ static void test(int nb_cnst, int nb_var, int nb_elem, unsigned int pw_base_limi
     }
   }
 
+  build_date = xbt_os_time() * 1000000 - build_date;
+
   fprintf(stderr,"Starting to solve(%i)\n",myrand()%1000);
   date = xbt_os_time() * 1000000;
-  lmm_solve(Sys);
+  solve(Sys);
   date = xbt_os_time() * 1000000 - date;
 
+  if (values)
+    for (int i = 0; i < nb_var; i++)
+      values[i] = lmm_variable_getvalue(var[i]);
+
   if(mode==2){
     fprintf(stderr,"Max concurrency:\n");
     int l=0;
@@ -123,7 +131,7 @@ int main(int argc, char **argv)
   int testclass;
 
   if(argc<3) {
-    fprintf(stderr, "Syntax: <small|medium|big|huge> <count> [test|debug|perf]\n");
+    fprintf(stderr, "Syntax: <small|medium|big|huge> <count> [test|debug|perf|compare [perf]]\n");
     return -1;
   }
 
@@ -152,6 +160,9 @@ int main(int argc, char **argv)
     mode=2;
   if(argc>=4 && strcmp(argv[3],"perf")==0)
     mode=3;
+  //Solve each system with both lmm_solve() and lmm_solve_soa(), and compare the results
+  if(argc>=4 && strcmp(argv[3],"compare")==0)
+    mode=4;
 
   if(mode==1)
     xbt_log_control_set("surf/maxmin.threshold:DEBUG surf/maxmin.fmt:\'[%r]: [%c/%p] %m%n\'\
@@ -171,10 +182,55 @@ int main(int argc, char **argv)
   //Otherwise, just set it to a constant value (and set rate_no_limit to 1.0):
   //nb_elem=200
 
+  if (mode == 4) {
+    float acc_date_soa  = 0;
+    float acc_date2_soa = 0;
+    float acc_build     = 0;
+    float acc_build_soa = 0;
+    double* values      = new double[nb_var];
+    double* values_soa  = new double[nb_var];
+    for (int i = 0; i < testcount; i++) {
+      seedx = i + 1;
+      fprintf(stderr, "Starting %i: (%i)\n", i, myrand() % 1000);
+      test(nb_cnst, nb_var, nb_elem, pw_base_limit, pw_max_limit, rate_no_limit, max_share, mode, lmm_solve, values);
+      acc_date += date;
+      acc_date2 += date * date;
+      acc_build += build_date;
+      /* The contiguous storage is filled while the system is built */
+      seedx = i + 1;
+      myrand();
+      sg_maxmin_soa = true;
+      test(nb_cnst, nb_var, nb_elem, pw_base_limit, pw_max_limit, rate_no_limit, max_share, mode, lmm_solve_soa,
+           values_soa);
+      sg_maxmin_soa = false;
+      acc_date_soa += date;
+      acc_date2_soa += date * date;
+      acc_build_soa += build_date;
+      for (unsigned int j = 0; j < nb_var; j++)
+        xbt_assert(values[j] == values_soa[j],
+                   "Solvers disagree on variable %u of system %i: %.17g with lists, %.17g with arrays", j, i,
+                   values[j], values_soa[j]);
+    }
+    delete[] values;
+    delete[] values_soa;
+    fprintf(stderr, "Both solvers agree on the %i systems\n", testcount);
+    if (argc >= 5 && strcmp(argv[4], "perf") == 0) {
+      float mean_date     = acc_date / (float)testcount;
+      float mean_date_soa = acc_date_soa / (float)testcount;
+      fprintf(stderr, "Execution time with lists: %g +- %g  microseconds \n", mean_date,
+              sqrt(acc_date2 / (float)testcount - mean_date * mean_date));
+      fprintf(stderr, "Execution time with arrays: %g +- %g  microseconds \n", mean_date_soa,
+              sqrt(acc_date2_soa / (float)testcount - mean_date_soa * mean_date_soa));
+      fprintf(stderr, "Building time with lists: %g microseconds, with arrays: %g microseconds\n",
+              acc_build / (float)testcount, acc_build_soa / (float)testcount);
+    }
+    return 0;
+  }
+
   for(int i=0;i<testcount;i++){
     seedx=i+1;
     fprintf(stderr, "Starting %i: (%i)\n",i,myrand()%1000);
-    test(nb_cnst, nb_var, nb_elem, pw_base_limit, pw_max_limit, rate_no_limit,max_share,mode);
+    test(nb_cnst, nb_var, nb_elem, pw_base_limit, pw_max_limit, rate_no_limit, max_share, mode, lmm_solve, nullptr);
     acc_date+=date;
     acc_date2+=date*date;
   }
@@ -0,0 +1,134 @@
+/* Benchmark of the future event set of the trace manager                   */
+
+/* Copyright (c) 2017. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#include "src/surf/trace_mgr.hpp"
+#include "src/xbt/calendar_queue.hpp"
+#include "xbt/heap.hpp"
+#include "xbt/xbt_os_time.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/* Synthetic availability traces: each trace has a sample every period, shifted by its own phase and slightly jittered
+ * (unless aligned, in which case all the traces have their samples at the same dates) */
+struct Traces {
+  std::vector<double> phase;
+  std::vector<double> period;
+};
+
+static int64_t seedx = 0;
+
+static int myrand()
+{
+  seedx = seedx * 16807 % 2147483647;
+  return static_cast<int32_t>(seedx % 1000);
+}
+
+static double float_random(double max)
+{
+  return (max * myrand()) / 1001.0;
+}
+
+static Traces make_traces(int nb_traces, bool aligned)
+{
+  Traces traces;
+  for (int i = 0; i < nb_traces; i++) {
+    traces.phase.push_back(aligned ? 0.0 : float_random(1.0));
+    traces.period.push_back(aligned ? 1.0 : 0.5 + float_random(1.0));
+  }
+  return traces;
+}
+
+/* Pop nb_events events, rescheduling each trace at its next sample. Returns a checksum of the popped dates: the queues
+ * do not pop the simultaneous events in the same order, so the traces themselves are not part of it. */
+template <class Queue> static double run(Queue& queue, const Traces& traces, int nb_events)
+{
+  for (unsigned i = 0; i < traces.phase.size(); i++)
+    queue.push(i, traces.phase[i]);
+  double checksum = 0;
+  for (int j = 0; j < nb_events; j++) {
+    double date  = queue.top_key();
+    unsigned idx = queue.pop();
+    checksum += (j % 1009) * date;
+    queue.push(idx, date + traces.period[idx]);
+  }
+  return checksum;
+}
+
+template <class Queue> static double time_run(const Traces& traces, int nb_events, double* checksum)
+{
+  Queue queue;
+  double date = xbt_os_time();
+  *checksum   = run(queue, traces, nb_events);
+  return xbt_os_time() - date;
+}
+
+/* Same workload through the real future event set, with one trace shared by all the resources */
+static double time_future_evt_set(const Traces& traces, int nb_events)
+{
+  std::string input;
+  for (int i = 0; i < 100; i++)
+    input += std::to_string(i) + " " + std::to_string(i % 2) + "\n";
+  tmgr_trace_t trace = tmgr_trace_new_from_string("bench", input, 100);
+
+  simgrid::trace_mgr::future_evt_set fes;
+  for (unsigned i = 0; i < traces.phase.size(); i++)
+    fes.add_trace(trace, nullptr);
+
+  double date = xbt_os_time();
+  double value;
+  simgrid::surf::Resource* resource;
+  for (int j = 0; j < nb_events;) {
+    double now = fes.next_date();
+    while (j < nb_events && fes.pop_leq(now, &value, &resource))
+      j++;
+  }
+  return xbt_os_time() - date;
+}
+
+int main(int argc, char** argv)
+{
+  if (argc < 3) {
+    fprintf(stderr, "Syntax: <traces> <events> [aligned] [perf]\n");
+    return -1;
+  }
+  int nb_traces = atoi(argv[1]);
+  int nb_events = atoi(argv[2]);
+  bool aligned  = false;
+  bool perf     = false;
+  for (int i = 3; i < argc; i++) {
+    if (not strcmp(argv[i], "aligned"))
+      aligned = true;
+    else if (not strcmp(argv[i], "perf"))
+      perf = true;
+  }
+
+  Traces traces = make_traces(nb_traces, aligned);
+  double heap_checksum;
+  double calendar_checksum;
+  double heap_time = time_run<simgrid::xbt::Heap<unsigned>>(traces, nb_events, &heap_checksum);
+  double calendar_time = time_run<simgrid::xbt::CalendarQueue<unsigned>>(traces, nb_events, &calendar_checksum);
+
+  if (heap_checksum != calendar_checksum) {
+    fprintf(stderr, "The heap and the calendar queue disagree on the dates: %f != %f\n", heap_checksum,
+            calendar_checksum);
+    return 1;
+  }
+  printf("Popped %d events of %d %s traces at the same dates with both queues\n", nb_events, nb_traces,
+         aligned ? "aligned" : "shifted");
+
+  if (perf) {
+    printf("Heap:            %g microseconds per event\n", heap_time * 1e6 / nb_events);
+    printf("Calendar queue:  %g microseconds per event\n", calendar_time * 1e6 / nb_events);
+    printf("future_evt_set:  %g microseconds per event\n", time_future_evt_set(traces, nb_events) * 1e6 / nb_events);
+  }
+  return 0;
+}
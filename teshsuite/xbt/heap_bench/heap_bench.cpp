@@ -0,0 +1,278 @@
+/* A few tests for the xbt_heap module and its C++ counterpart               */
+
+/* Copyright (c) 2004-2010, 2012-2017. The SimGrid Team.
+ * All rights reserved.                                                     */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <xbt/xbt_os_time.h>
+
+#include "xbt/heap.h"
+#include "xbt/heap.hpp"
+#include "xbt/sysdep.h"
+
+#define MAX_TEST 1000000
+
+/* Elements that remember their position in the heap, as the surf actions do */
+struct Element {
+  int index = -1;
+};
+
+static void element_update_index(void* elm, int i)
+{
+  static_cast<Element*>(elm)->index = i;
+}
+
+struct ElementIndex {
+  void operator()(Element* elm, int i) const { elm->index = i; }
+};
+
+typedef simgrid::xbt::Heap<Element*, ElementIndex> ElementHeap;
+
+static double random_key()
+{
+  return 10.0 * rand() / (RAND_MAX + 1.0);
+}
+
+static void test_reset_heap(xbt_heap_t * heap, int size)
+{
+  xbt_heap_free(*heap);
+  *heap = xbt_heap_new(size, nullptr);
+
+  for (int i = 0; i < size; i++) {
+    xbt_heap_push(*heap, nullptr, random_key());
+  }
+}
+
+static void test_reset_heap(simgrid::xbt::Heap<void*>& heap, int size)
+{
+  heap.clear();
+  for (int i = 0; i < size; i++)
+    heap.push(nullptr, random_key());
+}
+
+static void test_heap_validity(int size)
+{
+  xbt_heap_t heap = xbt_heap_new(size, nullptr);
+  simgrid::xbt::Heap<void*> cpp_heap;
+  std::vector<double> tab(size);
+
+  for (int i = 0; i < size; i++) {
+    tab[i] = random_key();
+    xbt_heap_push(heap, nullptr, tab[i]);
+    cpp_heap.push(nullptr, tab[i]);
+  }
+
+  std::sort(tab.begin(), tab.end());
+
+  for (int i = 0; i < size; i++) {
+    if (fabs(xbt_heap_maxkey(heap) - tab[i]) > 1e-9 || fabs(cpp_heap.top_key() - tab[i]) > 1e-9) {
+      fprintf(stderr, "Problem !\n");
+      exit(1);
+    }
+    xbt_heap_pop(heap);
+    cpp_heap.pop();
+  }
+  xbt_heap_free(heap);
+  printf("Validity test complete!\n");
+}
+
+/* Change the key of random elements, then check that the keys still come out sorted */
+static void test_heap_update_validity(int size)
+{
+  std::vector<Element> elements(size);
+  ElementHeap heap;
+
+  for (Element& elm : elements)
+    heap.push(&elm, random_key());
+  for (int i = 0; i < size; i++) {
+    Element& elm = elements[rand() % size];
+    if (elm.index < 0)
+      heap.push(&elm, random_key());
+    else if (rand() % 4 == 0)
+      heap.remove(elm.index);
+    else
+      heap.update(elm.index, random_key());
+  }
+
+  double previous = -1;
+  while (not heap.empty()) {
+    double key = heap.top_key();
+    if (key < previous || heap.top()->index != 0) {
+      fprintf(stderr, "Problem !\n");
+      exit(1);
+    }
+    previous = key;
+    heap.pop();
+  }
+  for (Element& elm : elements)
+    if (elm.index != -1) {
+      fprintf(stderr, "Problem !\n");
+      exit(1);
+    }
+  printf("Update validity test complete!\n");
+}
+
+/* Elements in both heaps at once, to check that they come out in the same order */
+struct TwinElement {
+  int c_index   = -1;
+  int cpp_index = -1;
+};
+
+static void twin_update_index(void* elm, int i)
+{
+  static_cast<TwinElement*>(elm)->c_index = i;
+}
+
+struct TwinIndex {
+  void operator()(TwinElement* elm, int i) const { elm->cpp_index = i; }
+};
+
+/* Same operations on xbt_heap and on the C++ heap, with many equal keys: the ties must be broken the same way */
+static void test_heap_same_order(int size)
+{
+  std::vector<TwinElement> elements(size);
+  xbt_heap_t heap = xbt_heap_new(size, nullptr);
+  xbt_heap_set_update_callback(heap, twin_update_index);
+  simgrid::xbt::Heap<TwinElement*, TwinIndex> cpp_heap;
+  auto tied_key = []() { return (double)(rand() % 4); };
+
+  for (TwinElement& elm : elements) {
+    double key = tied_key();
+    xbt_heap_push(heap, &elm, key);
+    cpp_heap.push(&elm, key);
+  }
+  for (int i = 0; i < 4 * size; i++) {
+    TwinElement& elm = elements[rand() % size];
+    double key       = tied_key();
+    if (elm.c_index < 0) {
+      xbt_heap_push(heap, &elm, key);
+      cpp_heap.push(&elm, key);
+    } else if (rand() % 4 == 0) {
+      xbt_heap_remove(heap, elm.c_index);
+      cpp_heap.remove(elm.cpp_index);
+    } else if (rand() % 4 == 0) {
+      if (xbt_heap_pop(heap) != cpp_heap.pop()) {
+        fprintf(stderr, "Problem !\n");
+        exit(1);
+      }
+    } else {
+      xbt_heap_update(heap, elm.c_index, key);
+      cpp_heap.update(elm.cpp_index, key);
+    }
+    if (elm.c_index != elm.cpp_index) {
+      fprintf(stderr, "Problem !\n");
+      exit(1);
+    }
+  }
+  while (xbt_heap_size(heap) > 0)
+    if (xbt_heap_pop(heap) != cpp_heap.pop()) {
+      fprintf(stderr, "Problem !\n");
+      exit(1);
+    }
+  xbt_heap_free(heap);
+  printf("Same order test complete!\n");
+}
+
+static void test_heap_mean_operation(int size)
+{
+  xbt_heap_t heap = xbt_heap_new(size, nullptr);
+
+  double date = xbt_os_time() * 1000000;
+  for (int i = 0; i < size; i++)
+    xbt_heap_push(heap, nullptr, random_key());
+
+  date = xbt_os_time() * 1000000 - date;
+  printf("Creation time  %d size heap : %g\n", size, date);
+
+  date = xbt_os_time() * 1000000;
+  for (int j = 0; j < MAX_TEST; j++) {
+
+    if (!(j % size) && j)
+      test_reset_heap(&heap, size);
+
+    double val = xbt_heap_maxkey(heap);
+    xbt_heap_pop(heap);
+    xbt_heap_push(heap, nullptr, 3.0 * val);
+  }
+  date = xbt_os_time() * 1000000 - date;
+  printf("Mean access time for a %d size heap : %g\n", size, date * 1.0 / (MAX_TEST + 0.0));
+
+  xbt_heap_free(heap);
+}
+
+static void test_cpp_heap_mean_operation(int size)
+{
+  simgrid::xbt::Heap<void*> heap;
+
+  double date = xbt_os_time() * 1000000;
+  for (int i = 0; i < size; i++)
+    heap.push(nullptr, random_key());
+
+  date = xbt_os_time() * 1000000 - date;
+  printf("Creation time  %d size C++ heap : %g\n", size, date);
+
+  date = xbt_os_time() * 1000000;
+  for (int j = 0; j < MAX_TEST; j++) {
+
+    if (!(j % size) && j)
+      test_reset_heap(heap, size);
+
+    double val = heap.top_key();
+    heap.pop();
+    heap.push(nullptr, 3.0 * val);
+  }
+  date = xbt_os_time() * 1000000 - date;
+  printf("Mean access time for a %d size C++ heap : %g\n", size, date * 1.0 / (MAX_TEST + 0.0));
+}
+
+/* Reschedule random elements, as the lazy models do with the actions whose share changed */
+static void test_heap_mean_update(int size)
+{
+  std::vector<Element> elements(size);
+  std::vector<int> picks(MAX_TEST);
+  std::vector<double> keys(MAX_TEST);
+  for (int j = 0; j < MAX_TEST; j++) {
+    picks[j] = rand() % size;
+    keys[j]  = random_key();
+  }
+
+  xbt_heap_t heap = xbt_heap_new(size, nullptr);
+  xbt_heap_set_update_callback(heap, element_update_index);
+  for (Element& elm : elements)
+    xbt_heap_push(heap, &elm, random_key());
+  double date = xbt_os_time() * 1000000;
+  for (int j = 0; j < MAX_TEST; j++)
+    xbt_heap_update(heap, elements[picks[j]].index, keys[j]);
+  date = xbt_os_time() * 1000000 - date;
+  printf("Mean update time for a %d size heap : %g\n", size, date * 1.0 / (MAX_TEST + 0.0));
+  xbt_heap_free(heap);
+
+  ElementHeap cpp_heap;
+  for (Element& elm : elements)
+    cpp_heap.push(&elm, random_key());
+  date = xbt_os_time() * 1000000;
+  for (int j = 0; j < MAX_TEST; j++)
+    cpp_heap.update(elements[picks[j]].index, keys[j]);
+  date = xbt_os_time() * 1000000 - date;
+  printf("Mean update time for a %d size C++ heap : %g\n", size, date * 1.0 / (MAX_TEST + 0.0));
+}
+
+int main(int argc, char **argv)
+{
+  for (int size = 100; size < 10000; size *= 10) {
+    test_heap_validity(size);
+    test_heap_update_validity(size);
+    test_heap_same_order(size);
+    test_heap_mean_operation(size);
+    test_cpp_heap_mean_operation(size);
+    test_heap_mean_update(size);
+  }
+  return 0;
+}
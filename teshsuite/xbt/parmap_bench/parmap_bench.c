@@ -12,12 +12,13 @@
 #include <xbt/parmap.h>
 #include <xbt/sysdep.h>
 
-#define MODES_DEFAULT 0x7
+#define MODES_DEFAULT 0x17
 #define TIMEOUT 10.0
 #define ARRAY_SIZE 10007
 #define FIBO_MAX 25
 
 void (*fun_to_apply)(void *);
+static unsigned *array; /* the array of the current benchmark */
 
 static const char *parmap_mode_name(e_xbt_parmap_mode_t mode)
 {
@@ -35,6 +36,9 @@ static const char *parmap_mode_name(e_xbt_parmap_mode_t mode)
   case XBT_PARMAP_DEFAULT:
     snprintf(name, sizeof name, "DEFAULT");
     break;
+  case XBT_PARMAP_WORK_STEALING:
+    snprintf(name, sizeof name, "WORK_STEALING");
+    break;
   default:
     snprintf(name, sizeof name, "UNKNOWN(%d)", (int)mode);
     break;
@@ -73,9 +77,20 @@ static void fun_big_comp(void *arg)
   *u = fibonacci(*u % FIBO_MAX);
 }
 
+/* Only the first elements of the array are costly, so a static split of the array is unbalanced */
+static void fun_unbalanced_comp(void *arg)
+{
+  unsigned *u = arg;
+  if (u - array < ARRAY_SIZE / 8)
+    *u = fibonacci(FIBO_MAX - 5 + (u - array) % 5);
+  else
+    *u = 2 * *u + 1;
+}
+
 static void array_new(unsigned **a, xbt_dynar_t *data)
 {
   *a = xbt_malloc(ARRAY_SIZE * sizeof **a);
+  array = *a;
   *data = xbt_dynar_new(sizeof *a, NULL);
   xbt_dynar_shrink(*data, ARRAY_SIZE);
   for (int i = 0 ; i < ARRAY_SIZE ; i++) {
@@ -148,7 +163,8 @@ static void bench_parmap_apply(int nthreads, e_xbt_parmap_mode_t mode)
 static void bench_all_modes(void (*bench_fun)(int, e_xbt_parmap_mode_t),
                             int nthreads, unsigned modes)
 {
-  e_xbt_parmap_mode_t all_modes[] = {XBT_PARMAP_POSIX, XBT_PARMAP_FUTEX, XBT_PARMAP_BUSY_WAIT, XBT_PARMAP_DEFAULT};
+  e_xbt_parmap_mode_t all_modes[] = {XBT_PARMAP_POSIX, XBT_PARMAP_FUTEX, XBT_PARMAP_BUSY_WAIT, XBT_PARMAP_DEFAULT,
+                                     XBT_PARMAP_WORK_STEALING};
 
   for (unsigned i = 0 ; i < sizeof all_modes / sizeof all_modes[0] ; i++) {
     if (1U << i & modes)
@@ -200,5 +216,11 @@ int main(int argc, char *argv[])
   bench_all_modes(bench_parmap_apply, nthreads, modes);
   printf("\n");
 
+  fun_to_apply = &fun_unbalanced_comp;
+
+  printf("Benchmark for parmap apply only (unbalanced comp):\n");
+  bench_all_modes(bench_parmap_apply, nthreads, modes);
+  printf("\n");
+
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,24 @@
+/* Copyright (c) 2017. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+/* Converts a binary trace, written with --cfg=tracing/binary:yes, into the regular Paje format read by the
+ * visualization tools. */
+
+#include "instr/instr_interface.h"
+#include "xbt/log.h"
+#include "xbt/module.h"
+#include "xbt/sysdep.h"
+
+XBT_LOG_NEW_DEFAULT_CATEGORY(bin2paje, "Binary trace converter Logging System");
+
+int main(int argc, char** argv)
+{
+  xbt_init(&argc, argv);
+  if (argc != 3)
+    xbt_die("Usage: %s <binary_trace_file> <trace_file>", argv[0]);
+  TRACE_binary_to_paje(argv[1], argv[2]);
+  XBT_INFO("Converted %s into %s", argv[1], argv[2]);
+  return 0;
+}
@@ -266,6 +266,7 @@ set(XBT_SRC
   src/xbt/heap.c
   src/xbt/log.c
   src/xbt/mallocator.c
+  src/xbt/calendar_queue.hpp
   src/xbt/memory_map.cpp
   src/xbt/memory_map.hpp
   src/xbt/parmap.cpp
@@ -315,6 +316,8 @@ set(SURF_SRC
   src/kernel/routing/NetZoneImpl.hpp
   src/kernel/routing/RoutedZone.cpp
   src/kernel/routing/RoutedZone.hpp
+  src/kernel/routing/RoutingTable.cpp
+  src/kernel/routing/RoutingTable.hpp
   src/kernel/routing/TorusZone.cpp
   src/kernel/routing/TorusZone.hpp
   src/kernel/routing/VivaldiZone.cpp
@@ -332,6 +335,7 @@ set(SURF_SRC
   src/surf/instr_surf.cpp
   src/surf/lagrange.cpp
   src/surf/maxmin.cpp
+  src/surf/maxmin_soa.cpp
   src/surf/network_cm02.cpp
   src/surf/network_constant.cpp
   src/surf/network_interface.cpp
@@ -541,10 +545,13 @@ set(TRACING_SRC
   src/instr/instr_config.cpp
   src/instr/instr_interface.cpp
   src/instr/instr_paje_containers.cpp
+  src/instr/instr_paje_binary.cpp
   src/instr/instr_paje_header.cpp
   src/instr/instr_paje_trace.cpp
   src/instr/instr_paje_types.cpp
   src/instr/instr_paje_values.cpp
+  src/instr/instr_paje_writer.cpp
+  src/instr/instr_paje_writer.hpp
   src/instr/instr_private.h
   src/instr/instr_smpi.h
   src/instr/instr_resource_utilization.cpp
@@ -578,6 +585,8 @@ set(MC_SRC
   src/mc/checker/CommunicationDeterminismChecker.hpp
   src/mc/checker/SafetyChecker.cpp
   src/mc/checker/SafetyChecker.hpp
+  src/mc/checker/ParallelSafetyChecker.cpp
+  src/mc/checker/ParallelSafetyChecker.hpp
   src/mc/checker/LivenessChecker.cpp
   src/mc/checker/LivenessChecker.hpp
   src/mc/remote/Channel.cpp
@@ -720,6 +729,7 @@ set(headers_to_install
   include/xbt/future.hpp
   include/xbt/graph.h
   include/xbt/heap.h
+  include/xbt/heap.hpp
   include/xbt/Extendable.hpp
   include/xbt/log.h
   include/xbt/log.hpp
@@ -1013,7 +1023,10 @@ set(CMAKEFILES_TXT
   teshsuite/smpi/mpich3-test/perf/CMakeLists.txt
   
   tools/CMakeLists.txt
+  tools/bin2paje/CMakeLists.txt
   tools/graphicator/CMakeLists.txt
+  tools/trace2bin/CMakeLists.txt
+  tools/ti2bin/CMakeLists.txt
   tools/tesh/CMakeLists.txt
   )
 
@@ -71,6 +71,10 @@ if(HAVE_PAPI)
   SET(SIMGRID_DEP "${SIMGRID_DEP} -lpapi")
 endif()
 
+if(HAVE_ZLIB)
+  SET(SIMGRID_DEP "${SIMGRID_DEP} ${ZLIB_LIBRARIES}")
+endif()
+
 if(HAVE_GRAPHVIZ)
   if(HAVE_CGRAPH_LIB)
     SET(SIMGRID_DEP "${SIMGRID_DEP} -lcgraph")
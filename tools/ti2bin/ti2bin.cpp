@@ -0,0 +1,44 @@
+/* Copyright (c) 2017. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+/* Converts the time-independent traces of SMPI between the textual format and the binary one, that is decoded without
+ * parsing any text when the trace is replayed. */
+
+#include "xbt/asserts.h"
+#include "xbt/log.h"
+#include "xbt/module.h"
+#include "xbt/replay.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+XBT_LOG_NEW_DEFAULT_CATEGORY(ti2bin, "Time-independent trace converter Logging System");
+
+int main(int argc, char** argv)
+{
+  xbt_init(&argc, argv);
+
+  if (argc >= 3 && strcmp(argv[1], "--dump") == 0) {
+    for (int file = 2; file < argc; file++)
+      simgrid::xbt::replay_trace_foreach(argv[file], [](const char* const* action) {
+        printf("%s", action[0]);
+        for (int i = 1; action[i] != nullptr; i++)
+          printf(" %s", action[i]);
+        printf("\n");
+      });
+  } else {
+    xbt_assert(argc == 3, "Usage: %s <trace_file> <binary_trace_file>\n"
+                          "       %s --dump <trace_file>...",
+               argv[0], argv[0]);
+    size_t count = 0;
+    simgrid::xbt::ReplayBinaryWriter writer(argv[2]);
+    simgrid::xbt::replay_trace_foreach(argv[1], [&writer, &count](const char* const* action) {
+      writer.write(action);
+      count++;
+    });
+    XBT_INFO("Converted %zu actions into %s", count, argv[2]);
+  }
+  return 0;
+}
@@ -0,0 +1,49 @@
+/* Copyright (c) 2017. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+/* Converts the availability and state traces between the textual format and the binary one, that is mapped in memory
+ * instead of being parsed when the platform is loaded. */
+
+#include "src/surf/trace_mgr.hpp"
+#include "surf/surf.h"
+#include "xbt/log.h"
+
+#include <cstdio>
+#include <cstring>
+
+XBT_LOG_NEW_DEFAULT_CATEGORY(trace2bin, "Trace converter Logging System");
+
+/* Print a trace in the textual format (the dates of the trace are the delays between the events) */
+static void dump_trace(tmgr_trace_t trace)
+{
+  const simgrid::trace_mgr::DatedValueList& events = trace->event_list;
+  double date = events.front().date_;
+  for (std::size_t i = 1; i < events.size(); i++) {
+    printf("%.15g %.15g\n", date, events[i].value_);
+    if (i + 1 < events.size())
+      date += events[i].date_;
+  }
+  if (events.back().date_ > 0)
+    printf("LOOPAFTER %.15g\n", events.back().date_ - events.front().date_);
+}
+
+int main(int argc, char** argv)
+{
+  XBT_LOG_CONNECT(trace2bin);
+  surf_init(&argc, argv);
+
+  if (argc == 3 && strcmp(argv[1], "--dump") == 0) {
+    dump_trace(tmgr_trace_new_from_file(argv[2]));
+  } else {
+    xbt_assert(argc == 3, "Usage: %s <trace_file> <binary_trace_file>\n"
+                          "       %s --dump <trace_file>",
+               argv[0], argv[0]);
+    tmgr_trace_t trace = tmgr_trace_new_from_file(argv[1]);
+    tmgr_trace_save_binary(trace, argv[2]);
+    XBT_INFO("Converted %zu events into %s", trace->event_list.size() - 1, argv[2]);
+  }
+  surf_exit();
+  return 0;
+}